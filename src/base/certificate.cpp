@@ -1,5 +1,5 @@
 #include "base/certificate.hpp"
-#include "rtc/base/task_utils/task_queue.hpp"
+#include "base/certificate_pool.hpp"
 
 #include <plog/Log.h>
 
@@ -156,9 +156,15 @@ std::shared_ptr<Certificate> Certificate::Generate(CertificateType type, std::st
 	return std::make_shared<Certificate>(x509, pkey);
 }
 
-const std::string COMMON_NAME = "libnaivertc";
+const std::string Certificate::kCommonName = "libnaivertc";
 std::shared_future<std::shared_ptr<Certificate>> Certificate::MakeCertificate(CertificateType type) {
-    auto future = std::async(std::launch::async, Certificate::Generate, type, COMMON_NAME);
+    // Take a pre-generated certificate if there is one ready.
+    if (auto certificate = CertificatePool::SharedInstance()->Take(type)) {
+        std::promise<std::shared_ptr<Certificate>> promise;
+        promise.set_value(std::move(certificate));
+        return promise.get_future().share();
+    }
+    auto future = std::async(std::launch::async, Certificate::Generate, type, kCommonName);
     return future;
 }
 
@@ -28,6 +28,8 @@ public:
     static std::string MakeFingerprint(X509* x509);
 
 private:
+    friend class CertificatePool;
+    static const std::string kCommonName;
     static std::shared_ptr<Certificate> Generate(CertificateType type, std::string_view common_name);
 private:
     std::shared_ptr<X509> x509_;
@@ -0,0 +1,77 @@
+#include "base/certificate_pool.hpp"
+
+#include <plog/Log.h>
+
+namespace naivertc {
+
+CertificatePool::CertificatePool() 
+    : task_queue_(std::make_unique<TaskQueue>("CertificatePool.task.queue")) {}
+
+CertificatePool::~CertificatePool() {
+    // Wait until the pending generating tasks are done.
+    task_queue_.reset();
+    pools_.clear();
+}
+
+void CertificatePool::Prepare(CertificateType type, size_t capacity) {
+    std::lock_guard lock(mutex_);
+    type = Normalize(type);
+    auto& pool = pools_[type];
+    pool.capacity = capacity;
+    while (pool.certificates.size() > capacity) {
+        pool.certificates.pop_back();
+    }
+    MaybeRefill(type);
+}
+
+std::shared_ptr<Certificate> CertificatePool::Take(CertificateType type) {
+    std::lock_guard lock(mutex_);
+    type = Normalize(type);
+    auto it = pools_.find(type);
+    if (it == pools_.end() || it->second.certificates.empty()) {
+        return nullptr;
+    }
+    auto certificate = std::move(it->second.certificates.front());
+    it->second.certificates.pop_front();
+    MaybeRefill(type);
+    return certificate;
+}
+
+size_t CertificatePool::NumReady(CertificateType type) const {
+    std::lock_guard lock(mutex_);
+    auto it = pools_.find(Normalize(type));
+    return it != pools_.end() ? it->second.certificates.size() : 0;
+}
+
+// Private methods
+CertificateType CertificatePool::Normalize(CertificateType type) {
+    // The default certificate is a ECDSA certificate.
+    return type == CertificateType::DEFAULT ? CertificateType::ECDSA : type;
+}
+
+void CertificatePool::MaybeRefill(CertificateType type) {
+    auto& pool = pools_[type];
+    while (pool.certificates.size() + pool.num_pending < pool.capacity) {
+        ++pool.num_pending;
+        task_queue_->Post([this, type](){
+            std::shared_ptr<Certificate> certificate = nullptr;
+            try {
+                certificate = Certificate::Generate(type, Certificate::kCommonName);
+            } catch (const std::exception& e) {
+                PLOG_WARNING << "Failed to pre-generate certificate: " << e.what();
+            }
+            OnCertificateGenerated(type, std::move(certificate));
+        });
+    }
+}
+
+void CertificatePool::OnCertificateGenerated(CertificateType type, std::shared_ptr<Certificate> certificate) {
+    std::lock_guard lock(mutex_);
+    auto& pool = pools_[type];
+    --pool.num_pending;
+    if (certificate && pool.certificates.size() < pool.capacity) {
+        pool.certificates.push_back(std::move(certificate));
+    }
+}
+    
+} // namespace naivertc
@@ -0,0 +1,56 @@
+#ifndef _BASE_CERTIFICATE_POOL_H_
+#define _BASE_CERTIFICATE_POOL_H_
+
+#include "base/defines.hpp"
+#include "base/certificate.hpp"
+#include "rtc/base/task_utils/task_queue.hpp"
+
+#include <map>
+#include <deque>
+#include <mutex>
+#include <memory>
+
+namespace naivertc {
+
+// A process-wide pool keeps a number of pre-generated certificates ready,
+// which takes the key pair generation off the critical path of connection
+// setup, and it will refill itself in background once a certificate is taken.
+class CertificatePool {
+public:
+    static CertificatePool* SharedInstance() {
+        static CertificatePool instance;
+        return &instance;
+    }
+
+    // Keeps |capacity| certificates of |type| ready, the pool
+    // of |type| will be disabled if |capacity| is zero.
+    void Prepare(CertificateType type, size_t capacity);
+
+    // Returns nullptr if there is no certificate ready.
+    std::shared_ptr<Certificate> Take(CertificateType type);
+
+    size_t NumReady(CertificateType type) const;
+
+private:
+    CertificatePool();
+    ~CertificatePool();
+
+    static CertificateType Normalize(CertificateType type);
+    void MaybeRefill(CertificateType type);
+    void OnCertificateGenerated(CertificateType type, std::shared_ptr<Certificate> certificate);
+
+private:
+    struct Pool {
+        size_t capacity = 0;
+        size_t num_pending = 0;
+        std::deque<std::shared_ptr<Certificate>> certificates;
+    };
+
+    mutable std::mutex mutex_;
+    std::map<CertificateType, Pool> pools_;
+    std::unique_ptr<TaskQueue> task_queue_;
+};
+
+} // namespace naivertc
+
+#endif
@@ -0,0 +1,64 @@
+#include "base/certificate_pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#define ENABLE_UNIT_TESTS 0
+#include "testing/defines.hpp"
+
+namespace naivertc {
+namespace test {
+namespace {
+
+bool WaitUntilReady(CertificateType type, size_t num_ready) {
+    for (int i = 0; i < 500; ++i) {
+        if (CertificatePool::SharedInstance()->NumReady(type) == num_ready) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+} // namespace
+
+MY_TEST(CertificatePoolTest, TakeAndRefill) {
+    auto pool = CertificatePool::SharedInstance();
+    EXPECT_EQ(pool->Take(CertificateType::ECDSA), nullptr);
+
+    pool->Prepare(CertificateType::ECDSA, 2);
+    ASSERT_TRUE(WaitUntilReady(CertificateType::ECDSA, 2));
+
+    // The default certificate shares the pool of ECDSA.
+    auto certificate = pool->Take(CertificateType::DEFAULT);
+    ASSERT_NE(certificate, nullptr);
+    EXPECT_FALSE(certificate->fingerprint().empty());
+
+    // Refilled in background.
+    EXPECT_TRUE(WaitUntilReady(CertificateType::ECDSA, 2));
+    auto other_certificate = pool->Take(CertificateType::ECDSA);
+    ASSERT_NE(other_certificate, nullptr);
+    EXPECT_NE(certificate->fingerprint(), other_certificate->fingerprint());
+
+    // Disable the pool.
+    pool->Prepare(CertificateType::ECDSA, 0);
+    EXPECT_TRUE(WaitUntilReady(CertificateType::ECDSA, 0));
+    EXPECT_EQ(pool->Take(CertificateType::ECDSA), nullptr);
+}
+
+MY_TEST(CertificatePoolTest, MakeCertificateFromPool) {
+    auto pool = CertificatePool::SharedInstance();
+    pool->Prepare(CertificateType::ECDSA, 1);
+    ASSERT_TRUE(WaitUntilReady(CertificateType::ECDSA, 1));
+
+    auto future = Certificate::MakeCertificate(CertificateType::ECDSA);
+    // The certificate is ready immediately.
+    EXPECT_EQ(future.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+    EXPECT_NE(future.get(), nullptr);
+
+    pool->Prepare(CertificateType::ECDSA, 0);
+}
+
+} // namespace test
+} // namespace naivertc
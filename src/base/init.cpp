@@ -1,4 +1,5 @@
 #include "base/init.hpp"
+#include "base/certificate_pool.hpp"
 #include "common/logger.hpp"
 #include "rtc/transports/dtls_transport.hpp"
 #include "rtc/transports/dtls_srtp_transport.hpp"
@@ -6,6 +7,13 @@
 #include "rtc/transports/sctp_transport_usr_sctp_settings.hpp"
 
 namespace naivertc {
+namespace {
+
+// The number of certificates kept ready for the peer connections
+// to be created, one is used per peer connection.
+constexpr size_t kNumPreparedCertificates = 2;
+
+} // namespace
 
 void InitLogger(LoggingLevel level);
 
@@ -19,9 +27,13 @@ void Init(LoggingLevel level) {
     // TODO: Add public APIs for user customizing sctp
     auto sctp_settings = SctpCustomizedSettings();
     SctpTransport::CustomizeSctp(sctp_settings);
+
+    // Generates the certificates in background before any peer connection is created.
+    CertificatePool::SharedInstance()->Prepare(CertificateType::DEFAULT, kNumPreparedCertificates);
 }
 
 void Cleanup() {
+    CertificatePool::SharedInstance()->Prepare(CertificateType::DEFAULT, 0);
     SctpTransport::Cleanup();
     DtlsSrtpTransport::Cleanup();
     DtlsTransport::Cleanup();
@@ -3,6 +3,7 @@
 
 #include "base/defines.hpp"
 
+#include <cassert>
 #include <cstdint>
 #include <vector>
 #include <type_traits>
@@ -51,6 +52,8 @@ public:
     T* data() const noexcept { return ptr_; }
     size_t size() const noexcept { return size_; };
     bool empty() const noexcept { return this->size() == 0; }
+    T& front() const noexcept { assert(!empty()); return ptr_[0]; }
+    T& back() const noexcept { assert(!empty()); return ptr_[size_ - 1]; }
 
     T* begin() const noexcept { return this->data(); }
     T* end() const noexcept { return this->data() + this->size(); }
@@ -0,0 +1,103 @@
+#ifndef _COMMON_RING_BUFFER_H_
+#define _COMMON_RING_BUFFER_H_
+
+#include "base/defines.hpp"
+
+#include <cassert>
+#include <optional>
+#include <vector>
+
+namespace naivertc {
+
+// RingBuffer is a FIFO container backed by a power-of-two sized array, which
+// grows by doubling when full and never shrinks, so no allocation happens in
+// the steady state.
+template<typename T>
+class RingBuffer {
+public:
+    RingBuffer() = default;
+    explicit RingBuffer(size_t capacity) { reserve(capacity); }
+    ~RingBuffer() = default;
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return slots_.size(); }
+    bool empty() const { return size_ == 0; }
+
+    // The index is relative to the front element.
+    T& operator[](size_t index) {
+        assert(index < size_);
+        return *slots_[(head_ + index) & mask_];
+    }
+    const T& operator[](size_t index) const {
+        assert(index < size_);
+        return *slots_[(head_ + index) & mask_];
+    }
+
+    T& front() { return (*this)[0]; }
+    const T& front() const { return (*this)[0]; }
+    T& back() { return (*this)[size_ - 1]; }
+    const T& back() const { return (*this)[size_ - 1]; }
+
+    void push_back(T value) {
+        if (size_ == slots_.size()) {
+            reserve(slots_.empty() ? kMinCapacity : slots_.size() * 2);
+        }
+        slots_[(head_ + size_) & mask_].emplace(std::move(value));
+        ++size_;
+    }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (size_ == slots_.size()) {
+            reserve(slots_.empty() ? kMinCapacity : slots_.size() * 2);
+        }
+        auto& slot = slots_[(head_ + size_) & mask_];
+        slot.emplace(std::forward<Args>(args)...);
+        ++size_;
+        return *slot;
+    }
+
+    void pop_front() {
+        assert(size_ > 0);
+        slots_[head_].reset();
+        head_ = (head_ + 1) & mask_;
+        --size_;
+    }
+
+    void clear() {
+        while (!empty()) {
+            pop_front();
+        }
+        head_ = 0;
+    }
+
+    // Grows the capacity to the power of two not less than |capacity|.
+    void reserve(size_t capacity) {
+        if (capacity <= slots_.size()) {
+            return;
+        }
+        size_t new_capacity = kMinCapacity;
+        while (new_capacity < capacity) {
+            new_capacity *= 2;
+        }
+        std::vector<std::optional<T>> new_slots(new_capacity);
+        for (size_t i = 0; i < size_; ++i) {
+            new_slots[i] = std::move(slots_[(head_ + i) & mask_]);
+        }
+        slots_ = std::move(new_slots);
+        head_ = 0;
+        mask_ = new_capacity - 1;
+    }
+
+private:
+    static constexpr size_t kMinCapacity = 4;
+
+    std::vector<std::optional<T>> slots_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+    size_t mask_ = 0;
+};
+
+} // namespace naivertc
+
+#endif
@@ -0,0 +1,61 @@
+#include "common/ring_buffer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#define ENABLE_UNIT_TESTS 0
+#include "testing/defines.hpp"
+
+namespace naivertc {
+namespace test {
+
+MY_TEST(RingBufferTest, PushAndPopInOrder) {
+    RingBuffer<int> buffer;
+    EXPECT_TRUE(buffer.empty());
+    for (int i = 0; i < 10; ++i) {
+        buffer.push_back(i);
+    }
+    EXPECT_EQ(buffer.size(), 10u);
+    EXPECT_EQ(buffer.capacity(), 16u);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(buffer[i], i);
+    }
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(buffer.front(), i);
+        buffer.pop_front();
+    }
+    EXPECT_TRUE(buffer.empty());
+}
+
+MY_TEST(RingBufferTest, WrapAroundWithoutGrowing) {
+    RingBuffer<int> buffer(4);
+    for (int i = 0; i < 100; ++i) {
+        buffer.push_back(i);
+        if (buffer.size() == 3) {
+            EXPECT_EQ(buffer.front(), i - 2);
+            buffer.pop_front();
+        }
+    }
+    EXPECT_EQ(buffer.capacity(), 4u);
+    EXPECT_EQ(buffer.front(), 98);
+    EXPECT_EQ(buffer.back(), 99);
+}
+
+MY_TEST(RingBufferTest, GrowAfterWrapAround) {
+    RingBuffer<std::unique_ptr<int>> buffer(4);
+    buffer.push_back(std::make_unique<int>(0));
+    buffer.push_back(std::make_unique<int>(1));
+    buffer.pop_front();
+    for (int i = 2; i < 6; ++i) {
+        buffer.emplace_back(std::make_unique<int>(i));
+    }
+    EXPECT_EQ(buffer.capacity(), 8u);
+    ASSERT_EQ(buffer.size(), 5u);
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        EXPECT_EQ(*buffer[i], static_cast<int>(i) + 1);
+    }
+}
+
+} // namespace test
+} // namespace naivertc
@@ -60,6 +60,35 @@ inline T division_with_roundup(T numerator, T denominator) {
     return (numerator + denominator / 2) / denominator;
 }
 
+// count_trailing_zeros
+// Returns the index of the lowest set bit of a non-zero |value|.
+inline size_t count_trailing_zeros(uint64_t value) {
+    assert(value != 0);
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_ctzll(value));
+#else
+    size_t count = 0;
+    while ((value & 1) == 0) {
+        value >>= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+// count_ones
+inline size_t count_ones(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_popcountll(value));
+#else
+    size_t count = 0;
+    for (; value != 0; value &= value - 1) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
 // to_u_type
 // C++11
 // template<typename T> 
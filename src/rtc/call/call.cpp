@@ -5,6 +5,12 @@
 #include "rtc/media/video_receive_stream.hpp"
 #include "rtc/rtp_rtcp/rtp/packets/rtp_packet_received.hpp"
 #include "rtc/call/rtp_send_controller.hpp"
+#include "rtc/call/packet_router.hpp"
+#include "rtc/rtp_rtcp/rtp/sender/rtp_packet_history_budget.hpp"
+#include "rtc/base/task_utils/task_queue_impl.hpp"
+
+#include <numeric>
+#include <algorithm>
 
 namespace naivertc {
 namespace {
@@ -30,20 +36,56 @@ bool SendPeriodicFeedback(const std::vector<RtpExtension>& extensions) {
     return true;
 }
 
-std::unique_ptr<RtpSendController> CreateSendController(Clock* clock) {
+std::unique_ptr<RtpSendController> CreateSendController(Clock* clock, 
+                                                        SharedPacedSender* shared_pacer,
+                                                        PacketRouter* packet_router,
+                                                        TargetTransferRateObserver* target_transfer_rate_observer) {
     RtpSendController::Configuration config;
     config.clock = clock;
+    config.shared_pacer = shared_pacer;
+    config.packet_sender = packet_router;
+    config.target_transfer_rate_observer = target_transfer_rate_observer;
     // TODO: Initial target bitrate settings.
     return std::make_unique<RtpSendController>(config);
 }
 
+// Shares the total bitrate evenly, and the bitrate left by the streams
+// capped by their max bitrates is shared by the others.
+std::vector<DataRate> AllocateBitrates(DataRate total_bitrate,
+                                       const std::vector<DataRate>& max_bitrates) {
+    // Visit the streams in ascending order of their max bitrates.
+    std::vector<size_t> indices(max_bitrates.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::stable_sort(indices.begin(), indices.end(), [&](size_t lhs, size_t rhs){
+        return max_bitrates[lhs] < max_bitrates[rhs];
+    });
+    std::vector<DataRate> allocated_bitrates(max_bitrates.size(), DataRate::Zero());
+    DataRate remaining_bitrate = total_bitrate;
+    size_t num_streams_left = indices.size();
+    for (size_t index : indices) {
+        DataRate fair_share = remaining_bitrate / num_streams_left--;
+        allocated_bitrates[index] = std::min(fair_share, max_bitrates[index]);
+        remaining_bitrate -= allocated_bitrates[index];
+    }
+    return allocated_bitrates;
+}
+
 } // namespace
 
-Call::Call(Clock* clock, RtcMediaTransport* send_transport) 
-    : clock_(clock),
-      send_transport_(send_transport),
-      send_controller_(CreateSendController(clock_)) {
+Call::Call(const Configuration& config) 
+    : clock_(config.clock),
+      send_transport_(config.send_transport),
+      worker_queue_(config.worker_queue),
+      packet_history_budget_(config.max_packet_history_bytes > 0 ? std::make_unique<RtpPacketHistoryBudget>(config.max_packet_history_bytes) 
+                                                                 : nullptr),
+      packet_router_(std::make_unique<PacketRouter>(worker_queue_)),
+      send_controller_(CreateSendController(clock_, config.shared_pacer, packet_router_.get(), this)) {
+    assert(clock_ != nullptr);
+    assert(worker_queue_ != nullptr);
     worker_queue_checker_.Detach();
+    worker_queue_->Post(ToQueuedTask(task_safety_, [this](){
+        packet_router_->SetPacer(send_controller_->pacer());
+    }));
 }
     
 Call::~Call() {};
@@ -75,7 +117,15 @@ void Call::DeliverRtpPacket(CopyOnWriteBuffer in_packet, bool is_rtcp) {
     }
 }
 
-void Call::AddVideoSendStream(const RtpParameters& rtp_params) {
+void Call::OnTargetTransferRate(TargetTransferRate target_rate) {
+    // Called on the worker queue of the send controller.
+    worker_queue_->Post(ToQueuedTask(task_safety_, [this, target_rate=std::move(target_rate)](){
+        AllocateTargetTransferRate(target_rate);
+    }));
+}
+
+void Call::AddVideoSendStream(const RtpParameters& rtp_params,
+                              MediaBitrateCallback media_bitrate_callback) {
     RTC_RUN_ON(&worker_queue_checker_);
     if (!UseSendSideBwe(rtp_params.extensions)) {
         PLOG_WARNING << "The transport sequence number extension is required to enable send-side bandwidth estimation.";
@@ -87,6 +137,8 @@ void Call::AddVideoSendStream(const RtpParameters& rtp_params) {
         VideoSendStream::Configuration send_config;
         send_config.clock = clock_;
         send_config.send_transport = send_transport_;
+        send_config.packet_history_budget = packet_history_budget_.get();
+        send_config.paced_sender = send_controller_->pacer();
         send_config.rtp = rtp_params;
         send_config.observers.bandwidth_observer = send_controller_.get();
         send_config.observers.rtcp_transport_feedback_observer = send_controller_.get();
@@ -96,7 +148,11 @@ void Call::AddVideoSendStream(const RtpParameters& rtp_params) {
         for (uint32_t ssrc : send_stream->ssrcs()) {
             rtp_demuxer_.AddRtcpSink(ssrc, send_stream.get());
         }
-        video_send_streams_.insert(std::move(send_stream));
+        // Added as the destination of the paced packets.
+        packet_router_->AddSendStream(send_stream.get());
+        video_send_streams_.push_back({std::move(send_stream), 
+                                       rtp_params.max_bitrate, 
+                                       std::move(media_bitrate_callback)});
     }
 
     OnAggregateNetworkStateChanged();
@@ -134,6 +190,9 @@ void Call::Clear() {
     RTC_RUN_ON(&worker_queue_checker_);
     rtp_demuxer_.Clear();
     send_controller_->Clear();
+    for (auto& stream_info : video_send_streams_) {
+        packet_router_->RemoveSendStream(stream_info.send_stream.get());
+    }
     video_send_streams_.clear();
     video_recv_streams_.clear();
     recv_streams_by_ssrc_.clear();
@@ -144,8 +203,8 @@ void Call::Send(video::EncodedFrame encoded_frame) {
     if (video_send_streams_.empty()) {
         return;
     }
-    for (auto& send_stream: video_send_streams_) {
-        send_stream->OnEncodedFrame(std::move(encoded_frame));
+    for (auto& stream_info : video_send_streams_) {
+        stream_info.send_stream->OnEncodedFrame(std::move(encoded_frame));
     }
 }
 
@@ -156,5 +215,33 @@ void Call::OnAggregateNetworkStateChanged() {
 
     send_controller_->OnNetworkAvailability(have_video);
 }
+
+void Call::AllocateTargetTransferRate(const TargetTransferRate& target_rate) {
+    RTC_RUN_ON(&worker_queue_checker_);
+    if (video_send_streams_.empty()) {
+        return;
+    }
+    std::vector<DataRate> max_bitrates;
+    max_bitrates.reserve(video_send_streams_.size());
+    for (const auto& stream_info : video_send_streams_) {
+        max_bitrates.push_back(stream_info.max_bitrate.value_or(DataRate::PlusInfinity()));
+    }
+    std::vector<DataRate> allocated_bitrates = AllocateBitrates(target_rate.target_bitrate, max_bitrates);
+    const double stable_ratio = target_rate.target_bitrate > DataRate::Zero() 
+                                    ? target_rate.stable_target_bitrate / target_rate.target_bitrate 
+                                    : 0.0;
+    for (size_t i = 0; i < video_send_streams_.size(); ++i) {
+        auto& stream_info = video_send_streams_[i];
+        TargetTransferRate stream_target_rate = target_rate;
+        stream_target_rate.target_bitrate = allocated_bitrates[i];
+        stream_target_rate.stable_target_bitrate = allocated_bitrates[i] * stable_ratio;
+        // The protection overhead is taken from the allocated bitrate, 
+        // and the encoder should target the bitrate left for the media.
+        DataRate media_bitrate = stream_info.send_stream->OnBitrateUpdated(stream_target_rate);
+        if (stream_info.media_bitrate_callback) {
+            stream_info.media_bitrate_callback(media_bitrate);
+        }
+    }
+}
     
 } // namespace naivertc
@@ -3,12 +3,15 @@
 
 #include "base/defines.hpp"
 #include "rtc/base/synchronization/sequence_checker.hpp"
+#include "rtc/base/task_utils/pending_task_safety_flag.hpp"
+#include "rtc/congestion_control/send_side/network_controller_interface.hpp"
 #include "rtc/rtp_rtcp/base/rtp_parameters.hpp"
 #include "rtc/rtp_rtcp/components/rtp_demuxer.hpp"
 #include "rtc/media/video/encoded_frame.hpp"
 
 #include <unordered_map>
 #include <set>
+#include <functional>
 
 namespace naivertc {
 
@@ -18,13 +21,32 @@ class VideoSendStream;
 class VideoReceiveStream;
 class MediaReceiveStream;
 class RtpSendController;
+class PacketRouter;
+class TaskQueueImpl;
+class SharedPacedSender;
+class RtpPacketHistoryBudget;
 
-class Call {
+class Call : public TargetTransferRateObserver {
 public:
-    Call(Clock* clock, RtcMediaTransport* send_transport);
-    ~Call();
-
-    void AddVideoSendStream(const RtpParameters& rtp_params);
+    struct Configuration {
+        Clock* clock = nullptr;
+        RtcMediaTransport* send_transport = nullptr;
+        TaskQueueImpl* worker_queue = nullptr;
+        // If set, the call is paced by the shared pacer.
+        SharedPacedSender* shared_pacer = nullptr;
+        // The bytes budget of the packet histories shared by the send
+        // streams, zero means no limit.
+        size_t max_packet_history_bytes = 0;
+    };
+public:
+    Call(const Configuration& config);
+    ~Call() override;
+
+    // Called on the worker queue with the bitrate left for the media
+    // after the protection overhead, which the encoder should target.
+    using MediaBitrateCallback = std::function<void(DataRate media_bitrate)>;
+    void AddVideoSendStream(const RtpParameters& rtp_params,
+                            MediaBitrateCallback media_bitrate_callback = nullptr);
     void AddVideoRecvStream(const RtpParameters& rtp_params);
 
     void Clear();
@@ -33,20 +55,38 @@ public:
 
     void DeliverRtpPacket(CopyOnWriteBuffer in_packet, bool is_rtcp);
 
+    // Implements TargetTransferRateObserver
+    void OnTargetTransferRate(TargetTransferRate target_rate) override;
+
 private:
     void OnAggregateNetworkStateChanged();
 
+    void AllocateTargetTransferRate(const TargetTransferRate& target_rate);
+
+private:
+    struct VideoSendStreamInfo {
+        std::unique_ptr<VideoSendStream> send_stream;
+        std::optional<DataRate> max_bitrate;
+        MediaBitrateCallback media_bitrate_callback;
+    };
+
 private:
     SequenceChecker worker_queue_checker_;
     Clock* const clock_;
     RtcMediaTransport* send_transport_;
+    TaskQueueImpl* const worker_queue_;
+    // Outlives the send streams.
+    std::unique_ptr<RtpPacketHistoryBudget> packet_history_budget_;
 
-    std::set<std::unique_ptr<VideoSendStream>> video_send_streams_;
+    std::vector<VideoSendStreamInfo> video_send_streams_;
     std::set<std::unique_ptr<VideoReceiveStream>> video_recv_streams_;
 
     std::unordered_map<uint32_t, MediaReceiveStream*> recv_streams_by_ssrc_;
 
     RtpDemuxer rtp_demuxer_;
+    ScopedTaskSafety task_safety_;
+    // Outlives the pacer of the send controller.
+    std::unique_ptr<PacketRouter> packet_router_;
     std::unique_ptr<RtpSendController> send_controller_;
     
 };
@@ -0,0 +1,92 @@
+#include "rtc/call/packet_router.hpp"
+#include "rtc/base/task_utils/task_queue_impl.hpp"
+#include "rtc/media/video_send_stream.hpp"
+
+#include <plog/Log.h>
+
+#include <algorithm>
+
+namespace naivertc {
+
+PacketRouter::PacketRouter(TaskQueueImpl* worker_queue) 
+    : worker_queue_(worker_queue) {
+    assert(worker_queue_ != nullptr);
+}
+
+PacketRouter::~PacketRouter() = default;
+
+void PacketRouter::AddSendStream(VideoSendStream* send_stream) {
+    RTC_RUN_ON(worker_queue_);
+    for (uint32_t ssrc : send_stream->ssrcs()) {
+        send_streams_by_ssrc_[ssrc] = send_stream;
+    }
+    send_streams_.push_back(send_stream);
+}
+
+void PacketRouter::RemoveSendStream(VideoSendStream* send_stream) {
+    RTC_RUN_ON(worker_queue_);
+    for (uint32_t ssrc : send_stream->ssrcs()) {
+        send_streams_by_ssrc_.erase(ssrc);
+    }
+    send_streams_.erase(std::remove(send_streams_.begin(), send_streams_.end(), send_stream), send_streams_.end());
+}
+
+void PacketRouter::SetPacer(RtpPacketSender* pacer) {
+    RTC_RUN_ON(worker_queue_);
+    pacer_ = pacer;
+}
+
+void PacketRouter::SendPacket(RtpPacketToSend packet, 
+                              const PacedPacketInfo& pacing_info) {
+    worker_queue_->Post(ToQueuedTask(task_safety_, [this, packet=std::move(packet), pacing_info]() mutable {
+        auto it = send_streams_by_ssrc_.find(packet.ssrc());
+        if (it == send_streams_by_ssrc_.end()) {
+            PLOG_WARNING << "No send stream found for the paced packet with ssrc=" << packet.ssrc();
+            return;
+        }
+        VideoSendStream* send_stream = it->second;
+        if (!send_stream->SendPacket(std::move(packet), pacing_info)) {
+            return;
+        }
+        // The FEC packets protecting the packet sent.
+        EnqueueToPacer(send_stream->FetchFecPackets());
+    }));
+}
+
+std::vector<RtpPacketToSend> PacketRouter::FetchFecPackets() {
+    // The FEC packets are enqueued once generated on the worker queue.
+    return {};
+}
+
+std::vector<RtpPacketToSend> PacketRouter::GeneratePadding(size_t padding_size) {
+    worker_queue_->Post(ToQueuedTask(task_safety_, [this, padding_size](){
+        for (VideoSendStream* send_stream : send_streams_) {
+            auto padding_packets = send_stream->GeneratePadding(padding_size);
+            if (!padding_packets.empty()) {
+                EnqueueToPacer(std::move(padding_packets));
+                return;
+            }
+        }
+    }));
+    // The padding packets are enqueued once generated on the worker queue.
+    return {};
+}
+
+void PacketRouter::OnFramesDropped(uint32_t ssrc, size_t num_frames) {
+    worker_queue_->Post(ToQueuedTask(task_safety_, [this, ssrc, num_frames](){
+        auto it = send_streams_by_ssrc_.find(ssrc);
+        if (it != send_streams_by_ssrc_.end()) {
+            it->second->OnFramesDropped(num_frames);
+        }
+    }));
+}
+
+// Private methods
+void PacketRouter::EnqueueToPacer(std::vector<RtpPacketToSend> packets) {
+    RTC_RUN_ON(worker_queue_);
+    if (!packets.empty() && pacer_) {
+        pacer_->EnqueuePackets(std::move(packets));
+    }
+}
+
+} // namespace naivertc
@@ -0,0 +1,56 @@
+#ifndef _RTC_CALL_PACKET_ROUTER_H_
+#define _RTC_CALL_PACKET_ROUTER_H_
+
+#include "base/defines.hpp"
+#include "rtc/base/task_utils/pending_task_safety_flag.hpp"
+#include "rtc/congestion_control/pacing/pacing_controller.hpp"
+#include "rtc/rtp_rtcp/base/rtp_rtcp_interfaces.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace naivertc {
+
+class TaskQueueImpl;
+class VideoSendStream;
+
+// Routes the packets paced by the pacer of a call to the send streams by SSRC,
+// and notifies the streams of the frames dropped by the pacer.
+// NOTE: The pacer calls the router on its own queue, while the send streams
+// run on the worker queue of the call, so the calls are posted to the worker
+// queue, and the FEC and padding packets generated there are enqueued back to
+// the pacer instead of being returned.
+class PacketRouter : public PacingController::PacketSender {
+public:
+    explicit PacketRouter(TaskQueueImpl* worker_queue);
+    ~PacketRouter() override;
+
+    // Called on the worker queue.
+    void AddSendStream(VideoSendStream* send_stream);
+    void RemoveSendStream(VideoSendStream* send_stream);
+    // The pacer to enqueue the FEC and padding packets to.
+    void SetPacer(RtpPacketSender* pacer);
+
+    // Implements PacingController::PacketSender, called on the pacing queue.
+    void SendPacket(RtpPacketToSend packet, 
+                    const PacedPacketInfo& pacing_info) override;
+    std::vector<RtpPacketToSend> FetchFecPackets() override;
+    std::vector<RtpPacketToSend> GeneratePadding(size_t padding_size) override;
+    void OnFramesDropped(uint32_t ssrc, size_t num_frames) override;
+
+private:
+    void EnqueueToPacer(std::vector<RtpPacketToSend> packets);
+
+private:
+    TaskQueueImpl* const worker_queue_;
+    RtpPacketSender* pacer_ RTC_GUARDED_BY(worker_queue_) = nullptr;
+    std::unordered_map<uint32_t, VideoSendStream*> send_streams_by_ssrc_ RTC_GUARDED_BY(worker_queue_);
+    // The streams in order of registration, the padding is generated by the
+    // first one which has sent media.
+    std::vector<VideoSendStream*> send_streams_ RTC_GUARDED_BY(worker_queue_);
+    ScopedTaskSafety task_safety_;
+};
+
+} // namespace naivertc
+
+#endif
@@ -11,14 +11,20 @@ namespace {
 // Goog-CC process interval: 25ms
 constexpr TimeDelta kUpdateInterval = TimeDelta::Millis(25);
 
-std::unique_ptr<TaskQueuePacedSender> CreatePacer(Clock* clock, TaskQueueImpl* pacing_queue) {
+std::unique_ptr<PacedSenderInterface> CreatePacer(Clock* clock, 
+                                                  PacingController::PacketSender* packet_sender,
+                                                  SharedPacedSender* shared_pacer,
+                                                  TaskQueue* pacing_queue) {
     TaskQueuePacedSender::Configuration config;
     config.clock = clock;
-    // TODO: Sets packet sende, pacing_settings and probing_settings.
-    // config.packet_sender = nullptr;
+    config.packet_sender = packet_sender;
+    // TODO: Sets pacing_settings and probing_settings.
     // config.pacing_settings
     // config.probing_settings
-    return std::make_unique<TaskQueuePacedSender>(config, pacing_queue);
+    if (shared_pacer) {
+        return shared_pacer->RegisterClient(config);
+    }
+    return std::make_unique<TaskQueuePacedSender>(config, pacing_queue->Get());
 }
 
 TargetBitrateConstraints InitialTargetBitrateContraints(const RtpSendController::Configuration& config) {
@@ -31,10 +37,12 @@ TargetBitrateConstraints InitialTargetBitrateContraints(const RtpSendController:
 
 RtpSendController::RtpSendController(const Configuration& config) 
     : clock_(config.clock),
+      target_transfer_rate_observer_(config.target_transfer_rate_observer),
       task_queue_("RtpSendController.worker.queue"),
-      pacing_queue_("RtpSendController.pacing.queue"),
+      pacing_queue_(config.shared_pacer ? nullptr 
+                                        : std::make_unique<TaskQueue>("RtpSendController.pacing.queue")),
       network_available_(false),
-      pacer_(CreatePacer(clock_, pacing_queue_.Get())),
+      pacer_(CreatePacer(clock_, config.packet_sender, config.shared_pacer, pacing_queue_.get())),
       last_report_block_time_(clock_->CurrentTime()) {
     assert(clock_ != nullptr);
     // Initial
@@ -61,6 +69,10 @@ void RtpSendController::Clear() {
     }
 }
 
+RtpPacketSender* RtpSendController::pacer() const {
+    return pacer_.get();
+}
+
 void RtpSendController::OnNetworkAvailability(bool network_available) {
     NetworkAvailability msg;
     msg.network_available = network_available;
@@ -163,7 +175,19 @@ void RtpSendController::MaybeCreateNetworkController() {
 
 void RtpSendController::PostUpdates(NetworkControlUpdate update) {
     RTC_RUN_ON(&task_queue_);
-
+    if (update.congestion_window) {
+        pacer_->SetCongestionWindow(*update.congestion_window);
+    }
+    if (update.pacer_config) {
+        pacer_->SetPacingBitrates(update.pacer_config->data_rate(), 
+                                  update.pacer_config->pad_rate());
+    }
+    for (const auto& probe : update.probe_cluster_configs) {
+        pacer_->AddProbeCluster(probe.id, probe.target_bitrate);
+    }
+    if (update.target_rate && target_transfer_rate_observer_) {
+        target_transfer_rate_observer_->OnTargetTransferRate(std::move(*update.target_rate));
+    }
 }
 
 void RtpSendController::HandleRtcpReportBlocks(const std::vector<RtcpReportBlock>& report_blocks,
@@ -6,6 +6,7 @@
 #include "rtc/base/task_utils/repeating_task.hpp"
 #include "rtc/congestion_control/components/network_transport_statistician.hpp"
 #include "rtc/congestion_control/pacing/task_queue_paced_sender.hpp"
+#include "rtc/congestion_control/pacing/shared_paced_sender.hpp"
 #include "rtc/congestion_control/send_side/network_controller_interface.hpp"
 
 #include <unordered_map>
@@ -26,6 +27,17 @@ public:
         std::optional<DataRate> min_bitrate;
         std::optional<DataRate> max_bitrate;
         std::optional<DataRate> starting_bitrate;
+
+        // If set, the call registers with the process-wide shared pacer
+        // instead of running a pacer of its own.
+        SharedPacedSender* shared_pacer = nullptr;
+
+        // Routes the paced packets to the RTP senders, and notifies them of
+        // the frames dropped by the pacer, see PacketRouter.
+        PacingController::PacketSender* packet_sender = nullptr;
+
+        // Notified of the target bitrate on the worker queue of the controller.
+        TargetTransferRateObserver* target_transfer_rate_observer = nullptr;
     };
 public:
     RtpSendController(const Configuration& config);
@@ -33,6 +45,10 @@ public:
 
     void Clear();
 
+    // The pacer which the RTP senders enqueue packets to, thread-safe
+    // as the pacer posts the packets to its own queue.
+    RtpPacketSender* pacer() const;
+
     void OnNetworkAvailability(bool network_available);
 
     // void OnReceivedPacket(const ReceivedPacket& recv_packet);
@@ -62,8 +78,10 @@ private:
 
 private:
     Clock* const clock_;
+    TargetTransferRateObserver* const target_transfer_rate_observer_;
     TaskQueue task_queue_;
-    TaskQueue pacing_queue_;
+    // Null if the shared pacer is used.
+    std::unique_ptr<TaskQueue> pacing_queue_;
     std::unique_ptr<RepeatingTask> controller_task_;
 
     bool network_available_ RTC_GUARDED_BY(task_queue_);
@@ -73,7 +91,7 @@ private:
     NetworkControllerInterface::Configuration network_config_ RTC_GUARDED_BY(task_queue_);
     std::unique_ptr<NetworkControllerInterface> network_controller_ RTC_GUARDED_BY(task_queue_);
 
-    std::unique_ptr<TaskQueuePacedSender> pacer_ RTC_GUARDED_BY(task_queue_);
+    std::unique_ptr<PacedSenderInterface> pacer_ RTC_GUARDED_BY(task_queue_);
 
     Timestamp last_report_block_time_ RTC_GUARDED_BY(task_queue_);
     std::unordered_map<uint32_t, RtcpReportBlock> last_report_blocks_ RTC_GUARDED_BY(task_queue_);
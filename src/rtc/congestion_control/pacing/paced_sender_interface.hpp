@@ -0,0 +1,36 @@
+#ifndef _RTC_CONGESTION_CONTROL_PACING_PACED_SENDER_INTERFACE_H_
+#define _RTC_CONGESTION_CONTROL_PACING_PACED_SENDER_INTERFACE_H_
+
+#include "rtc/rtp_rtcp/base/rtp_rtcp_interfaces.hpp"
+#include "rtc/base/units/data_rate.hpp"
+#include "rtc/base/units/time_delta.hpp"
+
+namespace naivertc {
+
+// The pacer of a call, which is either owned by the call itself or
+// a client of the process-wide shared pacer.
+class PacedSenderInterface : public RtpPacketSender {
+public:
+    virtual ~PacedSenderInterface() override = default;
+
+    virtual void Pause() = 0;
+    virtual void Resume() = 0;
+
+    virtual void EnsureStarted() = 0;
+    virtual void SetAccountForAudioPackets(bool account_for_audio) = 0;
+    virtual void SetIncludeOverhead() = 0;
+    virtual void SetTransportOverhead(size_t overhead_per_packet) = 0;
+    virtual void SetQueueTimeCap(TimeDelta cap) = 0;
+
+    virtual void SetProbingEnabled(bool enabled) = 0;
+    virtual void SetPacingBitrates(DataRate pacing_bitrate,
+                                   DataRate padding_bitrate) = 0;
+    virtual void SetCongestionWindow(size_t congestion_window_size) = 0;
+    virtual void OnInflightBytes(size_t inflight_bytes) = 0;
+
+    virtual void AddProbeCluster(int cluster_id, DataRate target_bitrate) = 0;
+};
+
+} // namespace naivertc
+
+#endif
@@ -0,0 +1,304 @@
+#include "rtc/congestion_control/pacing/pacing_controller.hpp"
+#include "rtc/congestion_control/pacing/task_queue_paced_sender.hpp"
+#include "testing/simulated_time_controller.hpp"
+#include "testing/allocation_counter.hpp"
+
+#include <gtest/gtest.h>
+
+#define ENABLE_UNIT_TESTS 0
+#include "testing/defines.hpp"
+#include "testing/simulated_clock.hpp"
+
+#include <chrono>
+#include <tuple>
+
+namespace naivertc {
+namespace test {
+namespace {
+
+constexpr uint32_t kFirstSsrc = 1000;
+constexpr size_t kMaxPaddingPacketSize = 224;
+constexpr TimeDelta kFrameInterval = TimeDelta::Millis(33);
+constexpr TimeDelta kMediaDuration = TimeDelta::Seconds(1);
+constexpr TimeDelta kMaxDrainTime = TimeDelta::Seconds(1);
+// The media is produced at 80% of the pacing bitrate.
+constexpr double kMediaLoadFactor = 0.8;
+
+using SteadyClock = std::chrono::steady_clock;
+
+int64_t ElapsedNs(SteadyClock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(SteadyClock::now() - start).count();
+}
+
+// Measures the heap allocations and the time spent within its scope.
+class ScopedMeasurement {
+public:
+    ScopedMeasurement(int64_t* elapsed_ns, size_t* num_allocations)
+        : elapsed_ns_(elapsed_ns),
+          num_allocations_(num_allocations),
+          start_(SteadyClock::now()) {}
+    ~ScopedMeasurement() {
+        *elapsed_ns_ += ElapsedNs(start_);
+        *num_allocations_ += allocation_counter_.num_allocations();
+    }
+private:
+    int64_t* const elapsed_ns_;
+    size_t* const num_allocations_;
+    const SteadyClock::time_point start_;
+    ScopedAllocationCounter allocation_counter_;
+};
+
+// Records the deviation of each media packet from its ideal send time, which
+// is the enqueue time or the time the previous packet is paced off at the
+// pacing bitrate, whichever comes later.
+class BenchmarkPacketSender : public PacingController::PacketSender {
+public:
+    BenchmarkPacketSender(Clock* clock, DataRate pacing_bitrate, size_t max_num_packets)
+        : clock_(clock),
+          pacing_bitrate_(pacing_bitrate) {
+        enqueue_times_.reserve(max_num_packets);
+    }
+
+    // The RTP timestamp of the media packet carries its index.
+    RtpPacketToSend BuildPacket(uint32_t ssrc, uint16_t seq_num, size_t payload_size) {
+        RtpPacketToSend packet(nullptr);
+        packet.set_packet_type(RtpPacketType::VIDEO);
+        packet.set_ssrc(ssrc);
+        packet.set_sequence_number(seq_num);
+        packet.set_timestamp(static_cast<uint32_t>(enqueue_times_.size()));
+        packet.set_capture_time_ms(clock_->now_ms());
+        packet.set_payload_size(payload_size);
+        enqueue_times_.push_back(clock_->CurrentTime());
+        return packet;
+    }
+
+    void SendPacket(RtpPacketToSend packet, const PacedPacketInfo& pacing_info) override {
+        if (packet.packet_type() == RtpPacketType::PADDING) {
+            padding_bytes_sent_ += packet.padding_size();
+            return;
+        }
+        const Timestamp now = clock_->CurrentTime();
+        const Timestamp ideal_send_time = std::max(enqueue_times_[packet.timestamp()], next_ideal_send_time_);
+        const TimeDelta deviation = (now - ideal_send_time).Abs();
+        total_deviation_ += deviation;
+        max_deviation_ = std::max(max_deviation_, deviation);
+        next_ideal_send_time_ = ideal_send_time + packet.payload_size() / pacing_bitrate_;
+        ++num_media_packets_sent_;
+    }
+
+    std::vector<RtpPacketToSend> FetchFecPackets() override {
+        return {};
+    }
+
+    std::vector<RtpPacketToSend> GeneratePadding(size_t target_size) override {
+        std::vector<RtpPacketToSend> padding_packets;
+        while (target_size > 0) {
+            const size_t padding_size = std::min(target_size, kMaxPaddingPacketSize);
+            RtpPacketToSend packet(nullptr);
+            packet.set_ssrc(kFirstSsrc);
+            packet.set_packet_type(RtpPacketType::PADDING);
+            packet.SetPadding(padding_size);
+            padding_packets.push_back(std::move(packet));
+            target_size -= padding_size;
+        }
+        return padding_packets;
+    }
+
+    size_t num_media_packets_enqueued() const { return enqueue_times_.size(); }
+    size_t num_media_packets_sent() const { return num_media_packets_sent_; }
+    size_t padding_bytes_sent() const { return padding_bytes_sent_; }
+    TimeDelta max_deviation() const { return max_deviation_; }
+    TimeDelta avg_deviation() const {
+        return num_media_packets_sent_ > 0 ? total_deviation_ / num_media_packets_sent_
+                                           : TimeDelta::Zero();
+    }
+
+private:
+    Clock* const clock_;
+    const DataRate pacing_bitrate_;
+    std::vector<Timestamp> enqueue_times_;
+    Timestamp next_ideal_send_time_ = Timestamp::Zero();
+    size_t num_media_packets_sent_ = 0;
+    size_t padding_bytes_sent_ = 0;
+    TimeDelta total_deviation_ = TimeDelta::Zero();
+    TimeDelta max_deviation_ = TimeDelta::Zero();
+};
+
+// Produces the packets of all the streams every |kFrameInterval|, the
+// packets are spread over the streams in turn.
+class MediaSource {
+public:
+    MediaSource(DataRate pacing_bitrate, size_t num_streams, size_t packet_size)
+        : num_streams_(num_streams),
+          packet_size_(packet_size),
+          num_packets_per_frame_(std::max<size_t>(1, pacing_bitrate * kFrameInterval * kMediaLoadFactor / packet_size)),
+          next_stream_(0),
+          seq_nums_(num_streams, 0) {}
+
+    size_t MaxNumPackets() const {
+        const size_t num_frames = kMediaDuration / kFrameInterval + 1;
+        return num_frames * num_packets_per_frame_;
+    }
+
+    std::vector<RtpPacketToSend> NextFrames(BenchmarkPacketSender* packet_sender) {
+        std::vector<RtpPacketToSend> packets;
+        packets.reserve(num_packets_per_frame_);
+        for (size_t i = 0; i < num_packets_per_frame_; ++i) {
+            packets.push_back(packet_sender->BuildPacket(static_cast<uint32_t>(kFirstSsrc + next_stream_),
+                                                         seq_nums_[next_stream_]++,
+                                                         packet_size_));
+            next_stream_ = (next_stream_ + 1) % num_streams_;
+        }
+        return packets;
+    }
+
+private:
+    const size_t num_streams_;
+    const size_t packet_size_;
+    const size_t num_packets_per_frame_;
+    size_t next_stream_;
+    std::vector<uint16_t> seq_nums_;
+};
+
+struct BenchmarkResult {
+    int64_t enqueue_ns = 0;
+    int64_t process_ns = 0;
+    size_t num_allocations = 0;
+    size_t num_process_calls = 0;
+};
+
+} // namespace
+
+// Params: pacing bitrate in Mbps, number of streams, packet size, probing enabled.
+class T(PacerBenchmarkTest) : public ::testing::TestWithParam<std::tuple<int, size_t, size_t, bool>> {
+public:
+    T(PacerBenchmarkTest)()
+        : pacing_bitrate_(DataRate::KilobitsPerSec(std::get<0>(GetParam()) * 1000)),
+          num_streams_(std::get<1>(GetParam())),
+          packet_size_(std::get<2>(GetParam())),
+          probing_enabled_(std::get<3>(GetParam())) {}
+
+    void Report(const char* pacer_name,
+                const BenchmarkResult& result,
+                const BenchmarkPacketSender& packet_sender) {
+        const size_t num_packets = std::max<size_t>(1, packet_sender.num_media_packets_enqueued());
+        GTEST_COUT << pacer_name
+                   << " bitrate=" << pacing_bitrate_.kbps() / 1000 << " Mbps"
+                   << " streams=" << num_streams_
+                   << " packet_size=" << packet_size_
+                   << " probing=" << (probing_enabled_ ? "on" : "off")
+                   << " packets=" << num_packets
+                   << " - enqueue=" << result.enqueue_ns / num_packets << " ns/packet"
+                   << " process=" << result.process_ns / num_packets << " ns/packet"
+                   << " allocs=" << static_cast<double>(result.num_allocations) / num_packets << " /packet"
+                   << " wakeups=" << result.num_process_calls
+                   << " deviation avg=" << packet_sender.avg_deviation().us() << " us"
+                   << " max=" << packet_sender.max_deviation().us() << " us"
+                   << std::endl;
+    }
+
+protected:
+    const DataRate pacing_bitrate_;
+    const size_t num_streams_;
+    const size_t packet_size_;
+    const bool probing_enabled_;
+};
+
+MY_INSTANTIATE_TEST_SUITE_P(PacerScaling,
+                            PacerBenchmarkTest,
+                            ::testing::Combine(::testing::Values(1, 10, 50),
+                                               ::testing::Values(1, 16),
+                                               ::testing::Values(200, 1200),
+                                               ::testing::Bool()));
+
+MY_TEST_P(PacerBenchmarkTest, PacingController) {
+    SimulatedClock clock(Timestamp::Seconds(1000));
+    MediaSource media_source(pacing_bitrate_, num_streams_, packet_size_);
+    BenchmarkPacketSender packet_sender(&clock, pacing_bitrate_, media_source.MaxNumPackets());
+    PacingController::Configuration config;
+    config.clock = &clock;
+    config.packet_sender = &packet_sender;
+    PacingController pacer(config);
+    pacer.SetProbingEnabled(probing_enabled_);
+    pacer.SetPacingBitrates(pacing_bitrate_, DataRate::Zero());
+    if (probing_enabled_) {
+        pacer.AddProbeCluster(/*cluster_id=*/1, pacing_bitrate_ * 2);
+        pacer.AddProbeCluster(/*cluster_id=*/2, pacing_bitrate_ * 3);
+    }
+
+    BenchmarkResult result;
+    const Timestamp media_end_time = clock.CurrentTime() + kMediaDuration;
+    const Timestamp drain_end_time = media_end_time + kMaxDrainTime;
+    Timestamp next_frame_time = clock.CurrentTime();
+    while (clock.CurrentTime() < drain_end_time) {
+        Timestamp now = clock.CurrentTime();
+        if (now >= next_frame_time && now < media_end_time) {
+            auto packets = media_source.NextFrames(&packet_sender);
+            ScopedMeasurement measurement(&result.enqueue_ns, &result.num_allocations);
+            for (auto& packet : packets) {
+                pacer.EnqueuePacket(std::move(packet));
+            }
+            next_frame_time += kFrameInterval;
+        } else if (now >= media_end_time && pacer.NumQueuedPackets() == 0) {
+            break;
+        }
+
+        if (pacer.NextSendTime() <= now) {
+            ScopedMeasurement measurement(&result.process_ns, &result.num_allocations);
+            pacer.ProcessPackets();
+            ++result.num_process_calls;
+        }
+
+        Timestamp next_time = pacer.NextSendTime();
+        if (next_frame_time < media_end_time) {
+            next_time = std::min(next_time, next_frame_time);
+        }
+        // Advance at least 1 us to make progress.
+        clock.AdvanceTime(std::max(next_time - now, TimeDelta::Micros(1)));
+    }
+
+    EXPECT_EQ(packet_sender.num_media_packets_sent(), packet_sender.num_media_packets_enqueued());
+    Report("PacingController", result, packet_sender);
+}
+
+MY_TEST_P(PacerBenchmarkTest, TaskQueuePacedSender) {
+    SimulatedTimeController time_controller(Timestamp::Seconds(1000));
+    auto task_queue = time_controller.CreateTaskQueue();
+    MediaSource media_source(pacing_bitrate_, num_streams_, packet_size_);
+    BenchmarkPacketSender packet_sender(time_controller.Clock(), pacing_bitrate_, media_source.MaxNumPackets());
+    TaskQueuePacedSender::Configuration config;
+    config.clock = time_controller.Clock();
+    config.packet_sender = &packet_sender;
+    auto pacer = std::make_unique<TaskQueuePacedSender>(config, task_queue.get());
+    pacer->SetProbingEnabled(probing_enabled_);
+    pacer->SetPacingBitrates(pacing_bitrate_, DataRate::Zero());
+    if (probing_enabled_) {
+        pacer->AddProbeCluster(/*cluster_id=*/1, pacing_bitrate_ * 2);
+        pacer->AddProbeCluster(/*cluster_id=*/2, pacing_bitrate_ * 3);
+    }
+    pacer->EnsureStarted();
+
+    // The time spent in the task queue is accounted as processing.
+    BenchmarkResult result;
+    const Timestamp media_end_time = time_controller.CurrentTime() + kMediaDuration;
+    while (time_controller.CurrentTime() < media_end_time) {
+        auto packets = media_source.NextFrames(&packet_sender);
+        {
+            ScopedMeasurement measurement(&result.enqueue_ns, &result.num_allocations);
+            pacer->EnqueuePackets(std::move(packets));
+        }
+        ScopedMeasurement measurement(&result.process_ns, &result.num_allocations);
+        time_controller.AdvanceTime(kFrameInterval);
+    }
+    {
+        ScopedMeasurement measurement(&result.process_ns, &result.num_allocations);
+        time_controller.AdvanceTime(kMaxDrainTime);
+    }
+    result.num_process_calls = pacer->GetStats().num_process_wakeups;
+
+    EXPECT_EQ(packet_sender.num_media_packets_sent(), packet_sender.num_media_packets_enqueued());
+    Report("TaskQueuePacedSender", result, packet_sender);
+}
+
+} // namespace test
+} // namespace naivertc
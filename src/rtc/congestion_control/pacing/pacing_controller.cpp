@@ -104,6 +104,10 @@ DataRate PacingController::pacing_bitrate() const {
     return pacing_bitrate_;
 }
 
+TimeDelta PacingController::send_burst_interval() const {
+    return pacing_settings_.send_burst_interval;
+}
+
 void PacingController::Pause() {
     if (!paused_) {
         PLOG_INFO << "PacedSender paused.";
@@ -231,6 +235,8 @@ void PacingController::ProcessPackets() {
         size_t queued_packet_size = packet_queue_.queued_size();
         if (queued_packet_size > 0) {
             packet_queue_.UpdateEnqueueTime(now);
+            MaybeDropStaleFrames(now);
+            queued_packet_size = packet_queue_.queued_size();
             if (pacing_settings_.drain_large_queue) {
                 auto avg_time_left = std::max(TimeDelta::Millis(1), queue_time_cap_ - packet_queue_.AverageQueueTime());
                 // The minimum bitrate required to drain queue.
@@ -322,7 +328,7 @@ void PacingController::ProcessPackets() {
         }
 
         const RtpPacketType packet_type = rtp_packet->packet_type();
-        size_t packet_size = rtp_packet->payload_size() + rtp_packet->padding_size();
+        size_t packet_size = rtp_packet->expected_payload_size() + rtp_packet->padding_size();
         if (include_overhead()) {
             packet_size += rtp_packet->header_size() + transport_overhead();
         }
@@ -410,7 +416,7 @@ Timestamp PacingController::NextSendTime() const {
         //            << " - paid_off_time=" << TimeToPayOffMediaDebt().ms()
         //            << " ms" << std::endl;
         return std::min(last_send_time_ + kPausedProcessInterval, 
-                        last_process_time_ + TimeToPayOffMediaDebt());
+                        last_process_time_ + TimeToPayOffMediaDebtInBurst());
     }
 
     // Send padding packet when no packets in queue.
@@ -459,7 +465,7 @@ TimeDelta PacingController::ExpectedQueueTime() const {
 // Private methods
 void PacingController::EnqueuePacketInternal(RtpPacketToSend packet, 
                                              const int priority) {
-    prober_.OnIncomingPacket(packet.size());
+    prober_.OnIncomingPacket(packet.expected_size());
 
     auto now = clock_->CurrentTime();
     
@@ -538,6 +544,23 @@ bool PacingController::IsTimeToSendHeartbeat(Timestamp at_time) const {
     return false;
 }
 
+void PacingController::MaybeDropStaleFrames(Timestamp at_time) {
+    const TimeDelta deadline = pacing_settings_.stale_frame_deadline;
+    if (deadline.IsPlusInfinity()) {
+        return;
+    }
+    // The queue is expected to be drained in time.
+    if (!pacing_bitrate_.IsZero() && ExpectedQueueTime() <= deadline) {
+        return;
+    }
+    auto dropped_frames = packet_queue_.DropStaleFrames(at_time - deadline);
+    for (const auto& [ssrc, num_frames] : dropped_frames) {
+        PLOG_WARNING << "Dropped " << num_frames << " stale frames of stream ssrc="
+                     << ssrc << " queued longer than " << deadline.ms() << " ms.";
+        packet_sender_->OnFramesDropped(ssrc, num_frames);
+    }
+}
+
 void PacingController::OnMediaSent(RtpPacketType packet_type, 
                                    size_t sent_bytes, 
                                    Timestamp at_time) {
@@ -588,7 +611,7 @@ std::optional<RtpPacketToSend> PacingController::NextPacketToSend(const PacedPac
             // NOTE: |time_to_paid_off|是一个估计值，预估之前发送的包到达接收端的理论时长。
             // 因为此时|media_debt_|对应的包可能已经抵达接受端，只是发送端还没收到反馈而已，
             // 故media_debt_可能未被及时更新。
-            auto time_to_paid_off = TimeToPayOffMediaDebt();
+            auto time_to_paid_off = TimeToPayOffMediaDebtInBurst();
             // GTEST_COUT << "at_time=" << at_time.ms() 
             //            << " ms - target_send_time=" << target_send_time.ms()
             //            << " ms - time_to_paid_off=" << time_to_paid_off.ms() << " ms."
@@ -646,6 +669,16 @@ inline TimeDelta PacingController::TimeToPayOffMediaDebt() const {
     return media_debt_ / media_bitrate_;
 }
 
+inline TimeDelta PacingController::TimeToPayOffMediaDebtInBurst() const {
+    TimeDelta time_to_paid_off = TimeToPayOffMediaDebt();
+    // The debt is allowed to grow up to one packet more than what
+    // can be sent during the burst interval.
+    if (time_to_paid_off < pacing_settings_.send_burst_interval) {
+        return TimeDelta::Zero();
+    }
+    return time_to_paid_off;
+}
+
 inline TimeDelta PacingController::TimeToPayOffPaddingDebt() const {
     return padding_debt_ / padding_bitrate_;
 }
@@ -26,6 +26,9 @@ public:
         // Should be called after each call to SendPacket().
         virtual std::vector<RtpPacketToSend> FetchFecPackets() = 0;
         virtual std::vector<RtpPacketToSend> GeneratePadding(size_t padding_size) = 0;
+        // Called when the stale frames of the stream |ssrc| were dropped under
+        // congestion, the encoder should request a key frame or lower the rate.
+        virtual void OnFramesDropped(uint32_t ssrc, size_t num_frames) {}
     };
 
     struct PacingSettings {
@@ -39,6 +42,14 @@ public:
         bool ignore_transport_overhead = false;
         // "WebRTC-Pacer-DynamicPaddingTarget/timedelta:10ms/"
         TimeDelta padding_target_duration = TimeDelta::Millis(5);
+        // The pacer may send ahead of schedule by up to |send_burst_interval|
+        // worth of budget, which allows the packets to be sent in a burst with
+        // fewer wakeups, zero means no burst.
+        TimeDelta send_burst_interval = TimeDelta::Zero();
+        // If the expected queue time exceeds |stale_frame_deadline|, the non-key
+        // video frames queued longer than it are dropped instead of being sent
+        // too late to render, infinity means never drop.
+        TimeDelta stale_frame_deadline = TimeDelta::PlusInfinity();
     };
 
     using ProbingSettings = BitrateProber::Configuration;
@@ -90,6 +101,8 @@ public:
 
     DataRate pacing_bitrate() const;
 
+    TimeDelta send_burst_interval() const;
+
     void Pause();
     void Resume();
 
@@ -134,6 +147,8 @@ private:
 
     bool IsTimeToSendHeartbeat(Timestamp at_time) const;
 
+    void MaybeDropStaleFrames(Timestamp at_time);
+
     void OnMediaSent(RtpPacketType packet_type, 
                      size_t sent_bytes, 
                      Timestamp at_time);
@@ -148,6 +163,9 @@ private:
     size_t PaddingSizeToAdd(size_t recommended_probe_size, size_t sent_bytes);
 
     inline TimeDelta TimeToPayOffMediaDebt() const;
+    // Returns zero if the media debt can be paid off within the send burst
+    // interval, so the packets can be sent ahead of schedule.
+    inline TimeDelta TimeToPayOffMediaDebtInBurst() const;
     inline TimeDelta TimeToPayOffPaddingDebt() const;
                 
 private:
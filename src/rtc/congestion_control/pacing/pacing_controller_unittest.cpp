@@ -132,6 +132,7 @@ public:
                 (override));
     MOCK_METHOD(size_t, SendPadding, (size_t target_size));
     MOCK_METHOD(void, SendProbe, (RtpPacketType, uint32_t ssrc, int probe_cluster_id));
+    MOCK_METHOD(void, OnFramesDropped, (uint32_t ssrc, size_t num_frames), (override));
 
     size_t padding_sent() const { return padding_sent_; }
     size_t total_bytes_sent() const { return total_bytes_sent_; }
@@ -1563,5 +1564,36 @@ MY_TEST_F(PacingControllerTest, GapInPacingDoesntAccumulateBudget) {
     pacer_->ProcessPackets();
 }
 
+MY_TEST_F(PacingControllerTest, DropsStaleFramesWhenQueueTooLong) {
+    const size_t kPacketSize = 1000;
+    const TimeDelta kStaleFrameDeadline = TimeDelta::Millis(100);
+    pacing_config_.pacing_settings.stale_frame_deadline = kStaleFrameDeadline;
+    pacing_config_.pacing_settings.drain_large_queue = false;
+    pacer_ = std::make_unique<PacingController>(pacing_config_);
+    pacer_->SetProbingEnabled(false);
+    // 100 ms per packet.
+    pacer_->SetPacingBitrates(kPacketSize / TimeDelta::Millis(100), DataRate::Zero());
+
+    // Enqueue 5 delta frames, which are expected to be queued for 1s.
+    uint16_t seq_num = 0;
+    for (int frame = 0; frame < 5; ++frame) {
+        for (int i = 0; i < 2; ++i) {
+            auto packet = BuildPacket(RtpPacketType::VIDEO, kVideoSsrc, seq_num++, clock_.now_ms(), kPacketSize);
+            packet.set_is_first_packet_of_frame(i == 0);
+            pacer_->EnqueuePacket(std::move(packet));
+        }
+    }
+    EXPECT_GT(pacer_->ExpectedQueueTime(), kStaleFrameDeadline);
+
+    // All the frames but the last one are dropped once stale, and the late
+    // process catches up by sending both packets of the last frame.
+    clock_.AdvanceTime(kStaleFrameDeadline + TimeDelta::Millis(10));
+    EXPECT_CALL(packet_sender_, OnFramesDropped(kVideoSsrc, 4u));
+    EXPECT_CALL(packet_sender_, SendPacket(RtpPacketType::VIDEO, kVideoSsrc, 8, _, kPacketSize));
+    EXPECT_CALL(packet_sender_, SendPacket(RtpPacketType::VIDEO, kVideoSsrc, 9, _, kPacketSize));
+    pacer_->ProcessPackets();
+    EXPECT_EQ(pacer_->NumQueuedPackets(), 0u);
+}
+
 } // namespace test    
 } // namespace naivertc
@@ -1,5 +1,7 @@
 #include "rtc/congestion_control/pacing/round_robin_packet_queue.hpp"
 
+#include <algorithm>
+
 namespace naivertc {
 namespace {
 
@@ -8,12 +10,12 @@ constexpr size_t kMaxLeadingSize = 1400;
 } // namespace
 
 // RoundRobinPacketQueue
-RoundRobinPacketQueue::RoundRobinPacketQueue(Timestamp start_time) 
+RoundRobinPacketQueue::RoundRobinPacketQueue(Timestamp start_time)
     : time_last_update_(start_time),
       max_stream_sent_size_(kMaxLeadingSize) {
 
 }
-   
+
 RoundRobinPacketQueue::~RoundRobinPacketQueue() {
     while (!Empty()) {
         Pop();
@@ -28,11 +30,13 @@ void RoundRobinPacketQueue::set_include_overhead() {
     MaybePromoteSinglePacketToNormalQueue();
     include_overhead_ = true;
     // Update the size to reflect overhead for existing packets.
-    for (const auto& stream : streams_) {
-        for (const auto& packet : stream.second.packet_queue) {
-            // The header size of each packet may be different as within defferent
-            // header extensions.
-            total_queued_size_ += packet.owned_packet.header_size() + transport_overhead_;
+    for (const auto& [ssrc, stream] : streams_) {
+        for (const auto& packet_fifo : stream.packet_fifos) {
+            packet_fifo.ForEach([this](const QueuedPacket& packet){
+                // The header size of each packet may be different as within defferent
+                // header extensions.
+                total_queued_size_ += packet.owned_packet.header_size() + transport_overhead_;
+            });
         }
     }
 }
@@ -44,8 +48,8 @@ size_t RoundRobinPacketQueue::transport_overhead() const {
 void RoundRobinPacketQueue::set_transport_overhead(size_t overhead_per_packet) {
     MaybePromoteSinglePacketToNormalQueue();
     // Update the size to reflect overhead for existing packets.
-    for (const auto& stream : streams_) {
-        int num_packets = stream.second.packet_queue.size();
+    for (const auto& [ssrc, stream] : streams_) {
+        int num_packets = stream.num_packets;
         total_queued_size_ += num_packets * (overhead_per_packet - transport_overhead_);
     }
     transport_overhead_ = overhead_per_packet;
@@ -53,10 +57,10 @@ void RoundRobinPacketQueue::set_transport_overhead(size_t overhead_per_packet) {
 
 bool RoundRobinPacketQueue::Empty() const {
     if (num_packets_ == 0) {
-        assert(!single_packet_queue_.has_value() && stream_priorities_.empty());
+        assert(!single_packet_queue_.has_value() && GetHighestPriorityStream() == nullptr);
         return true;
     }
-    assert(single_packet_queue_.has_value() || !stream_priorities_.empty());
+    assert(single_packet_queue_.has_value() || GetHighestPriorityStream() != nullptr);
     return false;
 }
 
@@ -64,25 +68,26 @@ void RoundRobinPacketQueue::Push(int priority,
                                  Timestamp enqueue_time,
                                  uint64_t enqueue_order,
                                  RtpPacketToSend packet) {
+    // Lower number takes priority over higher.
+    priority = std::clamp(priority, 0, kNumPriorityLevels - 1);
     if (num_packets_ == 0) {
         // Single packet fast-path
-        single_packet_queue_.emplace(QueuedPacket(priority, 
-                                                  enqueue_time, 
-                                                  enqueue_order, 
-                                                  enqueue_times_.end(), 
-                                                  std::move(packet)));
+        single_packet_queue_.emplace(priority,
+                                     enqueue_time,
+                                     enqueue_order,
+                                     std::move(packet));
         UpdateEnqueueTime(enqueue_time);
         single_packet_queue_->SubtractPauseTime(pause_time_sum_);
         num_packets_ = 1;
         total_queued_size_ += PacketSize(*single_packet_queue_);
     } else {
         MaybePromoteSinglePacketToNormalQueue();
-        Push(QueuedPacket(priority, 
-                          enqueue_time, 
-                          enqueue_order, 
-                          enqueue_times_.insert(enqueue_time), 
-                          std::move(packet)));
-    } 
+        Push(QueuedPacket(priority,
+                          enqueue_time,
+                          enqueue_order,
+                          std::move(packet)),
+             false /* promoted */);
+    }
 }
 
 std::optional<RtpPacketToSend> RoundRobinPacketQueue::Pop() {
@@ -98,12 +103,14 @@ std::optional<RtpPacketToSend> RoundRobinPacketQueue::Pop() {
     // Get the stream with highest priority.
     Stream* stream = GetHighestPriorityStream();
     // No stream found.
-    if (stream == nullptr || IsEmptyStream(*stream)) {
+    if (stream == nullptr) {
         return std::nullopt;
     }
-    
+
     // Get the packet with highest priority in the stream.
-    const QueuedPacket& queued_packet = stream->packet_queue.top();
+    PacketFifo& packet_fifo = stream->packet_fifos[stream->scheduled_priority];
+    assert(!packet_fifo.empty());
+    QueuedPacket& queued_packet = packet_fifo.front();
 
     // Calculate the total amount of time spent by this packet in the queue
     // while in a non-paused state. Note that the |pause_time_sum_| was
@@ -113,8 +120,7 @@ std::optional<RtpPacketToSend> RoundRobinPacketQueue::Pop() {
     TimeDelta delat_in_non_paused_state = time_last_update_ - queued_packet.enqueue_time - pause_time_sum_;
     queue_time_sum_ -= delat_in_non_paused_state;
 
-    assert(queued_packet.enqueue_time_it != enqueue_times_.end());
-    enqueue_times_.erase(queued_packet.enqueue_time_it);
+    RemoveEnqueueTime(queued_packet.enqueue_time_index);
 
     // Update |bytes| of this stream. The general idea is that the stream that
     // has sent the least amount of bytes should have the highest priority.
@@ -131,16 +137,15 @@ std::optional<RtpPacketToSend> RoundRobinPacketQueue::Pop() {
     num_packets_ -= 1;
 
     RtpPacketToSend rtp_packet = std::move(queued_packet.owned_packet);
-    stream->packet_queue.pop();
+    packet_fifo.pop_front();
+    stream->num_packets -= 1;
 
     // Update priority after popping packet.
-    stream_priorities_.erase(stream->priority_it);
-    if (stream->packet_queue.empty()) {
-        stream->priority_it = stream_priorities_.end();
-    } else {
+    UnscheduleStream(stream);
+    int priority = stream->top_priority();
+    if (priority >= 0) {
         // The highest priority of packet denotes the priority of stream.
-        int priority = stream->packet_queue.top().priority;
-        stream->priority_it = stream_priorities_.emplace(StreamPrioKey(priority, stream->sent_size), stream->ssrc);
+        ScheduleStream(stream, priority);
     }
     return rtp_packet;
 }
@@ -149,10 +154,10 @@ Timestamp RoundRobinPacketQueue::OldestEnqueueTime() const {
     if (single_packet_queue_) {
         return single_packet_queue_->enqueue_time;
     }
-    if (stream_priorities_.empty()) {
+    if (enqueue_times_.empty()) {
         return Timestamp::MinusInfinity();
     }
-    return *enqueue_times_.begin();
+    return enqueue_times_.front().enqueue_time;
 }
 
 void RoundRobinPacketQueue::UpdateEnqueueTime(Timestamp at_time) {
@@ -191,8 +196,8 @@ std::optional<Timestamp> RoundRobinPacketQueue::LeadingAudioPacketEnqueueTime()
     }
 
     // Queue mode
-    uint32_t ssrc = stream_priorities_.begin()->second;
-    const auto& top_packet = streams_.find(ssrc)->second.packet_queue.top();
+    const Stream* stream = GetHighestPriorityStream();
+    const auto& top_packet = stream->packet_fifos[stream->scheduled_priority].front();
     if (top_packet.type() == RtpPacketType::AUDIO) {
         return top_packet.enqueue_time;
     }
@@ -207,31 +212,54 @@ void RoundRobinPacketQueue::SetPauseState(bool paused, Timestamp at_time) {
     paused_ = paused;
 }
 
+std::unordered_map<uint32_t, size_t> RoundRobinPacketQueue::DropStaleFrames(Timestamp enqueued_before) {
+    std::unordered_map<uint32_t, size_t> dropped_frames;
+    // A single packet can't be a complete frame followed by another.
+    if (single_packet_queue_) {
+        return dropped_frames;
+    }
+    for (auto& [ssrc, stream] : streams_) {
+        if (stream.num_packets == 0) {
+            continue;
+        }
+        size_t num_dropped_frames = 0;
+        for (auto& packet_fifo : stream.packet_fifos) {
+            num_dropped_frames += DropStaleFrames(&stream, packet_fifo.others, enqueued_before);
+        }
+        if (num_dropped_frames == 0) {
+            continue;
+        }
+        dropped_frames[ssrc] = num_dropped_frames;
+        // Update priority after dropping packets.
+        UnscheduleStream(&stream);
+        int priority = stream.top_priority();
+        if (priority >= 0) {
+            ScheduleStream(&stream, priority);
+        }
+    }
+    return dropped_frames;
+}
+
 // Private methods
-void RoundRobinPacketQueue::Push(QueuedPacket packet) {
+void RoundRobinPacketQueue::Push(QueuedPacket packet, bool promoted) {
     auto stream_it = streams_.find(packet.ssrc());
     if (stream_it == streams_.end()) {
-        stream_it = streams_.emplace(packet.ssrc(), Stream()).first;
-        stream_it->second.priority_it = stream_priorities_.end();
-        stream_it->second.ssrc = packet.ssrc();
+        stream_it = streams_.try_emplace(packet.ssrc(), packet.ssrc()).first;
     }
 
     Stream& stream = stream_it->second;
 
-    if (stream.priority_it == stream_priorities_.end()) {
-        // If the SSRC is not scheduled, add it to |stream_priorities_|.
-        stream.priority_it = stream_priorities_.emplace(StreamPrioKey(packet.priority, stream.sent_size), packet.ssrc());
-    } else {
-        // If the priority of this SSRC increased, remove the outdated StreamPrioKey
-        // and insert a new one with the new priority. Note that |priority_| uses
-        // lower ordinal for higher priority.
-        stream_priorities_.erase(stream.priority_it);
-        stream.priority_it = stream_priorities_.emplace(StreamPrioKey(packet.priority, stream.sent_size), packet.ssrc());
+    if (stream.scheduled_priority < 0) {
+        // If the SSRC is not scheduled, schedule it with the priority of the packet.
+        ScheduleStream(&stream, packet.priority);
+    } else if (packet.priority < stream.scheduled_priority) {
+        // If the priority of this SSRC increased, reschedule it with the new priority.
+        // Note that |priority| uses lower ordinal for higher priority.
+        UnscheduleStream(&stream);
+        ScheduleStream(&stream, packet.priority);
     }
 
-    if (packet.enqueue_time_it == enqueue_times_.end()) {
-        packet.enqueue_time_it = enqueue_times_.insert(packet.enqueue_time);
-    } else {
+    if (!promoted) {
         // In order to figure out how much time a packet has spent in the queue
         // while not in a paused state, we subtract the total amount of time the
         // queue has been paused so far, and when the packet is popped we subtract
@@ -245,11 +273,15 @@ void RoundRobinPacketQueue::Push(QueuedPacket packet) {
         total_queued_size_ += PacketSize(packet);
     }
 
-    stream.packet_queue.push(std::move(packet));
+    packet.enqueue_time_index = enqueue_times_offset_ + enqueue_times_.size();
+    enqueue_times_.push_back({packet.enqueue_time, false});
+
+    stream.num_packets += 1;
+    stream.packet_fifos[packet.priority].push_back(std::move(packet));
 }
 
 size_t RoundRobinPacketQueue::PacketSize(const QueuedPacket& packet) const {
-    size_t packet_size = packet.owned_packet.payload_size() + packet.owned_packet.padding_size();
+    size_t packet_size = packet.owned_packet.expected_payload_size() + packet.owned_packet.padding_size();
     if (include_overhead_) {
         packet_size += packet.owned_packet.header_size() + transport_overhead_;
     }
@@ -258,33 +290,91 @@ size_t RoundRobinPacketQueue::PacketSize(const QueuedPacket& packet) const {
 
 void RoundRobinPacketQueue::MaybePromoteSinglePacketToNormalQueue() {
     if (single_packet_queue_) {
-        Push(std::move(single_packet_queue_.value()));
+        Push(std::move(single_packet_queue_.value()), true /* promoted */);
         single_packet_queue_.reset();
     }
 }
 
-RoundRobinPacketQueue::Stream* RoundRobinPacketQueue::GetHighestPriorityStream() {
-    if (stream_priorities_.empty()) {
-        return nullptr;
+RoundRobinPacketQueue::Stream* RoundRobinPacketQueue::GetHighestPriorityStream() const {
+    for (const auto& stream_heap : stream_heaps_) {
+        if (!stream_heap.empty()) {
+            return stream_heap.top();
+        }
     }
-    uint32_t ssrc = stream_priorities_.begin()->second;
+    return nullptr;
+}
+
+void RoundRobinPacketQueue::ScheduleStream(Stream* stream, int priority) {
+    assert(stream->scheduled_priority < 0);
+    stream->scheduled_priority = priority;
+    stream->schedule_order = next_schedule_order_++;
+    stream_heaps_[priority].Insert(stream);
+}
+
+void RoundRobinPacketQueue::UnscheduleStream(Stream* stream) {
+    assert(stream->scheduled_priority >= 0);
+    stream_heaps_[stream->scheduled_priority].Remove(stream);
+    stream->scheduled_priority = -1;
+}
 
-    auto stream_it = streams_.find(ssrc);
-    if (stream_it != streams_.end() &&
-        stream_it->second.priority_it == stream_priorities_.begin() &&
-        !stream_it->second.packet_queue.empty()) {
-        return &stream_it->second;
+size_t RoundRobinPacketQueue::DropStaleFrames(Stream* stream,
+                                              RingBuffer<QueuedPacket>& packets,
+                                              Timestamp enqueued_before) {
+    size_t num_dropped_frames = 0;
+    // The number of the packets left to drop in the current frame.
+    size_t num_packets_to_drop = 0;
+    // Rotate the packets through the ring buffer and push back the ones to
+    // keep, so the order is kept without allocation.
+    size_t num_remaining_packets = packets.size();
+    while (num_remaining_packets > 0) {
+        const QueuedPacket& front_packet = packets.front();
+        if (num_packets_to_drop == 0 && 
+            front_packet.is_first_packet_of_video_frame() &&
+            front_packet.enqueue_time <= enqueued_before) {
+            // Look ahead for the first packet of the next frame, which
+            // indicates the current frame is complete.
+            bool is_key_frame = front_packet.owned_packet.is_key_frame();
+            size_t frame_size = 1;
+            while (frame_size < num_remaining_packets && 
+                   !packets[frame_size].is_first_packet_of_video_frame()) {
+                is_key_frame |= packets[frame_size].owned_packet.is_key_frame();
+                ++frame_size;
+            }
+            if (frame_size < num_remaining_packets && !is_key_frame) {
+                num_packets_to_drop = frame_size;
+                ++num_dropped_frames;
+            }
+        }
+
+        QueuedPacket packet = std::move(packets.front());
+        packets.pop_front();
+        --num_remaining_packets;
+
+        if (num_packets_to_drop > 0) {
+            --num_packets_to_drop;
+            if (packet.type() == RtpPacketType::VIDEO) {
+                // Same as Pop() but without being accounted as sent.
+                queue_time_sum_ -= time_last_update_ - packet.enqueue_time - pause_time_sum_;
+                RemoveEnqueueTime(packet.enqueue_time_index);
+                total_queued_size_ -= PacketSize(packet);
+                num_packets_ -= 1;
+                stream->num_packets -= 1;
+                continue;
+            }
+        }
+        packets.push_back(std::move(packet));
     }
-    return nullptr;
+    return num_dropped_frames;
 }
 
-bool RoundRobinPacketQueue::IsEmptyStream(const Stream& stream) const {
-    if (stream.packet_queue.empty()) {
-        assert(stream.priority_it == stream_priorities_.end());
-        return true;
+void RoundRobinPacketQueue::RemoveEnqueueTime(uint64_t enqueue_time_index) {
+    assert(enqueue_time_index >= enqueue_times_offset_);
+    enqueue_times_[enqueue_time_index - enqueue_times_offset_].removed = true;
+    // Drop the removed entries from the front.
+    while (!enqueue_times_.empty() && enqueue_times_.front().removed) {
+        enqueue_times_.pop_front();
+        ++enqueue_times_offset_;
     }
-    assert(stream.priority_it != stream_priorities_.end());
-    return false;
 }
-    
+
 } // namespace naivertc
@@ -5,16 +5,24 @@
 #include "rtc/base/units/timestamp.hpp"
 #include "rtc/rtp_rtcp/rtp/packets/rtp_packet_to_send.hpp"
 #include "rtc/rtp_rtcp/base/rtp_rtcp_defines.hpp"
+#include "common/ring_buffer.hpp"
 
-#include <set>
-#include <map>
-#include <queue>
+#include <array>
+#include <vector>
 #include <optional>
 #include <unordered_map>
 
 namespace naivertc {
 
+// NOTE: The packets are stored in per-stream FIFO ring buffers grouped by
+// priority level, and the streams of each priority level are scheduled by an
+// indexed binary heap, so no allocation happens on Push/Pop once the buffers
+// have grown to the working size.
 class RoundRobinPacketQueue {
+public:
+    // The priorities are expected in [0, kNumPriorityLevels), and lower
+    // number takes priority over higher.
+    static constexpr int kNumPriorityLevels = 4;
 public:
     RoundRobinPacketQueue(Timestamp start_time);
     ~RoundRobinPacketQueue();
@@ -46,18 +54,33 @@ public:
 
     void SetPauseState(bool paused, Timestamp at_time);
 
+    // Drops the complete non-key video frames whose first packet was enqueued
+    // at or before |enqueued_before|, and returns the number of frames dropped
+    // per SSRC. The frame partially sent and the last frame of each stream,
+    // which may be still enqueueing, are never dropped.
+    std::unordered_map<uint32_t, size_t> DropStaleFrames(Timestamp enqueued_before);
+
 private:
     struct QueuedPacket;
     struct Stream;
 
-    void Push(QueuedPacket packet);
+    void Push(QueuedPacket packet, bool promoted);
 
     size_t PacketSize(const QueuedPacket& packet) const;
 
     void MaybePromoteSinglePacketToNormalQueue();
 
-    Stream* GetHighestPriorityStream();
-    bool IsEmptyStream(const Stream& stream) const;
+    Stream* GetHighestPriorityStream() const;
+
+    void ScheduleStream(Stream* stream, int priority);
+    void UnscheduleStream(Stream* stream);
+
+    void RemoveEnqueueTime(uint64_t enqueue_time_index);
+
+    // Returns the number of frames dropped from |packets|.
+    size_t DropStaleFrames(Stream* stream,
+                           RingBuffer<QueuedPacket>& packets,
+                           Timestamp enqueued_before);
 
 private:
     // QueuedPacket
@@ -66,60 +89,94 @@ private:
         int priority;
         Timestamp enqueue_time;
         uint64_t enqueue_order;
-        std::multiset<Timestamp>::iterator enqueue_time_it;
+        // The absolute index in |enqueue_times_|.
+        uint64_t enqueue_time_index;
         RtpPacketToSend owned_packet;
 
         QueuedPacket(int priority,
                      Timestamp enqueue_time,
                      uint64_t enqueue_order,
-                     std::multiset<Timestamp>::iterator enqueue_time_it,
                      RtpPacketToSend packet);
-        QueuedPacket(const QueuedPacket& rhs);
+        QueuedPacket(QueuedPacket&& rhs);
+        QueuedPacket& operator=(QueuedPacket&& rhs);
         ~QueuedPacket();
 
         RtpPacketType type() const { return owned_packet.packet_type(); }
         uint32_t ssrc() const { return owned_packet.ssrc(); }
         bool is_retransmission() const { return type() == RtpPacketType::RETRANSMISSION; }
-      
-        void SubtractPauseTime(TimeDelta pause_time_sum);
-        // std::priority_queue的特点是让优先级高的排在队列前面，优先出队。
-        // Return true if the other has higher priority.
-        bool operator<(const QueuedPacket& other) const;
-
-    };
+        bool is_first_packet_of_video_frame() const { 
+            return type() == RtpPacketType::VIDEO && owned_packet.is_first_packet_of_frame(); 
+        }
 
-    // PriorityPacketQueue
-    class PriorityPacketQueue : public std::priority_queue<QueuedPacket> {
-    public:
-        using const_iterator = container_type::const_iterator;
-        const_iterator begin() const;
-        const_iterator end() const;
+        void SubtractPauseTime(TimeDelta pause_time_sum);
     };
 
-    // StreamPrioKey 
-    struct StreamPrioKey {
-        const int priority;
-        const size_t sent_size;
-
-        StreamPrioKey(int priority, size_t sent_size);
-        bool operator<(const StreamPrioKey& other) const;
+    // PacketFifo
+    // The packets with the same priority in a stream, the retransmissions
+    // are sent before new media, and the others are sent in enqueue order.
+    struct PacketFifo {
+        RingBuffer<QueuedPacket> retransmissions;
+        RingBuffer<QueuedPacket> others;
+
+        bool empty() const { return retransmissions.empty() && others.empty(); }
+        size_t size() const { return retransmissions.size() + others.size(); }
+        QueuedPacket& front() { return retransmissions.empty() ? others.front() : retransmissions.front(); }
+        const QueuedPacket& front() const { return retransmissions.empty() ? others.front() : retransmissions.front(); }
+        void pop_front();
+        void push_back(QueuedPacket packet);
+
+        template<typename Visitor>
+        void ForEach(Visitor&& visitor) const {
+            for (size_t i = 0; i < retransmissions.size(); ++i) visitor(retransmissions[i]);
+            for (size_t i = 0; i < others.size(); ++i) visitor(others[i]);
+        }
     };
 
     // Stream
     struct Stream {
-        Stream();
-        Stream(const Stream&);
+        Stream(uint32_t ssrc);
         ~Stream();
 
+        // Returns the priority of the packet to send next,
+        // or -1 if the stream is empty.
+        int top_priority() const;
+
         uint32_t ssrc;
         size_t sent_size;
-        PriorityPacketQueue packet_queue;
-        // Whenever a packet is inserted for this stream we check if |priority_it|
-        // points to an element in |stream_priorities_|, and if it does it means
-        // this stream has already been scheduled, and if the scheduled priority is
-        // lower than the priority of the incoming packet we reschedule this stream
-        // with the higher priority.
-        std::multimap<StreamPrioKey, uint32_t>::iterator priority_it;
+        size_t num_packets;
+        std::array<PacketFifo, kNumPriorityLevels> packet_fifos;
+        // The priority level the stream is scheduled in, or -1 if not scheduled.
+        int scheduled_priority;
+        // The index of the stream in the heap of the scheduled priority level.
+        size_t heap_index;
+        // Used to break the ties of |sent_size|, the stream scheduled earlier
+        // will be sent first.
+        uint64_t schedule_order;
+    };
+
+    // StreamHeap
+    // A min-heap of streams ordered by (sent_size, schedule_order), the general
+    // idea is that the stream that has sent the least amount of bytes should
+    // have the highest priority.
+    class StreamHeap {
+    public:
+        bool empty() const { return streams_.empty(); }
+        Stream* top() const { return streams_.front(); }
+        void Insert(Stream* stream);
+        void Remove(Stream* stream);
+    private:
+        static bool Less(const Stream* lhs, const Stream* rhs);
+        void SiftUp(size_t index);
+        void SiftDown(size_t index);
+        void Swap(size_t lhs, size_t rhs);
+    private:
+        std::vector<Stream*> streams_;
+    };
+
+    // EnqueueTimeEntry
+    struct EnqueueTimeEntry {
+        Timestamp enqueue_time;
+        bool removed;
     };
 
 private:
@@ -135,22 +192,24 @@ private:
     bool include_overhead_ = false;
     size_t transport_overhead_ = 0;
 
-    // A map of streams used to prioritize from which stream to send next. We use
-    // a multimap instead of a priority_queue since the priority of a stream can
-    // change as a new packet is inserted, and a multimap allows us to remove and
-    // then reinsert a StreamPrioKey if the priority has increased.
-    std::multimap<StreamPrioKey, uint32_t> stream_priorities_;
+    uint64_t next_schedule_order_ = 0;
+    // The scheduled streams of each priority level.
+    std::array<StreamHeap, kNumPriorityLevels> stream_heaps_;
 
-    // A map of SSRCs to Streams.
+    // A map of SSRCs to Streams, the streams are never removed once created,
+    // and the node-based map keeps the pointers to streams stable.
     std::unordered_map<uint32_t, Stream> streams_;
 
-    // The enqueue time of every packet currently in the queue. Used to figure out
-    // the age of the oldest packet in the queue.
-    std::multiset<Timestamp> enqueue_times_;
+    // The enqueue time of every packet pushed in enqueue order, and the popped
+    // packets are marked as removed and dropped lazily from the front. As the
+    // enqueue time is non-decreasing, the front one is always the oldest.
+    RingBuffer<EnqueueTimeEntry> enqueue_times_;
+    // The absolute index of the front entry in |enqueue_times_|.
+    uint64_t enqueue_times_offset_ = 0;
 
     std::optional<QueuedPacket> single_packet_queue_;
 };
 
 } // namespace naivertc
 
-#endif
\ No newline at end of file
+#endif
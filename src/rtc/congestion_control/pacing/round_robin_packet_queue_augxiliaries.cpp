@@ -6,60 +6,126 @@ namespace naivertc {
 RoundRobinPacketQueue::QueuedPacket::QueuedPacket(int priority,
                                                   Timestamp enqueue_time,
                                                   uint64_t enqueue_order,
-                                                  std::multiset<Timestamp>::iterator enqueue_time_it,
                                                   RtpPacketToSend packet)
     : priority(priority),
       enqueue_time(enqueue_time),
       enqueue_order(enqueue_order),
-      enqueue_time_it(enqueue_time_it),
+      enqueue_time_index(0),
       owned_packet(std::move(packet)) {}
 
-RoundRobinPacketQueue::QueuedPacket::QueuedPacket(const QueuedPacket& rhs) = default;
+RoundRobinPacketQueue::QueuedPacket::QueuedPacket(QueuedPacket&& rhs) = default;
+RoundRobinPacketQueue::QueuedPacket& RoundRobinPacketQueue::QueuedPacket::operator=(QueuedPacket&& rhs) = default;
 RoundRobinPacketQueue::QueuedPacket::~QueuedPacket() = default;
 
 void RoundRobinPacketQueue::QueuedPacket::SubtractPauseTime(TimeDelta pause_time_sum) {
     enqueue_time -= pause_time_sum;
 }
 
-bool RoundRobinPacketQueue::QueuedPacket::operator<(const RoundRobinPacketQueue::QueuedPacket& other) const {
-    // Lower number takes priority over higher.
-    if (priority != other.priority)
-        return other.priority < priority;
+// PacketFifo
+void RoundRobinPacketQueue::PacketFifo::pop_front() {
+    if (!retransmissions.empty()) {
+        retransmissions.pop_front();
+    } else {
+        others.pop_front();
+    }
+}
+
+void RoundRobinPacketQueue::PacketFifo::push_back(QueuedPacket packet) {
     // Send retransimission before new media.
-    if (is_retransmission() != other.is_retransmission())
-        return other.is_retransmission();
+    if (packet.is_retransmission()) {
+        retransmissions.push_back(std::move(packet));
+    } else {
+        others.push_back(std::move(packet));
+    }
+}
+
+// Stream
+RoundRobinPacketQueue::Stream::Stream(uint32_t ssrc)
+    : ssrc(ssrc),
+      sent_size(0),
+      num_packets(0),
+      scheduled_priority(-1),
+      heap_index(0),
+      schedule_order(0) {}
+
+RoundRobinPacketQueue::Stream::~Stream() = default;
+
+int RoundRobinPacketQueue::Stream::top_priority() const {
+    if (num_packets == 0) {
+        return -1;
+    }
+    for (int priority = 0; priority < kNumPriorityLevels; ++priority) {
+        if (!packet_fifos[priority].empty()) {
+            return priority;
+        }
+    }
+    return -1;
+}
 
-    // Send the early packe first.
-    return other.enqueue_order < enqueue_order;
+// StreamHeap
+void RoundRobinPacketQueue::StreamHeap::Insert(Stream* stream) {
+    stream->heap_index = streams_.size();
+    streams_.push_back(stream);
+    SiftUp(stream->heap_index);
 }
 
-// RoundRobinPacketQueue
-RoundRobinPacketQueue::PriorityPacketQueue::const_iterator
-RoundRobinPacketQueue::PriorityPacketQueue::begin() const {
-    return c.begin();
+void RoundRobinPacketQueue::StreamHeap::Remove(Stream* stream) {
+    const size_t index = stream->heap_index;
+    assert(index < streams_.size() && streams_[index] == stream);
+    const size_t last = streams_.size() - 1;
+    if (index != last) {
+        Swap(index, last);
+        streams_.pop_back();
+        SiftUp(index);
+        SiftDown(index);
+    } else {
+        streams_.pop_back();
+    }
 }
 
-RoundRobinPacketQueue::PriorityPacketQueue::const_iterator
-RoundRobinPacketQueue::PriorityPacketQueue::end() const {
-    return c.end();
+bool RoundRobinPacketQueue::StreamHeap::Less(const Stream* lhs, const Stream* rhs) {
+    // Smaller size takes priority over larger.
+    if (lhs->sent_size != rhs->sent_size) {
+        return lhs->sent_size < rhs->sent_size;
+    }
+    return lhs->schedule_order < rhs->schedule_order;
 }
 
-// StreamPrioKey
-RoundRobinPacketQueue::StreamPrioKey::StreamPrioKey(int priority, size_t sent_size) 
-    : priority(priority), sent_size(sent_size) {}
+void RoundRobinPacketQueue::StreamHeap::SiftUp(size_t index) {
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (!Less(streams_[index], streams_[parent])) {
+            break;
+        }
+        Swap(index, parent);
+        index = parent;
+    }
+}
 
-bool RoundRobinPacketQueue::StreamPrioKey::operator<(const StreamPrioKey& other) const {
-    // Lower number takes priority over higher.
-    if (priority != other.priority) {
-        return priority < other.priority;
+void RoundRobinPacketQueue::StreamHeap::SiftDown(size_t index) {
+    const size_t size = streams_.size();
+    while (true) {
+        size_t smallest = index;
+        size_t left = 2 * index + 1;
+        size_t right = left + 1;
+        if (left < size && Less(streams_[left], streams_[smallest])) {
+            smallest = left;
+        }
+        if (right < size && Less(streams_[right], streams_[smallest])) {
+            smallest = right;
+        }
+        if (smallest == index) {
+            break;
+        }
+        Swap(index, smallest);
+        index = smallest;
     }
-    // Smaller size takes priority over larger.
-    return sent_size < other.sent_size;
 }
-        
-// Stream
-RoundRobinPacketQueue::Stream::Stream() : ssrc(0), sent_size(0) {}
-RoundRobinPacketQueue::Stream::Stream(const Stream& stream) = default;
-RoundRobinPacketQueue::Stream::~Stream() = default;
-    
+
+void RoundRobinPacketQueue::StreamHeap::Swap(size_t lhs, size_t rhs) {
+    std::swap(streams_[lhs], streams_[rhs]);
+    streams_[lhs]->heap_index = lhs;
+    streams_[rhs]->heap_index = rhs;
+}
+
 } // namespace naivertc
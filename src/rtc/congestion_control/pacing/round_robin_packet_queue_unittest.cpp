@@ -0,0 +1,196 @@
+#include "rtc/congestion_control/pacing/round_robin_packet_queue.hpp"
+#include "common/utils_time.hpp"
+
+#include <gtest/gtest.h>
+
+#define ENABLE_UNIT_TESTS 0
+#include "testing/defines.hpp"
+
+namespace naivertc {
+namespace test {
+namespace {
+
+constexpr Timestamp kStartTime = Timestamp::Millis(1000);
+constexpr size_t kPayloadSize = 1000;
+
+RtpPacketToSend CreatePacket(uint32_t ssrc, RtpPacketType type, uint16_t seq_num = 0) {
+    RtpPacketToSend packet(nullptr);
+    packet.set_ssrc(ssrc);
+    packet.set_sequence_number(seq_num);
+    packet.set_packet_type(type);
+    packet.set_payload_size(kPayloadSize);
+    return packet;
+}
+
+// Pushes a video frame of |num_packets| packets.
+void PushFrame(RoundRobinPacketQueue& queue,
+               uint32_t ssrc,
+               Timestamp enqueue_time,
+               bool is_key_frame,
+               size_t num_packets,
+               uint16_t& seq_num,
+               uint64_t& enqueue_order) {
+    for (size_t i = 0; i < num_packets; ++i) {
+        auto packet = CreatePacket(ssrc, RtpPacketType::VIDEO, seq_num++);
+        packet.set_is_first_packet_of_frame(i == 0);
+        packet.set_is_key_frame(is_key_frame);
+        packet.set_capture_time_ms(enqueue_time.ms());
+        queue.Push(3, enqueue_time, enqueue_order++, std::move(packet));
+    }
+}
+
+} // namespace
+
+MY_TEST(RoundRobinPacketQueueTest, PopByPriority) {
+    RoundRobinPacketQueue queue(kStartTime);
+    uint64_t enqueue_order = 0;
+    queue.Push(3, kStartTime, enqueue_order++, CreatePacket(1, RtpPacketType::VIDEO));
+    queue.Push(2, kStartTime, enqueue_order++, CreatePacket(2, RtpPacketType::RETRANSMISSION));
+    queue.Push(1, kStartTime, enqueue_order++, CreatePacket(3, RtpPacketType::AUDIO));
+    EXPECT_EQ(queue.num_packets(), 3u);
+    EXPECT_EQ(queue.queued_size(), 3 * kPayloadSize);
+    EXPECT_EQ(queue.LeadingAudioPacketEnqueueTime(), kStartTime);
+
+    EXPECT_EQ(queue.Pop()->ssrc(), 3u);
+    EXPECT_EQ(queue.Pop()->ssrc(), 2u);
+    EXPECT_EQ(queue.Pop()->ssrc(), 1u);
+    EXPECT_TRUE(queue.Empty());
+    EXPECT_FALSE(queue.Pop().has_value());
+}
+
+MY_TEST(RoundRobinPacketQueueTest, PopInEnqueueOrderWithinStream) {
+    RoundRobinPacketQueue queue(kStartTime);
+    uint64_t enqueue_order = 0;
+    for (uint16_t seq_num = 0; seq_num < 10; ++seq_num) {
+        queue.Push(3, kStartTime, enqueue_order++, CreatePacket(1, RtpPacketType::VIDEO, seq_num));
+    }
+    // Retransmission is sent before new media with the same priority.
+    queue.Push(3, kStartTime, enqueue_order++, CreatePacket(1, RtpPacketType::RETRANSMISSION, 100));
+    EXPECT_EQ(queue.Pop()->sequence_number(), 100u);
+    for (uint16_t seq_num = 0; seq_num < 10; ++seq_num) {
+        EXPECT_EQ(queue.Pop()->sequence_number(), seq_num);
+    }
+    EXPECT_TRUE(queue.Empty());
+}
+
+MY_TEST(RoundRobinPacketQueueTest, RoundRobinAcrossStreams) {
+    RoundRobinPacketQueue queue(kStartTime);
+    uint64_t enqueue_order = 0;
+    // Stream 1 enqueues all the packets before stream 2.
+    for (int i = 0; i < 5; ++i) {
+        queue.Push(3, kStartTime, enqueue_order++, CreatePacket(1, RtpPacketType::VIDEO));
+    }
+    for (int i = 0; i < 5; ++i) {
+        queue.Push(3, kStartTime, enqueue_order++, CreatePacket(2, RtpPacketType::VIDEO));
+    }
+    // The stream sent less is sent first, so the streams are interleaved.
+    uint32_t last_ssrc = 0;
+    for (int i = 0; i < 10; ++i) {
+        auto packet = queue.Pop();
+        ASSERT_TRUE(packet.has_value());
+        EXPECT_NE(packet->ssrc(), last_ssrc);
+        last_ssrc = packet->ssrc();
+    }
+    EXPECT_TRUE(queue.Empty());
+}
+
+MY_TEST(RoundRobinPacketQueueTest, OldestEnqueueTime) {
+    RoundRobinPacketQueue queue(kStartTime);
+    EXPECT_EQ(queue.OldestEnqueueTime(), Timestamp::MinusInfinity());
+    // Audio enqueued later will be popped before the older video.
+    queue.Push(3, kStartTime, 0, CreatePacket(1, RtpPacketType::VIDEO));
+    queue.Push(1, kStartTime + TimeDelta::Millis(10), 1, CreatePacket(2, RtpPacketType::AUDIO));
+    queue.Push(3, kStartTime + TimeDelta::Millis(20), 2, CreatePacket(1, RtpPacketType::VIDEO));
+    EXPECT_EQ(queue.OldestEnqueueTime(), kStartTime);
+
+    EXPECT_EQ(queue.Pop()->ssrc(), 2u);
+    EXPECT_EQ(queue.OldestEnqueueTime(), kStartTime);
+    EXPECT_EQ(queue.Pop()->ssrc(), 1u);
+    EXPECT_EQ(queue.OldestEnqueueTime(), kStartTime + TimeDelta::Millis(20));
+    EXPECT_EQ(queue.Pop()->ssrc(), 1u);
+    EXPECT_EQ(queue.OldestEnqueueTime(), Timestamp::MinusInfinity());
+}
+
+MY_TEST(RoundRobinPacketQueueTest, DropStaleFrames) {
+    RoundRobinPacketQueue queue(kStartTime);
+    uint64_t enqueue_order = 0;
+    uint16_t seq_num = 0;
+    PushFrame(queue, 1, kStartTime, /*is_key_frame=*/false, 3, seq_num, enqueue_order);
+    PushFrame(queue, 1, kStartTime, /*is_key_frame=*/true, 2, seq_num, enqueue_order);
+    PushFrame(queue, 1, kStartTime + TimeDelta::Millis(10), /*is_key_frame=*/false, 2, seq_num, enqueue_order);
+    PushFrame(queue, 1, kStartTime + TimeDelta::Millis(20), /*is_key_frame=*/false, 2, seq_num, enqueue_order);
+    // The only frame of stream 2 may be still enqueueing.
+    uint16_t seq_num_2 = 100;
+    PushFrame(queue, 2, kStartTime, /*is_key_frame=*/false, 2, seq_num_2, enqueue_order);
+    EXPECT_EQ(queue.num_packets(), 11u);
+
+    // The delta frames enqueued at 0ms and 10ms are dropped, but the key frame
+    // and the last frame are kept.
+    auto dropped_frames = queue.DropStaleFrames(kStartTime + TimeDelta::Millis(10));
+    ASSERT_EQ(dropped_frames.size(), 1u);
+    EXPECT_EQ(dropped_frames[1], 2u);
+    EXPECT_EQ(queue.num_packets(), 6u);
+    EXPECT_EQ(queue.queued_size(), 6 * kPayloadSize);
+    EXPECT_EQ(queue.OldestEnqueueTime(), kStartTime);
+
+    std::vector<uint16_t> seq_nums;
+    while (auto packet = queue.Pop()) {
+        if (packet->ssrc() == 1) {
+            seq_nums.push_back(packet->sequence_number());
+        }
+    }
+    EXPECT_EQ(seq_nums, std::vector<uint16_t>({3, 4, 7, 8}));
+}
+
+MY_TEST(RoundRobinPacketQueueTest, NotDropPartiallySentFrame) {
+    RoundRobinPacketQueue queue(kStartTime);
+    uint64_t enqueue_order = 0;
+    uint16_t seq_num = 0;
+    PushFrame(queue, 1, kStartTime, /*is_key_frame=*/false, 3, seq_num, enqueue_order);
+    PushFrame(queue, 1, kStartTime, /*is_key_frame=*/false, 2, seq_num, enqueue_order);
+    PushFrame(queue, 1, kStartTime, /*is_key_frame=*/false, 2, seq_num, enqueue_order);
+    // Send the first packet of the first frame.
+    EXPECT_EQ(queue.Pop()->sequence_number(), 0u);
+
+    auto dropped_frames = queue.DropStaleFrames(kStartTime);
+    EXPECT_EQ(dropped_frames[1], 1u);
+    EXPECT_EQ(queue.Pop()->sequence_number(), 1u);
+    EXPECT_EQ(queue.Pop()->sequence_number(), 2u);
+    EXPECT_EQ(queue.Pop()->sequence_number(), 5u);
+    EXPECT_EQ(queue.Pop()->sequence_number(), 6u);
+    EXPECT_TRUE(queue.Empty());
+}
+
+MY_TEST(RoundRobinPacketQueueTest, PushAndPopAtScale) {
+    const size_t kNumStreams = 100;
+    const size_t kNumPackets = 10000;
+    const int kNumRounds = 10;
+    RoundRobinPacketQueue queue(kStartTime);
+    uint64_t enqueue_order = 0;
+    int64_t start_us = utils::time::TimeInMicros();
+    for (int round = 0; round < kNumRounds; ++round) {
+        for (size_t i = 0; i < kNumPackets; ++i) {
+            uint32_t ssrc = static_cast<uint32_t>(i % kNumStreams);
+            queue.Push(3, kStartTime, enqueue_order++, CreatePacket(ssrc, RtpPacketType::VIDEO));
+        }
+        EXPECT_EQ(queue.num_packets(), kNumPackets);
+        std::vector<size_t> num_popped(kNumStreams, 0);
+        for (size_t i = 0; i < kNumPackets; ++i) {
+            auto packet = queue.Pop();
+            ASSERT_TRUE(packet.has_value());
+            ++num_popped[packet->ssrc()];
+            // The streams are served fairly.
+            if ((i + 1) % kNumStreams == 0) {
+                for (size_t n : num_popped) {
+                    EXPECT_EQ(n, (i + 1) / kNumStreams);
+                }
+            }
+        }
+        EXPECT_TRUE(queue.Empty());
+    }
+    int64_t elapsed_us = utils::time::TimeInMicros() - start_us;
+    RecordProperty("ns_per_push_pop", static_cast<int>(elapsed_us * 1000 / (kNumRounds * kNumPackets)));
+}
+
+} // namespace test
+} // namespace naivertc
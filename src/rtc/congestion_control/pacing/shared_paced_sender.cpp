@@ -0,0 +1,347 @@
+#include "rtc/congestion_control/pacing/shared_paced_sender.hpp"
+#include "rtc/base/time/clock.hpp"
+#include "rtc/base/time/clock_real_time.hpp"
+#include "rtc/base/task_utils/task_queue.hpp"
+
+#include <plog/Log.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace naivertc {
+
+// SharedPacedSender
+SharedPacedSender* SharedPacedSender::SharedInstance() {
+    // Never destroyed, like the other process-wide instances.
+    static RealTimeClock* const clock = new RealTimeClock();
+    static TaskQueue* const task_queue = new TaskQueue("SharedPacedSender.task.queue");
+    static SharedPacedSender* const instance = [](){
+        Configuration config;
+        config.clock = clock;
+        return new SharedPacedSender(config, task_queue->Get());
+    }();
+    return instance;
+}
+
+SharedPacedSender::SharedPacedSender(const Configuration& config,
+                                     TaskQueueImpl* task_queue)
+    : clock_(config.clock),
+      max_hold_back_window_(config.max_hold_back_window),
+      max_total_pacing_bitrate_(config.max_total_pacing_bitrate),
+      task_queue_(task_queue) {
+    assert(clock_ != nullptr);
+    assert(task_queue != nullptr);
+}
+
+SharedPacedSender::~SharedPacedSender() {
+    // Post an immediate task to mark the queue as shutting down.
+    // The task queue desctructor will wait for pending tasks to
+    // complete before continuing.
+    task_queue_->Post([this](){
+        assert(clients_.empty() && "The clients must be unregistered before.");
+        is_shutdown_ = true;
+    });
+}
+
+std::unique_ptr<SharedPacedSender::Client> SharedPacedSender::RegisterClient(const PacingController::Configuration& config) {
+    const int client_id = next_client_id_++;
+    PacingController::Configuration client_config = config;
+    client_config.clock = clock_;
+    // Draining the queue would raise the pacing bitrate above the allocated one.
+    client_config.pacing_settings.drain_large_queue = false;
+    task_queue_->Post([this, client_id, client_config](){
+        clients_.emplace(client_id, std::make_unique<ClientState>(client_config));
+        AllocatePacingBitrates();
+        UpdateStats();
+    });
+    return std::unique_ptr<Client>(new Client(client_id, this));
+}
+
+void SharedPacedSender::SetMaxTotalPacingBitrate(DataRate max_total_pacing_bitrate) {
+    task_queue_->Post([this, max_total_pacing_bitrate](){
+        max_total_pacing_bitrate_ = max_total_pacing_bitrate;
+        AllocatePacingBitrates();
+        RescheduleProcess();
+    });
+}
+
+SharedPacedSender::Stats SharedPacedSender::GetStats() {
+    return task_queue_->Invoke<Stats>([&](){
+        return current_stats_;
+    });
+}
+
+// Private methods
+void SharedPacedSender::PostToClient(int client_id, std::function<void(ClientState&)> handler) {
+    task_queue_->Post([this, client_id, handler=std::move(handler)](){
+        auto it = clients_.find(client_id);
+        if (it == clients_.end()) {
+            return;
+        }
+        handler(*it->second);
+        RescheduleProcess();
+    });
+}
+
+void SharedPacedSender::AllocatePacingBitrates() {
+    RTC_RUN_ON(task_queue_);
+    if (clients_.empty()) {
+        return;
+    }
+    // Max-min fair allocation: the clients requesting less than the fair share
+    // get what they requested, and the rest is shared equally by the others.
+    std::vector<ClientState*> clients;
+    clients.reserve(clients_.size());
+    for (auto& [client_id, client] : clients_) {
+        clients.push_back(client.get());
+    }
+    std::sort(clients.begin(), clients.end(), [](const ClientState* lhs, const ClientState* rhs){
+        return lhs->target_pacing_bitrate < rhs->target_pacing_bitrate;
+    });
+
+    DataRate remaining_bitrate = max_total_pacing_bitrate_;
+    size_t num_remaining_clients = clients.size();
+    for (ClientState* client : clients) {
+        DataRate pacing_bitrate = client->target_pacing_bitrate;
+        if (!remaining_bitrate.IsPlusInfinity()) {
+            pacing_bitrate = std::min(pacing_bitrate, remaining_bitrate / num_remaining_clients);
+            remaining_bitrate -= pacing_bitrate;
+        }
+        --num_remaining_clients;
+        // The padding is not allowed to exceed the allocated bitrate.
+        DataRate padding_bitrate = std::min(client->target_padding_bitrate, pacing_bitrate);
+        client->pacing_controller.SetPacingBitrates(pacing_bitrate, padding_bitrate);
+    }
+}
+
+DataRate SharedPacedSender::ProbingHeadroom(int client_id) const {
+    RTC_RUN_ON(task_queue_);
+    if (max_total_pacing_bitrate_.IsPlusInfinity()) {
+        return DataRate::Infinity();
+    }
+    DataRate others_pacing_bitrate = DataRate::Zero();
+    for (const auto& [id, client] : clients_) {
+        if (id != client_id) {
+            others_pacing_bitrate += client->pacing_controller.pacing_bitrate();
+        }
+    }
+    if (others_pacing_bitrate >= max_total_pacing_bitrate_) {
+        return DataRate::Zero();
+    }
+    return max_total_pacing_bitrate_ - others_pacing_bitrate;
+}
+
+void SharedPacedSender::MaybeProcessPackets(Timestamp scheduled_process_time) {
+    RTC_RUN_ON(task_queue_);
+
+    if (is_shutdown_) {
+        return;
+    }
+
+    const auto now = clock_->CurrentTime();
+    if (next_scheduled_process_time_ == scheduled_process_time) {
+        // Indicates no pending scheduled call.
+        next_scheduled_process_time_ = Timestamp::MinusInfinity();
+    }
+
+    // Serve the clients in round-robin order, so no call is always the
+    // first one to take the egress capacity.
+    auto first_it = clients_.upper_bound(last_served_client_id_);
+    bool any_served = false;
+    for (size_t i = 0; i < clients_.size(); ++i, ++first_it) {
+        if (first_it == clients_.end()) {
+            first_it = clients_.begin();
+        }
+        auto& [client_id, client] = *first_it;
+        if (!client->is_started) {
+            continue;
+        }
+        // NOTE: The probing clients may be processed a bit earlier, as the
+        // delay to the next process is rounded down when probing.
+        TimeDelta early_execute_margin = client->pacing_controller.IsProbing() ? PacingController::kMaxEarlyProbeProcessing 
+                                                                               : TimeDelta::Zero();
+        if (now >= client->pacing_controller.NextSendTime() - early_execute_margin) {
+            client->pacing_controller.ProcessPackets();
+            if (!any_served) {
+                last_served_client_id_ = client_id;
+                any_served = true;
+            }
+        }
+    }
+
+    Timestamp next_process_time = Timestamp::PlusInfinity();
+    bool is_probing = false;
+    for (const auto& [client_id, client] : clients_) {
+        if (!client->is_started) {
+            continue;
+        }
+        next_process_time = std::min(next_process_time, client->pacing_controller.NextSendTime());
+        is_probing |= client->pacing_controller.IsProbing();
+    }
+
+    // No client to process.
+    if (next_process_time.IsPlusInfinity()) {
+        UpdateStats();
+        return;
+    }
+
+    std::optional<TimeDelta> delay_to_next_process;
+    // NOTE: Probing will override holdback window if any client is in probing.
+    if (is_probing && next_process_time != next_scheduled_process_time_) {
+        if (next_process_time.IsMinusInfinity()) {
+            delay_to_next_process = TimeDelta::Zero();
+        } else {
+            delay_to_next_process = std::max(TimeDelta::Zero(), (next_process_time - now).RoundDownTo(TimeDelta::Millis(1)));
+        }
+    } else if (next_scheduled_process_time_.IsMinusInfinity() ||
+               next_process_time <= next_scheduled_process_time_ - max_hold_back_window_) {
+        // Schdule a new task since there is none currently scheduled, or the new
+        // process is at least one holdback window earlier than the scheduled one.
+        delay_to_next_process = std::max(next_process_time - now, max_hold_back_window_);
+    }
+
+    if (delay_to_next_process) {
+        next_scheduled_process_time_ = next_process_time;
+        task_queue_->PostDelayed(*delay_to_next_process, [this, next_process_time](){
+            ++num_process_wakeups_;
+            MaybeProcessPackets(next_process_time);
+        });
+    }
+
+    UpdateStats();
+}
+
+void SharedPacedSender::RescheduleProcess() {
+    RTC_RUN_ON(task_queue_);
+    MaybeProcessPackets(Timestamp::MinusInfinity());
+}
+
+void SharedPacedSender::UpdateStats() {
+    RTC_RUN_ON(task_queue_);
+    Stats new_stats;
+    new_stats.num_clients = clients_.size();
+    for (const auto& [client_id, client] : clients_) {
+        new_stats.total_pacing_bitrate += client->pacing_controller.pacing_bitrate();
+    }
+    new_stats.num_process_wakeups = num_process_wakeups_;
+    current_stats_ = new_stats;
+}
+
+// ClientState
+SharedPacedSender::ClientState::ClientState(const PacingController::Configuration& config)
+    : pacing_controller(config) {}
+
+SharedPacedSender::ClientState::~ClientState() = default;
+
+// Client
+SharedPacedSender::Client::Client(int id, SharedPacedSender* shared_pacer)
+    : id_(id),
+      shared_pacer_(shared_pacer) {}
+
+SharedPacedSender::Client::~Client() {
+    // Unregister synchronously, since the packet sender of the call may be
+    // destroyed right after.
+    shared_pacer_->task_queue_->Invoke<void>([this](){
+        shared_pacer_->clients_.erase(id_);
+        shared_pacer_->AllocatePacingBitrates();
+        shared_pacer_->UpdateStats();
+    });
+}
+
+void SharedPacedSender::Client::Pause() {
+    shared_pacer_->PostToClient(id_, [](ClientState& client){
+        client.pacing_controller.Pause();
+    });
+}
+
+void SharedPacedSender::Client::Resume() {
+    shared_pacer_->PostToClient(id_, [](ClientState& client){
+        client.pacing_controller.Resume();
+    });
+}
+
+void SharedPacedSender::Client::EnsureStarted() {
+    shared_pacer_->PostToClient(id_, [](ClientState& client){
+        client.is_started = true;
+    });
+}
+
+void SharedPacedSender::Client::SetAccountForAudioPackets(bool account_for_audio) {
+    shared_pacer_->PostToClient(id_, [account_for_audio](ClientState& client){
+        client.pacing_controller.set_account_for_audio(account_for_audio);
+    });
+}
+
+void SharedPacedSender::Client::SetIncludeOverhead() {
+    shared_pacer_->PostToClient(id_, [](ClientState& client){
+        client.pacing_controller.set_include_overhead();
+    });
+}
+
+void SharedPacedSender::Client::SetTransportOverhead(size_t overhead_per_packet) {
+    shared_pacer_->PostToClient(id_, [overhead_per_packet](ClientState& client){
+        client.pacing_controller.set_transport_overhead(overhead_per_packet);
+    });
+}
+
+void SharedPacedSender::Client::SetQueueTimeCap(TimeDelta cap) {
+    shared_pacer_->PostToClient(id_, [cap](ClientState& client){
+        client.pacing_controller.set_queue_time_cap(cap);
+    });
+}
+
+void SharedPacedSender::Client::SetProbingEnabled(bool enabled) {
+    shared_pacer_->PostToClient(id_, [enabled](ClientState& client){
+        client.pacing_controller.SetProbingEnabled(enabled);
+    });
+}
+
+void SharedPacedSender::Client::SetPacingBitrates(DataRate pacing_bitrate,
+                                                  DataRate padding_bitrate) {
+    SharedPacedSender* shared_pacer = shared_pacer_;
+    shared_pacer_->PostToClient(id_, [=](ClientState& client){
+        client.target_pacing_bitrate = pacing_bitrate;
+        client.target_padding_bitrate = padding_bitrate;
+        shared_pacer->AllocatePacingBitrates();
+    });
+}
+
+void SharedPacedSender::Client::SetCongestionWindow(size_t congestion_window_size) {
+    shared_pacer_->PostToClient(id_, [congestion_window_size](ClientState& client){
+        client.pacing_controller.SetCongestionWindow(congestion_window_size);
+    });
+}
+
+void SharedPacedSender::Client::OnInflightBytes(size_t inflight_bytes) {
+    shared_pacer_->PostToClient(id_, [inflight_bytes](ClientState& client){
+        client.pacing_controller.OnInflightBytes(inflight_bytes);
+    });
+}
+
+void SharedPacedSender::Client::AddProbeCluster(int cluster_id, DataRate target_bitrate) {
+    SharedPacedSender* shared_pacer = shared_pacer_;
+    const int client_id = id_;
+    shared_pacer_->PostToClient(id_, [=](ClientState& client){
+        // The probe cluster bypasses the allocated bitrate, so it's clamped to
+        // the bitrate left by the other clients under the cap.
+        DataRate probe_bitrate = std::min(target_bitrate, shared_pacer->ProbingHeadroom(client_id));
+        if (probe_bitrate < target_bitrate) {
+            PLOG_VERBOSE << "Clamped probe cluster " << cluster_id 
+                         << " from " << target_bitrate.bps() << " bps to "
+                         << probe_bitrate.bps() << " bps.";
+        }
+        client.pacing_controller.AddProbeCluster(cluster_id, probe_bitrate);
+    });
+}
+
+void SharedPacedSender::Client::EnqueuePackets(std::vector<RtpPacketToSend> packets) {
+    // std::function requires a copyable callable.
+    auto shared_packets = std::make_shared<std::vector<RtpPacketToSend>>(std::move(packets));
+    shared_pacer_->PostToClient(id_, [shared_packets](ClientState& client){
+        for (auto& packet : *shared_packets) {
+            client.pacing_controller.EnqueuePacket(std::move(packet));
+        }
+    });
+}
+
+} // namespace naivertc
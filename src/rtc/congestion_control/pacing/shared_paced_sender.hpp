@@ -0,0 +1,145 @@
+#ifndef _RTC_CONGESTION_CONTROL_PACING_SHARED_PACED_SENDER_H_
+#define _RTC_CONGESTION_CONTROL_PACING_SHARED_PACED_SENDER_H_
+
+#include "base/defines.hpp"
+#include "rtc/congestion_control/pacing/paced_sender_interface.hpp"
+#include "rtc/congestion_control/pacing/pacing_controller.hpp"
+#include "rtc/base/task_utils/task_queue_impl.hpp"
+
+#include <atomic>
+#include <map>
+#include <memory>
+
+namespace naivertc {
+
+class Clock;
+
+// A process-wide pacing engine shared by the calls, each call registers as a
+// client with its own pacing controller, and all the clients are processed on
+// a single task queue in round-robin order. The pacing bitrate of each client
+// is set by its network controller, and the total pacing bitrate is capped
+// by a host-wide egress limit using max-min fair allocation.
+// NOTE: Draining large queues, which bypasses the pacing bitrate, is disabled
+// for the clients, and the probe clusters are clamped to the bitrate left by
+// the other clients, so the total never exceeds the cap.
+class SharedPacedSender {
+public:
+    struct Configuration {
+        Clock* clock = nullptr;
+        // The cap of the total pacing bitrate of all clients, e.g. the capacity
+        // of NIC, infinity means no cap.
+        DataRate max_total_pacing_bitrate = DataRate::Infinity();
+        TimeDelta max_hold_back_window = PacingController::kMaxEarlyProbeProcessing;
+    };
+
+    // Stats
+    struct Stats {
+        size_t num_clients = 0;
+        // The sum of the pacing bitrates allocated to the clients.
+        DataRate total_pacing_bitrate = DataRate::Zero();
+        // The number of the delayed process tasks executed.
+        size_t num_process_wakeups = 0;
+    };
+
+    // Client
+    // The pacer of a call registered with the shared pacer, which must
+    // be destroyed before the shared pacer.
+    class Client : public PacedSenderInterface {
+    public:
+        ~Client() override;
+
+        int id() const { return id_; }
+
+        // Implements PacedSenderInterface
+        void Pause() override;
+        void Resume() override;
+
+        void EnsureStarted() override;
+        void SetAccountForAudioPackets(bool account_for_audio) override;
+        void SetIncludeOverhead() override;
+        void SetTransportOverhead(size_t overhead_per_packet) override;
+        void SetQueueTimeCap(TimeDelta cap) override;
+
+        void SetProbingEnabled(bool enabled) override;
+        void SetPacingBitrates(DataRate pacing_bitrate,
+                               DataRate padding_bitrate) override;
+        void SetCongestionWindow(size_t congestion_window_size) override;
+        void OnInflightBytes(size_t inflight_bytes) override;
+
+        void AddProbeCluster(int cluster_id, DataRate target_bitrate) override;
+
+        // Implements RtpPacketSender
+        void EnqueuePackets(std::vector<RtpPacketToSend> packets) override;
+
+    private:
+        friend class SharedPacedSender;
+        Client(int id, SharedPacedSender* shared_pacer);
+    private:
+        const int id_;
+        SharedPacedSender* const shared_pacer_;
+    };
+
+public:
+    // The process-wide instance running on its own task queue, which is
+    // not capped until SetMaxTotalPacingBitrate is called.
+    static SharedPacedSender* SharedInstance();
+
+    SharedPacedSender(const Configuration& config,
+                      TaskQueueImpl* task_queue);
+    ~SharedPacedSender();
+
+    // Registers a call with the given pacing settings and packet sender.
+    std::unique_ptr<Client> RegisterClient(const PacingController::Configuration& config);
+
+    void SetMaxTotalPacingBitrate(DataRate max_total_pacing_bitrate);
+
+    Stats GetStats();
+
+private:
+    // ClientState
+    struct ClientState {
+        ClientState(const PacingController::Configuration& config);
+        ~ClientState();
+
+        PacingController pacing_controller;
+        bool is_started = false;
+        // The bitrates requested by the network controller of the call.
+        DataRate target_pacing_bitrate = DataRate::Zero();
+        DataRate target_padding_bitrate = DataRate::Zero();
+    };
+
+    // Runs |handler| with the state of client |client_id| on the task queue.
+    void PostToClient(int client_id, std::function<void(ClientState&)> handler);
+
+    void AllocatePacingBitrates();
+    // The bitrate left by the other clients under the cap.
+    DataRate ProbingHeadroom(int client_id) const;
+
+    void MaybeProcessPackets(Timestamp scheduled_process_time);
+    void RescheduleProcess();
+    void UpdateStats();
+
+private:
+    Clock* const clock_;
+    const TimeDelta max_hold_back_window_;
+    DataRate max_total_pacing_bitrate_;
+
+    std::atomic<int> next_client_id_{0};
+    // The clients ordered by id, which are served in round-robin order
+    // starting after |last_served_client_id_|.
+    std::map<int, std::unique_ptr<ClientState>> clients_;
+    int last_served_client_id_ = -1;
+
+    // Timestamp::MinusInfinity() indicates no valid pending task.
+    Timestamp next_scheduled_process_time_ = Timestamp::MinusInfinity();
+    bool is_shutdown_ = false;
+    size_t num_process_wakeups_ = 0;
+
+    Stats current_stats_;
+
+    TaskQueueImpl* const task_queue_;
+};
+
+} // namespace naivertc
+
+#endif
@@ -0,0 +1,217 @@
+#include "rtc/congestion_control/pacing/shared_paced_sender.hpp"
+#include "testing/simulated_time_controller.hpp"
+
+#include <gtest/gtest.h>
+
+#include <map>
+
+#define ENABLE_UNIT_TESTS 0
+#include "testing/defines.hpp"
+
+namespace naivertc {
+namespace test {
+namespace {
+
+constexpr size_t kPacketSize = 1000;
+constexpr DataRate kCallBitrate = DataRate::KilobitsPerSec(800);
+
+class FakePacketSender : public PacingController::PacketSender {
+public:
+    void SendPacket(RtpPacketToSend packet,
+                    const PacedPacketInfo& pacing_info) override {
+        sent_size_ += packet.payload_size() + packet.padding_size();
+        if (pacing_info.probe_cluster) {
+            probe_bitrates_.insert_or_assign(pacing_info.probe_cluster->id, pacing_info.probe_cluster->target_bitrate);
+        }
+    }
+    std::vector<RtpPacketToSend> FetchFecPackets() override { return {}; }
+    std::vector<RtpPacketToSend> GeneratePadding(size_t padding_size) override { return {}; }
+
+    size_t sent_size() const { return sent_size_; }
+    const std::map<int, DataRate>& probe_bitrates() const { return probe_bitrates_; }
+private:
+    size_t sent_size_ = 0;
+    std::map<int, DataRate> probe_bitrates_;
+};
+
+std::vector<RtpPacketToSend> GeneratePackets(uint32_t ssrc, size_t num_packets) {
+    std::vector<RtpPacketToSend> packets;
+    for (size_t i = 0; i < num_packets; ++i) {
+        RtpPacketToSend packet(nullptr);
+        packet.set_packet_type(RtpPacketType::VIDEO);
+        packet.set_ssrc(ssrc);
+        packet.set_payload_size(kPacketSize);
+        packets.push_back(std::move(packet));
+    }
+    return packets;
+}
+
+} // namespace
+
+class T(SharedPacedSenderTest) : public ::testing::Test {
+public:
+    T(SharedPacedSenderTest)()
+        : time_controller_(Timestamp::Millis(1000)),
+          task_queue_(time_controller_.CreateTaskQueue()) {}
+
+    void ResetSharedPacer(DataRate max_total_pacing_bitrate) {
+        SharedPacedSender::Configuration config;
+        config.clock = time_controller_.Clock();
+        config.max_total_pacing_bitrate = max_total_pacing_bitrate;
+        shared_pacer_ = std::make_unique<SharedPacedSender>(config, task_queue_.get());
+    }
+
+    std::unique_ptr<SharedPacedSender::Client> RegisterCall(FakePacketSender* packet_sender,
+                                                            DataRate pacing_bitrate) {
+        PacingController::Configuration config;
+        config.packet_sender = packet_sender;
+        auto client = shared_pacer_->RegisterClient(config);
+        client->SetPacingBitrates(pacing_bitrate, DataRate::Zero());
+        client->EnsureStarted();
+        return client;
+    }
+
+protected:
+    SimulatedTimeController time_controller_;
+    std::unique_ptr<SimulatedTaskQueue, SimulatedTaskQueue::Deleter> task_queue_;
+    std::unique_ptr<SharedPacedSender> shared_pacer_;
+};
+
+MY_TEST_F(SharedPacedSenderTest, PacesEachCallAtItsOwnBitrate) {
+    ResetSharedPacer(DataRate::Infinity());
+    FakePacketSender packet_sender_1;
+    FakePacketSender packet_sender_2;
+    auto call_1 = RegisterCall(&packet_sender_1, kCallBitrate);
+    auto call_2 = RegisterCall(&packet_sender_2, kCallBitrate / 2);
+
+    // Enqueue 2 seconds worth of packets for each call.
+    const size_t kNumPackets = kCallBitrate * TimeDelta::Seconds(2) / kPacketSize;
+    call_1->EnqueuePackets(GeneratePackets(1, kNumPackets));
+    call_2->EnqueuePackets(GeneratePackets(2, kNumPackets));
+    time_controller_.AdvanceTime(TimeDelta::Seconds(1));
+
+    EXPECT_NEAR(packet_sender_1.sent_size(), kCallBitrate * TimeDelta::Seconds(1), 2 * kPacketSize);
+    EXPECT_NEAR(packet_sender_2.sent_size(), kCallBitrate / 2 * TimeDelta::Seconds(1), 2 * kPacketSize);
+
+    auto stats = shared_pacer_->GetStats();
+    EXPECT_EQ(stats.num_clients, 2u);
+    EXPECT_EQ(stats.total_pacing_bitrate, kCallBitrate * 1.5);
+}
+
+MY_TEST_F(SharedPacedSenderTest, SharesCapFairly) {
+    const DataRate kMaxTotalPacingBitrate = kCallBitrate;
+    ResetSharedPacer(kMaxTotalPacingBitrate);
+    FakePacketSender packet_sender_1;
+    FakePacketSender packet_sender_2;
+    FakePacketSender packet_sender_3;
+    // The first call requests less than the fair share, and the rest
+    // is shared equally by the others.
+    auto call_1 = RegisterCall(&packet_sender_1, kCallBitrate / 4);
+    auto call_2 = RegisterCall(&packet_sender_2, kCallBitrate);
+    auto call_3 = RegisterCall(&packet_sender_3, kCallBitrate);
+
+    const size_t kNumPackets = kCallBitrate * TimeDelta::Seconds(2) / kPacketSize;
+    call_1->EnqueuePackets(GeneratePackets(1, kNumPackets));
+    call_2->EnqueuePackets(GeneratePackets(2, kNumPackets));
+    call_3->EnqueuePackets(GeneratePackets(3, kNumPackets));
+    time_controller_.AdvanceTime(TimeDelta::Seconds(1));
+
+    const size_t kExpectedSentSize1 = kCallBitrate / 4 * TimeDelta::Seconds(1);
+    const size_t kExpectedSentSize2 = (kMaxTotalPacingBitrate - kCallBitrate / 4) / 2 * TimeDelta::Seconds(1);
+    EXPECT_NEAR(packet_sender_1.sent_size(), kExpectedSentSize1, 2 * kPacketSize);
+    EXPECT_NEAR(packet_sender_2.sent_size(), kExpectedSentSize2, 2 * kPacketSize);
+    EXPECT_NEAR(packet_sender_3.sent_size(), kExpectedSentSize2, 2 * kPacketSize);
+    EXPECT_EQ(shared_pacer_->GetStats().total_pacing_bitrate, kMaxTotalPacingBitrate);
+}
+
+MY_TEST_F(SharedPacedSenderTest, ReallocateAfterCallUnregistered) {
+    ResetSharedPacer(kCallBitrate);
+    FakePacketSender packet_sender_1;
+    FakePacketSender packet_sender_2;
+    auto call_1 = RegisterCall(&packet_sender_1, kCallBitrate);
+    auto call_2 = RegisterCall(&packet_sender_2, kCallBitrate);
+    time_controller_.AdvanceTime(TimeDelta::Zero());
+    EXPECT_EQ(shared_pacer_->GetStats().num_clients, 2u);
+
+    call_2.reset();
+    auto stats = shared_pacer_->GetStats();
+    EXPECT_EQ(stats.num_clients, 1u);
+    EXPECT_EQ(stats.total_pacing_bitrate, kCallBitrate);
+
+    const size_t kNumPackets = kCallBitrate * TimeDelta::Seconds(2) / kPacketSize;
+    call_1->EnqueuePackets(GeneratePackets(1, kNumPackets));
+    time_controller_.AdvanceTime(TimeDelta::Seconds(1));
+    EXPECT_NEAR(packet_sender_1.sent_size(), kCallBitrate * TimeDelta::Seconds(1), 2 * kPacketSize);
+    EXPECT_EQ(packet_sender_2.sent_size(), 0u);
+}
+
+MY_TEST_F(SharedPacedSenderTest, NeverExceedsCapWhenDrainingOrProbing) {
+    const DataRate kMaxTotalPacingBitrate = kCallBitrate;
+    const TimeDelta kWindow = TimeDelta::Millis(100);
+    ResetSharedPacer(kMaxTotalPacingBitrate);
+    FakePacketSender packet_senders[3];
+    std::vector<std::unique_ptr<SharedPacedSender::Client>> calls;
+    for (size_t i = 0; i < 3; ++i) {
+        // With the default pacing settings, which drain large queues.
+        calls.push_back(RegisterCall(&packet_senders[i], kCallBitrate));
+    }
+    for (size_t i = 0; i < 3; ++i) {
+        // The probe clusters are clamped to the bitrate left by the others.
+        calls[i]->SetProbingEnabled(true);
+        calls[i]->AddProbeCluster(i, kCallBitrate * 4);
+        // The queue is far longer than the queue time cap.
+        const size_t kNumPackets = kCallBitrate * TimeDelta::Seconds(10) / kPacketSize;
+        calls[i]->EnqueuePackets(GeneratePackets(i + 1, kNumPackets));
+    }
+
+    size_t last_total_sent_size = 0;
+    for (int i = 0; i < 20; ++i) {
+        time_controller_.AdvanceTime(kWindow);
+        size_t total_sent_size = 0;
+        for (const auto& packet_sender : packet_senders) {
+            total_sent_size += packet_sender.sent_size();
+        }
+        // Allows one packet in flight per call at the boundary of the window.
+        EXPECT_LE(total_sent_size - last_total_sent_size, kMaxTotalPacingBitrate * kWindow + 3 * kPacketSize);
+        last_total_sent_size = total_sent_size;
+    }
+    EXPECT_NEAR(last_total_sent_size, kMaxTotalPacingBitrate * TimeDelta::Seconds(2), 3 * kPacketSize);
+}
+
+MY_TEST_F(SharedPacedSenderTest, ClampProbeClustersToHeadroom) {
+    const DataRate kMaxTotalPacingBitrate = kCallBitrate * 2;
+    ResetSharedPacer(kMaxTotalPacingBitrate);
+    FakePacketSender packet_sender_1;
+    FakePacketSender packet_sender_2;
+    auto call_1 = RegisterCall(&packet_sender_1, kCallBitrate);
+    auto call_2 = RegisterCall(&packet_sender_2, kCallBitrate / 2);
+
+    // The first cluster is within the headroom, and the second one
+    // is clamped to the bitrate left by the second call.
+    call_1->AddProbeCluster(1, kCallBitrate);
+    call_1->AddProbeCluster(2, kCallBitrate * 4);
+    const size_t kNumPackets = kCallBitrate * TimeDelta::Seconds(2) / kPacketSize;
+    call_1->EnqueuePackets(GeneratePackets(1, kNumPackets));
+    call_2->EnqueuePackets(GeneratePackets(2, kNumPackets));
+    time_controller_.AdvanceTime(TimeDelta::Seconds(1));
+
+    const auto& probe_bitrates = packet_sender_1.probe_bitrates();
+    ASSERT_EQ(probe_bitrates.size(), 2u);
+    EXPECT_EQ(probe_bitrates.at(1), kCallBitrate);
+    EXPECT_EQ(probe_bitrates.at(2), kMaxTotalPacingBitrate - kCallBitrate / 2);
+    EXPECT_TRUE(packet_sender_2.probe_bitrates().empty());
+}
+
+MY_TEST_F(SharedPacedSenderTest, NoProbingIfDisabled) {
+    ResetSharedPacer(kCallBitrate * 2);
+    FakePacketSender packet_sender;
+    auto call = RegisterCall(&packet_sender, kCallBitrate);
+    call->SetProbingEnabled(false);
+    call->AddProbeCluster(1, kCallBitrate * 2);
+    call->EnqueuePackets(GeneratePackets(1, 100));
+    time_controller_.AdvanceTime(TimeDelta::Seconds(1));
+    EXPECT_TRUE(packet_sender.probe_bitrates().empty());
+}
+
+} // namespace test
+} // namespace naivertc
@@ -119,7 +119,7 @@ void TaskQueuePacedSender::EnqueuePackets(std::vector<RtpPacketToSend> packets)
     task_queue_->Post([this, packets=std::move(packets)]() mutable {
         for (auto& packet : packets) {
             smoothed_packet_size_ = kDefaultSmoothingCoeff * smoothed_packet_size_ + 
-                                    (1 - kDefaultSmoothingCoeff) * packet.size();
+                                    (1 - kDefaultSmoothingCoeff) * packet.expected_size();
             pacing_controller_.EnqueuePacket(std::move(packet));
         }
         RescheduleProcess();
@@ -171,6 +171,10 @@ void TaskQueuePacedSender::MaybeProcessPackets(Timestamp scheduled_process_time)
         hold_back_window = std::min(hold_back_window, avg_packet_send_time * max_hold_window_in_packets_);
     }
 
+    // In burst mode, the packets can be sent ahead of schedule by up to 
+    // the burst interval, so there is no need to wake up more frequently.
+    hold_back_window = std::max(hold_back_window, pacing_controller_.send_burst_interval());
+
     std::optional<TimeDelta> delay_to_next_process;
     // NOTE: Probing will override holdback window if we're in probing.
     if (pacing_controller_.IsProbing() && 
@@ -196,6 +200,7 @@ void TaskQueuePacedSender::MaybeProcessPackets(Timestamp scheduled_process_time)
 
         // Schedule the next process.
         task_queue_->PostDelayed(*delay_to_next_process, [this, next_process_time](){
+            ++num_process_wakeups_;
             MaybeProcessPackets(next_process_time);
         });
     }
@@ -215,6 +220,7 @@ void TaskQueuePacedSender::UpdateStats() {
     new_stats.first_sent_packet_time = pacing_controller_.first_sent_packet_time();
     new_stats.oldest_packet_enqueue_time = pacing_controller_.OldestPacketEnqueueTime();
     new_stats.queue_size = pacing_controller_.QueuedPacketSize();
+    new_stats.num_process_wakeups = num_process_wakeups_;
     current_stats_ = new_stats;
 }
     
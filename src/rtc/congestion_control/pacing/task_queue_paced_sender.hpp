@@ -1,7 +1,7 @@
 #ifndef _RTC_CONGESTION_CONTROL_PACING_TASK_QUEUE_PACED_SENDER_H_
 #define _RTC_CONGESTION_CONTROL_PACING_TASK_QUEUE_PACED_SENDER_H_
 
-#include "rtc/rtp_rtcp/base/rtp_rtcp_interfaces.hpp"
+#include "rtc/congestion_control/pacing/paced_sender_interface.hpp"
 #include "rtc/congestion_control/pacing/pacing_controller.hpp"
 #include "rtc/base/numerics/exp_filter.hpp"
 #include "rtc/base/task_utils/task_queue_impl.hpp"
@@ -12,7 +12,7 @@ namespace naivertc {
 
 class Clock;
 
-class TaskQueuePacedSender : public RtpPacketSender {
+class TaskQueuePacedSender : public PacedSenderInterface {
 public:
     using Configuration = PacingController::Configuration;
 
@@ -22,6 +22,8 @@ public:
         size_t queue_size = 0;
         TimeDelta expected_queue_time = TimeDelta::Zero();
         std::optional<Timestamp> first_sent_packet_time;
+        // The number of the delayed process tasks executed.
+        size_t num_process_wakeups = 0;
     };
 
 public:
@@ -31,22 +33,23 @@ public:
                          int max_hold_window_in_packets = -1);
     ~TaskQueuePacedSender() override;
 
-    void Pause();
-    void Resume();
+    // Implements PacedSenderInterface
+    void Pause() override;
+    void Resume() override;
 
-    void EnsureStarted();
-    void SetAccountForAudioPackets(bool account_for_audio);
-    void SetIncludeOverhead();
-    void SetTransportOverhead(size_t overhead_per_packet);
-    void SetQueueTimeCap(TimeDelta cap);
+    void EnsureStarted() override;
+    void SetAccountForAudioPackets(bool account_for_audio) override;
+    void SetIncludeOverhead() override;
+    void SetTransportOverhead(size_t overhead_per_packet) override;
+    void SetQueueTimeCap(TimeDelta cap) override;
 
-    void SetProbingEnabled(bool enabled);
+    void SetProbingEnabled(bool enabled) override;
     void SetPacingBitrates(DataRate pacing_bitrate, 
-                           DataRate padding_bitrate);
-    void SetCongestionWindow(size_t congestion_window_size);
-    void OnInflightBytes(size_t inflight_bytes);
+                           DataRate padding_bitrate) override;
+    void SetCongestionWindow(size_t congestion_window_size) override;
+    void OnInflightBytes(size_t inflight_bytes) override;
 
-    void AddProbeCluster(int cluster_id, DataRate target_bitrate);
+    void AddProbeCluster(int cluster_id, DataRate target_bitrate) override;
 
     // Implements RtpPacketSender
     void EnqueuePackets(std::vector<RtpPacketToSend> packets) override;
@@ -79,6 +82,8 @@ private:
     // never drain.
     bool is_shutdown_ = false;
 
+    size_t num_process_wakeups_ = 0;
+
     // Smoothed size of enqueued packtes, in bytes.
     double smoothed_packet_size_ = 0.0;
 
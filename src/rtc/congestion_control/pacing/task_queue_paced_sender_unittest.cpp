@@ -524,5 +524,74 @@ MY_TEST_F(TaskQueuePacedSenderTest, Stats) {
     EXPECT_TRUE(stats.expected_queue_time.IsZero());
 }
 
+MY_TEST_F(TaskQueuePacedSenderTest, BurstModeReducesWakeups) {
+    struct BurstResult {
+        size_t num_packets_sent = 0;
+        size_t num_process_wakeups = 0;
+        TimeDelta max_send_interval = TimeDelta::Zero();
+        TimeDelta elapsed_time = TimeDelta::Zero();
+    };
+    // Paces one second of video packets with a dedicated pacer.
+    auto run_pacer = [](DataRate pacing_bitrate, TimeDelta send_burst_interval) {
+        SimulatedTimeController time_controller(Timestamp::Millis(1000));
+        ::testing::NiceMock<MockPacketSender> packet_sender;
+        auto task_queue = time_controller.CreateTaskQueue();
+        TaskQueuePacedSender::Configuration config;
+        config.clock = time_controller.Clock();
+        config.packet_sender = &packet_sender;
+        config.pacing_settings.send_burst_interval = send_burst_interval;
+        auto pacer = std::make_unique<TaskQueuePacedSender>(config, task_queue.get());
+
+        BurstResult result;
+        const Timestamp start_time = time_controller.CurrentTime();
+        Timestamp last_send_time = start_time;
+        EXPECT_CALL(packet_sender, SendPacket).WillRepeatedly([&](RtpPacketType, uint32_t){
+            Timestamp now = time_controller.CurrentTime();
+            ++result.num_packets_sent;
+            result.max_send_interval = std::max(result.max_send_interval, now - last_send_time);
+            result.elapsed_time = now - start_time;
+            last_send_time = now;
+        });
+
+        const size_t num_packets = pacing_bitrate.bps() / (kDefaultPacketSize * 8);
+        pacer->SetPacingBitrates(pacing_bitrate, DataRate::Zero());
+        pacer->EnsureStarted();
+        std::vector<RtpPacketToSend> packets;
+        for (size_t i = 0; i < num_packets; ++i) {
+            RtpPacketToSend packet{nullptr};
+            packet.set_packet_type(RtpPacketType::VIDEO);
+            packet.set_ssrc(kVideoSsrc);
+            packet.set_payload_size(kDefaultPacketSize);
+            packets.push_back(std::move(packet));
+        }
+        pacer->EnqueuePackets(std::move(packets));
+        time_controller.AdvanceTime(TimeDelta::Millis(1100));
+        EXPECT_EQ(result.num_packets_sent, num_packets);
+        result.num_process_wakeups = pacer->GetStats().num_process_wakeups;
+        return result;
+    };
+
+    const TimeDelta kSendBurstInterval = TimeDelta::Millis(10);
+    for (int mbps : {2, 10, 50}) {
+        const DataRate pacing_bitrate = DataRate::KilobitsPerSec(mbps * 1000);
+        BurstResult no_burst = run_pacer(pacing_bitrate, TimeDelta::Zero());
+        BurstResult burst = run_pacer(pacing_bitrate, kSendBurstInterval);
+
+        // The packets are still paced at the same rate.
+        EXPECT_NEAR(burst.elapsed_time.ms(), no_burst.elapsed_time.ms(), kSendBurstInterval.ms());
+        EXPECT_LT(burst.num_process_wakeups, no_burst.num_process_wakeups);
+        // The spacing between bursts is bounded by the burst interval plus the
+        // send time of one packet, as the debt may exceed the burst interval by
+        // one packet.
+        const TimeDelta packet_send_time = kDefaultPacketSize / pacing_bitrate;
+        EXPECT_LE(burst.max_send_interval, kSendBurstInterval + packet_send_time + TimeDelta::Millis(1));
+
+        GTEST_COUT << mbps << " Mbps: wakeups/s " << no_burst.num_process_wakeups
+                   << " -> " << burst.num_process_wakeups
+                   << ", max send interval " << no_burst.max_send_interval.us()
+                   << " us -> " << burst.max_send_interval.us() << " us" << std::endl;
+    }
+}
+
 } // namespace test
 } // namespace naivertc
\ No newline at end of file
@@ -9,6 +9,14 @@ namespace naivertc {
 
 class Clock;
 
+// TargetTransferRateObserver
+class TargetTransferRateObserver {
+public:
+    virtual ~TargetTransferRateObserver() = default;
+    // Called with the target bitrate estimated by the network controller.
+    virtual void OnTargetTransferRate(TargetTransferRate target_rate) = 0;
+};
+
 class NetworkControllerInterface {
 public:
     struct Configuration {
@@ -60,6 +60,10 @@ RtpParameters ParseRtpParameters(const sdp::Media& media) {
             rtp_parameters.ulpfec.ulpfec_payload_type = rtp_map.payload_type;
             break;
         }
+        case sdp::Media::Codec::FLEX_FEC: {
+            rtp_parameters.flexfec.payload_type = rtp_map.payload_type;
+            break;
+        }
         default:
             // TODO: Support more codecs.
             break;
@@ -146,10 +150,18 @@ void MediaTrack::OnNegotiated(const sdp::Description& local_sdp,
                 auto rtp_params = ParseRtpParameters(*local_media);
                 // Local media SSRC.
                 rtp_params.local_media_ssrc = local_media->media_ssrcs()[0];
+                // FlexFEC protects the local media stream.
+                rtp_params.flexfec.protected_media_ssrc = rtp_params.local_media_ssrc;
                 // Don't care remote media SSRC.
                 rtp_params.remote_media_ssrc = std::nullopt;
                 rtp_params.extmap_allow_mixed = local_sdp.extmap_allow_mixed();
-                call_->AddVideoSendStream(rtp_params);
+                // The maximum bandwidth the remote peer is willing to receive.
+                if (remote_media->bandwidth_max_value() > 0) {
+                    rtp_params.max_bitrate = DataRate::KilobitsPerSec(remote_media->bandwidth_max_value());
+                }
+                call_->AddVideoSendStream(rtp_params, [this](DataRate media_bitrate){
+                    OnMediaBitrateUpdated(media_bitrate);
+                });
             } else {
                 PLOG_WARNING << "Failed to add video send stream as no media stream found.";
             }
@@ -169,6 +181,8 @@ void MediaTrack::OnNegotiated(const sdp::Description& local_sdp,
                 }
                 // Remote media SSRC.
                 rtp_params.remote_media_ssrc = remote_media->media_ssrcs()[0];
+                // FlexFEC protects the remote media stream.
+                rtp_params.flexfec.protected_media_ssrc = *rtp_params.remote_media_ssrc;
                 rtp_params.extmap_allow_mixed = local_sdp.extmap_allow_mixed();
                 call_->AddVideoRecvStream(rtp_params);
             }
@@ -179,6 +193,9 @@ void MediaTrack::OnNegotiated(const sdp::Description& local_sdp,
     }
 }
 
+// Protected methods
+void MediaTrack::OnMediaBitrateUpdated(DataRate media_bitrate) {}
+
 // Private methods
 void MediaTrack::TriggerOpen() {
     RTC_RUN_ON(signaling_queue_);
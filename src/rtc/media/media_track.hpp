@@ -6,6 +6,7 @@
 #include "rtc/rtp_rtcp/base/rtp_extensions.hpp"
 #include "rtc/media/media_channel.hpp"
 #include "rtc/base/task_utils/task_queue.hpp"
+#include "rtc/base/units/data_rate.hpp"
 
 #include <string>
 #include <vector>
@@ -119,6 +120,10 @@ public:
     void OnNegotiated(const sdp::Description& local_sdp, 
                       const sdp::Description& remote_sdp);
 
+protected:
+    // Called on the worker queue with the bitrate left for the media of the send stream.
+    virtual void OnMediaBitrateUpdated(DataRate media_bitrate);
+
 private:
     void Open() override;
     void Close() override;
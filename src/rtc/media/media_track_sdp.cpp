@@ -19,6 +19,10 @@ const std::string kDefaultH264FormatProfile =
 const std::string kDefaultOpusFormatProfile =
     "minptime=10;maxaveragebitrate=96000;stereo=1;sprop-stereo=1;useinbandfec=1";
 
+// The time window (in microseconds) of the media packets protected by FlexFEC.
+// See https://datatracker.ietf.org/doc/html/draft-ietf-payload-flexible-fec-scheme-03#section-5.1.1
+const std::string kDefaultFlexfecFormatProfile = "repair-window=10000000";
+
 /**
  * UDP/TLS/RTP/SAVPF：指明使用的传输协议，其中SAVPF是由S(secure)、AVP（RTP A(audio)/V(video) profile、F(feedback), 详解rfc1890）组成
  * 即传输层使用UDP协议，并采用DTLS(UDP + TLS)，在传输层之上使用RTP(RTCP)协议，具体的RTP格式是SAVPF
@@ -147,7 +151,11 @@ void MediaTrack::SdpBuilder::AddCodecs(const Configuration& config, sdp::Media&
     // FlexFec + Ssrc
     else if (config.fec_codec == FecCodec::FLEX_FEC) {
         // Codec: FLEX_FEC
-        media.AddCodec(NextPayloadType(kind), sdp::Media::Codec::FLEX_FEC, clock_rate);
+        media.AddCodec(NextPayloadType(kind), 
+                       sdp::Media::Codec::FLEX_FEC, 
+                       clock_rate, 
+                       std::nullopt, 
+                       kDefaultFlexfecFormatProfile);
     }
 
     // RTX Codec
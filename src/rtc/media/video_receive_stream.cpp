@@ -30,6 +30,10 @@ VideoReceiveStream::VideoReceiveStream(const Configuration& config)
                                                               &rtp_video_receiver_);
         rtp_demuxer_.AddRtpSink(*config.rtp.rtx_send_ssrc, rtx_recv_stream_.get());
     }
+    // FLEX_FEC stream
+    if (config.rtp.flexfec.payload_type >= 0 && config.rtp.flexfec.ssrc != 0) {
+        rtp_demuxer_.AddRtpSink(config.rtp.flexfec.ssrc, &rtp_video_receiver_);
+    }
 }
 
 VideoReceiveStream::~VideoReceiveStream() {
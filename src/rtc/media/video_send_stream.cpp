@@ -1,6 +1,12 @@
 #include "rtc/media/video_send_stream.hpp"
 
 namespace naivertc {
+namespace {
+
+// TODO: Use the frame rate measured from the encoded frames.
+constexpr double kDefaultFrameRate = 30.0;
+
+} // namespace
 
 VideoSendStream::VideoSendStream(const Configuration& config) 
     : rtp_video_sender_(std::make_unique<RtpVideoSender>(config)) {
@@ -36,5 +42,31 @@ void VideoSendStream::OnRtcpPacket(CopyOnWriteBuffer in_packet) {
     RTC_RUN_ON(&sequence_checker_);
     rtp_video_sender_->OnRtcpPacket(std::move(in_packet));
 }
+
+DataRate VideoSendStream::OnBitrateUpdated(const TargetTransferRate& target_rate) {
+    RTC_RUN_ON(&sequence_checker_);
+    return rtp_video_sender_->OnBitrateUpdated(target_rate, kDefaultFrameRate);
+}
+
+bool VideoSendStream::SendPacket(RtpPacketToSend packet, 
+                                 const PacedPacketInfo& pacing_info) {
+    RTC_RUN_ON(&sequence_checker_);
+    return rtp_video_sender_->TrySendPacket(std::move(packet), pacing_info);
+}
+
+std::vector<RtpPacketToSend> VideoSendStream::FetchFecPackets() const {
+    RTC_RUN_ON(&sequence_checker_);
+    return rtp_video_sender_->FetchFecPackets();
+}
+
+std::vector<RtpPacketToSend> VideoSendStream::GeneratePadding(size_t target_packet_size) {
+    RTC_RUN_ON(&sequence_checker_);
+    return rtp_video_sender_->GeneratePadding(target_packet_size);
+}
+
+void VideoSendStream::OnFramesDropped(size_t num_frames) {
+    RTC_RUN_ON(&sequence_checker_);
+    rtp_video_sender_->OnFramesDropped(num_frames);
+}
     
 } // namespace naivertc
\ No newline at end of file
@@ -29,6 +29,16 @@ public:
     // RtcpPacketSink interfaces
     void OnRtcpPacket(CopyOnWriteBuffer in_packet) override;
 
+    // Returns the bitrate left for the media after the protection overhead.
+    DataRate OnBitrateUpdated(const TargetTransferRate& target_rate);
+
+    // Called by the packet router of the call with the packets paced.
+    bool SendPacket(RtpPacketToSend packet, 
+                    const PacedPacketInfo& pacing_info);
+    std::vector<RtpPacketToSend> FetchFecPackets() const;
+    std::vector<RtpPacketToSend> GeneratePadding(size_t target_packet_size);
+    void OnFramesDropped(size_t num_frames);
+
 private:
     SequenceChecker sequence_checker_;
     std::unique_ptr<RtpVideoSender> rtp_video_sender_;
@@ -12,5 +12,19 @@ void VideoTrack::Send(video::EncodedFrame encoded_frame) {
         }
     });
 }
+
+void VideoTrack::OnTargetBitrate(TargetBitrateCallback callback) {
+    worker_queue_->Post([this, callback=std::move(callback)](){
+        target_bitrate_callback_ = std::move(callback);
+    });
+}
+
+// Private methods
+void VideoTrack::OnMediaBitrateUpdated(DataRate media_bitrate) {
+    RTC_RUN_ON(worker_queue_);
+    if (target_bitrate_callback_) {
+        target_bitrate_callback_(media_bitrate);
+    }
+}
     
 } // namespace naivertc
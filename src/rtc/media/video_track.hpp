@@ -14,8 +14,19 @@ public:
     ~VideoTrack() override;
 
     void Send(video::EncodedFrame encoded_frame);
+
+    // The bitrate the encoder should target, which is the target bitrate
+    // allocated to this track minus the protection overhead.
+    using TargetBitrateCallback = std::function<void(DataRate target_bitrate)>;
+    void OnTargetBitrate(TargetBitrateCallback callback);
+
+private:
+    void OnMediaBitrateUpdated(DataRate media_bitrate) override;
+
+private:
+    TargetBitrateCallback target_bitrate_callback_ RTC_GUARDED_BY(worker_queue_) = nullptr;
 };
     
 } // namespace naivertc
 
-#endif
\ No newline at end of file
+#endif
@@ -1,5 +1,6 @@
 #include "rtc/pc/peer_connection.hpp"
 #include "rtc/transports/dtls_srtp_transport.hpp"
+#include "rtc/congestion_control/pacing/shared_paced_sender.hpp"
 #include "common/logger.hpp"
 
 #include <plog/Log.h>
@@ -11,8 +12,7 @@ namespace naivertc {
 
 PeerConnection::PeerConnection(const RtcConfiguration& config) 
     : rtc_config_(config),
-      certificate_(Certificate::MakeCertificate(rtc_config_.certificate_type)),
-      call_(&clock_, this) {
+      certificate_(Certificate::MakeCertificate(rtc_config_.certificate_type)) {
 
     ValidateConfiguration(rtc_config_);
 
@@ -20,6 +20,19 @@ PeerConnection::PeerConnection(const RtcConfiguration& config)
     network_task_queue_ = std::make_unique<TaskQueue>("PeerConnection.network.task.queue");
     worker_task_queue_ = std::make_unique<TaskQueue>("PeerConnection.worker.task.queue");
 
+    Call::Configuration call_config;
+    call_config.clock = &clock_;
+    call_config.send_transport = this;
+    call_config.worker_queue = worker_task_queue_->Get();
+    if (rtc_config_.use_shared_pacer) {
+        call_config.shared_pacer = SharedPacedSender::SharedInstance();
+        if (rtc_config_.shared_pacer_max_bitrate_kbps > 0) {
+            call_config.shared_pacer->SetMaxTotalPacingBitrate(DataRate::KilobitsPerSec(rtc_config_.shared_pacer_max_bitrate_kbps));
+        }
+    }
+    call_config.max_packet_history_bytes = rtc_config_.max_packet_history_kbytes * 1024;
+    call_ = std::make_unique<Call>(call_config);
+
     signaling_task_queue_->Post([this](){
         InitIceTransport();
     });
@@ -27,6 +40,9 @@ PeerConnection::PeerConnection(const RtcConfiguration& config)
 
 PeerConnection::~PeerConnection() {
     Close();
+    worker_task_queue_->Invoke<void>([this](){
+        this->call_.reset();
+    });
     // Those task queues will be blocked until
     // all the tasks in the queue have been done. 
     signaling_task_queue_.reset();
@@ -36,7 +52,7 @@ PeerConnection::~PeerConnection() {
 
 void PeerConnection::Close() {
     worker_task_queue_->Invoke<void>([this](){
-        this->call_.Clear();
+        this->call_->Clear();
     });
     network_task_queue_->Invoke<void>([this](){
         this->CloseTransports();
@@ -92,6 +108,12 @@ void PeerConnection::OnRemoteMediaTrackReceived(MediaTrackCallback callback) {
     });
 }
 
+std::optional<TimeDelta> PeerConnection::dtls_setup_delay() const {
+    return signaling_task_queue_->Invoke<std::optional<TimeDelta>>([this](){
+        return this->dtls_setup_delay_;
+    });
+}
+
 // Private methods
 void PeerConnection::ValidateConfiguration(RtcConfiguration& config) {
     if (config.port_range_end > 0 && 
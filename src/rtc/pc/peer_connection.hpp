@@ -116,6 +116,10 @@ public:
     // Incoming data channel or media track created by remote peer
     void OnRemoteDataChannelReceived(DataChannelCallback callback);
     void OnRemoteMediaTrackReceived(MediaTrackCallback callback);
+
+    // The time elapsed from the remote description was set to
+    // the DTLS transport connected, or nullopt if not connected yet.
+    std::optional<TimeDelta> dtls_setup_delay() const;
     
 protected:
     PeerConnection(const RtcConfiguration& config);
@@ -216,6 +220,9 @@ private:
     std::optional<sdp::Description> local_sdp_ RTC_GUARDED_BY(signaling_task_queue_) = std::nullopt;
     std::optional<sdp::Description> remote_sdp_ RTC_GUARDED_BY(signaling_task_queue_) = std::nullopt;
 
+    std::optional<Timestamp> remote_sdp_set_time_ RTC_GUARDED_BY(signaling_task_queue_) = std::nullopt;
+    std::optional<TimeDelta> dtls_setup_delay_ RTC_GUARDED_BY(signaling_task_queue_) = std::nullopt;
+
     std::vector<const sdp::Candidate> remote_candidates_ RTC_GUARDED_BY(signaling_task_queue_);
 
     DataChannelCallback data_channel_callback_ RTC_GUARDED_BY(signaling_task_queue_) = nullptr;
@@ -231,7 +238,8 @@ private:
     std::vector<std::shared_ptr<DataChannel>> pending_data_channels_ RTC_GUARDED_BY(signaling_task_queue_);
     std::vector<std::shared_ptr<MediaTrack>> pending_media_tracks_ RTC_GUARDED_BY(signaling_task_queue_);
 
-    Call call_ RTC_GUARDED_BY(worker_task_queue_);
+    // Created after the worker queue, and destroyed on it.
+    std::unique_ptr<Call> call_ RTC_GUARDED_BY(worker_task_queue_) = nullptr;
 };
 
 std::ostream& operator<<(std::ostream& out, PeerConnection::ConnectionState state);
@@ -58,6 +58,9 @@ struct RtcConfiguration {
 #if USE_NICE
     // libnice only
     std::optional<ProxyServer> proxy_server;
+    // The maximum number of main loops shared by the ICE agents of the process,
+    // zero means each ICE agent runs on its own main loop thread.
+    size_t num_shared_nice_main_loops = 0;
 #else
     // libjuice only
     std::optional<std::string> bind_addresses;
@@ -75,6 +78,21 @@ struct RtcConfiguration {
     // MTU: Maximum Transmission Unit
     std::optional<size_t> mtu;
 
+    // The number of workers used to offload SRTP protect/unprotect
+    // from the network thread, zero means doing crypto inline.
+    size_t num_srtp_crypto_workers = 0;
+
+    // If set, the calls of the process are paced by the shared pacer
+    // instead of a pacer thread per call.
+    bool use_shared_pacer = false;
+    // The cap of the total pacing bitrate of the shared pacer, which is
+    // process-wide, zero means no cap.
+    size_t shared_pacer_max_bitrate_kbps = 0;
+
+    // The memory budget of the retransmission histories shared by the
+    // send streams, zero means no limit.
+    size_t max_packet_history_kbytes = 0;
+
     // SCTP
     std::optional<uint16_t> local_sctp_port;
     std::optional<size_t> sctp_max_message_size;
@@ -16,17 +16,19 @@ void PeerConnection::InitDtlsTransport() {
     
     // NOTE: The thread might be blocked here until the certificate has been created.
     auto dtls_config = DtlsTransport::Configuration();
+    dtls_config.clock = &clock_;
     dtls_config.certificate = certificate_.get();
     dtls_config.mtu = rtc_config_.mtu;
 
     bool has_media = local_sdp_->HasAudio() || local_sdp_->HasVideo();
     auto lower = ice_transport_.get();
+    size_t num_srtp_crypto_workers = rtc_config_.num_srtp_crypto_workers;
  
-    network_task_queue_->Post([this, has_media, lower, config=std::move(dtls_config)](){
+    network_task_queue_->Post([this, has_media, lower, num_srtp_crypto_workers, config=std::move(dtls_config)](){
         bool is_dtls_client = ice_transport_->role() == sdp::Role::ACTIVE;
         // DTLS-SRTP
         if (has_media) {
-            auto dtls_srtp_transport = std::make_unique<DtlsSrtpTransport>(std::move(config), is_dtls_client, lower);
+            auto dtls_srtp_transport = std::make_unique<DtlsSrtpTransport>(std::move(config), is_dtls_client, lower, num_srtp_crypto_workers);
             dtls_srtp_transport->OnReceivedRtpPacket(std::bind(&PeerConnection::OnRtpPacketReceived, this, std::placeholders::_1, std::placeholders::_2));
             dtls_transport_ = std::move(dtls_srtp_transport);
         // DTLS only
@@ -50,6 +52,10 @@ void PeerConnection::OnDtlsTransportStateChanged(DtlsTransport::State transport_
         {
         case DtlsSrtpTransport::State::CONNECTED: {
             PLOG_DEBUG << "DTLS transport connected";
+            if (this->remote_sdp_set_time_ && !this->dtls_setup_delay_) {
+                this->dtls_setup_delay_ = this->clock_.CurrentTime() - *this->remote_sdp_set_time_;
+                PLOG_INFO << "DTLS setup delay: " << this->dtls_setup_delay_->ms() << " ms since remote description set.";
+            }
             // DataChannel enabled
             if (this->remote_sdp_ && this->remote_sdp_->HasApplication()) {
                 this->InitSctpTransport();
@@ -96,7 +102,7 @@ bool PeerConnection::OnDtlsVerify(std::string_view fingerprint) {
 void PeerConnection::OnRtpPacketReceived(CopyOnWriteBuffer in_packet, bool is_rtcp) {
     RTC_RUN_ON(network_task_queue_);
     worker_task_queue_->Post([this, in_packet=std::move(in_packet), is_rtcp]() mutable {
-        call_.DeliverRtpPacket(std::move(in_packet), is_rtcp);
+        call_->DeliverRtpPacket(std::move(in_packet), is_rtcp);
     });
 }
 
@@ -17,6 +17,7 @@ void PeerConnection::InitIceTransport() {
     ice_config.port_range_end = rtc_config_.port_range_end;
 #if USE_NICE
     ice_config.proxy_server = rtc_config_.proxy_server;
+    ice_config.num_shared_main_loops = rtc_config_.num_shared_nice_main_loops;
 #else
     ice_config.bind_addresses = rtc_config_.bind_addresses;
 #endif
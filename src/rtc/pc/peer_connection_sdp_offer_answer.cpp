@@ -246,6 +246,11 @@ void PeerConnection::SetRemoteDescription(sdp::Description remote_sdp) {
 
     ProcessRemoteDescription(std::move(remote_sdp));
 
+    // Used to measure the time to DTLS connected.
+    if (!remote_sdp_set_time_) {
+        remote_sdp_set_time_ = clock_.CurrentTime();
+    }
+
     UpdateSignalingState(new_signaling_state);
 
     if (remote_sdp_) {
@@ -491,7 +496,7 @@ void PeerConnection::ValidRemoteDescription(const sdp::Description& remote_sdp)
 
 std::shared_ptr<MediaTrack> PeerConnection::OnIncomingMediaTrack(sdp::Media remote_sdp) {
     RTC_RUN_ON(signaling_task_queue_);
-    auto media_track = std::make_shared<MediaTrack>(std::move(remote_sdp), &call_, worker_task_queue_.get());
+    auto media_track = std::make_shared<MediaTrack>(std::move(remote_sdp), call_.get(), worker_task_queue_.get());
     // Make sure the current media track dosen't be added before.
     if (media_tracks_.find(media_track->mid()) == media_tracks_.end()) {
         media_tracks_.emplace(std::make_pair(media_track->mid(), media_track));
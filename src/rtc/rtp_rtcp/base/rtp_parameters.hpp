@@ -5,6 +5,7 @@
 #include "rtc/rtp_rtcp/base/rtp_rtcp_defines.hpp"
 #include "rtc/rtp_rtcp/base/rtp_rtcp_interfaces.hpp"
 #include "rtc/rtp_rtcp/base/rtp_extensions.hpp"
+#include "rtc/base/units/data_rate.hpp"
 
 #include <optional>
 #include <unordered_map>
@@ -37,6 +38,10 @@ struct RtpParameters {
 
     size_t max_packet_size = kDefaultMaxPacketSize;
 
+    // The maximum bitrate of the stream, e.g. the 'b=AS' of the remote
+    // media description, and the stream is not capped if not set.
+    std::optional<DataRate> max_bitrate = std::nullopt;
+
     // RtpHeaderExtension
     std::vector<RtpExtension> extensions;
 
@@ -61,6 +66,10 @@ struct RtpParameters {
         uint32_t ssrc = 0;
         // The media stream being protected by this FlexFEC stream.
         uint32_t protected_media_ssrc = 0;
+        // Protects the media stream with the Reed-Solomon erasure code instead
+        // of the XOR masks, which recovers the burst losses better. It's not
+        // negotiated by SDP, so both ends MUST enable it out of band.
+        bool reed_solomon = false;
     } flexfec;
 
     std::unordered_map</*rtx_payload_type=*/int, /*original_payload_type=*/int> 
@@ -14,6 +14,8 @@
 namespace naivertc {
 
 class FecGenerator;
+class BitrateLimiter;
+class RtpPacketHistoryBudget;
 
 struct RtpConfiguration {
     // True for a audio version of the RTP/RTCP module object false will create
@@ -55,12 +57,19 @@ struct RtpConfiguration {
     RtcMediaTransport* send_transport = nullptr;
     FecGenerator* fec_generator = nullptr;
     RtpPacketSender* paced_sender = nullptr;
+    // Limits the retransmission bitrate, no limit if not set.
+    BitrateLimiter* retransmission_rate_limiter = nullptr;
+    // The bytes budget of the packet history shared by all the streams,
+    // no limit if not set.
+    RtpPacketHistoryBudget* packet_history_budget = nullptr;
 
     RtpSendDelayObserver* send_delay_observer = nullptr;
     RtpSendPacketObserver* send_packet_observer = nullptr;
     RtpSendBitratesObserver* send_bitrates_observer = nullptr;
     RtpTransportFeedbackObserver* transport_feedback_observer = nullptr;
     RtpStreamDataCountersObserver* stream_data_counters_observer = nullptr;
+    // Requests a key frame from the encoder when the pacer drops frames.
+    RtcpIntraFrameObserver* intra_frame_observer = nullptr;
 };
 
 struct RtcpConfiguration {
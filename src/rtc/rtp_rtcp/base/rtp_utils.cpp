@@ -1,4 +1,5 @@
 #include "rtc/rtp_rtcp/base/rtp_utils.hpp"
+#include "rtc/base/memory/byte_io_reader.hpp"
 
 // #include <boost/range/irange.hpp>
 
@@ -52,4 +53,14 @@ bool IsRtpPacket(ArrayView<const uint8_t> packet) {
            PayloadTypeIsReservedForRtp(packet[1] & 0x7F);
 }
 
+uint32_t ParseRtpSsrc(ArrayView<const uint8_t> rtp_packet) {
+    assert(rtp_packet.size() >= kFixedRtpPacketSize);
+    return ByteReader<uint32_t>::ReadBigEndian(&rtp_packet[8]);
+}
+
+uint32_t ParseRtcpSenderSsrc(ArrayView<const uint8_t> rtcp_packet) {
+    assert(rtcp_packet.size() >= kFixedRtcpPacketSize);
+    return ByteReader<uint32_t>::ReadBigEndian(&rtcp_packet[4]);
+}
+
 } // namespace naivertc
\ No newline at end of file
@@ -9,6 +9,10 @@ namespace naivertc {
 bool IsRtcpPacket(ArrayView<const uint8_t> packet);
 bool IsRtpPacket(ArrayView<const uint8_t> packet);
 
+// NOTE: The caller should make sure the packet is a valid RTP or RTCP packet.
+uint32_t ParseRtpSsrc(ArrayView<const uint8_t> rtp_packet);
+uint32_t ParseRtcpSenderSsrc(ArrayView<const uint8_t> rtcp_packet);
+
 } // namespace naivertc
 
 #endif
\ No newline at end of file
@@ -1,11 +1,13 @@
 #include "rtc/rtp_rtcp/components/bitrate_limiter.hpp"
 #include "rtc/base/time/clock.hpp"
 
+#include <limits>
+
 namespace naivertc {
 
 BitrateLimiter::BitrateLimiter(Clock* clock, TimeDelta max_window_size) 
     : clock_(clock),
-      bitrate_stats_(max_window_size),
+      bitrate_stats_(max_window_size.ms()),
       curr_window_size_(max_window_size),
       max_bitrate_(DataRate::PlusInfinity()) {}
 
@@ -17,12 +19,12 @@ void BitrateLimiter::set_max_bitrate(DataRate max_bitrate) {
 
 bool BitrateLimiter::SetWindowSize(TimeDelta window_size) {
     curr_window_size_ = window_size;
-    return bitrate_stats_.SetWindowSize(window_size, clock_->CurrentTime());
+    return bitrate_stats_.SetWindowSize(window_size.ms(), clock_->now_ms());
 }
 
 bool BitrateLimiter::TryConsumeBitrate(size_t bytes) {
-    auto now = clock_->CurrentTime();
-    auto curr_bitrate = bitrate_stats_.Rate(now);
+    const int64_t now_ms = clock_->now_ms();
+    auto curr_bitrate = bitrate_stats_.Rate(now_ms);
     if (curr_bitrate) {
         // If there is a available bitrate, check if adding bytes would
         // cause maximum bitrate target to be exceeded. 
@@ -36,8 +38,27 @@ bool BitrateLimiter::TryConsumeBitrate(size_t bytes) {
         // low bitrates, where for instance retransmissions would never
         // be allowed due to too high bitrate caused by a sinble packet.
     }
-    bitrate_stats_.Update(bytes, now);
+    bitrate_stats_.Update(bytes, now_ms);
     return true;
 }
+
+size_t BitrateLimiter::AvailableBytes() {
+    if (max_bitrate_.IsPlusInfinity()) {
+        return std::numeric_limits<size_t>::max();
+    }
+    auto curr_bitrate = bitrate_stats_.Rate(clock_->now_ms());
+    if (!curr_bitrate) {
+        // No bitrate available, the whole window is available.
+        return max_bitrate_ * curr_window_size_;
+    }
+    if (*curr_bitrate >= max_bitrate_) {
+        return 0;
+    }
+    return (max_bitrate_ - *curr_bitrate) * curr_window_size_;
+}
+
+void BitrateLimiter::ConsumeBitrate(size_t bytes) {
+    bitrate_stats_.Update(bytes, clock_->now_ms());
+}
     
 } // namespace naivertc
@@ -1,7 +1,7 @@
 #ifndef _RTC_RTP_RTCP_COMPONENTS_BITRATE_LIMITER_H_
 #define _RTC_RTP_RTCP_COMPONENTS_BITRATE_LIMITER_H_
 
-#include "rtc/rtp_rtcp/components/bitrate_statistics.hpp"
+#include "rtc/rtp_rtcp/components/bit_rate_statistics.hpp"
 #include "rtc/base/units/time_delta.hpp"
 #include "rtc/base/units/data_rate.hpp"
 
@@ -23,6 +23,13 @@ public:
 
     bool TryConsumeBitrate(size_t bytes);
 
+    // Returns the bytes can be consumed without exceeding the maximum bitrate,
+    // used to apply the budget once for a batch of packets.
+    size_t AvailableBytes();
+    // Consumes the |bytes| unconditionally, the caller should have checked
+    // them against AvailableBytes().
+    void ConsumeBitrate(size_t bytes);
+
 private:
     Clock* const clock_;
     BitrateStatistics bitrate_stats_;
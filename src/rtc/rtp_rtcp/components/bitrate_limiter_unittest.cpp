@@ -97,6 +97,24 @@ MY_TEST_F(BitrateLimiterTest, SingleUsageAlwaysOk) {
     EXPECT_TRUE(bitrate_limiter_.TryConsumeBitrate(kBitrateFilllingBytes + 1));
 }
 
+MY_TEST_F(BitrateLimiterTest, AvailableBytes) {
+    // The whole window is available before any usage.
+    EXPECT_EQ(bitrate_limiter_.AvailableBytes(), kBitrateFilllingBytes);
+
+    bitrate_limiter_.ConsumeBitrate(kBitrateFilllingBytes / 2);
+    clock_.AdvanceTime(kWindowSize - TimeDelta::Millis(1));
+    EXPECT_NEAR(bitrate_limiter_.AvailableBytes(), kBitrateFilllingBytes / 2, 1);
+
+    // Consuming the available bytes saturates the limiter.
+    bitrate_limiter_.ConsumeBitrate(bitrate_limiter_.AvailableBytes());
+    EXPECT_EQ(bitrate_limiter_.AvailableBytes(), 0u);
+    EXPECT_FALSE(bitrate_limiter_.TryConsumeBitrate(1));
+
+    // Unlimited if no maximum bitrate.
+    bitrate_limiter_.set_max_bitrate(DataRate::PlusInfinity());
+    EXPECT_EQ(bitrate_limiter_.AvailableBytes(), std::numeric_limits<size_t>::max());
+}
+
 MY_TEST_F(BitrateLimiterTest, WindowSizeLimits) {
     EXPECT_TRUE(bitrate_limiter_.SetWindowSize(TimeDelta::Millis(1)));
     EXPECT_FALSE(bitrate_limiter_.SetWindowSize(TimeDelta::Millis(0)));
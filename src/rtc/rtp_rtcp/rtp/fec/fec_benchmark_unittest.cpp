@@ -0,0 +1,253 @@
+#include "rtc/rtp_rtcp/rtp/fec/ulp/fec_generator_ulp.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/ulp/fec_receiver_ulp.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/fec_test_helper.hpp"
+#include "testing/simulated_clock.hpp"
+#include "testing/allocation_counter.hpp"
+
+#include <gtest/gtest.h>
+
+#define ENABLE_UNIT_TESTS 0
+#include "testing/defines.hpp"
+
+#include <chrono>
+#include <tuple>
+
+namespace naivertc {
+namespace test {
+namespace {
+
+constexpr uint8_t kFecPayloadType = 96;
+constexpr uint8_t kRedPayloadType = 97;
+constexpr uint8_t kMediaPayloadType = 120;
+constexpr uint32_t kMediaSsrc = 835424;
+constexpr size_t kRedForFecHeaderLength = 1;
+
+constexpr size_t kPayloadSize = 1000;
+// The number of media packets simulated per case, at least |kMinNumFrames|.
+constexpr size_t kNumMediaPackets = 2000;
+constexpr size_t kMinNumFrames = 20;
+// The packets are sent back to back at the interval.
+constexpr int64_t kPacketIntervalUs = 100;
+constexpr int64_t kFrameIntervalUs = 33'000;
+
+using SteadyClock = std::chrono::steady_clock;
+
+int64_t ElapsedNs(SteadyClock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(SteadyClock::now() - start).count();
+}
+
+// Measures the heap allocations and the time spent within its scope.
+class ScopedMeasurement {
+public:
+    ScopedMeasurement(int64_t* elapsed_ns, size_t* num_allocations)
+        : elapsed_ns_(elapsed_ns),
+          num_allocations_(num_allocations),
+          start_(SteadyClock::now()) {}
+    ~ScopedMeasurement() {
+        *elapsed_ns_ += ElapsedNs(start_);
+        *num_allocations_ += allocation_counter_.num_allocations();
+    }
+private:
+    int64_t* const elapsed_ns_;
+    size_t* const num_allocations_;
+    const SteadyClock::time_point start_;
+    ScopedAllocationCounter allocation_counter_;
+};
+
+RtpPacketToSend ToPacketToSend(const RtpPacket& rtp_packet) {
+    RtpPacketToSend packet_to_send(kIpPacketSize);
+    EXPECT_TRUE(packet_to_send.Parse(rtp_packet.cdata(), rtp_packet.size()));
+    packet_to_send.set_packet_type(RtpPacketType::VIDEO);
+    return packet_to_send;
+}
+
+// Records the time from which each lost media packet would have been
+// received to which it is recovered, the packets received are delivered
+// to here as well and ignored.
+class LatencyRecorder : public RecoveredPacketReceiver {
+public:
+    explicit LatencyRecorder(Clock* clock)
+        : clock_(clock),
+          lost_times_us_(1 << 16, kNotLost) {}
+
+    void OnPacketLost(uint16_t seq_num) {
+        lost_times_us_[seq_num] = clock_->now_us();
+    }
+
+    void OnRecoveredPacket(CopyOnWriteBuffer packet) override {
+        if (packet.size() < 4) {
+            return;
+        }
+        const uint16_t seq_num = static_cast<uint16_t>((packet.data()[2] << 8) | packet.data()[3]);
+        const int64_t lost_time_us = lost_times_us_[seq_num];
+        if (lost_time_us == kNotLost) {
+            return;
+        }
+        const int64_t latency_us = clock_->now_us() - lost_time_us;
+        total_latency_us_ += latency_us;
+        max_latency_us_ = std::max(max_latency_us_, latency_us);
+        ++num_recovered_packets_;
+        lost_times_us_[seq_num] = kNotLost;
+    }
+
+    size_t num_recovered_packets() const { return num_recovered_packets_; }
+    int64_t max_latency_us() const { return max_latency_us_; }
+    int64_t avg_latency_us() const {
+        return num_recovered_packets_ > 0 ? total_latency_us_ / static_cast<int64_t>(num_recovered_packets_) : 0;
+    }
+
+private:
+    static constexpr int64_t kNotLost = -1;
+
+    Clock* const clock_;
+    // Indexed by the sequence number to keep the allocations out of the
+    // measured decoding.
+    std::vector<int64_t> lost_times_us_;
+    size_t num_recovered_packets_ = 0;
+    int64_t total_latency_us_ = 0;
+    int64_t max_latency_us_ = 0;
+};
+
+struct BenchmarkResult {
+    int64_t encode_ns = 0;
+    int64_t decode_ns = 0;
+    int64_t recovery_ns = 0;
+    size_t encode_allocations = 0;
+    size_t decode_allocations = 0;
+    size_t num_media_bytes = 0;
+    size_t num_protected_packets = 0;
+    size_t num_fec_packets = 0;
+    size_t num_lost_media_packets = 0;
+};
+
+} // namespace
+
+// Params: protection factor in [0, 255], media packets per frame, FEC mask type, loss fraction.
+class T(UlpFecBenchmarkTest) : public ::testing::TestWithParam<std::tuple<int, size_t, FecMaskType, double>> {
+public:
+    T(UlpFecBenchmarkTest)()
+        : protection_factor_(static_cast<size_t>(std::get<0>(GetParam()))),
+          num_packets_per_frame_(std::get<1>(GetParam())),
+          fec_mask_type_(std::get<2>(GetParam())),
+          loss_fraction_(std::get<3>(GetParam())),
+          num_frames_(std::max(kMinNumFrames, kNumMediaPackets / num_packets_per_frame_)) {}
+
+    void Report(const BenchmarkResult& result, const LatencyRecorder& latency_recorder) {
+        const size_t num_media_bytes = std::max<size_t>(1, result.num_media_bytes);
+        const size_t num_fec_packets = std::max<size_t>(1, result.num_fec_packets);
+        const size_t num_lost_media_packets = std::max<size_t>(1, result.num_lost_media_packets);
+        GTEST_COUT << "UlpFec"
+                   << " factor=" << protection_factor_
+                   << " frame=" << num_packets_per_frame_ << " packets"
+                   << " mask=" << (fec_mask_type_ == FecMaskType::BURSTY ? "bursty" : "random")
+                   << " loss=" << loss_fraction_ * 100 << "%"
+                   << " - encode=" << static_cast<double>(result.encode_ns) / num_media_bytes << " ns/byte"
+                   << " decode=" << static_cast<double>(result.decode_ns) / num_media_bytes << " ns/byte"
+                   << " recovery=" << result.recovery_ns / static_cast<int64_t>(num_fec_packets) << " ns/fec"
+                   << " allocs encode=" << static_cast<double>(result.encode_allocations) / num_frames_ << " /frame"
+                   << " decode=" << static_cast<double>(result.decode_allocations) / num_frames_ << " /frame"
+                   << " protected=" << 100.0 * result.num_protected_packets / (num_frames_ * num_packets_per_frame_) << "%"
+                   << " fec=" << result.num_fec_packets
+                   << " recovered=" << 100.0 * latency_recorder.num_recovered_packets() / num_lost_media_packets << "%"
+                   << " latency avg=" << latency_recorder.avg_latency_us() << " us"
+                   << " max=" << latency_recorder.max_latency_us() << " us"
+                   << std::endl;
+    }
+
+protected:
+    const size_t protection_factor_;
+    const size_t num_packets_per_frame_;
+    const FecMaskType fec_mask_type_;
+    const double loss_fraction_;
+    const size_t num_frames_;
+};
+
+MY_INSTANTIATE_TEST_SUITE_P(UlpFecScaling,
+                            UlpFecBenchmarkTest,
+                            ::testing::Combine(::testing::Values(0, 32, 64, 128, 255),
+                                               ::testing::Values(1, 4, 10, 48, 100, 200),
+                                               ::testing::Values(FecMaskType::RANDOM, FecMaskType::BURSTY),
+                                               ::testing::Values(0.0, 0.05, 0.2)));
+
+// Runs the media through UlpFecGenerator (and thus FecHeaderWriterUlp) on
+// the sending side and UlpFecReceiver on the receiving side, with the losses
+// matching the mask type, random or in bursts of 3 packets in average.
+MY_TEST_P(UlpFecBenchmarkTest, EncodeAndDecode) {
+    SimulatedClock clock(Timestamp::Seconds(1000));
+    LossChannel channel(loss_fraction_, fec_mask_type_ == FecMaskType::BURSTY ? 3.0 : 1.0);
+    LatencyRecorder latency_recorder(&clock);
+    UlpFecGenerator fec_generator(kRedPayloadType, kFecPayloadType);
+    UlpFecReceiver fec_receiver(kMediaSsrc, &clock, &latency_recorder);
+    UlpFecPacketGenerator packet_generator(kMediaSsrc, kMediaPayloadType, kFecPayloadType, kRedPayloadType);
+    const FecProtectionParams params = {protection_factor_, 1, fec_mask_type_};
+    fec_generator.SetProtectionParameters(params, params);
+
+    BenchmarkResult result;
+    std::vector<RtpPacket> media_packets;
+    std::vector<RtpPacketToSend> packets_to_send;
+    media_packets.reserve(num_packets_per_frame_);
+    packets_to_send.reserve(num_packets_per_frame_);
+    for (size_t frame = 0; frame < num_frames_; ++frame) {
+        media_packets.clear();
+        packets_to_send.clear();
+        packet_generator.NewFrame(num_packets_per_frame_);
+        for (size_t i = 0; i < num_packets_per_frame_; ++i) {
+            media_packets.push_back(packet_generator.NextRtpPacket(kPayloadSize));
+            packets_to_send.push_back(ToPacketToSend(media_packets.back()));
+            result.num_media_bytes += kPayloadSize;
+        }
+        // UlpFecGenerator protects up to 48 media packets of a frame.
+        result.num_protected_packets += std::min(num_packets_per_frame_, kUlpFecMaxMediaPackets);
+
+        std::vector<RtpPacketToSend> fec_packets;
+        {
+            ScopedMeasurement measurement(&result.encode_ns, &result.encode_allocations);
+            for (auto& packet : packets_to_send) {
+                fec_generator.PushMediaPacket(std::move(packet));
+            }
+            fec_packets = fec_generator.PopFecPackets();
+        }
+        result.num_fec_packets += fec_packets.size();
+
+        for (const auto& media_packet : media_packets) {
+            clock.AdvanceTimeUs(kPacketIntervalUs);
+            if (channel.Lost()) {
+                latency_recorder.OnPacketLost(media_packet.sequence_number());
+                ++result.num_lost_media_packets;
+                continue;
+            }
+            auto red_packet = packet_generator.BuildMediaRedPacket(media_packet);
+            ScopedMeasurement measurement(&result.decode_ns, &result.decode_allocations);
+            fec_receiver.OnRedPacket(red_packet, kFecPayloadType);
+        }
+        for (const auto& fec_packet : fec_packets) {
+            clock.AdvanceTimeUs(kPacketIntervalUs);
+            // The FEC packets generated share the RTP header of the last
+            // media packet, so they are rebuilt with their own sequence
+            // numbers, anyway to keep the numbering when lost.
+            auto fec_payload = fec_packet.payload().subview(kRedForFecHeaderLength);
+            auto red_packet = packet_generator.BuildUlpFecRedPacket(CopyOnWriteBuffer(fec_payload.data(), fec_payload.size()));
+            if (channel.Lost()) {
+                continue;
+            }
+            int64_t recovery_ns = 0;
+            {
+                ScopedMeasurement measurement(&recovery_ns, &result.decode_allocations);
+                fec_receiver.OnRedPacket(red_packet, kFecPayloadType);
+            }
+            result.recovery_ns += recovery_ns;
+            result.decode_ns += recovery_ns;
+        }
+        clock.AdvanceTimeUs(kFrameIntervalUs);
+    }
+
+    EXPECT_EQ(latency_recorder.num_recovered_packets(), fec_receiver.packet_counter().num_recovered_packets);
+    EXPECT_LE(latency_recorder.num_recovered_packets(), result.num_lost_media_packets);
+    if (protection_factor_ == 0) {
+        EXPECT_EQ(0u, result.num_fec_packets);
+    }
+    Report(result, latency_recorder);
+}
+
+} // namespace test
+} // namespace naivertc
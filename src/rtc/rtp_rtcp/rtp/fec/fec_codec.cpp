@@ -1,7 +1,136 @@
 #include "rtc/rtp_rtcp/rtp/fec/fec_codec.hpp"
 #include "rtc/rtp_rtcp/base/rtp_rtcp_defines.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RTC_FEC_XOR_X86 1
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define RTC_FEC_XOR_NEON 1
+#include <arm_neon.h>
+#endif
+
 namespace naivertc {
+namespace {
+
+using XorFunc = void (*)(const uint8_t* src, uint8_t* dst, size_t size);
+
+struct XorKernel {
+    const char* name;
+    XorFunc func;
+};
+
+// XORs the bytes one word at a time, and is used by the vector kernels to
+// handle the unaligned head and the tail too.
+void XorScalar(const uint8_t* src, uint8_t* dst, size_t size) {
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t s, d;
+        memcpy(&s, src + i, sizeof(s));
+        memcpy(&d, dst + i, sizeof(d));
+        d ^= s;
+        memcpy(dst + i, &d, sizeof(d));
+    }
+    for (; i < size; ++i) {
+        dst[i] ^= src[i];
+    }
+}
+
+// Returns the number of bytes to XOR before |dst| is aligned to |alignment|.
+size_t HeadSize(const uint8_t* dst, size_t size, size_t alignment) {
+    size_t misalignment = reinterpret_cast<uintptr_t>(dst) & (alignment - 1);
+    return std::min(size, misalignment == 0 ? 0 : alignment - misalignment);
+}
+
+#if defined(RTC_FEC_XOR_X86)
+
+__attribute__((target("sse2")))
+void XorSse2(const uint8_t* src, uint8_t* dst, size_t size) {
+    size_t i = HeadSize(dst, size, 16);
+    XorScalar(src, dst, i);
+    for (; i + 16 <= size; i += 16) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i d = _mm_load_si128(reinterpret_cast<const __m128i*>(dst + i));
+        _mm_store_si128(reinterpret_cast<__m128i*>(dst + i), _mm_xor_si128(d, s));
+    }
+    XorScalar(src + i, dst + i, size - i);
+}
+
+__attribute__((target("avx2")))
+void XorAvx2(const uint8_t* src, uint8_t* dst, size_t size) {
+    size_t i = HeadSize(dst, size, 32);
+    XorScalar(src, dst, i);
+    for (; i + 32 <= size; i += 32) {
+        __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i d = _mm256_load_si256(reinterpret_cast<const __m256i*>(dst + i));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_xor_si256(d, s));
+    }
+    XorScalar(src + i, dst + i, size - i);
+}
+
+__attribute__((target("avx512f")))
+void XorAvx512(const uint8_t* src, uint8_t* dst, size_t size) {
+    size_t i = HeadSize(dst, size, 64);
+    XorScalar(src, dst, i);
+    for (; i + 64 <= size; i += 64) {
+        __m512i s = _mm512_loadu_si512(src + i);
+        __m512i d = _mm512_load_si512(dst + i);
+        _mm512_store_si512(dst + i, _mm512_xor_si512(d, s));
+    }
+    XorScalar(src + i, dst + i, size - i);
+}
+
+#elif defined(RTC_FEC_XOR_NEON)
+
+void XorNeon(const uint8_t* src, uint8_t* dst, size_t size) {
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        uint8x16_t d0 = veorq_u8(vld1q_u8(dst + i), vld1q_u8(src + i));
+        uint8x16_t d1 = veorq_u8(vld1q_u8(dst + i + 16), vld1q_u8(src + i + 16));
+        vst1q_u8(dst + i, d0);
+        vst1q_u8(dst + i + 16, d1);
+    }
+    XorScalar(src + i, dst + i, size - i);
+}
+
+#endif
+
+// Returns the kernels supported by the running CPU, from the fastest to the
+// slowest, the scalar one is always the last.
+const std::vector<XorKernel>& SupportedXorKernels() {
+    static const std::vector<XorKernel> kernels = [](){
+        std::vector<XorKernel> kernels;
+#if defined(RTC_FEC_XOR_X86)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            kernels.push_back({"avx512", &XorAvx512});
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            kernels.push_back({"avx2", &XorAvx2});
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            kernels.push_back({"sse2", &XorSse2});
+        }
+#elif defined(RTC_FEC_XOR_NEON)
+        kernels.push_back({"neon", &XorNeon});
+#endif
+        kernels.push_back({"scalar", &XorScalar});
+        return kernels;
+    }();
+    return kernels;
+}
+
+// The fastest kernel is selected at the first use, by the CPU features
+// detected at runtime.
+std::atomic<const XorKernel*>& CurrentXorKernel() {
+    static std::atomic<const XorKernel*> kernel(&SupportedXorKernels().front());
+    return kernel;
+}
+
+} // namespace
 
 void FecCodec::XorHeader(const CopyOnWriteBuffer& src, size_t src_payload_size, CopyOnWriteBuffer& dst) {
     uint8_t* dst_data = dst.data();
@@ -15,7 +144,7 @@ void FecCodec::XorHeader(const CopyOnWriteBuffer& src, size_t src_payload_size,
     // Store the lenth recovery temporally.
     uint16_t length_recovery = static_cast<uint16_t>(src_payload_size);
     dst_data[2] ^= (length_recovery >> 8);
-    dst_data[3] ^= (length_recovery & 0x0F);
+    dst_data[3] ^= (length_recovery & 0xFF);
 
     // XOR the 5th to 8th bytes of the header: the timestamp field.
     dst_data[4] ^= src_data[4];
@@ -38,11 +167,30 @@ void FecCodec::XorPayload(size_t src_payload_offset,
         dst.Resize(dst_payload_offset + src_payload_size);
     }
 
-    uint8_t* dst_data = dst.data();
-    const uint8_t* src_data = src.data();
-    for (size_t i = 0; i < src_payload_size; ++i) {
-        dst_data[dst_payload_offset + i] ^= src_data[src_payload_offset + i];
+    XorFunc xor_func = CurrentXorKernel().load(std::memory_order_relaxed)->func;
+    xor_func(src.data() + src_payload_offset, dst.data() + dst_payload_offset, src_payload_size);
+}
+
+const char* FecCodec::XorKernelName() {
+    return CurrentXorKernel().load()->name;
+}
+
+std::vector<std::string> FecCodec::SupportedXorKernelNames() {
+    std::vector<std::string> names;
+    for (const auto& kernel : SupportedXorKernels()) {
+        names.push_back(kernel.name);
+    }
+    return names;
+}
+
+bool FecCodec::SelectXorKernelForTesting(const std::string& name) {
+    for (const auto& kernel : SupportedXorKernels()) {
+        if (name == kernel.name) {
+            CurrentXorKernel().store(&kernel);
+            return true;
+        }
     }
+    return false;
 }
     
 } // namespace naivertc
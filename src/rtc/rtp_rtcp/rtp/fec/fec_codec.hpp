@@ -6,6 +6,9 @@
 #include "rtc/rtp_rtcp/rtp/packets/rtp_packet.hpp"
 #include "common/array_view.hpp"
 
+#include <string>
+#include <vector>
+
 namespace naivertc {
 
 class FecCodec {
@@ -20,6 +23,13 @@ public:
                            const CopyOnWriteBuffer& src,
                            size_t dst_payload_offset, 
                            CopyOnWriteBuffer& dst);
+
+    // Returns the name of the XOR kernel selected for the running CPU,
+    // one of "avx512", "avx2", "sse2", "neon" or "scalar".
+    static const char* XorKernelName();
+    static std::vector<std::string> SupportedXorKernelNames();
+    // Returns false if the kernel is not supported by the running CPU.
+    static bool SelectXorKernelForTesting(const std::string& name);
 };
     
 } // namespace naivertc
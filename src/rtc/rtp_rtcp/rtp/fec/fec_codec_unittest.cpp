@@ -0,0 +1,137 @@
+#include "rtc/rtp_rtcp/rtp/fec/fec_codec.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/fec_encoder.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/fec_test_helper.hpp"
+
+#include <gtest/gtest.h>
+
+#define ENABLE_UNIT_TESTS 0
+#include "testing/defines.hpp"
+
+#include <chrono>
+
+namespace naivertc {
+namespace test {
+namespace {
+
+constexpr uint32_t kMediaSsrc = 835424;
+constexpr uint8_t kMediaPayloadType = 98;
+constexpr size_t kMaxXorSize = 300;
+constexpr size_t kMaxXorOffset = 70;
+constexpr size_t kPacketSize = 1200;
+constexpr size_t kNumPacketsPerFrame = 10;
+// 50% protection factor in the [0, 255] domain.
+constexpr uint8_t kProtectionFactor = 128;
+
+using SteadyClock = std::chrono::steady_clock;
+
+int64_t ElapsedNs(SteadyClock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(SteadyClock::now() - start).count();
+}
+
+CopyOnWriteBuffer CreateBuffer(size_t size, uint8_t seed) {
+    CopyOnWriteBuffer buffer(size);
+    uint8_t* data = buffer.data();
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<uint8_t>(seed + i * 7);
+    }
+    return buffer;
+}
+
+} // namespace
+
+// Params: the name of the XOR kernel.
+class T(FecCodecTest) : public ::testing::TestWithParam<std::string> {
+public:
+    void SetUp() override {
+        ASSERT_TRUE(FecCodec::SelectXorKernelForTesting(GetParam()));
+    }
+
+    void TearDown() override {
+        // Restore the fastest kernel for the other tests.
+        FecCodec::SelectXorKernelForTesting(FecCodec::SupportedXorKernelNames().front());
+    }
+};
+
+MY_INSTANTIATE_TEST_SUITE_P(XorKernels,
+                            FecCodecTest,
+                            ::testing::ValuesIn(FecCodec::SupportedXorKernelNames()));
+
+MY_TEST_P(FecCodecTest, XorPayloadMatchesBytewiseXor) {
+    EXPECT_EQ(GetParam(), FecCodec::XorKernelName());
+    const CopyOnWriteBuffer src = CreateBuffer(kMaxXorOffset + kMaxXorSize, 3);
+    // Covers all the combinations of the unaligned heads and tails.
+    for (size_t src_offset = 0; src_offset < kMaxXorOffset; src_offset += 5) {
+        for (size_t dst_offset = 0; dst_offset < kMaxXorOffset; dst_offset += 3) {
+            for (size_t size = 0; size <= kMaxXorSize; ++size) {
+                CopyOnWriteBuffer dst = CreateBuffer(dst_offset + size, 11);
+                CopyOnWriteBuffer expected = CreateBuffer(dst_offset + size, 11);
+                for (size_t i = 0; i < size; ++i) {
+                    expected.data()[dst_offset + i] ^= src.cdata()[src_offset + i];
+                }
+
+                FecCodec::XorPayload(src_offset, size, src, dst_offset, dst);
+
+                ASSERT_EQ(expected, dst) << "src_offset=" << src_offset
+                                         << " dst_offset=" << dst_offset
+                                         << " size=" << size;
+            }
+        }
+    }
+}
+
+MY_TEST_P(FecCodecTest, XorPayloadGrowsDestination) {
+    const CopyOnWriteBuffer src = CreateBuffer(kPacketSize, 3);
+    CopyOnWriteBuffer dst(100, kPacketSize);
+    memset(dst.data(), 0, dst.size());
+
+    FecCodec::XorPayload(0, kPacketSize, src, 0, dst);
+
+    EXPECT_EQ(kPacketSize, dst.size());
+    EXPECT_EQ(src, dst);
+}
+
+MY_TEST_P(FecCodecTest, XorThroughput) {
+    constexpr size_t kNumIterations = 200000;
+    const CopyOnWriteBuffer src = CreateBuffer(kPacketSize, 3);
+    CopyOnWriteBuffer dst = CreateBuffer(kPacketSize, 11);
+    // Using an odd offset to exercise the unaligned head and tail.
+    const size_t xor_size = kPacketSize - 1;
+
+    auto start = SteadyClock::now();
+    for (size_t i = 0; i < kNumIterations; ++i) {
+        FecCodec::XorPayload(1, xor_size, src, 0, dst);
+    }
+    const int64_t elapsed_ns = std::max<int64_t>(1, ElapsedNs(start));
+
+    GTEST_COUT << GetParam() << " XOR of " << xor_size << " bytes: "
+               << static_cast<double>(xor_size * kNumIterations) / elapsed_ns << " GB/s"
+               << std::endl;
+}
+
+MY_TEST_P(FecCodecTest, UlpFecEncodeTimePerFrame) {
+    constexpr size_t kNumFrames = 2000;
+    auto fec_encoder = FecEncoder::CreateUlpFecEncoder();
+    RtpPacketGenerator packet_generator(kMediaSsrc, kMediaPayloadType);
+    packet_generator.NewFrame(kNumPacketsPerFrame);
+    FecEncoder::PacketList media_packets;
+    for (size_t i = 0; i < kNumPacketsPerFrame; ++i) {
+        media_packets.push_back(packet_generator.NextRtpPacket(kPacketSize - kRtpHeaderSize));
+    }
+
+    FecEncoder::FecPacketList fec_packets;
+    auto start = SteadyClock::now();
+    for (size_t i = 0; i < kNumFrames; ++i) {
+        fec_packets.clear();
+        ASSERT_TRUE(fec_encoder->Encode(media_packets, kProtectionFactor, 0, false, FecMaskType::RANDOM, fec_packets));
+    }
+    const int64_t elapsed_ns = ElapsedNs(start);
+    EXPECT_EQ(FecEncoder::CalcNumFecPackets(kNumPacketsPerFrame, kProtectionFactor), fec_packets.size());
+
+    GTEST_COUT << GetParam() << " ULPFEC encode of " << kNumPacketsPerFrame
+               << " x " << kPacketSize << " bytes at 50% protection: "
+               << elapsed_ns / kNumFrames / 1000.0 << " us/frame"
+               << std::endl;
+}
+
+} // namespace test
+} // namespace naivertc
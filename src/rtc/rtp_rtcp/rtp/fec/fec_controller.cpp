@@ -1,9 +1,236 @@
 #include "rtc/rtp_rtcp/rtp/fec/fec_controller.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 namespace naivertc {
+namespace {
+
+// The number of the latest report blocks used to estimate the loss.
+constexpr size_t kLossHistorySize = 5;
+// The minimum number of reports with known packet counts needed to
+// estimate the burstiness.
+constexpr size_t kMinReportsForBurstiness = 3;
+// The loss is considered bursty when the packets lost per interval disperse
+// twice as much as the random loss, i.e. the mean burst length is about 2.
+constexpr double kBurstyLossThreshold = 2.0;
+
+// Below this RTT, the lost packets are recovered by NACK only.
+constexpr TimeDelta kLowRttNackThreshold = TimeDelta::Millis(20);
+// Above this RTT, the lost packets are fully protected by FEC, and NACK
+// is kept as a fallback.
+constexpr TimeDelta kHighRttNackThreshold = TimeDelta::Millis(100);
+
+// The residual loss tolerated after FEC.
+constexpr double kDeltaFrameResidualLoss = 0.005;
+constexpr double kKeyFrameResidualLoss = 0.001;
+// At most 50% of the delta frames are protected, the key frames are
+// allowed to use the full range.
+constexpr uint8_t kMaxDeltaProtectionFactor = 128;
+constexpr uint8_t kMaxKeyProtectionFactor = 255;
+// FEC can hardly help beyond this loss, which gets the maximum protection.
+constexpr double kMaxProtectedLossFraction = 0.5;
+
+// A key frame is about this many times larger than a delta frame.
+constexpr size_t kKeyFrameSizeRatio = 4;
+// The frames are grouped until at least this many media packets are
+// protected together, since the FEC of a few packets is inefficient.
+constexpr size_t kMinMediaPacketsPerFecGroup = 4;
+constexpr size_t kMaxFecFrames = 3;
+
+constexpr double kDefaultFrameRate = 30.0;
+
+} // namespace
+
+FecController::FecController(const Configuration& config)
+    : nack_enabled_(config.nack_enabled),
+      fec_enabled_(config.fec_enabled),
+      max_packet_size_(std::max<size_t>(config.max_packet_size, 1)) {
+    mode_ = CalcProtectionMode();
+}
 
-FecController::FecController() = default;
-    
 FecController::~FecController() = default;
-    
+
+double FecController::loss_fraction() const {
+    double loss_fraction = 0;
+    for (const auto& report : loss_history_) {
+        loss_fraction = std::max(loss_fraction, report.loss_fraction);
+    }
+    return loss_fraction;
+}
+
+double FecController::burstiness() const {
+    int64_t num_expected_packets = 0;
+    double num_lost_packets = 0;
+    size_t num_reports = 0;
+    for (const auto& report : loss_history_) {
+        if (report.num_expected_packets > 0) {
+            num_expected_packets += report.num_expected_packets;
+            num_lost_packets += report.loss_fraction * report.num_expected_packets;
+            ++num_reports;
+        }
+    }
+    if (num_reports < kMinReportsForBurstiness || num_lost_packets <= 0) {
+        return 1.0;
+    }
+    const double mean_loss = num_lost_packets / num_expected_packets;
+    if (mean_loss >= 1.0) {
+        return 1.0;
+    }
+    // The index of dispersion: the variance of the loss fractions over the
+    // variance expected from the Bernoulli loss of the same mean.
+    double dispersion = 0;
+    for (const auto& report : loss_history_) {
+        if (report.num_expected_packets > 0) {
+            const double diff = report.loss_fraction - mean_loss;
+            const double variance = mean_loss * (1 - mean_loss) / report.num_expected_packets;
+            dispersion += diff * diff / variance;
+        }
+    }
+    return dispersion / num_reports;
+}
+
+void FecController::OnReceivedRtcpReportBlock(const RtcpReportBlock& report_block) {
+    LossReport report;
+    report.loss_fraction = report_block.fraction_lost / 256.0;
+    if (last_report_block_) {
+        const int64_t num_expected_packets = static_cast<int64_t>(report_block.extended_highest_sequence_number) -
+                                             static_cast<int64_t>(last_report_block_->extended_highest_sequence_number);
+        if (num_expected_packets <= 0) {
+            // No packet was sent during the interval, or a stale report.
+            return;
+        }
+        // The packets lost may be negative due to the duplicates.
+        const int64_t num_lost_packets = std::clamp<int64_t>(report_block.packets_lost - last_report_block_->packets_lost,
+                                                             0, num_expected_packets);
+        report.loss_fraction = static_cast<double>(num_lost_packets) / num_expected_packets;
+        report.num_expected_packets = num_expected_packets;
+    }
+    last_report_block_ = report_block;
+
+    loss_history_.push_back(report);
+    if (loss_history_.size() > kLossHistorySize) {
+        loss_history_.pop_front();
+    }
+}
+
+void FecController::OnRttUpdated(TimeDelta rtt) {
+    rtt_ = rtt;
+}
+
+DataRate FecController::UpdateProtection(DataRate target_bitrate, double frame_rate) {
+    mode_ = CalcProtectionMode();
+    delta_params_ = FecProtectionParams();
+    key_params_ = FecProtectionParams();
+    overhead_ratio_ = 0;
+
+    if (mode_ == ProtectionMode::NONE || target_bitrate.IsZero() || target_bitrate.IsInfinite()) {
+        return target_bitrate;
+    }
+
+    const double loss = loss_fraction();
+    if (mode_ != ProtectionMode::NACK) {
+        if (frame_rate <= 0) {
+            frame_rate = kDefaultFrameRate;
+        }
+        const double bytes_per_frame = target_bitrate.bps<double>() / 8 / frame_rate;
+        const size_t packets_per_frame = std::max<size_t>(1, static_cast<size_t>(std::ceil(bytes_per_frame / max_packet_size_)));
+
+        // Group the small frames to protect more packets at once, but not
+        // with NACK, which recovers the frames without waiting for the
+        // next ones.
+        size_t max_fec_frames = 1;
+        if (mode_ == ProtectionMode::FEC) {
+            max_fec_frames = std::clamp<size_t>((kMinMediaPacketsPerFecGroup + packets_per_frame - 1) / packets_per_frame,
+                                                1, kMaxFecFrames);
+        }
+        const size_t num_delta_packets = std::min(packets_per_frame * max_fec_frames, kUlpFecMaxMediaPackets);
+        const size_t num_key_packets = std::min(packets_per_frame * kKeyFrameSizeRatio, kUlpFecMaxMediaPackets);
+
+        // NACK recovers more of the lost packets in time as the RTT decreases,
+        // and FEC only protects against the rest.
+        const double fec_loss = mode_ == ProtectionMode::NACK_FEC ? loss * FecWeight() : loss;
+        const uint8_t delta_factor = CalcProtectionFactor(num_delta_packets, fec_loss, kDeltaFrameResidualLoss);
+        const uint8_t key_factor = CalcProtectionFactor(num_key_packets, fec_loss, kKeyFrameResidualLoss);
+        const FecMaskType mask_type = burstiness() >= kBurstyLossThreshold ? FecMaskType::BURSTY
+                                                                             : FecMaskType::RANDOM;
+
+        delta_params_.fec_rate = std::min(delta_factor, kMaxDeltaProtectionFactor);
+        delta_params_.max_fec_frames = max_fec_frames;
+        delta_params_.fec_mask_type = mask_type;
+        key_params_.fec_rate = std::min(key_factor, kMaxKeyProtectionFactor);
+        key_params_.max_fec_frames = 1;
+        key_params_.fec_mask_type = mask_type;
+
+        // The key frames are rare, so the overhead is dominated by the delta frames.
+        overhead_ratio_ += delta_params_.fec_rate / 256.0;
+    }
+    if (mode_ != ProtectionMode::FEC) {
+        // The lost packets beyond the recovery capacity of FEC are retransmitted.
+        overhead_ratio_ += std::max(0.0, loss - overhead_ratio_);
+    }
+    return DataRate::BitsPerSec(target_bitrate.bps<double>() / (1.0 + overhead_ratio_));
+}
+
+// Private methods
+uint8_t FecController::CalcProtectionFactor(size_t num_media_packets,
+                                            double loss_fraction,
+                                            double residual_loss) {
+    if (num_media_packets == 0 || loss_fraction <= 0) {
+        return 0;
+    }
+    loss_fraction = std::min(loss_fraction, kMaxProtectedLossFraction);
+    // Find the fewest FEC packets which keep the expected fraction of the
+    // packets lost beyond the recovery capacity below |residual_loss|,
+    // assuming the loss is independent.
+    size_t num_fec_packets = 0;
+    for (; num_fec_packets < num_media_packets; ++num_fec_packets) {
+        const size_t num_packets = num_media_packets + num_fec_packets;
+        // The sum of x * P(X = x) for x > num_fec_packets, X ~ Binomial(num_packets, loss_fraction).
+        double pmf = std::pow(1.0 - loss_fraction, num_packets);
+        double unrecovered = 0;
+        for (size_t x = 1; x <= num_packets; ++x) {
+            pmf *= static_cast<double>(num_packets - x + 1) / x * loss_fraction / (1.0 - loss_fraction);
+            if (x > num_fec_packets) {
+                unrecovered += x * pmf;
+            }
+        }
+        if (unrecovered / num_packets <= residual_loss) {
+            break;
+        }
+    }
+    if (num_fec_packets == 0) {
+        return 0;
+    }
+    // The smallest factor for which the FEC encoder generates |num_fec_packets|,
+    // the inverse of (num_media_packets * factor + 128) >> 8.
+    const size_t factor = (num_fec_packets * 256 - 128 + num_media_packets - 1) / num_media_packets;
+    return static_cast<uint8_t>(std::min<size_t>(factor, 255));
+}
+
+FecController::ProtectionMode FecController::CalcProtectionMode() const {
+    if (nack_enabled_ && fec_enabled_) {
+        // FEC is useless if the lost packets can be retransmitted in time.
+        return rtt_.IsFinite() && rtt_ < kLowRttNackThreshold ? ProtectionMode::NACK
+                                                              : ProtectionMode::NACK_FEC;
+    } else if (nack_enabled_) {
+        return ProtectionMode::NACK;
+    } else if (fec_enabled_) {
+        return ProtectionMode::FEC;
+    } else {
+        return ProtectionMode::NONE;
+    }
+}
+
+double FecController::FecWeight() const {
+    if (rtt_.IsInfinite() || rtt_ >= kHighRttNackThreshold) {
+        return 1.0;
+    }
+    if (rtt_ <= kLowRttNackThreshold) {
+        return 0.0;
+    }
+    return static_cast<double>((rtt_ - kLowRttNackThreshold).ms()) /
+           (kHighRttNackThreshold - kLowRttNackThreshold).ms();
+}
+
 } // namespace naivertc
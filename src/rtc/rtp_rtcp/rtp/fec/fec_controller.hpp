@@ -2,17 +2,99 @@
 #define _RTC_RTP_RTCP_RTP_FEC_FEC_CONTROLLER_H_
 
 #include "base/defines.hpp"
+#include "rtc/base/internals.hpp"
+#include "rtc/base/units/data_rate.hpp"
+#include "rtc/base/units/time_delta.hpp"
+#include "rtc/rtp_rtcp/base/rtcp_statistic_types.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/fec_defines.hpp"
+
+#include <deque>
+#include <optional>
 
 namespace naivertc {
 
+// FecController decides how a video stream is protected against the packet
+// loss, based on the loss reported by the RTCP report blocks, the RTT and
+// the target bitrate given by the network controller.
+// NACK is preferred when the RTT is short enough to retransmit the lost
+// packets in time, and FEC takes over as the RTT grows. The protection
+// overhead is substracted from the target bitrate, and the rest is left
+// for the media.
 class FecController {
 public:
-    FecController();
+    enum class ProtectionMode {
+        NONE,
+        NACK,
+        FEC,
+        NACK_FEC
+    };
+
+    struct Configuration {
+        bool nack_enabled = false;
+        bool fec_enabled = false;
+        // The maximum size of the media packets, used to estimate the
+        // number of packets per frame.
+        size_t max_packet_size = kIpPacketSize;
+    };
+public:
+    explicit FecController(const Configuration& config);
     ~FecController();
 
+    ProtectionMode mode() const { return mode_; }
+    const FecProtectionParams& delta_params() const { return delta_params_; }
+    const FecProtectionParams& key_params() const { return key_params_; }
+
+    // The loss fraction in [0, 1] used to protect the stream.
+    double loss_fraction() const;
+    // The dispersion of the number of packets lost per report interval,
+    // which is about 1 for the random loss, and grows with the mean length
+    // of the loss bursts.
+    double burstiness() const;
+    // The ratio of the protection bitrate to the media bitrate.
+    double overhead_ratio() const { return overhead_ratio_; }
+
+    // The report block for the protected media stream.
+    void OnReceivedRtcpReportBlock(const RtcpReportBlock& report_block);
+    void OnRttUpdated(TimeDelta rtt);
+
+    // Updates the protection parameters with the target bitrate and the
+    // frame rate of the stream, returns the bitrate left for the media.
+    DataRate UpdateProtection(DataRate target_bitrate, double frame_rate);
+
+private:
+    struct LossReport {
+        double loss_fraction = 0;
+        // The number of packets expected during the report interval, or
+        // zero if unknown.
+        int64_t num_expected_packets = 0;
+    };
+
+    // Returns the smallest protection factor in [0, 255] which keeps the
+    // residual loss of |num_media_packets| below |residual_loss|.
+    static uint8_t CalcProtectionFactor(size_t num_media_packets,
+                                        double loss_fraction,
+                                        double residual_loss);
+
+    ProtectionMode CalcProtectionMode() const;
+    // The weight in [0, 1] of FEC, which grows with the RTT.
+    double FecWeight() const;
+
+private:
+    const bool nack_enabled_;
+    const bool fec_enabled_;
+    const size_t max_packet_size_;
+
+    std::optional<RtcpReportBlock> last_report_block_;
+    std::deque<LossReport> loss_history_;
+    TimeDelta rtt_ = TimeDelta::PlusInfinity();
+
+    ProtectionMode mode_ = ProtectionMode::NONE;
+    FecProtectionParams delta_params_;
+    FecProtectionParams key_params_;
+    double overhead_ratio_ = 0;
 };
-    
+
 } // namespace naivertc
 
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,370 @@
+#include "rtc/rtp_rtcp/rtp/fec/fec_controller.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/fec_encoder.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/flex/fec_generator_flex.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/flex/fec_receiver_flex.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/fec_test_helper.hpp"
+#include "rtc/base/memory/byte_io_reader.hpp"
+#include "testing/simulated_clock.hpp"
+
+#include <gtest/gtest.h>
+
+#define ENABLE_UNIT_TESTS 0
+#include "testing/defines.hpp"
+
+#include <set>
+
+namespace naivertc {
+namespace test {
+namespace {
+
+constexpr uint32_t kMediaSsrc = 835424;
+constexpr uint32_t kFlexfecSsrc = 42984;
+constexpr uint8_t kMediaPayloadType = 120;
+constexpr uint8_t kFlexfecPayloadType = 96;
+
+constexpr size_t kMaxPacketSize = 1200;
+constexpr DataRate kTargetBitrate = DataRate::KilobitsPerSec(1000);
+constexpr double kFrameRate = 30.0;
+
+// Builds the report block of the |num_expected_packets| packets since the
+// last report, with |num_lost_packets| of them lost.
+class ReportBlockBuilder {
+public:
+    RtcpReportBlock Build(int64_t num_expected_packets, int64_t num_lost_packets) {
+        extended_highest_sequence_number_ += static_cast<uint32_t>(num_expected_packets);
+        cumulative_lost_ += static_cast<int32_t>(num_lost_packets);
+        RtcpReportBlock report_block;
+        report_block.source_ssrc = kMediaSsrc;
+        report_block.extended_highest_sequence_number = extended_highest_sequence_number_;
+        report_block.packets_lost = cumulative_lost_;
+        report_block.fraction_lost = num_expected_packets > 0
+                                   ? static_cast<uint8_t>(std::min<int64_t>(num_lost_packets * 256 / num_expected_packets, 255))
+                                   : 0;
+        return report_block;
+    }
+
+private:
+    uint32_t extended_highest_sequence_number_ = 1000;
+    int32_t cumulative_lost_ = 0;
+};
+
+FecController::Configuration FecOnly() {
+    FecController::Configuration config;
+    config.fec_enabled = true;
+    config.max_packet_size = kMaxPacketSize;
+    return config;
+}
+
+FecController::Configuration NackAndFec() {
+    FecController::Configuration config = FecOnly();
+    config.nack_enabled = true;
+    return config;
+}
+
+void ReportLoss(FecController& fec_controller,
+                ReportBlockBuilder& builder,
+                double loss_fraction,
+                size_t num_reports = 5) {
+    constexpr int64_t kNumPacketsPerReport = 1000;
+    for (size_t i = 0; i < num_reports; ++i) {
+        fec_controller.OnReceivedRtcpReportBlock(builder.Build(kNumPacketsPerReport,
+                                                               static_cast<int64_t>(loss_fraction * kNumPacketsPerReport)));
+    }
+}
+
+} // namespace
+
+MY_TEST(FecControllerTest, NoProtectionWithoutLoss) {
+    FecController fec_controller(FecOnly());
+    ReportBlockBuilder builder;
+    ReportLoss(fec_controller, builder, 0.0);
+
+    EXPECT_EQ(kTargetBitrate, fec_controller.UpdateProtection(kTargetBitrate, kFrameRate));
+    EXPECT_EQ(FecController::ProtectionMode::FEC, fec_controller.mode());
+    EXPECT_EQ(0u, fec_controller.delta_params().fec_rate);
+    EXPECT_EQ(0u, fec_controller.key_params().fec_rate);
+    EXPECT_EQ(0.0, fec_controller.overhead_ratio());
+}
+
+MY_TEST(FecControllerTest, ProtectionGrowsWithLoss) {
+    FecController fec_controller(FecOnly());
+    ReportBlockBuilder builder;
+    size_t last_fec_rate = 0;
+    for (double loss_fraction : {0.01, 0.05, 0.1, 0.2}) {
+        ReportLoss(fec_controller, builder, loss_fraction);
+        EXPECT_NEAR(loss_fraction, fec_controller.loss_fraction(), 1e-6);
+        fec_controller.UpdateProtection(kTargetBitrate, kFrameRate);
+        const auto& delta_params = fec_controller.delta_params();
+        EXPECT_GT(delta_params.fec_rate, 0u);
+        EXPECT_GE(delta_params.fec_rate, last_fec_rate);
+        // At most 50% of the delta frames.
+        EXPECT_LE(delta_params.fec_rate, 128u);
+        // The key frames of 16 packets get more FEC packets.
+        EXPECT_GE(FecEncoder::CalcNumFecPackets(16, static_cast<uint8_t>(fec_controller.key_params().fec_rate)),
+                  FecEncoder::CalcNumFecPackets(4, static_cast<uint8_t>(delta_params.fec_rate)));
+        last_fec_rate = delta_params.fec_rate;
+    }
+    EXPECT_EQ(128u, last_fec_rate);
+}
+
+MY_TEST(FecControllerTest, ProtectionFactorMatchesFecPackets) {
+    FecController fec_controller(FecOnly());
+    ReportBlockBuilder builder;
+    ReportLoss(fec_controller, builder, 0.01);
+    // 1 Mbps at 30 fps is 4 packets per frame.
+    fec_controller.UpdateProtection(kTargetBitrate, kFrameRate);
+    const auto& delta_params = fec_controller.delta_params();
+    EXPECT_EQ(1u, delta_params.max_fec_frames);
+    // One FEC packet for the 4 media packets keeps the residual loss below 0.5% at 1% loss.
+    EXPECT_EQ(1u, FecEncoder::CalcNumFecPackets(4, static_cast<uint8_t>(delta_params.fec_rate)));
+}
+
+MY_TEST(FecControllerTest, GroupsSmallFrames) {
+    FecController fec_controller(FecOnly());
+    ReportBlockBuilder builder;
+    ReportLoss(fec_controller, builder, 0.05);
+    // Less than one packet per frame.
+    fec_controller.UpdateProtection(DataRate::KilobitsPerSec(200), kFrameRate);
+    EXPECT_EQ(3u, fec_controller.delta_params().max_fec_frames);
+    EXPECT_EQ(1u, fec_controller.key_params().max_fec_frames);
+}
+
+MY_TEST(FecControllerTest, NackOnlyWithShortRtt) {
+    FecController fec_controller(NackAndFec());
+    ReportBlockBuilder builder;
+    ReportLoss(fec_controller, builder, 0.1);
+    fec_controller.OnRttUpdated(TimeDelta::Millis(10));
+
+    DataRate media_bitrate = fec_controller.UpdateProtection(kTargetBitrate, kFrameRate);
+    EXPECT_EQ(FecController::ProtectionMode::NACK, fec_controller.mode());
+    EXPECT_EQ(0u, fec_controller.delta_params().fec_rate);
+    EXPECT_EQ(0u, fec_controller.key_params().fec_rate);
+    // The lost packets are retransmitted.
+    EXPECT_NEAR(0.1, fec_controller.overhead_ratio(), 1e-6);
+    EXPECT_NEAR(kTargetBitrate.bps() / 1.1, media_bitrate.bps(), 1);
+}
+
+MY_TEST(FecControllerTest, FecTakesOverAsRttGrows) {
+    FecController fec_controller(NackAndFec());
+    ReportBlockBuilder builder;
+    ReportLoss(fec_controller, builder, 0.1);
+
+    size_t last_fec_rate = 0;
+    for (int64_t rtt_ms : {25, 50, 150}) {
+        fec_controller.OnRttUpdated(TimeDelta::Millis(rtt_ms));
+        fec_controller.UpdateProtection(kTargetBitrate, kFrameRate);
+        EXPECT_EQ(FecController::ProtectionMode::NACK_FEC, fec_controller.mode());
+        EXPECT_GT(fec_controller.delta_params().fec_rate, last_fec_rate);
+        // No frame grouping to not delay the frames which NACK can recover.
+        EXPECT_EQ(1u, fec_controller.delta_params().max_fec_frames);
+        last_fec_rate = fec_controller.delta_params().fec_rate;
+    }
+
+    // Same as FEC only beyond the high RTT threshold.
+    FecController fec_only_controller(FecOnly());
+    ReportBlockBuilder fec_only_builder;
+    ReportLoss(fec_only_controller, fec_only_builder, 0.1);
+    fec_only_controller.UpdateProtection(kTargetBitrate, kFrameRate);
+    EXPECT_EQ(fec_only_controller.delta_params().fec_rate, last_fec_rate);
+}
+
+MY_TEST(FecControllerTest, MediaBitrateExcludesOverhead) {
+    FecController fec_controller(FecOnly());
+    ReportBlockBuilder builder;
+    ReportLoss(fec_controller, builder, 0.05);
+
+    DataRate media_bitrate = fec_controller.UpdateProtection(kTargetBitrate, kFrameRate);
+    EXPECT_GT(fec_controller.overhead_ratio(), 0.0);
+    EXPECT_NEAR(fec_controller.delta_params().fec_rate / 256.0, fec_controller.overhead_ratio(), 1e-6);
+    EXPECT_NEAR(kTargetBitrate.bps() / (1.0 + fec_controller.overhead_ratio()), media_bitrate.bps(), 1);
+}
+
+MY_TEST(FecControllerTest, DetectsBurstyLoss) {
+    FecController fec_controller(FecOnly());
+    ReportBlockBuilder builder;
+    // Steady loss is random.
+    ReportLoss(fec_controller, builder, 0.1);
+    EXPECT_LT(fec_controller.burstiness(), 2.0);
+    fec_controller.UpdateProtection(kTargetBitrate, kFrameRate);
+    EXPECT_EQ(FecMaskType::RANDOM, fec_controller.delta_params().fec_mask_type);
+
+    // The loss comes and goes in bursts.
+    for (double loss_fraction : {0.0, 0.2, 0.0, 0.2, 0.0}) {
+        ReportLoss(fec_controller, builder, loss_fraction, 1);
+    }
+    EXPECT_GE(fec_controller.burstiness(), 2.0);
+    fec_controller.UpdateProtection(kTargetBitrate, kFrameRate);
+    EXPECT_EQ(FecMaskType::BURSTY, fec_controller.delta_params().fec_mask_type);
+    EXPECT_EQ(FecMaskType::BURSTY, fec_controller.key_params().fec_mask_type);
+}
+
+MY_TEST(FecControllerTest, IgnoresStaleReports) {
+    FecController fec_controller(FecOnly());
+    ReportBlockBuilder builder;
+    ReportLoss(fec_controller, builder, 0.1);
+    // No packet expected since the last report.
+    fec_controller.OnReceivedRtcpReportBlock(builder.Build(0, 0));
+    EXPECT_NEAR(0.1, fec_controller.loss_fraction(), 1e-6);
+}
+
+// Simulated network
+namespace {
+
+constexpr size_t kPayloadSize = 1000;
+constexpr size_t kNumPacketsPerFrame = 4;
+constexpr size_t kNumFrames = 30 * 60;
+constexpr size_t kNumFramesPerReport = 30;
+// The lost packets retransmitted later than this are useless.
+constexpr TimeDelta kMaxRetransmissionDelay = TimeDelta::Millis(100);
+
+class RecoveredPacketCollector : public RecoveredPacketReceiver {
+public:
+    void OnRecoveredPacket(CopyOnWriteBuffer recovered_packet) override {
+        recovered_seq_nums_.insert(ByteReader<uint16_t>::ReadBigEndian(&recovered_packet.cdata()[2]));
+    }
+    const std::set<uint16_t>& recovered_seq_nums() const { return recovered_seq_nums_; }
+
+private:
+    std::set<uint16_t> recovered_seq_nums_;
+};
+
+struct Scenario {
+    const char* name;
+    double loss_fraction;
+    double mean_burst_length;
+    TimeDelta rtt;
+};
+
+struct SimulationResult {
+    double residual_loss = 0;
+    double overhead = 0;
+};
+
+enum class Strategy {
+    NACK_ONLY,
+    STATIC_FEC,
+    ADAPTIVE
+};
+
+const char* ToString(Strategy strategy) {
+    switch (strategy) {
+    case Strategy::NACK_ONLY: return "NACK only";
+    case Strategy::STATIC_FEC: return "static 50% FEC";
+    case Strategy::ADAPTIVE: return "adaptive";
+    }
+    return "";
+}
+
+SimulationResult Simulate(const Scenario& scenario, Strategy strategy) {
+    SimulatedClock clock(0x100);
+    LossChannel channel(scenario.loss_fraction, scenario.mean_burst_length);
+    RecoveredPacketCollector collector;
+    FlexfecGenerator fec_generator(kFlexfecPayloadType, kFlexfecSsrc, kMediaSsrc, &clock);
+    FlexfecReceiver fec_receiver(kFlexfecSsrc, kMediaSsrc, &clock, &collector);
+    RtpPacketGenerator packet_generator(kMediaSsrc, kMediaPayloadType);
+    FecController fec_controller(NackAndFec());
+    fec_controller.OnRttUpdated(scenario.rtt);
+    ReportBlockBuilder builder;
+
+    if (strategy == Strategy::STATIC_FEC) {
+        const FecProtectionParams params = {128, 1, FecMaskType::RANDOM};
+        fec_generator.SetProtectionParameters(params, params);
+    }
+
+    std::vector<uint16_t> lost_seq_nums;
+    size_t media_bytes = 0;
+    size_t protection_bytes = 0;
+    size_t num_expected_packets = 0;
+    size_t num_lost_packets = 0;
+    for (size_t frame = 0; frame < kNumFrames; ++frame) {
+        packet_generator.NewFrame(kNumPacketsPerFrame);
+        for (size_t i = 0; i < kNumPacketsPerFrame; ++i) {
+            RtpPacket rtp_packet = packet_generator.NextRtpPacket(kPayloadSize);
+            media_bytes += rtp_packet.size();
+            RtpPacketToSend packet_to_send(kIpPacketSize);
+            EXPECT_TRUE(packet_to_send.Parse(rtp_packet.cdata(), rtp_packet.size()));
+            packet_to_send.set_packet_type(RtpPacketType::VIDEO);
+            fec_generator.PushMediaPacket(std::move(packet_to_send));
+            ++num_expected_packets;
+            if (channel.Lost()) {
+                ++num_lost_packets;
+                lost_seq_nums.push_back(rtp_packet.sequence_number());
+                continue;
+            }
+            RtpPacketReceived received_packet;
+            EXPECT_TRUE(received_packet.Parse(rtp_packet.cdata(), rtp_packet.size()));
+            fec_receiver.OnRtpPacket(received_packet);
+        }
+        for (auto& fec_packet : fec_generator.PopFecPackets()) {
+            protection_bytes += fec_packet.size();
+            if (channel.Lost()) {
+                continue;
+            }
+            RtpPacketReceived received_packet;
+            EXPECT_TRUE(received_packet.Parse(fec_packet.cdata(), fec_packet.size()));
+            fec_receiver.OnRtpPacket(received_packet);
+        }
+        clock.AdvanceTimeMs(33);
+
+        if (strategy == Strategy::ADAPTIVE && (frame + 1) % kNumFramesPerReport == 0) {
+            fec_controller.OnReceivedRtcpReportBlock(builder.Build(num_expected_packets, num_lost_packets));
+            num_expected_packets = 0;
+            num_lost_packets = 0;
+            fec_controller.UpdateProtection(kTargetBitrate, kFrameRate);
+            fec_generator.SetProtectionParameters(fec_controller.delta_params(), fec_controller.key_params());
+        }
+    }
+
+    // The packets not recovered by FEC are retransmitted once, in time only
+    // if the RTT is short enough.
+    size_t num_residual_lost = 0;
+    for (uint16_t seq_num : lost_seq_nums) {
+        if (collector.recovered_seq_nums().count(seq_num) > 0) {
+            continue;
+        }
+        protection_bytes += kRtpHeaderSize + kPayloadSize;
+        if (channel.Lost() || scenario.rtt > kMaxRetransmissionDelay) {
+            ++num_residual_lost;
+        }
+    }
+
+    SimulationResult result;
+    result.residual_loss = static_cast<double>(num_residual_lost) / (kNumFrames * kNumPacketsPerFrame);
+    result.overhead = static_cast<double>(protection_bytes) / media_bytes;
+    return result;
+}
+
+} // namespace
+
+MY_TEST(FecControllerTest, ProtectionOnSimulatedNetwork) {
+    const Scenario kScenarios[] = {
+        {"1% random loss, 50 ms RTT", 0.01, 1.0, TimeDelta::Millis(50)},
+        {"1% random loss, 200 ms RTT", 0.01, 1.0, TimeDelta::Millis(200)},
+        {"5% random loss, 200 ms RTT", 0.05, 1.0, TimeDelta::Millis(200)},
+        {"5% bursty loss, 200 ms RTT", 0.05, 3.0, TimeDelta::Millis(200)},
+        {"10% random loss, 300 ms RTT", 0.1, 1.0, TimeDelta::Millis(300)},
+    };
+    for (const auto& scenario : kScenarios) {
+        SimulationResult results[3];
+        for (auto strategy : {Strategy::NACK_ONLY, Strategy::STATIC_FEC, Strategy::ADAPTIVE}) {
+            SimulationResult& result = results[static_cast<int>(strategy)];
+            result = Simulate(scenario, strategy);
+            GTEST_COUT << scenario.name << ", " << ToString(strategy)
+                       << ": residual loss " << result.residual_loss * 100 << "%"
+                       << ", overhead " << result.overhead * 100 << "%"
+                       << std::endl;
+        }
+        const auto& adaptive = results[static_cast<int>(Strategy::ADAPTIVE)];
+        const auto& static_fec = results[static_cast<int>(Strategy::STATIC_FEC)];
+        const auto& nack_only = results[static_cast<int>(Strategy::NACK_ONLY)];
+        // Costs less than the static protection.
+        EXPECT_LT(adaptive.overhead, static_fec.overhead) << scenario.name;
+        // Loses fewer packets than without FEC when NACK is too slow.
+        if (scenario.rtt > kMaxRetransmissionDelay) {
+            EXPECT_LT(adaptive.residual_loss, nack_only.residual_loss) << scenario.name;
+        }
+    }
+}
+
+} // namespace test
+} // namespace naivertc
@@ -3,9 +3,12 @@
 #include "rtc/rtp_rtcp/base/rtp_rtcp_defines.hpp"
 #include "rtc/base/memory/byte_io_reader.hpp"
 #include "rtc/base/memory/byte_io_writer.hpp"
+#include "common/utils_numeric.hpp"
 
 #include <plog/Log.h>
 
+#include <limits>
+
 namespace naivertc {
 namespace {
     
@@ -20,6 +23,11 @@ std::unique_ptr<FecDecoder> FecDecoder::CreateUlpFecDecoder(uint32_t ssrc) {
     return std::unique_ptr<FecDecoder>(new FecDecoder(ssrc/* fec_ssrc */, ssrc/* protected media ssrc */, std::move(fec_header_reader)));
 }
 
+std::unique_ptr<FecDecoder> FecDecoder::CreateFlexFecDecoder(uint32_t fec_ssrc, uint32_t protected_media_ssrc) {
+    auto fec_header_reader = std::make_unique<FlexfecHeaderReader>();
+    return std::unique_ptr<FecDecoder>(new FecDecoder(fec_ssrc, protected_media_ssrc, std::move(fec_header_reader)));
+}
+
 FecDecoder::FecDecoder(uint32_t fec_ssrc, 
                        uint32_t protected_media_ssrc, 
                        std::unique_ptr<FecHeaderReader> fec_header_reader) 
@@ -30,32 +38,37 @@ FecDecoder::FecDecoder(uint32_t fec_ssrc,
 FecDecoder::~FecDecoder() {}
 
 void FecDecoder::Decode(uint32_t fec_ssrc, uint16_t seq_num, bool is_fec, CopyOnWriteBuffer received_packet) {
-    const size_t max_media_packets = fec_header_reader_->max_media_packets();
-
     // Reset if there has a big gap in sequence numbers.
-    if (recovered_media_packets_.size() >= max_media_packets) {
-        const auto& last_recovered_packet = recovered_media_packets_.rbegin();
-        // Belongs to the same sequence number space.
-        if (fec_ssrc == last_recovered_packet->first) {
-            const uint16_t seq_num_diff = MinDiff(seq_num, last_recovered_packet->second.seq_num);
-            // A big gap in sequence numbers. The old recovered packets are now
-            // useless, so it's safe to do a reset.
-            if (seq_num_diff > max_media_packets) {
-                PLOG_WARNING << "Big gap in media/UlpFec sequence numbers."
-                             << " No need to keep the old packets in the recovered packet buffer,"
-                             << " thus resetting them.";
-                Reset();
-            }
+    // It only makes sense when the packet belongs to the sequence number space
+    // of the media packets.
+    if (newest_media_seq_num_ && fec_ssrc == protected_media_ssrc_) {
+        const uint16_t seq_num_diff = MinDiff(seq_num, *newest_media_seq_num_);
+        // A big gap in sequence numbers. The old recovered packets are now
+        // useless, so it's safe to do a reset.
+        if (seq_num_diff > fec_header_reader_->max_media_packets()) {
+            PLOG_WARNING << "Big gap in media/UlpFec sequence numbers."
+                         << " No need to keep the old packets in the recovered packet buffer,"
+                         << " thus resetting them.";
+            Reset();
         }
     }
 
-    InsertPacket(fec_ssrc, seq_num, is_fec, std::move(received_packet));
+    if (is_fec) {
+        InsertFecPacket(fec_ssrc, seq_num, std::move(received_packet));
+    } else {
+        InsertMediaPacket(fec_ssrc, seq_num, std::move(received_packet));
+    }
     TryToRecover();
 }
 
 void FecDecoder::Reset() {
-    recovered_media_packets_.clear();
-    received_fec_packets_.clear();
+    for (auto& media_packet : media_packets_) {
+        media_packet.reset();
+    }
+    newest_media_seq_num_.reset();
+    while (used_fec_slots_ != 0) {
+        RemoveFecPacket(utils::numeric::count_trailing_zeros(used_fec_slots_));
+    }
 }
 
 void FecDecoder::OnRecoveredPacket(PacketRecoveredCallback callback) {
@@ -63,58 +76,35 @@ void FecDecoder::OnRecoveredPacket(PacketRecoveredCallback callback) {
 }
 
 // Private methods
-void FecDecoder::InsertPacket(uint32_t fec_ssrc, uint16_t seq_num, bool is_fec, CopyOnWriteBuffer received_packet) {
-    // Discard old FEC packets such that the sequence numbers in `received_fec_packets_` 
-    // span at most 1/2 of the sequence number space.
-    // This is important for keeping `received_fec_packets_` sorted, and may also reduce
-    // the possiblity of incorrect decoding due to sequence number wrap-around.
-    if (!received_fec_packets_.empty() &&
-        fec_ssrc == received_fec_packets_.begin()->second.ssrc) {
-        // It only makes sense to detect wrap-around when `received_fec_packet` and `front_received_fec_packet`
-        // belong to the same sequence number space. i.e., the same SSRC.
-        auto it = received_fec_packets_.begin();
-        while (it != received_fec_packets_.end()) {
-            uint16_t seq_num_diff = MinDiff<uint16_t>(seq_num, it->first);
-            if (seq_num_diff > kOldSequenceThreshold) {
-                it = received_fec_packets_.erase(it);
-            } else {
-                // No need to keep iterating, since `received_fec_packets_` is sorted.
-                break;
-            }
-        }
-    }
-
-    if (is_fec) {
-        InsertFecPacket(fec_ssrc, seq_num, std::move(received_packet));
-    } else {
-        InsertMediaPacket(fec_ssrc, seq_num, std::move(received_packet));
-    }
-}
-
 void FecDecoder::InsertFecPacket(uint32_t fec_ssrc, uint16_t seq_num, CopyOnWriteBuffer received_packet) {
     // The incoming FEC packet and FEC decoder belong to the same sequence number space.
     assert(fec_ssrc == fec_ssrc_);
 
+    DiscardOldFecPackets(fec_ssrc, seq_num);
+
     // Drop duplicate FEC packet.
-    auto duplicated_it = received_fec_packets_.find(seq_num);
-    if (duplicated_it != received_fec_packets_.end()) {
-        return;
+    for (uint64_t slots = used_fec_slots_; slots != 0; slots &= slots - 1) {
+        const auto& fec_packet = fec_packets_[utils::numeric::count_trailing_zeros(slots)];
+        if (fec_packet.ssrc == fec_ssrc && fec_packet.seq_num == seq_num) {
+            return;
+        }
     }
 
     FecPacket fec_packet;
     fec_packet.ssrc = fec_ssrc;
     fec_packet.seq_num = seq_num;
-    // TODO: Compatible with FlexFEC.
-    // The FEC packet and media packet using the same stream to transport in UlpFEC.
-    fec_packet.protected_ssrc = fec_ssrc;
     fec_packet.pkt = std::move(received_packet);
 
     auto& fec_header = fec_packet.fec_header;
+    // The FEC packet and media packet using the same stream to transport in UlpFEC,
+    // and the protected SSRC will be overwritten by the FlexFEC header.
+    fec_header.protected_ssrc = fec_ssrc;
 
     // Parse ULP/FLX FEC header specific info.
     if (!fec_header_reader_->ReadFecHeader(fec_header, fec_packet.pkt)) {
         return;
     }
+    fec_packet.protected_ssrc = fec_header.protected_ssrc;
 
     // FIXME: Is this necessary?
     if (fec_packet.protected_ssrc != protected_media_ssrc_) {
@@ -122,52 +112,61 @@ void FecDecoder::InsertFecPacket(uint32_t fec_ssrc, uint16_t seq_num, CopyOnWrit
         return;
     }
 
-    if (fec_header.packet_mask_offset + fec_header.packet_mask_size > fec_packet.pkt.size()) {
+    if (fec_header.packet_mask_offset + fec_header.packet_mask_size > fec_packet.pkt.size() ||
+        fec_header.packet_mask_size * 8 > kMaxProtectedMediaPackets) {
         PLOG_WARNING << "Received a truncated FEC packet, droping.";
         return;
     }
 
-    // Parse packet mask from header and represent as protected packets.
-    for (uint16_t byte_idx = 0; byte_idx < fec_header.packet_mask_size; ++byte_idx) {
-        uint8_t packet_mask = fec_packet.pkt.data()[fec_header.packet_mask_offset + byte_idx];
-        for (uint16_t bit_idx = 0; bit_idx < 8; ++bit_idx) {
+    // Parse packet mask from header, and mark the protected packets not received yet as missing.
+    const uint8_t* packet_mask = fec_packet.pkt.cdata() + fec_header.packet_mask_offset;
+    for (size_t byte_idx = 0; byte_idx < fec_header.packet_mask_size; ++byte_idx) {
+        for (size_t bit_idx = 0; bit_idx < 8; ++bit_idx) {
             // Mask bit is set.
-            if (packet_mask & (1 << (7 - bit_idx))) {
-                MediaPacket protected_media_packet;
-                protected_media_packet.ssrc = protected_media_ssrc_;
-                protected_media_packet.seq_num = static_cast<uint16_t>(fec_header.seq_num_base + (byte_idx << 3 /* byte_idx * 8 (1 byte = 8 bit) */) + bit_idx);
-                fec_packet.protected_media_packets[protected_media_packet.seq_num] = std::move(protected_media_packet);
+            if (packet_mask[byte_idx] & (1 << (7 - bit_idx))) {
+                const size_t offset = (byte_idx << 3 /* byte_idx * 8 (1 byte = 8 bit) */) + bit_idx;
+                fec_packet.protected_mask.set(offset);
+                fec_packet.last_protected_offset = offset;
+                if (!FindMediaPacket(static_cast<uint16_t>(fec_header.seq_num_base + offset))) {
+                    fec_packet.missing_mask.set(offset);
+                }
             }
         }
     }
 
-    auto& protected_media_packets = fec_packet.protected_media_packets;
-    if (protected_media_packets.empty()) {
+    if (fec_packet.protected_mask.none()) {
         PLOG_WARNING << "Received FEC packet has all-zero packet mask.";
         return;
     }
 
-    // Assign protected packets with recovered packets.
-    auto it_p = protected_media_packets.begin();
-    auto it_r = recovered_media_packets_.cbegin();
-    while (it_p != protected_media_packets.end() && it_r != recovered_media_packets_.end()) {
-        // it_r is newer than it_p
-        if (wrap_around_utils::AheadOf<uint16_t>(it_r->first, it_p->first)) {
-            ++it_p;
-        // it_p is newer than it_r
-        } else if (wrap_around_utils::AheadOf<uint16_t>(it_p->first, it_r->first)) {
-            ++it_r;
-        // it_r is equan to it_p
-        } else {
-            it_p->second.pkt = it_r->second.pkt;
-            ++it_p;
-            ++it_r;
-        }
+    fec_packet.num_missing_packets = fec_packet.missing_mask.count();
+    // All the protected packets arrived or have been recovered already.
+    if (fec_packet.num_missing_packets == 0) {
+        return;
     }
 
-    received_fec_packets_[seq_num] = std::move(fec_packet);
+    // Evict the oldest FEC packet if there is no slot left.
+    const size_t max_fec_packets = std::min(fec_header_reader_->max_fec_packets(), kMaxFecPackets);
+    if (utils::numeric::count_ones(used_fec_slots_) >= max_fec_packets) {
+        size_t oldest_slot = 0;
+        uint64_t oldest_arrival_order = std::numeric_limits<uint64_t>::max();
+        for (uint64_t slots = used_fec_slots_; slots != 0; slots &= slots - 1) {
+            const size_t slot = utils::numeric::count_trailing_zeros(slots);
+            if (fec_packets_[slot].arrival_order < oldest_arrival_order) {
+                oldest_arrival_order = fec_packets_[slot].arrival_order;
+                oldest_slot = slot;
+            }
+        }
+        RemoveFecPacket(oldest_slot);
+    }
 
-    DiscardOldReceivedFecPackets();
+    const size_t slot = utils::numeric::count_trailing_zeros(~used_fec_slots_);
+    fec_packet.arrival_order = next_fec_arrival_order_++;
+    if (fec_packet.num_missing_packets == 1) {
+        recoverable_fec_slots_ |= uint64_t{1} << slot;
+    }
+    fec_packets_[slot] = std::move(fec_packet);
+    used_fec_slots_ |= uint64_t{1} << slot;
 }
 
 void FecDecoder::InsertMediaPacket(uint32_t media_ssrc, uint16_t seq_num, CopyOnWriteBuffer received_packet) {
@@ -175,8 +174,7 @@ void FecDecoder::InsertMediaPacket(uint32_t media_ssrc, uint16_t seq_num, CopyOn
     assert(media_ssrc == protected_media_ssrc_);
 
     // Drop duplicate media packet.
-    auto duplicated_it = recovered_media_packets_.find(seq_num);
-    if (duplicated_it != recovered_media_packets_.end()) {
+    if (FindMediaPacket(seq_num)) {
         return;
     }
 
@@ -187,107 +185,116 @@ void FecDecoder::InsertMediaPacket(uint32_t media_ssrc, uint16_t seq_num, CopyOn
     media_packet.was_recovered = false;
     media_packet.pkt = std::move(received_packet);
 
-    // Try to recover the protected packet with current media packet.
-    UpdateConveringFecPackets(media_packet);
-
-    recovered_media_packets_[seq_num] = std::move(media_packet);
+    StoreMediaPacket(std::move(media_packet));
+}
 
-    DiscardOldRecoveredPackets();
+void FecDecoder::StoreMediaPacket(RecoveredMediaPacket media_packet) {
+    const uint16_t seq_num = media_packet.seq_num;
+    if (!newest_media_seq_num_ || wrap_around_utils::AheadOf<uint16_t>(seq_num, *newest_media_seq_num_)) {
+        newest_media_seq_num_ = seq_num;
+    }
+    media_packets_[seq_num % kMediaWindowSize] = std::move(media_packet);
+    UpdateCoveringFecPackets(seq_num);
 }
 
-void FecDecoder::UpdateConveringFecPackets(const RecoveredMediaPacket& recovered_packet) {
-    for (auto& fec_packet : received_fec_packets_) {
-        // Find the packet has the same sequence number as the recovered packet.
-        auto protected_it = fec_packet.second.protected_media_packets.find(recovered_packet.seq_num);
-        // This FEC packet is protecting the recovered media packet.
-        if (protected_it != fec_packet.second.protected_media_packets.end()) {
-            protected_it->second.pkt = recovered_packet.pkt;
+void FecDecoder::UpdateCoveringFecPackets(uint16_t seq_num) {
+    for (uint64_t slots = used_fec_slots_; slots != 0; slots &= slots - 1) {
+        const size_t slot = utils::numeric::count_trailing_zeros(slots);
+        auto& fec_packet = fec_packets_[slot];
+        if (IsOldFecPacket(fec_packet)) {
+            RemoveFecPacket(slot);
+            continue;
+        }
+        const uint16_t offset = static_cast<uint16_t>(seq_num - fec_packet.fec_header.seq_num_base);
+        // This FEC packet is protecting the media packet.
+        if (offset < kMaxProtectedMediaPackets && fec_packet.missing_mask.test(offset)) {
+            fec_packet.missing_mask.reset(offset);
+            --fec_packet.num_missing_packets;
+            if (fec_packet.num_missing_packets == 1) {
+                recoverable_fec_slots_ |= uint64_t{1} << slot;
+            } else if (fec_packet.num_missing_packets == 0) {
+                // All the protected packets are received or recovered.
+                RemoveFecPacket(slot);
+            }
         }
     }
 }
 
-void FecDecoder::DiscardOldRecoveredPackets() {
-    const size_t max_media_packets = fec_header_reader_->max_media_packets();
-    auto it = recovered_media_packets_.begin();
-    // NOTE: We can't use `lower_bound` here, since there is not guarantee about
-    // all the packet in recovered packets are continuous.
-    // Furthermore, the measurement of discarding old packet is based on packet count
-    // not sequence number age.
-    while (recovered_media_packets_.size() > max_media_packets) {
-        it = recovered_media_packets_.erase(it);
+void FecDecoder::DiscardOldFecPackets(uint32_t fec_ssrc, uint16_t seq_num) {
+    // Discard old FEC packets such that the sequence numbers of the FEC packets
+    // span at most 1/2 of the sequence number space, which reduces the possiblity
+    // of incorrect decoding due to sequence number wrap-around.
+    for (uint64_t slots = used_fec_slots_; slots != 0; slots &= slots - 1) {
+        const size_t slot = utils::numeric::count_trailing_zeros(slots);
+        const auto& fec_packet = fec_packets_[slot];
+        // It only makes sense to detect wrap-around when the FEC packets
+        // belong to the same sequence number space. i.e., the same SSRC.
+        if (fec_packet.ssrc == fec_ssrc && MinDiff<uint16_t>(seq_num, fec_packet.seq_num) > kOldSequenceThreshold) {
+            RemoveFecPacket(slot);
+        }
     }
 }
 
-void FecDecoder::DiscardOldReceivedFecPackets() {
-    const size_t max_fec_packets = fec_header_reader_->max_fec_packets();
-    auto it = received_fec_packets_.begin();
-    while (received_fec_packets_.size() > max_fec_packets) {
-        it = received_fec_packets_.erase(it);
-    }
+void FecDecoder::RemoveFecPacket(size_t slot) {
+    const uint64_t slot_bit = uint64_t{1} << slot;
+    assert((used_fec_slots_ & slot_bit) != 0);
+    used_fec_slots_ &= ~slot_bit;
+    recoverable_fec_slots_ &= ~slot_bit;
+    // Release the buffer.
+    fec_packets_[slot] = FecPacket();
 }
 
 void FecDecoder::TryToRecover() {
-    auto fec_packet_it = received_fec_packets_.begin();
-    while (fec_packet_it != received_fec_packets_.end()) {
-        // The number packets that we need to recover of each FEC packet.
-        int num_packets_to_recover = NumPacketsToRecover(fec_packet_it->second);
-        // We can only recover one packet with an FEC packet.
-        if (num_packets_to_recover == 1) {
-            auto recovered_media_packet_op = RecoverPacket(fec_packet_it->second);
-            // We can't recover using this FEC packet, drop it.
-            if (!recovered_media_packet_op) {
-                fec_packet_it = received_fec_packets_.erase(fec_packet_it);
-                continue;
-            }
-
-            // Add recovered packet to the list of recovered packets.
-            auto [it, success] = recovered_media_packets_.insert({recovered_media_packet_op->seq_num, std::move(*recovered_media_packet_op)});
-
-            // Update any FEC packets covering this recovered packet.
-            UpdateConveringFecPackets(it->second);
-            DiscardOldRecoveredPackets();
-            
-            // Remove the FEC packet after recovery.
-            fec_packet_it = received_fec_packets_.erase(fec_packet_it);
-
-            // A packet has been recovered. We need to check the FEC list again, as
-            // this may allow additional packets to be recovered.
-            // Restart for first FEC packet.
-            fec_packet_it = received_fec_packets_.begin();
+    // A recovered packet may make the other FEC packets recoverable.
+    while (recoverable_fec_slots_ != 0) {
+        const size_t slot = utils::numeric::count_trailing_zeros(recoverable_fec_slots_);
+        auto recovered_media_packet = RecoverPacket(fec_packets_[slot]);
+        // Remove the FEC packet after recovery, or if we can't recover using it.
+        RemoveFecPacket(slot);
+        if (!recovered_media_packet) {
+            continue;
+        }
 
-            // Send the recovered media packet to VCM
-            if (packet_recovered_callback_ && it->second.was_recovered) {
-                packet_recovered_callback_(it->second);
-            }
+        const uint16_t seq_num = recovered_media_packet->seq_num;
+        // Add recovered packet to the window, and update any FEC packets covering it.
+        StoreMediaPacket(std::move(*recovered_media_packet));
 
-        } else if (num_packets_to_recover == 0 || IsOldFecPacket(fec_packet_it->second)) {
-            // Either all protected packets arrived or have beed recovered, or the FEC
-            // packet is old. We can discard this FEC packet.
-            fec_packet_it = received_fec_packets_.erase(fec_packet_it);
-        } else {
-            ++fec_packet_it;
+        // Send the recovered media packet to VCM
+        const RecoveredMediaPacket* media_packet = FindMediaPacket(seq_num);
+        if (packet_recovered_callback_ && media_packet) {
+            packet_recovered_callback_(*media_packet);
         }
     }
 }
 
 std::optional<FecDecoder::RecoveredMediaPacket> FecDecoder::RecoverPacket(const FecPacket& fec_packet) {
+    assert(fec_packet.num_missing_packets == 1);
     auto recovered_packet = PreparePacketForRecovery(fec_packet);
     if (!recovered_packet) {
         return std::nullopt;
     }
     // The recovered packet with payload of `fec_packet` do Xor operation
     // with the protected packet in `fec_packet` to recover itself.
-    for (const auto& [seq_num, protected_packet] : fec_packet.protected_media_packets) {
+    for (size_t offset = 0; offset <= fec_packet.last_protected_offset; ++offset) {
+        if (!fec_packet.protected_mask.test(offset)) {
+            continue;
+        }
+        const uint16_t seq_num = static_cast<uint16_t>(fec_packet.fec_header.seq_num_base + offset);
         // This is the packet we're recovering, since we can only recovery one pakcet,
-        // in ohter words, all the packets except the recovering one are has pkt already.
-        if (protected_packet.pkt.empty()) {
+        // in ohter words, all the other packets are received or recovered already.
+        if (fec_packet.missing_mask.test(offset)) {
             recovered_packet->seq_num = seq_num;
             recovered_packet->ssrc = fec_packet.protected_ssrc;
-        } else {
-            size_t length_recovery = protected_packet.pkt.size() - kRtpHeaderSize;
-            XorHeader(protected_packet.pkt, length_recovery, recovered_packet->pkt);
-            XorPayload(kRtpHeaderSize, length_recovery, protected_packet.pkt, kRtpHeaderSize, recovered_packet->pkt);
+            continue;
         }
+        const RecoveredMediaPacket* protected_packet = FindMediaPacket(seq_num);
+        // The protected packet has been dropped from the window since.
+        if (!protected_packet) {
+            return std::nullopt;
+        }
+        size_t length_recovery = protected_packet->pkt.size() - kRtpHeaderSize;
+        XorHeader(protected_packet->pkt, length_recovery, recovered_packet->pkt);
+        XorPayload(kRtpHeaderSize, length_recovery, protected_packet->pkt, kRtpHeaderSize, recovered_packet->pkt);
     }
 
     if(!FinishPacketForRecovery(recovered_packet.value())) {
@@ -355,32 +362,28 @@ bool FecDecoder::FinishPacketForRecovery(RecoveredMediaPacket& recovered_packet)
     return true;
 }
 
-size_t FecDecoder::NumPacketsToRecover(const FecPacket& fec_packet) const {
-    size_t packets_to_recover = 0;
-    for (const auto& protected_packet : fec_packet.protected_media_packets) {
-        // Count the packet we need to recover.
-        if (protected_packet.second.pkt.empty()) {
-            ++packets_to_recover;
-            // We can't recover more than one packet.
-            if (packets_to_recover > 1) {
-                break;
-            }
-        }
+const FecDecoder::RecoveredMediaPacket* FecDecoder::FindMediaPacket(uint16_t seq_num) const {
+    const auto& media_packet = media_packets_[seq_num % kMediaWindowSize];
+    if (!media_packet || media_packet->seq_num != seq_num) {
+        return nullptr;
     }
-    return packets_to_recover;
+    // Only the latest |max_media_packets| packets are tracked.
+    const uint16_t age = static_cast<uint16_t>(*newest_media_seq_num_ - seq_num);
+    if (age > fec_header_reader_->max_media_packets()) {
+        return nullptr;
+    }
+    return &media_packet.value();
 }
 
 bool FecDecoder::IsOldFecPacket(const FecPacket& fec_packet) const {
-    if (recovered_media_packets_.empty()) {
+    if (!newest_media_seq_num_) {
         return false;
     }
-
-    const uint16_t last_recovered_seq_num = recovered_media_packets_.rbegin()->first;
-    const uint16_t last_protected_seq_num = fec_packet.protected_media_packets.rbegin()->first;
-
-    // `fec_packet` is old if its `last_protected_seq_num` is much older
-    // than `last_recovered_seq_num`.
-    return MinDiff(last_recovered_seq_num, last_protected_seq_num) > kOldSequenceThreshold;
+    const uint16_t last_protected_seq_num = static_cast<uint16_t>(fec_packet.fec_header.seq_num_base + fec_packet.last_protected_offset);
+    // `fec_packet` is old if the packets it protects are out of the window of
+    // the tracked media packets, then they are not able to recover the missing one.
+    return wrap_around_utils::AheadOf<uint16_t>(*newest_media_seq_num_, last_protected_seq_num) &&
+           static_cast<uint16_t>(*newest_media_seq_num_ - last_protected_seq_num) > fec_header_reader_->max_media_packets();
 }
     
 } // namespace naivertc
\ No newline at end of file
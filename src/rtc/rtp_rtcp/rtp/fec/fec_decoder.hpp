@@ -6,15 +6,23 @@
 #include "rtc/rtp_rtcp/rtp/fec/fec_defines.hpp"
 #include "rtc/rtp_rtcp/components/wrap_around_utils.hpp"
 #include "rtc/rtp_rtcp/rtp/fec/ulp/fec_header_reader_ulp.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/flex/fec_header_reader_flex.hpp"
 
-#include <map>
+#include <array>
+#include <bitset>
 #include <memory>
 #include <functional>
+#include <optional>
 
 namespace naivertc {
 
 class FecDecoder : public FecCodec {
 public:
+    // The maximum number of media packets a FEC packet can protect, given
+    // the largest packet mask of FlexFEC.
+    static constexpr size_t kMaxProtectedMediaPackets = 8 * kFlexFecPacketMaskSizeKBit2Set;
+    using PacketMask = std::bitset<kMaxProtectedMediaPackets>;
+
     // MediaPacket
     struct MediaPacket {
         uint32_t ssrc = 0;
@@ -22,7 +30,6 @@ public:
 
         CopyOnWriteBuffer pkt;
     };
-    using ProtectedMediaPackets = std::map<uint16_t, MediaPacket, wrap_around_utils::OlderThan<uint16_t>>;
 
     // FecPacket
     struct FecPacket {
@@ -38,10 +45,17 @@ public:
         // FEC header + payload
         CopyOnWriteBuffer pkt;
 
-        // List of media packets that this FEC packet protects.
-        ProtectedMediaPackets protected_media_packets;
+        // The media packets this FEC packet protects, and the ones of them
+        // still missing, with the bit i standing for the sequence number
+        // `fec_header.seq_num_base + i`.
+        PacketMask protected_mask;
+        PacketMask missing_mask;
+        size_t num_missing_packets = 0;
+        // The offset of the newest protected media packet.
+        size_t last_protected_offset = 0;
+        // The order of arrival, used to evict the oldest FEC packet.
+        uint64_t arrival_order = 0;
     };
-    using ReceivedFecPackets = std::map<uint16_t, FecPacket, wrap_around_utils::OlderThan<uint16_t>>;
 
     // RecoveredMediaPacket 
     struct RecoveredMediaPacket : public MediaPacket {
@@ -50,10 +64,10 @@ public:
         // through the received packet list.
         bool was_recovered;
     };
-    using RecoveredMediaPackets = std::map<uint16_t, RecoveredMediaPacket, wrap_around_utils::OlderThan<uint16_t>>;
 
     // Convenient API to create FEC decoder.
     static std::unique_ptr<FecDecoder> CreateUlpFecDecoder(uint32_t ssrc);
+    static std::unique_ptr<FecDecoder> CreateFlexFecDecoder(uint32_t fec_ssrc, uint32_t protected_media_ssrc);
     
 public:
     ~FecDecoder() override;
@@ -68,29 +82,46 @@ public:
 private:
     FecDecoder(uint32_t fec_ssrc, uint32_t protected_media_ssrc, std::unique_ptr<FecHeaderReader> fec_header_reader);
 
-    void InsertPacket(uint32_t fec_ssrc, uint16_t seq_num, bool is_fec, CopyOnWriteBuffer received_packet);
     void InsertFecPacket(uint32_t fec_ssrc, uint16_t seq_num, CopyOnWriteBuffer received_packet);
     void InsertMediaPacket(uint32_t media_ssrc, uint16_t seq_num, CopyOnWriteBuffer received_packet);
+    void StoreMediaPacket(RecoveredMediaPacket media_packet);
 
-    void UpdateConveringFecPackets(const RecoveredMediaPacket& recovered_packet);
-    void DiscardOldRecoveredPackets();
-    void DiscardOldReceivedFecPackets();
+    // Clears the bit of the media packet in the masks of the FEC packets
+    // protecting it, and marks the ones missing one packet as recoverable.
+    void UpdateCoveringFecPackets(uint16_t seq_num);
+    void DiscardOldFecPackets(uint32_t fec_ssrc, uint16_t seq_num);
+    void RemoveFecPacket(size_t slot);
 
-    size_t NumPacketsToRecover(const FecPacket& fec_packet) const;
     void TryToRecover();
     std::optional<RecoveredMediaPacket> RecoverPacket(const FecPacket& fec_packet);
     std::optional<RecoveredMediaPacket> PreparePacketForRecovery(const FecPacket& fec_packet);
     bool FinishPacketForRecovery(RecoveredMediaPacket& recovered_packet);
 
+    // Returns the media packet if it is still in the window of the tracked media packets.
+    const RecoveredMediaPacket* FindMediaPacket(uint16_t seq_num) const;
     bool IsOldFecPacket(const FecPacket& fec_packet) const;
     
 private:
+    // The ring of the media packets, indexed by the sequence number, which is
+    // large enough to hold |kMaxTrackedMediaPackets| packets.
+    static constexpr size_t kMediaWindowSize = 256;
+    static_assert(kMediaWindowSize > kMaxTrackedMediaPackets, "The media window is too small.");
+    static_assert(kMediaWindowSize > kMaxProtectedMediaPackets, "The media window is too small.");
+    static_assert(kMaxFecPackets <= 64, "The FEC slots are tracked by 64 bits masks.");
+
     const uint32_t fec_ssrc_;
     const uint32_t protected_media_ssrc_;
     std::unique_ptr<FecHeaderReader> fec_header_reader_;
 
-    ReceivedFecPackets received_fec_packets_;
-    RecoveredMediaPackets recovered_media_packets_;
+    std::array<std::optional<RecoveredMediaPacket>, kMediaWindowSize> media_packets_;
+    std::optional<uint16_t> newest_media_seq_num_;
+
+    std::array<FecPacket, kMaxFecPackets> fec_packets_;
+    // The bits of the slots in |fec_packets_| in use.
+    uint64_t used_fec_slots_ = 0;
+    // The bits of the FEC packets missing exactly one protected packet.
+    uint64_t recoverable_fec_slots_ = 0;
+    uint64_t next_fec_arrival_order_ = 0;
 
     PacketRecoveredCallback packet_recovered_callback_ = nullptr;
 };
@@ -38,6 +38,22 @@ constexpr size_t kMaxTrackedMediaPackets = 4 * kUlpFecMaxMediaPackets; // 192
 static constexpr size_t kUlpFecMinPacketMaskSize = kUlpFecPacketMaskSizeLBitClear;
 static constexpr size_t kUlpFecMaxPacketMaskSize = kUlpFecPacketMaskSizeLBitSet;
 
+// Packet mask size in bytes (given K bits) of FlexFEC.
+// See https://datatracker.ietf.org/doc/html/draft-ietf-payload-flexible-fec-scheme-03#section-4.2
+static constexpr size_t kFlexFecPacketMaskSizeKBit0Set = 2;
+static constexpr size_t kFlexFecPacketMaskSizeKBit1Set = 6;
+static constexpr size_t kFlexFecPacketMaskSizeKBit2Set = 14;
+
+// FlexFEC header size in bytes (without the packet mask).
+static constexpr size_t kFlexFecBaseHeaderSize = 12;
+// SSRC + SN base of the only one protected stream.
+static constexpr size_t kFlexFecStreamSpecificHeaderSize = 6;
+static constexpr size_t kFlexFecPacketMaskOffset = kFlexFecBaseHeaderSize + kFlexFecStreamSpecificHeaderSize; // 18
+
+// Maximum number of media packets protected by one block of the Reed-Solomon
+// FEC, which is not limited by the packet masks but by the decoding cost.
+static constexpr size_t kRsFecMaxMediaPackets = 64;
+
 // Packet code mask maximum length. kFECPacketMaskMaxSize = kUlpFecMaxMediaPackets * (kUlpFecMaxMediaPackets / 8),
 static constexpr size_t kFECPacketMaskMaxSize = 288;
 
@@ -68,6 +84,23 @@ struct FecHeader {
     // `protection length` field is the same thing with 
     // `length recovery` in WebRTC ULP_FEC implement.
     size_t protection_length = 0;
+    // The media SSRC protected by the FEC packet, which is
+    // carried in FlexFEC header, and the same as the FEC
+    // SSRC in ULPFEC.
+    uint32_t protected_ssrc = 0;
+};
+
+// Packet counter of FEC receivers.
+struct FecPacketCounter {
+    // Number of received packets.
+    size_t num_received_packets = 0;
+    size_t num_received_bytes = 0;
+    // Number of received FEC packets.
+    size_t num_received_fec_packets = 0;
+    // Number of recovered media packets using FEC.
+    size_t num_recovered_packets = 0;
+    // Time in ms of the first packet is received.
+    int64_t first_packet_arrival_time_ms = -1;
 };
     
 } // namespace naivertc
@@ -1,10 +1,13 @@
 #include "rtc/rtp_rtcp/rtp/fec/fec_encoder.hpp"
 #include "rtc/rtp_rtcp/rtp/fec/ulp/fec_header_writer_ulp.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/flex/fec_header_writer_flex.hpp"
 #include "rtc/rtp_rtcp/base/rtp_rtcp_defines.hpp"
 #include "rtc/base/memory/byte_io_writer.hpp"
 
 #include <plog/Log.h>
 
+#include <algorithm>
+
 namespace naivertc {
 namespace internal {
 
@@ -50,6 +53,11 @@ std::unique_ptr<FecEncoder> FecEncoder::CreateUlpFecEncoder() {
     return std::unique_ptr<FecEncoder>(new FecEncoder(std::move(fec_header_writer)));
 }
 
+std::unique_ptr<FecEncoder> FecEncoder::CreateFlexFecEncoder() {
+    auto fec_header_writer = std::make_unique<FlexfecHeaderWriter>();
+    return std::unique_ptr<FecEncoder>(new FecEncoder(std::move(fec_header_writer)));
+}
+
 FecEncoder::FecEncoder(std::unique_ptr<FecHeaderWriter> fec_header_writer) 
     : fec_header_writer_(std::move(fec_header_writer)),
       packet_mask_generator_(std::make_unique<FecPacketMaskGenerator>()),
@@ -57,7 +65,7 @@ FecEncoder::FecEncoder(std::unique_ptr<FecHeaderWriter> fec_header_writer)
 
 FecEncoder::~FecEncoder() = default;
 
-bool FecEncoder::Encode(const PacketList& media_packets, 
+bool FecEncoder::Encode(PacketView media_packets, 
                         uint8_t protection_factor, 
                         size_t num_important_packets, 
                         bool use_unequal_protection, 
@@ -169,77 +177,92 @@ size_t FecEncoder::CalcNumFecPackets(size_t num_media_packets, uint8_t protectio
 //   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
 //   |              mask cont. (present only when L = 1)             |
 //   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-void FecEncoder::GenerateFecPayload(const PacketList& media_packets, 
+void FecEncoder::GenerateFecPayload(PacketView media_packets, 
                                     size_t num_fec_packets, 
                                     std::vector<CopyOnWriteBuffer>& generated_fec_packets) {
+    assert(num_fec_packets <= kMaxFecPackets);
+    const size_t media_header_size = kRtpHeaderSize;
+    const uint16_t first_seq_num = media_packets.front().sequence_number();
+    // The media packets beyond the packet mask are not protected.
+    const size_t num_mask_bits = packet_mask_size_ * 8;
+
+    size_t fec_header_sizes[kMaxFecPackets];
+    size_t max_protected_sizes[kMaxFecPackets];
+    bool is_first_protected_packet[kMaxFecPackets];
     for (size_t row = 0; row < num_fec_packets; ++row) {
-        CopyOnWriteBuffer& fec_packet = generated_fec_packets[row];
-        size_t pkt_mask_idx = row * packet_mask_size_;
-        const size_t min_packet_mask_size = fec_header_writer_->MinPacketMaskSize(&packet_masks_[pkt_mask_idx], packet_mask_size_);
-        const size_t fec_header_size = fec_header_writer_->FecHeaderSize(min_packet_mask_size);
-        const size_t media_header_size = kRtpHeaderSize;
-
-        size_t media_pkt_idx = 0;
-        size_t media_packet_payload_size = 0;
-        auto media_packets_it = media_packets.cbegin();
-        uint16_t prev_seq_num = media_packets_it->sequence_number();
-        while (media_packets_it != media_packets.end()) {
-            auto& media_packet = *media_packets_it;
-            // Rtp header extensons + csrcs + payload data
-            media_packet_payload_size = media_packet.size() - media_header_size;
-
-            // The current media packet is protected by FEC packets
-            if (packet_masks_[pkt_mask_idx] & (1 << (7 - media_pkt_idx))) {
-                bool is_first_protected_packet = (fec_packet.size() == 0);
-                size_t fec_packet_size = fec_header_size + media_packet_payload_size;
-                if (fec_packet_size > fec_packet.size()) {
-                    // The prior XORs are still correct after we expand the packet size.
-                    fec_packet.Resize(fec_packet_size);
-                }
-                
-                // Initialized the fec packet for the current row
-                // with the first protected media packet.
-                if (is_first_protected_packet) {
-                    const uint8_t* media_packet_data = media_packet.data();
-                    uint8_t* fec_packet_data = fec_packet.data();
-                    // Write fec header
-                    // Write P, X, CC, M, and PT recovery fields.
-                    // Note that bits 0, 1, and 16 are overwritten in FinalizeFecHeaders.
-                    memcpy(&fec_packet_data[0], &media_packet_data[0], 0x02);
-                    // Write length recovery field. (This is a temporary location for ULPFEC.)
-                    ByteWriter<uint16_t>::WriteBigEndian(&fec_packet_data[2], media_packet_payload_size);
-                    // Write timestamp recovery field
-                    memcpy(&fec_packet_data[4], &media_packet_data[4], 0x04);
-
-                    // Write payload
-                    if (media_packet_payload_size > 0) {
-                        memcpy(&fec_packet_data[fec_header_size], &media_packet_data[media_header_size], media_packet_payload_size);
-                    }
-                } else {
-                    XorHeader(media_packet, media_packet_payload_size, fec_packet);
-                    XorPayload(media_header_size, 
-                               media_packet_payload_size, 
-                               media_packet, 
-                               fec_header_size,
-                               fec_packet);
-                }
+        const size_t min_packet_mask_size = fec_header_writer_->MinPacketMaskSize(&packet_masks_[row * packet_mask_size_], packet_mask_size_);
+        fec_header_sizes[row] = fec_header_writer_->FecHeaderSize(min_packet_mask_size);
+        max_protected_sizes[row] = 0;
+        is_first_protected_packet[row] = true;
+    }
+
+    // Pre-size the FEC packets to the max protected length, so that no FEC
+    // packet will be resized while XORing.
+    for (const auto& media_packet : media_packets) {
+        // The missing media packets have been skipped by the packet masks.
+        const size_t media_bit_idx = static_cast<uint16_t>(media_packet.sequence_number() - first_seq_num);
+        if (media_bit_idx >= num_mask_bits) {
+            break;
+        }
+        // Rtp header extensons + csrcs + payload data
+        const size_t media_packet_payload_size = media_packet.size() - media_header_size;
+        for (size_t row = 0; row < num_fec_packets; ++row) {
+            if (IsProtectedBy(row, media_bit_idx)) {
+                max_protected_sizes[row] = std::max(max_protected_sizes[row], media_packet_payload_size);
             }
-            media_packets_it++;
-            if (media_packets_it != media_packets.end()) {
-                uint16_t curr_seq_num = media_packets_it->sequence_number();
-                // Skip the missing media packets
-                media_pkt_idx += curr_seq_num - prev_seq_num;
-                prev_seq_num = curr_seq_num;
+        }
+    }
+    for (size_t row = 0; row < num_fec_packets; ++row) {
+        // The bytes beyond the shorter protected packets are zero initialized.
+        generated_fec_packets[row] = CopyOnWriteBuffer(fec_header_sizes[row] + max_protected_sizes[row]);
+    }
+
+    for (const auto& media_packet : media_packets) {
+        const size_t media_bit_idx = static_cast<uint16_t>(media_packet.sequence_number() - first_seq_num);
+        if (media_bit_idx >= num_mask_bits) {
+            break;
+        }
+        const size_t media_packet_payload_size = media_packet.size() - media_header_size;
+        for (size_t row = 0; row < num_fec_packets; ++row) {
+            if (!IsProtectedBy(row, media_bit_idx)) {
+                continue;
+            }
+            CopyOnWriteBuffer& fec_packet = generated_fec_packets[row];
+            // Initialized the fec packet for the current row
+            // with the first protected media packet.
+            if (is_first_protected_packet[row]) {
+                is_first_protected_packet[row] = false;
+                const uint8_t* media_packet_data = media_packet.data();
+                uint8_t* fec_packet_data = fec_packet.data();
+                // Write fec header
+                // Write P, X, CC, M, and PT recovery fields.
+                // Note that bits 0, 1, and 16 are overwritten in FinalizeFecHeaders.
+                memcpy(&fec_packet_data[0], &media_packet_data[0], 0x02);
+                // Write length recovery field. (This is a temporary location for ULPFEC.)
+                ByteWriter<uint16_t>::WriteBigEndian(&fec_packet_data[2], media_packet_payload_size);
+                // Write timestamp recovery field
+                memcpy(&fec_packet_data[4], &media_packet_data[4], 0x04);
+
+                // Write payload
+                if (media_packet_payload_size > 0) {
+                    memcpy(&fec_packet_data[fec_header_sizes[row]], &media_packet_data[media_header_size], media_packet_payload_size);
+                }
+            } else {
+                XorHeader(media_packet, media_packet_payload_size, fec_packet);
+                XorPayload(media_header_size, 
+                           media_packet_payload_size, 
+                           media_packet, 
+                           fec_header_sizes[row],
+                           fec_packet);
             }
-            // Mask byte offset
-            pkt_mask_idx += media_pkt_idx / 8;
-            // Bit offset in mask byte
-            media_pkt_idx %= 8;
         }
-        assert(fec_packet.size() > 0 && "Not fec packets was generated.");
     }
 }
 
+bool FecEncoder::IsProtectedBy(size_t row, size_t media_bit_idx) const {
+    return packet_masks_[row * packet_mask_size_ + media_bit_idx / 8] & (1 << (7 - media_bit_idx % 8));
+}
+
 void FecEncoder::FinalizeFecHeaders(size_t packet_mask_size, 
                                     uint32_t media_ssrc, 
                                     uint16_t seq_num_base, 
@@ -254,7 +277,7 @@ void FecEncoder::FinalizeFecHeaders(size_t packet_mask_size,
     }
 }
 
-ssize_t FecEncoder::InsertZeroInPacketMasks(const PacketList& media_packets, size_t num_fec_packets) {
+ssize_t FecEncoder::InsertZeroInPacketMasks(PacketView media_packets, size_t num_fec_packets) {
     size_t num_media_packets = media_packets.size();
     // FIXME: Why is not num_media_packets == 0?
     if (num_media_packets <= 1) {
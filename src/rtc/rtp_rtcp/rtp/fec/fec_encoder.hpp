@@ -8,8 +8,6 @@
 #include "rtc/rtp_rtcp/rtp/fec/fec_header_writer.hpp"
 #include "rtc/rtp_rtcp/rtp/fec/fec_mask_generator.hpp"
 
-#include <list>
-
 namespace naivertc {
 
 // NOTE: This class is not thread safe, the caller must provide that.
@@ -18,8 +16,10 @@ public:
     // Using static Create method to make sure the FEC coder is unique, 
     // and not allowed to share with others
     static std::unique_ptr<FecEncoder> CreateUlpFecEncoder();
+    static std::unique_ptr<FecEncoder> CreateFlexFecEncoder();
 
-    using PacketList = std::list<RtpPacket>;
+    using PacketList = std::vector<RtpPacket>;
+    using PacketView = ArrayView<const RtpPacket>;
     using FecPacketList = std::vector<CopyOnWriteBuffer>;
 public:
     ~FecEncoder() override;
@@ -42,7 +42,7 @@ public:
      *      The bursty type is only defined up to 12 media packets. If the number of media packets is
      *      above 12, the packet masks from the random table will be selected.
     */
-    bool Encode(const PacketList& media_packets, 
+    bool Encode(PacketView media_packets, 
                 uint8_t protection_factor, 
                 size_t num_important_packets, 
                 bool use_unequal_protection, 
@@ -64,9 +64,14 @@ protected:
     FecEncoder(std::unique_ptr<FecHeaderWriter> fec_header_writer);
 
 private:
-    ssize_t InsertZeroInPacketMasks(const PacketList& media_packets, size_t num_fec_packets);
+    ssize_t InsertZeroInPacketMasks(PacketView media_packets, size_t num_fec_packets);
+
+    bool IsProtectedBy(size_t row, size_t media_bit_idx) const;
 
-    void GenerateFecPayload(const PacketList& media_packets, 
+    // Generates the FEC packets by walking the media packets once, each media
+    // packet is XORed into all the FEC packets protecting it while its bytes
+    // are still in cache.
+    void GenerateFecPayload(PacketView media_packets, 
                             size_t num_fec_packets, 
                             std::vector<CopyOnWriteBuffer>& generated_fec_packets);
 
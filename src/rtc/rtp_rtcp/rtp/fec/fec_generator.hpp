@@ -13,7 +13,8 @@ class FecGenerator {
 public:
     enum class FecType {
         ULP_FEC,
-        FLEX_FEC
+        FLEX_FEC,
+        RS_FEC
     };
 
 public:
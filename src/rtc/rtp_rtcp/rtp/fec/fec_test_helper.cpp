@@ -1,5 +1,7 @@
 #include "rtc/rtp_rtcp/rtp/fec/fec_test_helper.hpp"
 
+#include <algorithm>
+
 namespace naivertc {
 namespace test {
 namespace {
@@ -24,14 +26,19 @@ void RtpPacketGenerator::NewFrame(size_t num_packets) {
 
 RtpPacket RtpPacketGenerator::NextRtpPacket(size_t payload_size, size_t padding_size) {
     RtpPacket rtp_packet;
-    rtp_packet.Resize(kRtpHeaderSize + payload_size);
-
     rtp_packet.set_marker(num_packets_left_ == 1);
     rtp_packet.set_payload_type(payload_type_);
     rtp_packet.set_timestamp(timestamp_);
     rtp_packet.set_sequence_number(seq_num_);
     rtp_packet.set_ssrc(ssrc_);
 
+    // Fill the payload with bytes varying by packet, so that the FEC
+    // packets are not all zeros.
+    uint8_t* payload = rtp_packet.AllocatePayload(payload_size);
+    for (size_t i = 0; i < payload_size; ++i) {
+        payload[i] = static_cast<uint8_t>(seq_num_ + i);
+    }
+
     rtp_packet.SetPadding(padding_size);
 
     ++seq_num_;
@@ -93,5 +100,19 @@ RtpPacketReceived UlpFecPacketGenerator::BuildUlpFecRedPacket(const CopyOnWriteB
 
 }
 
+// LossChannel
+LossChannel::LossChannel(double loss_fraction, double mean_burst_length, uint32_t seed)
+    : good_to_bad_(loss_fraction / (1 - loss_fraction) / std::max(mean_burst_length, 1 / (1 - loss_fraction))),
+      bad_to_good_(1 / std::max(mean_burst_length, 1 / (1 - loss_fraction))),
+      random_(seed) {}
+
+LossChannel::~LossChannel() {}
+
+bool LossChannel::Lost() {
+    std::uniform_real_distribution<double> dis;
+    bad_ = bad_ ? dis(random_) >= bad_to_good_ : dis(random_) < good_to_bad_;
+    return bad_;
+}
+
 } // namespace test
 } // namespace naivert 
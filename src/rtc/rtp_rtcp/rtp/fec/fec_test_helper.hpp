@@ -6,6 +6,8 @@
 #include "common/utils_random.hpp"
 #include "rtc/rtp_rtcp/rtp/packets/rtp_packet_received.hpp"
 
+#include <random>
+
 namespace naivertc {
 namespace test {
 
@@ -49,6 +51,23 @@ private:
     uint8_t red_payload_type_;
 };
 
+// LossChannel
+// Gilbert-Elliott channel, which loses all the packets in the bad state.
+// The loss is random with the shortest mean burst length 1 / (1 - loss).
+class LossChannel {
+public:
+    LossChannel(double loss_fraction, double mean_burst_length, uint32_t seed = 0x1234);
+    ~LossChannel();
+
+    bool Lost();
+
+private:
+    const double good_to_bad_;
+    const double bad_to_good_;
+    std::mt19937 random_;
+    bool bad_ = false;
+};
+
 } // namespace test
 } // namespace naivertc
 
@@ -1,28 +1,81 @@
 #include "rtc/rtp_rtcp/rtp/fec/flex/fec_generator_flex.hpp"
+#include "rtc/rtp_rtcp/base/rtp_rtcp_defines.hpp"
+#include "common/utils_random.hpp"
+
+#include <plog/Log.h>
 
 namespace naivertc {
+namespace {
+
+constexpr uint16_t kMaxInitRtpSeqNumber = 32767;  // 2^15 - 1
+// The FlexFEC stream uses the same clock rate as the video stream.
+constexpr int64_t kMsToRtpTimestamp = kVideoPayloadTypeFrequency / 1000;
+    
+} // namespace
 
 FlexfecGenerator::FlexfecGenerator(int payload_type,
                                    uint32_t ssrc,
-                                   uint32_t protected_media_ssrc) 
+                                   uint32_t protected_media_ssrc,
+                                   Clock* clock) 
     : payload_type_(payload_type),
       ssrc_(ssrc),
-      protected_media_ssrc_(protected_media_ssrc) {}
+      protected_media_ssrc_(protected_media_ssrc),
+      clock_(clock),
+      timestamp_offset_(utils::random::generate_random<uint32_t>()),
+      seq_num_(utils::random::random<uint16_t>(1, kMaxInitRtpSeqNumber)),
+      ulp_fec_generator_(-1 /* No RED */, payload_type, FecEncoder::CreateFlexFecEncoder()) {}
 
 FlexfecGenerator::~FlexfecGenerator() = default;
 
 size_t FlexfecGenerator::MaxPacketOverhead() const {
-    return 0;
+    return ulp_fec_generator_.MaxPacketOverhead();
 }
 
 void FlexfecGenerator::SetProtectionParameters(const FecProtectionParams& delta_params, 
-                                               const FecProtectionParams& key_params) {}
+                                               const FecProtectionParams& key_params) {
+    ulp_fec_generator_.SetProtectionParameters(delta_params, key_params);
+}
 
-void FlexfecGenerator::PushMediaPacket(RtpPacketToSend packet) {}
+void FlexfecGenerator::PushMediaPacket(RtpPacketToSend packet) {
+    if (packet.ssrc() != protected_media_ssrc_) {
+        PLOG_WARNING << "Media packet with SSRC=" << packet.ssrc() 
+                     << " is not protected by the FlexFEC stream.";
+        return;
+    }
+    ulp_fec_generator_.PushMediaPacket(std::move(packet));
+}
 
 std::vector<RtpPacketToSend> FlexfecGenerator::PopFecPackets() {
-    std::vector<RtpPacketToSend> fec_packets; 
-    return fec_packets;
+    std::vector<RtpPacketToSend> fec_packets_to_send;
+    const auto& generated_fec_packets = ulp_fec_generator_.generated_fec_packets();
+    if (generated_fec_packets.empty()) {
+        return fec_packets_to_send;
+    }
+    fec_packets_to_send.reserve(generated_fec_packets.size());
+    // The FEC packets generated by the encoder don't have RTP headers,
+    // so we create a new RTP header of the FlexFEC stream for each one.
+    const uint32_t timestamp = timestamp_offset_ + static_cast<uint32_t>(kMsToRtpTimestamp * clock_->now_ms());
+    for (const auto& fec_packet : generated_fec_packets) {
+        RtpPacketToSend fec_packet_to_send(kIpPacketSize);
+        fec_packet_to_send.set_payload_type(payload_type_);
+        fec_packet_to_send.set_sequence_number(seq_num_++);
+        fec_packet_to_send.set_timestamp(timestamp);
+        fec_packet_to_send.set_ssrc(ssrc_);
+
+        uint8_t* payload = fec_packet_to_send.set_payload_size(fec_packet.size());
+        assert(payload != nullptr);
+        memcpy(payload, fec_packet.cdata(), fec_packet.size());
+
+        fec_packet_to_send.set_packet_type(RtpPacketType::FEC);
+        fec_packet_to_send.set_allow_retransmission(false);
+        fec_packet_to_send.set_fec_protection_need(false);
+        fec_packet_to_send.set_red_protection_need(false);
+        fec_packets_to_send.push_back(std::move(fec_packet_to_send));
+    }
+
+    ulp_fec_generator_.Reset();
+
+    return fec_packets_to_send;
 }
     
 } // namespace naivertc
@@ -2,16 +2,23 @@
 #define _RTC_RTP_RTCP_FEC_FLEX_FEC_GENERATOR_H_
 
 #include "base/defines.hpp"
+#include "rtc/base/time/clock.hpp"
 #include "rtc/rtp_rtcp/rtp/fec/fec_generator.hpp"
 #include "rtc/rtp_rtcp/rtp/fec/fec_defines.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/ulp/fec_generator_ulp.hpp"
 
 namespace naivertc {
 
+// The FlexFEC packets are sent in a separate stream with its own SSRC
+// and sequence number space, and the media packets are batched in the
+// same way as ULPFEC, but encoded with the FlexFEC header.
+// NOTE: This class is not thread safe, the caller MUST provide that.
 class FlexfecGenerator : public FecGenerator {
 public:
     FlexfecGenerator(int payload_type,
                      uint32_t ssrc,
-                     uint32_t protected_media_ssrc);
+                     uint32_t protected_media_ssrc,
+                     Clock* clock);
     ~FlexfecGenerator();
 
     FecType fec_type() const override { return FecGenerator::FecType::FLEX_FEC; };
@@ -32,9 +39,14 @@ private:
     const int payload_type_;
     const uint32_t ssrc_;
     const uint32_t protected_media_ssrc_;
+    Clock* const clock_;
+    const uint32_t timestamp_offset_;
+
+    uint16_t seq_num_;
+    UlpFecGenerator ulp_fec_generator_;
 };
     
 } // namespace naivertc
 
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,142 @@
+#include "rtc/rtp_rtcp/rtp/fec/flex/fec_header_reader_flex.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/fec_defines.hpp"
+#include "rtc/base/memory/byte_io_reader.hpp"
+#include "rtc/base/memory/byte_io_writer.hpp"
+
+#include <plog/Log.h>
+
+namespace naivertc {
+
+FlexfecHeaderReader::FlexfecHeaderReader() 
+    : FecHeaderReader(kMaxTrackedMediaPackets, kMaxFecPackets) {}
+
+FlexfecHeaderReader::~FlexfecHeaderReader() = default;
+
+size_t FlexfecHeaderReader::FecHeaderSize(size_t packet_mask_size) const {
+    if (packet_mask_size <= kFlexFecPacketMaskSizeKBit0Set) {
+        return kFlexFecPacketMaskOffset + kFlexFecPacketMaskSizeKBit0Set;
+    } else if (packet_mask_size <= kFlexFecPacketMaskSizeKBit1Set) {
+        return kFlexFecPacketMaskOffset + kFlexFecPacketMaskSizeKBit1Set;
+    } else {
+        return kFlexFecPacketMaskOffset + kFlexFecPacketMaskSizeKBit2Set;
+    }
+}
+
+// https://datatracker.ietf.org/doc/html/draft-ietf-payload-flexible-fec-scheme-03#section-4.2
+// FlexFEC header, 20, 24 or 32 octets (given K bits).
+//    0                   1                   2                   3
+//    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |R|F|P|X|  CC   |M| PT recovery |        length recovery        |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |                          TS recovery                          |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |   SSRCCount   |                    reserved                   |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |                             SSRC_i                            |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |           SN base_i           |k|          Mask [0-14]        |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |k|                   Mask [15-45] (optional)                   |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |k|                                                             |
+//   +-+                   Mask [46-108] (optional)                  |
+//   |                                                               |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+bool FlexfecHeaderReader::ReadFecHeader(FecHeader& fec_header, CopyOnWriteBuffer& fec_packet) const {
+    if (fec_packet.size() <= kFlexFecPacketMaskOffset) {
+        PLOG_WARNING << "Truncated FlexFEC packet.";
+        return false;
+    }
+    uint8_t* data = fec_packet.data();
+    bool r_bit = (data[0] & 0x80) != 0;
+    if (r_bit) {
+        PLOG_WARNING << "FlexFEC packet with retransmission bit set is not supported.";
+        return false;
+    }
+    bool f_bit = (data[0] & 0x40) != 0;
+    if (f_bit) {
+        PLOG_WARNING << "FlexFEC packet with inflexible generator matrix is not supported.";
+        return false;
+    }
+    uint8_t ssrc_count = ByteReader<uint8_t>::ReadBigEndian(&data[8]);
+    if (ssrc_count != 1) {
+        PLOG_WARNING << "FlexFEC packet protecting " << static_cast<int>(ssrc_count) 
+                     << " media SSRCs is not supported.";
+        return false;
+    }
+    uint32_t protected_ssrc = ByteReader<uint32_t>::ReadBigEndian(&data[12]);
+    uint16_t seq_num_base = ByteReader<uint16_t>::ReadBigEndian(&data[16]);
+
+    // Parse the FlexFEC packet mask and remove the interleaved K bits.
+    // NOTE: The packed packet mask is stored in place, which "destroys"
+    // the standards compliance of the header. That is fine though, since
+    // FecDecoder reading the header from this point is aware of this.
+    if (fec_packet.size() < FecHeaderSize(kFlexFecPacketMaskSizeKBit0Set)) {
+        PLOG_WARNING << "Truncated FlexFEC packet.";
+        return false;
+    }
+    uint8_t* const packet_mask = data + kFlexFecPacketMaskOffset;
+    size_t packet_mask_size = 0;
+    bool k_bit0 = (packet_mask[0] & 0x80) != 0;
+    uint16_t mask_part0 = ByteReader<uint16_t>::ReadBigEndian(&packet_mask[0]);
+    // Shift away K-bit 0, implicitly clearing the last bit.
+    mask_part0 <<= 1;
+    ByteWriter<uint16_t>::WriteBigEndian(&packet_mask[0], mask_part0);
+    if (k_bit0) {
+        // The first K-bit is set, and the packet mask is thus only 2 bytes long.
+        packet_mask_size = kFlexFecPacketMaskSizeKBit0Set;
+    } else {
+        if (fec_packet.size() < FecHeaderSize(kFlexFecPacketMaskSizeKBit1Set)) {
+            PLOG_WARNING << "Truncated FlexFEC packet.";
+            return false;
+        }
+        bool k_bit1 = (packet_mask[2] & 0x80) != 0;
+        // The first two bytes of the packet mask have been shifted one step
+        // to the left, now we shift the next four bytes two steps to the left,
+        // one step for the removed K-bit 0, and one for the to be removed K-bit 1.
+        uint8_t bit15 = (packet_mask[2] >> 6) & 0x01;
+        packet_mask[1] |= bit15;
+        uint32_t mask_part1 = ByteReader<uint32_t>::ReadBigEndian(&packet_mask[2]);
+        // Shift away K-bit 1 and bit 15, implicitly clearing the last two bits.
+        mask_part1 <<= 2;
+        ByteWriter<uint32_t>::WriteBigEndian(&packet_mask[2], mask_part1);
+        if (k_bit1) {
+            // The second K-bit is set, and the packet mask is thus 6 bytes long.
+            packet_mask_size = kFlexFecPacketMaskSizeKBit1Set;
+        } else {
+            if (fec_packet.size() < FecHeaderSize(kFlexFecPacketMaskSizeKBit2Set)) {
+                PLOG_WARNING << "Truncated FlexFEC packet.";
+                return false;
+            }
+            bool k_bit2 = (packet_mask[6] & 0x80) != 0;
+            if (!k_bit2) {
+                PLOG_WARNING << "FlexFEC packet with malformed header, dropping.";
+                return false;
+            }
+            // The last K-bit is set, and the packet mask is thus 14 bytes long.
+            // Shift the next eight bytes three steps to the left, one step for
+            // each of the removed K-bits.
+            uint8_t tail_bits = (packet_mask[6] >> 5) & 0x03;
+            packet_mask[5] |= tail_bits;
+            uint64_t mask_part2 = ByteReader<uint64_t>::ReadBigEndian(&packet_mask[6]);
+            // Shift away K-bit 2, bit 46, and bit 47, implicitly clearing the last three bits.
+            mask_part2 <<= 3;
+            ByteWriter<uint64_t>::WriteBigEndian(&packet_mask[6], mask_part2);
+            packet_mask_size = kFlexFecPacketMaskSizeKBit2Set;
+        }
+    }
+
+    // Store the "ULPFECized" packet mask info.
+    fec_header.fec_header_size = FecHeaderSize(packet_mask_size);
+    fec_header.protected_ssrc = protected_ssrc;
+    fec_header.seq_num_base = seq_num_base;
+    fec_header.packet_mask_offset = kFlexFecPacketMaskOffset;
+    fec_header.packet_mask_size = packet_mask_size;
+    // In FlexFEC, all media packets are protected in their entirety.
+    fec_header.protection_length = fec_packet.size() - fec_header.fec_header_size;
+
+    return true;
+}
+    
+} // namespace naivertc
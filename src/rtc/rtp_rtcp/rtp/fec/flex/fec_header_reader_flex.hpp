@@ -0,0 +1,24 @@
+#ifndef _RTC_RTP_RTCP_RTP_FEC_FEC_HEADER_READER_FLEX_H_
+#define _RTC_RTP_RTCP_RTP_FEC_FEC_HEADER_READER_FLEX_H_
+
+#include "base/defines.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/fec_header_reader.hpp"
+
+namespace naivertc {
+
+// FlexFEC header reader, which removes the interleaved K bits
+// from the packet mask in place, so that the FEC packet can be
+// decoded as the same as the ULPFEC packet by FecDecoder.
+class FlexfecHeaderReader : public FecHeaderReader {
+public:
+    FlexfecHeaderReader();
+    ~FlexfecHeaderReader() override;
+
+    size_t FecHeaderSize(size_t packet_mask_size) const;
+
+    bool ReadFecHeader(FecHeader& fec_header, CopyOnWriteBuffer& fec_packet) const override;
+};
+
+} // namespace naivertc
+
+#endif
@@ -0,0 +1,130 @@
+#include "rtc/rtp_rtcp/rtp/fec/flex/fec_header_reader_flex.hpp"
+
+#include <gtest/gtest.h>
+
+#define ENABLE_UNIT_TESTS 0
+#include "testing/defines.hpp"
+
+#include <memory>
+
+namespace naivertc {
+namespace test {
+
+MY_TEST(FlexfecHeaderReaderTest, ReadFecHeaderWithKBit0Set) {
+    const uint8_t packet[] = {
+        0x00, 0x12, 0xab, 0xcd,  // R and F bits clear, "random" payload type and length recovery
+        0x12, 0x34, 0x56, 0x78,  // "random" TS recovery
+        0x01, 0x00, 0x00, 0x00,  // SSRCCount and reserved
+        0x01, 0x02, 0x03, 0x04,  // Protected SSRC
+        0x05, 0x06, 0x81, 0x02,  // SN base and packet mask with K bit 0 set
+
+        0x00, 0x00, 0x00, 0x00   // payload
+    };
+    const uint8_t expected_packet_mask[] = {0x02, 0x04};
+    CopyOnWriteBuffer fec_packet(packet, sizeof(packet));
+    FlexfecHeaderReader reader;
+    FecHeader fec_header;
+    EXPECT_TRUE(reader.ReadFecHeader(fec_header, fec_packet));
+
+    EXPECT_EQ(20u, fec_header.fec_header_size);
+    EXPECT_EQ(0x01020304u, fec_header.protected_ssrc);
+    EXPECT_EQ(0x0506u, fec_header.seq_num_base);
+    EXPECT_EQ(18u, fec_header.packet_mask_offset);
+    EXPECT_EQ(2u, fec_header.packet_mask_size);
+    EXPECT_EQ(4u, fec_header.protection_length);
+    EXPECT_EQ(0, memcmp(expected_packet_mask, fec_packet.data() + fec_header.packet_mask_offset, sizeof(expected_packet_mask)));
+    // The length recovery field is kept in place.
+    EXPECT_EQ(0xab, fec_packet.data()[2]);
+    EXPECT_EQ(0xcd, fec_packet.data()[3]);
+}
+
+MY_TEST(FlexfecHeaderReaderTest, ReadFecHeaderWithKBit1Set) {
+    const uint8_t packet[] = {
+        0x00, 0x12, 0xab, 0xcd,  // R and F bits clear, "random" payload type and length recovery
+        0x12, 0x34, 0x56, 0x78,  // "random" TS recovery
+        0x01, 0x00, 0x00, 0x00,  // SSRCCount and reserved
+        0x01, 0x02, 0x03, 0x04,  // Protected SSRC
+        0x05, 0x06, 0x01, 0x02,  // SN base and packet mask with K bit 0 clear
+        0xc4, 0x8d, 0x15, 0x9e,  // Packet mask with K bit 1 set and bit 15 set
+
+        0x00, 0x00, 0x00, 0x00   // payload
+    };
+    const uint8_t expected_packet_mask[] = {0x02, 0x05, 0x12, 0x34, 0x56, 0x78};
+    CopyOnWriteBuffer fec_packet(packet, sizeof(packet));
+    FlexfecHeaderReader reader;
+    FecHeader fec_header;
+    EXPECT_TRUE(reader.ReadFecHeader(fec_header, fec_packet));
+
+    EXPECT_EQ(24u, fec_header.fec_header_size);
+    EXPECT_EQ(0x01020304u, fec_header.protected_ssrc);
+    EXPECT_EQ(0x0506u, fec_header.seq_num_base);
+    EXPECT_EQ(18u, fec_header.packet_mask_offset);
+    EXPECT_EQ(6u, fec_header.packet_mask_size);
+    EXPECT_EQ(4u, fec_header.protection_length);
+    EXPECT_EQ(0, memcmp(expected_packet_mask, fec_packet.data() + fec_header.packet_mask_offset, sizeof(expected_packet_mask)));
+}
+
+MY_TEST(FlexfecHeaderReaderTest, ReadFecHeaderWithKBit2Set) {
+    const uint8_t packet[] = {
+        0x00, 0x12, 0xab, 0xcd,  // R and F bits clear, "random" payload type and length recovery
+        0x12, 0x34, 0x56, 0x78,  // "random" TS recovery
+        0x01, 0x00, 0x00, 0x00,  // SSRCCount and reserved
+        0x01, 0x02, 0x03, 0x04,  // Protected SSRC
+        0x05, 0x06, 0x01, 0x02,  // SN base and packet mask with K bit 0 clear
+        0x04, 0x8d, 0x15, 0x9e,  // Packet mask with K bit 1 clear
+        0xe0, 0x00, 0x00, 0x00,  // Packet mask with K bit 2 set, bit 46 and 47 set
+        0x00, 0x00, 0x00, 0x01,
+
+        0x00, 0x00, 0x00, 0x00   // payload
+    };
+    const uint8_t expected_packet_mask[] = {0x02, 0x04, 0x12, 0x34, 0x56, 0x7b,
+                                            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08};
+    CopyOnWriteBuffer fec_packet(packet, sizeof(packet));
+    FlexfecHeaderReader reader;
+    FecHeader fec_header;
+    EXPECT_TRUE(reader.ReadFecHeader(fec_header, fec_packet));
+
+    EXPECT_EQ(32u, fec_header.fec_header_size);
+    EXPECT_EQ(0x01020304u, fec_header.protected_ssrc);
+    EXPECT_EQ(0x0506u, fec_header.seq_num_base);
+    EXPECT_EQ(18u, fec_header.packet_mask_offset);
+    EXPECT_EQ(14u, fec_header.packet_mask_size);
+    EXPECT_EQ(4u, fec_header.protection_length);
+    EXPECT_EQ(0, memcmp(expected_packet_mask, fec_packet.data() + fec_header.packet_mask_offset, sizeof(expected_packet_mask)));
+}
+
+MY_TEST(FlexfecHeaderReaderTest, ReadFecHeaderFailsWithUnsupportedHeaders) {
+    const uint8_t packet[] = {
+        0x00, 0x12, 0xab, 0xcd,  // R and F bits clear, "random" payload type and length recovery
+        0x12, 0x34, 0x56, 0x78,  // "random" TS recovery
+        0x01, 0x00, 0x00, 0x00,  // SSRCCount and reserved
+        0x01, 0x02, 0x03, 0x04,  // Protected SSRC
+        0x05, 0x06, 0x81, 0x02,  // SN base and packet mask with K bit 0 set
+
+        0x00, 0x00, 0x00, 0x00   // payload
+    };
+    FlexfecHeaderReader reader;
+    FecHeader fec_header;
+    // R bit set.
+    CopyOnWriteBuffer fec_packet(packet, sizeof(packet));
+    fec_packet.data()[0] |= 0x80;
+    EXPECT_FALSE(reader.ReadFecHeader(fec_header, fec_packet));
+    // F bit set.
+    fec_packet = CopyOnWriteBuffer(packet, sizeof(packet));
+    fec_packet.data()[0] |= 0x40;
+    EXPECT_FALSE(reader.ReadFecHeader(fec_header, fec_packet));
+    // More than one protected SSRC.
+    fec_packet = CopyOnWriteBuffer(packet, sizeof(packet));
+    fec_packet.data()[8] = 2;
+    EXPECT_FALSE(reader.ReadFecHeader(fec_header, fec_packet));
+    // Truncated packet mask.
+    fec_packet = CopyOnWriteBuffer(packet, 19);
+    EXPECT_FALSE(reader.ReadFecHeader(fec_header, fec_packet));
+    // Packet mask without any K bit set.
+    fec_packet = CopyOnWriteBuffer(packet, sizeof(packet));
+    fec_packet.data()[18] &= 0x7f;
+    EXPECT_FALSE(reader.ReadFecHeader(fec_header, fec_packet));
+}
+
+} // namespace test
+} // namespace naivertc
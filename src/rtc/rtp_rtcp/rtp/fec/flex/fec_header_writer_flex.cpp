@@ -0,0 +1,147 @@
+#include "rtc/rtp_rtcp/rtp/fec/flex/fec_header_writer_flex.hpp"
+#include "rtc/base/memory/byte_io_reader.hpp"
+#include "rtc/base/memory/byte_io_writer.hpp"
+
+#include <plog/Log.h>
+
+namespace naivertc {
+namespace {
+
+// We only support protecting one media stream.
+constexpr uint8_t kSsrcCount = 1;
+// There are three reserved bytes that MUST be set to 0.
+constexpr uint32_t kReservedBits = 0;
+    
+} // namespace
+
+FlexfecHeaderWriter::FlexfecHeaderWriter() 
+    // Since the ULPFEC packet masks are reused, which can only protect up to 48 media packets.
+    : FecHeaderWriter(kUlpFecMaxMediaPackets, kMaxFecPackets, kFlexFecPacketMaskOffset + kFlexFecPacketMaskSizeKBit2Set) {}
+
+FlexfecHeaderWriter::~FlexfecHeaderWriter() = default;
+
+size_t FlexfecHeaderWriter::MinPacketMaskSize(const uint8_t* packet_mask, size_t packet_mask_size) const {
+    if (packet_mask_size == kUlpFecPacketMaskSizeLBitClear) {
+        // The packet mask is 16 bits long, it can be used as is
+        // if the bit 15 is clear, otherwise we must expand the
+        // packet mask with zeros in the FlexFEC header.
+        return (packet_mask[1] & 0x01) == 0 ? kFlexFecPacketMaskSizeKBit0Set 
+                                            : kFlexFecPacketMaskSizeKBit1Set;
+    } else if (packet_mask_size == kUlpFecPacketMaskSizeLBitSet) {
+        // The packet mask is 48 bits long, it can be used as is
+        // if the bits 46 and 47 are clear, otherwise we must expand 
+        // it with zeros.
+        return (packet_mask[5] & 0x03) == 0 ? kFlexFecPacketMaskSizeKBit1Set 
+                                            : kFlexFecPacketMaskSizeKBit2Set;
+    }
+    PLOG_WARNING << "Incorrect packet mask size: " << packet_mask_size << ".";
+    return kFlexFecPacketMaskSizeKBit2Set;
+}
+
+size_t FlexfecHeaderWriter::FecHeaderSize(size_t packet_mask_size) const {
+    if (packet_mask_size <= kFlexFecPacketMaskSizeKBit0Set) {
+        return kFlexFecPacketMaskOffset + kFlexFecPacketMaskSizeKBit0Set;
+    } else if (packet_mask_size <= kFlexFecPacketMaskSizeKBit1Set) {
+        return kFlexFecPacketMaskOffset + kFlexFecPacketMaskSizeKBit1Set;
+    } else {
+        return kFlexFecPacketMaskOffset + kFlexFecPacketMaskSizeKBit2Set;
+    }
+}
+
+// https://datatracker.ietf.org/doc/html/draft-ietf-payload-flexible-fec-scheme-03#section-4.2
+// FlexFEC header, 20, 24 or 32 octets (given K bits).
+//    0                   1                   2                   3
+//    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |R|F|P|X|  CC   |M| PT recovery |        length recovery        |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |                          TS recovery                          |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |   SSRCCount   |                    reserved                   |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |                             SSRC_i                            |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |           SN base_i           |k|          Mask [0-14]        |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |k|                   Mask [15-45] (optional)                   |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |k|                                                             |
+//   +-+                   Mask [46-108] (optional)                  |
+//   |                                                               |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+void FlexfecHeaderWriter::FinalizeFecHeader(uint32_t media_ssrc,
+                                            uint16_t seq_num_base,
+                                            const uint8_t* packet_mask_data,
+                                            size_t packet_mask_size,
+                                            CopyOnWriteBuffer& fec_packet) const {
+    uint8_t* data = fec_packet.data();
+    // Clear the R bit, since we do not support retransmission.
+    data[0] &= 0x7f;
+    // Clear the F bit, since we use the flexible mask.
+    data[0] &= 0xbf;
+    // NOTE: The length recovery field is written in place already.
+    ByteWriter<uint8_t>::WriteBigEndian(&data[8], kSsrcCount);
+    ByteWriter<uint32_t, 3>::WriteBigEndian(&data[9], kReservedBits);
+    ByteWriter<uint32_t>::WriteBigEndian(&data[12], media_ssrc);
+    ByteWriter<uint16_t>::WriteBigEndian(&data[16], seq_num_base);
+
+    // Adapt the ULPFEC packet mask to FlexFEC header by inserting
+    // the K bits, we treat the mask parts as unsigned integers in
+    // order to simplify the bit shifting between bytes.
+    uint8_t* const written_packet_mask = data + kFlexFecPacketMaskOffset;
+    if (packet_mask_size == kUlpFecPacketMaskSizeLBitSet) {
+        // The packet mask is 48 bits long.
+        uint16_t tmp_mask_part0 = ByteReader<uint16_t>::ReadBigEndian(&packet_mask_data[0]);
+        uint32_t tmp_mask_part1 = ByteReader<uint32_t>::ReadBigEndian(&packet_mask_data[2]);
+
+        // Shift, thus clearing K-bit 0.
+        tmp_mask_part0 >>= 1;
+        ByteWriter<uint16_t>::WriteBigEndian(&written_packet_mask[0], tmp_mask_part0);
+        // Shift, thus clearing K-bit 1 and bit 15.
+        tmp_mask_part1 >>= 2;
+        ByteWriter<uint32_t>::WriteBigEndian(&written_packet_mask[2], tmp_mask_part1);
+        bool bit15 = (packet_mask_data[1] & 0x01) != 0;
+        if (bit15) {
+            written_packet_mask[2] |= 0x40;
+        }
+        bool bit46 = (packet_mask_data[5] & 0x02) != 0;
+        bool bit47 = (packet_mask_data[5] & 0x01) != 0;
+        if (!bit46 && !bit47) {
+            // Set K-bit 1.
+            written_packet_mask[2] |= 0x80;
+        } else {
+            // Clear all trailing bits.
+            memset(&written_packet_mask[6], 0, 8);
+            // Set K-bit 2.
+            written_packet_mask[6] |= 0x80;
+            if (bit46) {
+                written_packet_mask[6] |= 0x40;
+            }
+            if (bit47) {
+                written_packet_mask[6] |= 0x20;
+            }
+        }
+    } else if (packet_mask_size == kUlpFecPacketMaskSizeLBitClear) {
+        // The packet mask is 16 bits long.
+        uint16_t tmp_mask_part0 = ByteReader<uint16_t>::ReadBigEndian(&packet_mask_data[0]);
+
+        // Shift, thus clearing K-bit 0.
+        tmp_mask_part0 >>= 1;
+        ByteWriter<uint16_t>::WriteBigEndian(&written_packet_mask[0], tmp_mask_part0);
+        bool bit15 = (packet_mask_data[1] & 0x01) != 0;
+        if (!bit15) {
+            // Set K-bit 0.
+            written_packet_mask[0] |= 0x80;
+        } else {
+            // Clear all trailing bits.
+            memset(&written_packet_mask[2], 0, 4);
+            // Set K-bit 1 and bit 15.
+            written_packet_mask[2] |= 0x80;
+            written_packet_mask[2] |= 0x40;
+        }
+    } else {
+        PLOG_WARNING << "Incorrect packet mask size: " << packet_mask_size << ".";
+    }
+}
+    
+} // namespace naivertc
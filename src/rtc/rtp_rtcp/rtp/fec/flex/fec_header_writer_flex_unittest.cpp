@@ -0,0 +1,157 @@
+#include "rtc/rtp_rtcp/rtp/fec/flex/fec_header_writer_flex.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/flex/fec_header_reader_flex.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/fec_defines.hpp"
+#include "common/utils_random.hpp"
+#include "rtc/base/memory/byte_io_reader.hpp"
+
+#include <gtest/gtest.h>
+
+#define ENABLE_UNIT_TESTS 0
+#include "testing/defines.hpp"
+
+#include <memory>
+
+namespace naivertc {
+namespace test {
+namespace {
+
+constexpr size_t kMediaPacketSize = 1234;
+constexpr uint32_t kMediaSsrc = 1254983;
+constexpr uint16_t kMediaStartSeqNum = 825;
+
+constexpr size_t kFlexFecHeaderSizeKBit0Set = 20;
+constexpr size_t kFlexFecHeaderSizeKBit1Set = 24;
+constexpr size_t kFlexFecHeaderSizeKBit2Set = 32;
+constexpr size_t kFlexFecPacketMaskOffset = 18;
+
+CopyOnWriteBuffer GeneratePacketMask(size_t packet_mask_size) {
+    CopyOnWriteBuffer packet_mask;
+    packet_mask.Resize(packet_mask_size);
+    uint8_t* packet_mask_data = packet_mask.data();
+    for (size_t i = 0; i < packet_mask_size; ++i) {
+        packet_mask_data[i] = utils::random::generate_random<uint8_t>();
+    }
+    return packet_mask;
+}
+
+CopyOnWriteBuffer WriteHeader(ArrayView<const uint8_t> packet_mask) {
+    CopyOnWriteBuffer written_packet;
+    written_packet.Resize(kMediaPacketSize);
+    uint8_t* data = written_packet.data();
+    for (size_t i = 0; i < written_packet.size(); ++i) {
+        // Actual content dosen't matter
+        data[i] = i;
+    }
+    FlexfecHeaderWriter writer;
+    writer.FinalizeFecHeader(kMediaSsrc, kMediaStartSeqNum, packet_mask.data(), packet_mask.size(), written_packet);
+    return written_packet;
+}
+
+void VerifyFinalizedHeader(ArrayView<const uint8_t> expected_packet_mask, 
+                           const CopyOnWriteBuffer& written_packet) {
+    const uint8_t* packet_data = written_packet.data();
+    EXPECT_EQ(0x00, packet_data[0] & 0x80); // R bit
+    EXPECT_EQ(0x00, packet_data[0] & 0x40); // F bit
+    EXPECT_EQ(0x01, packet_data[8]); // SSRCCount
+    EXPECT_EQ(0x000000u, (ByteReader<uint32_t, 3>::ReadBigEndian(packet_data + 9))); // Reserved
+    EXPECT_EQ(kMediaSsrc, ByteReader<uint32_t>::ReadBigEndian(packet_data + 12));
+    EXPECT_EQ(kMediaStartSeqNum, ByteReader<uint16_t>::ReadBigEndian(packet_data + 16));
+    EXPECT_EQ(0, memcmp(packet_data + kFlexFecPacketMaskOffset, expected_packet_mask.data(), expected_packet_mask.size()));
+}
+    
+} // namespace
+
+MY_TEST(FlexfecHeaderWriterTest, FinalizeHeaderWithKBit0Set) {
+    // The bit 15 is clear.
+    const uint8_t packet_mask[] = {0xab, 0xcc};
+    const uint8_t expected_packet_mask[] = {0xd5, 0xe6};
+
+    auto written_packet = WriteHeader(packet_mask);
+
+    VerifyFinalizedHeader(expected_packet_mask, written_packet);
+}
+
+MY_TEST(FlexfecHeaderWriterTest, FinalizeHeaderWithKBit1Set) {
+    // The bit 15 is set.
+    const uint8_t packet_mask[] = {0xab, 0xcd};
+    const uint8_t expected_packet_mask[] = {0x55, 0xe6, 0xc0, 0x00, 0x00, 0x00};
+
+    auto written_packet = WriteHeader(packet_mask);
+
+    VerifyFinalizedHeader(expected_packet_mask, written_packet);
+}
+
+MY_TEST(FlexfecHeaderWriterTest, FinalizeHeaderWithKBit2Set) {
+    // The bit 15 and 47 are set.
+    const uint8_t packet_mask[] = {0xab, 0xcd, 0x12, 0x34, 0x56, 0x79};
+    const uint8_t expected_packet_mask[] = {0x55, 0xe6, 0x44, 0x8d, 0x15, 0x9e, 
+                                            0xa0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+    auto written_packet = WriteHeader(packet_mask);
+
+    VerifyFinalizedHeader(expected_packet_mask, written_packet);
+}
+
+MY_TEST(FlexfecHeaderWriterTest, CalculateHeaderSizes) {
+    FlexfecHeaderWriter writer;
+    // The bit 15 is clear.
+    const uint8_t small_packet_mask_bit15_clear[] = {0xff, 0xfe};
+    size_t min_packet_mask_size = writer.MinPacketMaskSize(small_packet_mask_bit15_clear, kUlpFecPacketMaskSizeLBitClear);
+    EXPECT_EQ(kFlexFecPacketMaskSizeKBit0Set, min_packet_mask_size);
+    EXPECT_EQ(kFlexFecHeaderSizeKBit0Set, writer.FecHeaderSize(min_packet_mask_size));
+
+    // The bit 15 is set.
+    const uint8_t small_packet_mask_bit15_set[] = {0x00, 0x01};
+    min_packet_mask_size = writer.MinPacketMaskSize(small_packet_mask_bit15_set, kUlpFecPacketMaskSizeLBitClear);
+    EXPECT_EQ(kFlexFecPacketMaskSizeKBit1Set, min_packet_mask_size);
+    EXPECT_EQ(kFlexFecHeaderSizeKBit1Set, writer.FecHeaderSize(min_packet_mask_size));
+
+    // The bit 46 and 47 are clear.
+    const uint8_t large_packet_mask_bit46_47_clear[] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xfc};
+    min_packet_mask_size = writer.MinPacketMaskSize(large_packet_mask_bit46_47_clear, kUlpFecPacketMaskSizeLBitSet);
+    EXPECT_EQ(kFlexFecPacketMaskSizeKBit1Set, min_packet_mask_size);
+    EXPECT_EQ(kFlexFecHeaderSizeKBit1Set, writer.FecHeaderSize(min_packet_mask_size));
+
+    // The bit 46 is set.
+    const uint8_t large_packet_mask_bit46_set[] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x02};
+    min_packet_mask_size = writer.MinPacketMaskSize(large_packet_mask_bit46_set, kUlpFecPacketMaskSizeLBitSet);
+    EXPECT_EQ(kFlexFecPacketMaskSizeKBit2Set, min_packet_mask_size);
+    EXPECT_EQ(kFlexFecHeaderSizeKBit2Set, writer.FecHeaderSize(min_packet_mask_size));
+}
+
+MY_TEST(FlexfecHeaderReaderWriterTest, WriteAndReadHeaderWithRandomMasks) {
+    constexpr size_t kNumIterations = 100;
+    FlexfecHeaderWriter writer;
+    FlexfecHeaderReader reader;
+    for (size_t packet_mask_size : {kUlpFecPacketMaskSizeLBitClear, kUlpFecPacketMaskSizeLBitSet}) {
+        for (size_t i = 0; i < kNumIterations; ++i) {
+            auto packet_mask = GeneratePacketMask(packet_mask_size);
+            const size_t expected_fec_header_size = writer.FecHeaderSize(writer.MinPacketMaskSize(packet_mask.data(), packet_mask_size));
+            auto written_packet = WriteHeader(packet_mask);
+            CopyOnWriteBuffer read_packet(written_packet.data(), written_packet.size());
+
+            FecHeader fec_header;
+            ASSERT_TRUE(reader.ReadFecHeader(fec_header, read_packet));
+
+            EXPECT_EQ(expected_fec_header_size, fec_header.fec_header_size);
+            EXPECT_EQ(kMediaSsrc, fec_header.protected_ssrc);
+            EXPECT_EQ(kMediaStartSeqNum, fec_header.seq_num_base);
+            EXPECT_EQ(kFlexFecPacketMaskOffset, fec_header.packet_mask_offset);
+            EXPECT_EQ(written_packet.size() - expected_fec_header_size, fec_header.protection_length);
+            // The read packet mask is the ULPFEC packet mask padded with zeros.
+            ASSERT_GE(fec_header.packet_mask_size, packet_mask_size);
+            const uint8_t* read_packet_mask = read_packet.data() + fec_header.packet_mask_offset;
+            EXPECT_EQ(0, memcmp(packet_mask.data(), read_packet_mask, packet_mask_size));
+            for (size_t j = packet_mask_size; j < fec_header.packet_mask_size; ++j) {
+                EXPECT_EQ(0x00, read_packet_mask[j]);
+            }
+            // Verify payload data.
+            EXPECT_EQ(0, memcmp(written_packet.data() + expected_fec_header_size, 
+                                read_packet.data() + expected_fec_header_size, 
+                                written_packet.size() - expected_fec_header_size));
+        }
+    }
+}
+    
+} // namespace test
+} // namespace naivertc
@@ -0,0 +1,72 @@
+#include "rtc/rtp_rtcp/rtp/fec/flex/fec_receiver_flex.hpp"
+#include "rtc/base/internals.hpp"
+
+#include <plog/Log.h>
+
+namespace naivertc {
+
+FlexfecReceiver::FlexfecReceiver(uint32_t ssrc,
+                                 uint32_t protected_media_ssrc,
+                                 Clock* clock, 
+                                 RecoveredPacketReceiver* recovered_packet_receiver) 
+    : ssrc_(ssrc),
+      protected_media_ssrc_(protected_media_ssrc),
+      clock_(clock),
+      recovered_packet_receiver_(recovered_packet_receiver),
+      fec_decoder_(FecDecoder::CreateFlexFecDecoder(ssrc_, protected_media_ssrc_)) {
+
+    fec_decoder_->OnRecoveredPacket(std::bind(&FlexfecReceiver::OnRecoveredPacket, this, std::placeholders::_1));
+}
+
+FlexfecReceiver::~FlexfecReceiver() {
+    fec_decoder_->Reset();
+}
+
+bool FlexfecReceiver::OnRtpPacket(const RtpPacketReceived& rtp_packet) {
+    // Do not pass recovered packets to FEC. Recovered packet might have
+    // different set of the RTP header extensions and thus different byte
+    // representation than the original packet, That will corrupt
+    // FEC calculation.
+    if (rtp_packet.is_recovered()) {
+        return false;
+    }
+    if (rtp_packet.size() > kIpPacketSize) {
+        PLOG_WARNING << "Received packet with length exceeds maxmimum typical IP packet size, dropping.";
+        return false;
+    }
+
+    const uint32_t ssrc = rtp_packet.ssrc();
+    const uint16_t seq_num = rtp_packet.sequence_number();
+    if (ssrc == ssrc_) {
+        if (rtp_packet.payload_size() == 0) {
+            PLOG_WARNING << "Received a FlexFEC packet without payload, dropping.";
+            return false;
+        }
+        ++packet_counter_.num_received_fec_packets;
+        // The FlexFEC header and the repair payload.
+        fec_decoder_->Decode(ssrc, seq_num, true /* is_fec */, rtp_packet.PayloadBuffer());
+    } else if (ssrc == protected_media_ssrc_) {
+        // The media packets are protected in their entirety.
+        fec_decoder_->Decode(ssrc, seq_num, false /* is_fec */, CopyOnWriteBuffer(rtp_packet.cdata(), rtp_packet.size()));
+    } else {
+        PLOG_WARNING << "Received packet with SSRC=" << ssrc 
+                     << " is neither FlexFEC packet nor the protected media packet, dropping.";
+        return false;
+    }
+
+    ++packet_counter_.num_received_packets;
+    packet_counter_.num_received_bytes += rtp_packet.size();
+    if (packet_counter_.first_packet_arrival_time_ms == -1) {
+        packet_counter_.first_packet_arrival_time_ms = clock_->now_ms();
+    }
+    return true;
+}
+
+void FlexfecReceiver::OnRecoveredPacket(const FecDecoder::RecoveredMediaPacket& recovered_packet) {
+    ++packet_counter_.num_recovered_packets;
+    if (recovered_packet_receiver_) {
+        recovered_packet_receiver_->OnRecoveredPacket(recovered_packet.pkt);
+    }
+}
+    
+} // namespace naivertc
@@ -0,0 +1,49 @@
+#ifndef _RTC_RTP_RTCP_RTP_FEC_FEC_RECEIVER_FLEX_H_
+#define _RTC_RTP_RTCP_RTP_FEC_FEC_RECEIVER_FLEX_H_
+
+#include "base/defines.hpp"
+#include "rtc/base/time/clock.hpp"
+#include "rtc/rtp_rtcp/rtp/packets/rtp_packet_received.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/fec_decoder.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/fec_defines.hpp"
+#include "rtc/rtp_rtcp/base/rtp_rtcp_interfaces.hpp"
+
+namespace naivertc {
+
+// Receives the FlexFEC packets in a separate stream and the media 
+// packets protected by them, and recovers the lost media packets.
+class FlexfecReceiver {
+public:
+    // Packet counter
+    using PacketCounter = FecPacketCounter;
+
+public:
+    FlexfecReceiver(uint32_t ssrc,
+                    uint32_t protected_media_ssrc,
+                    Clock* clock, 
+                    RecoveredPacketReceiver* recovered_packet_receiver);
+    ~FlexfecReceiver();
+
+    // Inserts a received FlexFEC packet or a media packet protected by it.
+    bool OnRtpPacket(const RtpPacketReceived& rtp_packet);
+
+    PacketCounter packet_counter() const { return packet_counter_; }
+
+private:
+    void OnRecoveredPacket(const FecDecoder::RecoveredMediaPacket& recovered_packet);
+
+private:
+    const uint32_t ssrc_;
+    const uint32_t protected_media_ssrc_;
+    Clock* const clock_;
+    RecoveredPacketReceiver* recovered_packet_receiver_;
+
+    const std::unique_ptr<FecDecoder> fec_decoder_;
+
+    PacketCounter packet_counter_;
+};
+    
+} // namespace naivertc
+
+
+#endif
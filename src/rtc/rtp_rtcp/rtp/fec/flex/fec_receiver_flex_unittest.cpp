@@ -0,0 +1,190 @@
+#include "rtc/rtp_rtcp/rtp/fec/flex/fec_receiver_flex.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/flex/fec_generator_flex.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/fec_encoder.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/fec_test_helper.hpp"
+#include "testing/simulated_clock.hpp"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#define ENABLE_UNIT_TESTS 0
+#include "testing/defines.hpp"
+
+namespace naivertc {
+namespace test {
+namespace {
+
+using ::testing::_;
+
+constexpr uint8_t kFlexfecPayloadType = 96;
+constexpr uint8_t kMediaPayloadType = 120;
+
+constexpr uint32_t kFlexfecSsrc = 42984;
+constexpr uint32_t kMediaSsrc = 835424;
+
+constexpr size_t kPayloadSize = 100;
+
+// 50% protection in the [0, 255] domain.
+constexpr FecProtectionParams kProtectionParams = {128, 1, FecMaskType::RANDOM};
+
+RtpPacketReceived ToReceivedPacket(const RtpPacket& rtp_packet) {
+    RtpPacketReceived received_packet;
+    EXPECT_TRUE(received_packet.Parse(rtp_packet.cdata(), rtp_packet.size()));
+    return received_packet;
+}
+
+RtpPacketToSend ToPacketToSend(const RtpPacket& rtp_packet) {
+    RtpPacketToSend packet_to_send(kIpPacketSize);
+    EXPECT_TRUE(packet_to_send.Parse(rtp_packet.cdata(), rtp_packet.size()));
+    packet_to_send.set_packet_type(RtpPacketType::VIDEO);
+    return packet_to_send;
+}
+    
+} // namespace
+
+// MockRecoveredPacketReceiver
+class MockRecoveredPacketReceiver : public RecoveredPacketReceiver {
+public:
+    MOCK_METHOD(void, 
+                OnRecoveredPacket, 
+                (CopyOnWriteBuffer recovered_packet), 
+                (override));
+};
+
+// FlexfecReceiverTest
+class T(FlexfecReceiverTest) : public ::testing::Test {
+protected:
+    T(FlexfecReceiverTest)() 
+        : clock_(0x100),
+          fec_generator_(kFlexfecPayloadType, kFlexfecSsrc, kMediaSsrc, &clock_),
+          fec_receiver_(kFlexfecSsrc, kMediaSsrc, &clock_, &recovered_packet_receiver_),
+          packet_generator_(kMediaSsrc, kMediaPayloadType) {
+        fec_generator_.SetProtectionParameters(kProtectionParams, kProtectionParams);
+    }
+
+    // Packetizes a frame and protects it with the FlexFEC packets.
+    std::vector<RtpPacketToSend> PacketizeAndProtectFrame(size_t num_media_packets, 
+                                                          std::vector<RtpPacket>& media_packets) {
+        packet_generator_.NewFrame(num_media_packets);
+        for (size_t i = 0; i < num_media_packets; ++i) {
+            RtpPacket rtp_packet = packet_generator_.NextRtpPacket(kPayloadSize);
+            fec_generator_.PushMediaPacket(ToPacketToSend(rtp_packet));
+            media_packets.push_back(std::move(rtp_packet));
+        }
+        return fec_generator_.PopFecPackets();
+    }
+
+protected:
+    SimulatedClock clock_;
+    MockRecoveredPacketReceiver recovered_packet_receiver_;
+    FlexfecGenerator fec_generator_;
+    FlexfecReceiver fec_receiver_;
+    RtpPacketGenerator packet_generator_;
+};
+
+MY_TEST_F(FlexfecReceiverTest, GeneratesFecPacketsInSeparateStream) {
+    std::vector<RtpPacket> media_packets;
+    auto fec_packets = PacketizeAndProtectFrame(4, media_packets);
+    ASSERT_EQ(2u, fec_packets.size());
+
+    const uint16_t first_seq_num = fec_packets[0].sequence_number();
+    for (size_t i = 0; i < fec_packets.size(); ++i) {
+        const auto& fec_packet = fec_packets[i];
+        EXPECT_EQ(kFlexfecPayloadType, fec_packet.payload_type());
+        EXPECT_EQ(kFlexfecSsrc, fec_packet.ssrc());
+        EXPECT_EQ(static_cast<uint16_t>(first_seq_num + i), fec_packet.sequence_number());
+        EXPECT_EQ(RtpPacketType::FEC, fec_packet.packet_type());
+        EXPECT_FALSE(fec_packet.allow_retransmission());
+        EXPECT_FALSE(fec_packet.is_red());
+        // The FEC packets are not larger than the protected media packets plus the overhead.
+        EXPECT_LE(fec_packet.size(), kRtpHeaderSize + fec_generator_.MaxPacketOverhead() + media_packets[0].size());
+    }
+    // The sequence numbers continue in the next frame.
+    auto next_fec_packets = PacketizeAndProtectFrame(4, media_packets);
+    ASSERT_FALSE(next_fec_packets.empty());
+    EXPECT_EQ(static_cast<uint16_t>(first_seq_num + fec_packets.size()), next_fec_packets[0].sequence_number());
+}
+
+MY_TEST_F(FlexfecReceiverTest, DropsPacketsOfUnprotectedStream) {
+    RtpPacketGenerator packet_generator(kMediaSsrc + 1, kMediaPayloadType);
+    packet_generator.NewFrame(1);
+    auto rtp_packet = packet_generator.NextRtpPacket(kPayloadSize);
+
+    fec_generator_.PushMediaPacket(ToPacketToSend(rtp_packet));
+    EXPECT_TRUE(fec_generator_.PopFecPackets().empty());
+    EXPECT_FALSE(fec_receiver_.OnRtpPacket(ToReceivedPacket(rtp_packet)));
+    EXPECT_EQ(0u, fec_receiver_.packet_counter().num_received_packets);
+}
+
+MY_TEST_F(FlexfecReceiverTest, RecoversOneLostMediaPacket) {
+    std::vector<RtpPacket> media_packets;
+    auto fec_packets = PacketizeAndProtectFrame(2, media_packets);
+    ASSERT_EQ(1u, fec_packets.size());
+
+    // The second media packet is lost.
+    EXPECT_TRUE(fec_receiver_.OnRtpPacket(ToReceivedPacket(media_packets[0])));
+    EXPECT_CALL(recovered_packet_receiver_, OnRecoveredPacket(media_packets[1])).Times(1);
+    EXPECT_TRUE(fec_receiver_.OnRtpPacket(ToReceivedPacket(fec_packets[0])));
+
+    auto packet_counter = fec_receiver_.packet_counter();
+    EXPECT_EQ(2u, packet_counter.num_received_packets);
+    EXPECT_EQ(1u, packet_counter.num_received_fec_packets);
+    EXPECT_EQ(1u, packet_counter.num_recovered_packets);
+}
+
+MY_TEST_F(FlexfecReceiverTest, RecoversLostMediaPacketsWithLargePacketMask) {
+    // More than 15 media packets make the FlexFEC header to use longer packet mask.
+    constexpr size_t kNumMediaPackets = 20;
+    std::vector<RtpPacket> media_packets;
+    auto fec_packets = PacketizeAndProtectFrame(kNumMediaPackets, media_packets);
+    ASSERT_FALSE(fec_packets.empty());
+
+    // All the media packets arrive except the last one.
+    for (size_t i = 0; i < kNumMediaPackets - 1; ++i) {
+        EXPECT_TRUE(fec_receiver_.OnRtpPacket(ToReceivedPacket(media_packets[i])));
+    }
+    EXPECT_CALL(recovered_packet_receiver_, OnRecoveredPacket(media_packets.back())).Times(1);
+    for (const auto& fec_packet : fec_packets) {
+        EXPECT_TRUE(fec_receiver_.OnRtpPacket(ToReceivedPacket(fec_packet)));
+    }
+    EXPECT_EQ(1u, fec_receiver_.packet_counter().num_recovered_packets);
+}
+
+MY_TEST_F(FlexfecReceiverTest, RecoversLostMediaPacketWhenFecPacketsArriveFirst) {
+    constexpr size_t kNumMediaPackets = 4;
+    std::vector<RtpPacket> media_packets;
+    auto fec_packets = PacketizeAndProtectFrame(kNumMediaPackets, media_packets);
+    ASSERT_EQ(2u, fec_packets.size());
+
+    // Nothing to recover while all the media packets are missing.
+    EXPECT_CALL(recovered_packet_receiver_, OnRecoveredPacket(_)).Times(0);
+    for (const auto& fec_packet : fec_packets) {
+        EXPECT_TRUE(fec_receiver_.OnRtpPacket(ToReceivedPacket(fec_packet)));
+    }
+
+    // The last media packet is recovered once the other ones arrive, and the
+    // media packets not arrived yet may be recovered earlier, depending on the mask.
+    EXPECT_CALL(recovered_packet_receiver_, OnRecoveredPacket(_)).Times(::testing::AnyNumber());
+    EXPECT_CALL(recovered_packet_receiver_, OnRecoveredPacket(media_packets.back())).Times(1);
+    for (size_t i = 0; i < kNumMediaPackets - 1; ++i) {
+        fec_receiver_.OnRtpPacket(ToReceivedPacket(media_packets[i]));
+    }
+    EXPECT_GE(fec_receiver_.packet_counter().num_recovered_packets, 1u);
+}
+
+MY_TEST_F(FlexfecReceiverTest, DoesNotDecodeRecoveredPackets) {
+    std::vector<RtpPacket> media_packets;
+    auto fec_packets = PacketizeAndProtectFrame(2, media_packets);
+    ASSERT_EQ(1u, fec_packets.size());
+
+    auto recovered_packet = ToReceivedPacket(media_packets[0]);
+    recovered_packet.set_is_recovered(true);
+    EXPECT_FALSE(fec_receiver_.OnRtpPacket(recovered_packet));
+
+    // Not enough packets to recover the lost one.
+    EXPECT_CALL(recovered_packet_receiver_, OnRecoveredPacket(_)).Times(0);
+    EXPECT_TRUE(fec_receiver_.OnRtpPacket(ToReceivedPacket(fec_packets[0])));
+}
+
+} // namespace test
+} // namespace naivertc
@@ -0,0 +1,127 @@
+#include "rtc/rtp_rtcp/rtp/fec/rs/fec_codec_rs.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/rs/galois_field.hpp"
+
+#include <cassert>
+#include <cstring>
+
+namespace naivertc {
+
+uint8_t RsFecCodec::Coefficient(size_t num_source_symbols,
+                                size_t repair_index,
+                                size_t source_index) {
+    assert(source_index < num_source_symbols);
+    assert(num_source_symbols + repair_index < kMaxSymbols);
+    // The Cauchy matrix 1 / (x_i + y_j) with x_i = k + i and y_j = j, which
+    // are distinct as long as k + m <= 256.
+    const uint8_t x = static_cast<uint8_t>(num_source_symbols + repair_index);
+    const uint8_t y = static_cast<uint8_t>(source_index);
+    return GaloisField::Inverse(x ^ y);
+}
+
+void RsFecCodec::Encode(ArrayView<const uint8_t* const> source_symbols,
+                        size_t symbol_size,
+                        size_t repair_index,
+                        uint8_t* repair_symbol) {
+    const size_t num_source_symbols = source_symbols.size();
+    memset(repair_symbol, 0, symbol_size);
+    for (size_t j = 0; j < num_source_symbols; ++j) {
+        GaloisField::MultiplyAccumulate(Coefficient(num_source_symbols, repair_index, j),
+                                        source_symbols[j],
+                                        repair_symbol,
+                                        symbol_size);
+    }
+}
+
+bool RsFecCodec::Decode(ArrayView<uint8_t* const> source_symbols,
+                        const std::vector<bool>& erased,
+                        ArrayView<const RepairSymbol> repair_symbols,
+                        size_t symbol_size) {
+    const size_t num_source_symbols = source_symbols.size();
+    assert(erased.size() == num_source_symbols);
+    std::vector<size_t> erased_indices;
+    for (size_t j = 0; j < num_source_symbols; ++j) {
+        if (erased[j]) {
+            erased_indices.push_back(j);
+        }
+    }
+    const size_t num_erased = erased_indices.size();
+    if (num_erased == 0) {
+        return true;
+    }
+    if (repair_symbols.size() < num_erased) {
+        return false;
+    }
+
+    // Substract the received source symbols from the first |num_erased|
+    // repair symbols, and the remainders are the erased source symbols
+    // times the square Cauchy submatrix.
+    std::vector<std::vector<uint8_t>> remainders(num_erased);
+    std::vector<uint8_t> matrix(num_erased * num_erased);
+    for (size_t r = 0; r < num_erased; ++r) {
+        const RepairSymbol& repair_symbol = repair_symbols[r];
+        auto& remainder = remainders[r];
+        remainder.assign(repair_symbol.data, repair_symbol.data + symbol_size);
+        for (size_t j = 0; j < num_source_symbols; ++j) {
+            if (!erased[j]) {
+                GaloisField::MultiplyAccumulate(Coefficient(num_source_symbols, repair_symbol.index, j),
+                                                source_symbols[j],
+                                                remainder.data(),
+                                                symbol_size);
+            }
+        }
+        for (size_t c = 0; c < num_erased; ++c) {
+            matrix[r * num_erased + c] = Coefficient(num_source_symbols, repair_symbol.index, erased_indices[c]);
+        }
+    }
+
+    // Invert the submatrix with Gauss-Jordan elimination.
+    std::vector<uint8_t> inverse(num_erased * num_erased, 0);
+    for (size_t i = 0; i < num_erased; ++i) {
+        inverse[i * num_erased + i] = 1;
+    }
+    for (size_t col = 0; col < num_erased; ++col) {
+        size_t pivot = col;
+        while (pivot < num_erased && matrix[pivot * num_erased + col] == 0) {
+            ++pivot;
+        }
+        if (pivot == num_erased) {
+            // Never happens to a Cauchy matrix, unless the repair indices are duplicated.
+            return false;
+        }
+        if (pivot != col) {
+            for (size_t c = 0; c < num_erased; ++c) {
+                std::swap(matrix[pivot * num_erased + c], matrix[col * num_erased + c]);
+                std::swap(inverse[pivot * num_erased + c], inverse[col * num_erased + c]);
+            }
+        }
+        const uint8_t scale = GaloisField::Inverse(matrix[col * num_erased + col]);
+        for (size_t c = 0; c < num_erased; ++c) {
+            matrix[col * num_erased + c] = GaloisField::Multiply(matrix[col * num_erased + c], scale);
+            inverse[col * num_erased + c] = GaloisField::Multiply(inverse[col * num_erased + c], scale);
+        }
+        for (size_t r = 0; r < num_erased; ++r) {
+            const uint8_t factor = matrix[r * num_erased + col];
+            if (r == col || factor == 0) {
+                continue;
+            }
+            for (size_t c = 0; c < num_erased; ++c) {
+                matrix[r * num_erased + c] ^= GaloisField::Multiply(factor, matrix[col * num_erased + c]);
+                inverse[r * num_erased + c] ^= GaloisField::Multiply(factor, inverse[col * num_erased + c]);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < num_erased; ++i) {
+        uint8_t* source_symbol = source_symbols[erased_indices[i]];
+        memset(source_symbol, 0, symbol_size);
+        for (size_t r = 0; r < num_erased; ++r) {
+            GaloisField::MultiplyAccumulate(inverse[i * num_erased + r],
+                                            remainders[r].data(),
+                                            source_symbol,
+                                            symbol_size);
+        }
+    }
+    return true;
+}
+
+} // namespace naivertc
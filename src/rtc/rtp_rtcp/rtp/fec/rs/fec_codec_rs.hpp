@@ -0,0 +1,49 @@
+#ifndef _RTC_RTP_RTCP_FEC_RS_FEC_CODEC_RS_H_
+#define _RTC_RTP_RTCP_FEC_RS_FEC_CODEC_RS_H_
+
+#include "base/defines.hpp"
+#include "common/array_view.hpp"
+
+#include <vector>
+
+namespace naivertc {
+
+// Systematic Cauchy Reed-Solomon erasure code over GF(2^8): the k source
+// symbols are sent as they are, and the m repair symbols are the rows of a
+// Cauchy matrix times the source symbols. Since every square submatrix of a
+// Cauchy matrix is invertible, any k of the k + m symbols recover the others.
+class RsFecCodec {
+public:
+    // The source and repair symbols of a block are the distinct points of GF(2^8).
+    static constexpr size_t kMaxSymbols = 256;
+
+    struct RepairSymbol {
+        size_t index = 0;
+        const uint8_t* data = nullptr;
+    };
+
+    // The coefficient of the source symbol |source_index| in the repair
+    // symbol |repair_index| of a block of |num_source_symbols|.
+    static uint8_t Coefficient(size_t num_source_symbols,
+                               size_t repair_index,
+                               size_t source_index);
+
+    // Computes the repair symbol |repair_index| of |source_symbols| into
+    // |repair_symbol|, all of |symbol_size| bytes.
+    static void Encode(ArrayView<const uint8_t* const> source_symbols,
+                       size_t symbol_size,
+                       size_t repair_index,
+                       uint8_t* repair_symbol);
+
+    // Recovers the source symbols flagged in |erased| in place, returns
+    // false if there are fewer repair symbols than the erased ones.
+    static bool Decode(ArrayView<uint8_t* const> source_symbols,
+                       const std::vector<bool>& erased,
+                       ArrayView<const RepairSymbol> repair_symbols,
+                       size_t symbol_size);
+};
+
+} // namespace naivertc
+
+
+#endif
@@ -0,0 +1,121 @@
+#include "rtc/rtp_rtcp/rtp/fec/rs/fec_codec_rs.hpp"
+
+#include <gtest/gtest.h>
+
+#define ENABLE_UNIT_TESTS 0
+#include "testing/defines.hpp"
+
+#include <random>
+
+namespace naivertc {
+namespace test {
+namespace {
+
+constexpr size_t kSymbolSize = 37;
+
+std::vector<std::vector<uint8_t>> CreateSourceSymbols(size_t num_symbols, uint32_t seed) {
+    std::mt19937 random(seed);
+    std::vector<std::vector<uint8_t>> symbols(num_symbols, std::vector<uint8_t>(kSymbolSize));
+    for (auto& symbol : symbols) {
+        for (auto& byte : symbol) {
+            byte = static_cast<uint8_t>(random());
+        }
+    }
+    return symbols;
+}
+
+std::vector<std::vector<uint8_t>> EncodeRepairSymbols(const std::vector<std::vector<uint8_t>>& source_symbols, 
+                                                      size_t num_repair_symbols) {
+    std::vector<const uint8_t*> sources;
+    for (const auto& symbol : source_symbols) {
+        sources.push_back(symbol.data());
+    }
+    std::vector<std::vector<uint8_t>> repair_symbols(num_repair_symbols, std::vector<uint8_t>(kSymbolSize));
+    for (size_t i = 0; i < num_repair_symbols; ++i) {
+        RsFecCodec::Encode(sources, kSymbolSize, i, repair_symbols[i].data());
+    }
+    return repair_symbols;
+}
+
+// Erases the symbols in |erased_mask| over the k source symbols followed by
+// the m repair symbols, and returns true if the source symbols are recovered.
+bool EraseAndRecover(const std::vector<std::vector<uint8_t>>& source_symbols,
+                     const std::vector<std::vector<uint8_t>>& repair_symbols,
+                     uint32_t erased_mask) {
+    const size_t k = source_symbols.size();
+    auto received_symbols = source_symbols;
+    std::vector<bool> erased(k, false);
+    std::vector<uint8_t*> sources;
+    for (size_t j = 0; j < k; ++j) {
+        if (erased_mask & (1u << j)) {
+            erased[j] = true;
+            std::fill(received_symbols[j].begin(), received_symbols[j].end(), 0xAA);
+        }
+        sources.push_back(received_symbols[j].data());
+    }
+    std::vector<RsFecCodec::RepairSymbol> repairs;
+    for (size_t i = 0; i < repair_symbols.size(); ++i) {
+        if (!(erased_mask & (1u << (k + i)))) {
+            repairs.push_back({i, repair_symbols[i].data()});
+        }
+    }
+    if (!RsFecCodec::Decode(sources, erased, repairs, kSymbolSize)) {
+        return false;
+    }
+    return received_symbols == source_symbols;
+}
+
+} // namespace
+
+MY_TEST(RsFecCodecTest, RecoversAnyErasuresUpToNumRepairSymbols) {
+    for (size_t k = 1; k <= 8; ++k) {
+        for (size_t m = 1; m <= 4; ++m) {
+            const auto source_symbols = CreateSourceSymbols(k, static_cast<uint32_t>(k * 10 + m));
+            const auto repair_symbols = EncodeRepairSymbols(source_symbols, m);
+            // All the erasure patterns over the k + m symbols.
+            for (uint32_t erased_mask = 0; erased_mask < (1u << (k + m)); ++erased_mask) {
+                const size_t num_erased = __builtin_popcount(erased_mask);
+                const size_t num_erased_sources = __builtin_popcount(erased_mask & ((1u << k) - 1));
+                const bool recovered = EraseAndRecover(source_symbols, repair_symbols, erased_mask);
+                if (num_erased <= m) {
+                    ASSERT_TRUE(recovered) << "k=" << k << " m=" << m << " erased_mask=" << erased_mask;
+                } else if (num_erased_sources > 0) {
+                    // Fewer than k symbols left.
+                    ASSERT_FALSE(recovered) << "k=" << k << " m=" << m << " erased_mask=" << erased_mask;
+                }
+            }
+        }
+    }
+}
+
+MY_TEST(RsFecCodecTest, RecoversLargeBlock) {
+    constexpr size_t kNumSourceSymbols = 64;
+    constexpr size_t kNumRepairSymbols = 32;
+    const auto source_symbols = CreateSourceSymbols(kNumSourceSymbols, 7);
+    const auto repair_symbols = EncodeRepairSymbols(source_symbols, kNumRepairSymbols);
+
+    // A burst of 32 lost source symbols in the middle of the block.
+    auto received_symbols = source_symbols;
+    std::vector<bool> erased(kNumSourceSymbols, false);
+    std::vector<uint8_t*> sources;
+    for (size_t j = 0; j < kNumSourceSymbols; ++j) {
+        if (j >= 16 && j < 48) {
+            erased[j] = true;
+            std::fill(received_symbols[j].begin(), received_symbols[j].end(), 0);
+        }
+        sources.push_back(received_symbols[j].data());
+    }
+    std::vector<RsFecCodec::RepairSymbol> repairs;
+    for (size_t i = 0; i < kNumRepairSymbols; ++i) {
+        repairs.push_back({i, repair_symbols[i].data()});
+    }
+    ASSERT_TRUE(RsFecCodec::Decode(sources, erased, repairs, kSymbolSize));
+    EXPECT_EQ(source_symbols, received_symbols);
+
+    // One more lost symbol can not be recovered.
+    erased[0] = true;
+    EXPECT_FALSE(RsFecCodec::Decode(sources, erased, repairs, kSymbolSize));
+}
+
+} // namespace test
+} // namespace naivertc
@@ -0,0 +1,166 @@
+#include "rtc/rtp_rtcp/rtp/fec/rs/fec_generator_rs.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/rs/fec_codec_rs.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/rs/fec_header_rs.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/fec_encoder.hpp"
+#include "rtc/rtp_rtcp/base/rtp_rtcp_defines.hpp"
+#include "rtc/base/memory/byte_io_reader.hpp"
+#include "rtc/base/memory/byte_io_writer.hpp"
+#include "common/utils_random.hpp"
+
+#include <plog/Log.h>
+
+namespace naivertc {
+namespace {
+
+constexpr uint16_t kMaxInitRtpSeqNumber = 32767;  // 2^15 - 1
+// The Reed-Solomon FEC stream uses the same clock rate as the video stream.
+constexpr int64_t kMsToRtpTimestamp = kVideoPayloadTypeFrequency / 1000;
+    
+} // namespace
+
+RsFecGenerator::RsFecGenerator(int payload_type,
+                               uint32_t ssrc,
+                               uint32_t protected_media_ssrc,
+                               Clock* clock) 
+    : payload_type_(payload_type),
+      ssrc_(ssrc),
+      protected_media_ssrc_(protected_media_ssrc),
+      clock_(clock),
+      timestamp_offset_(utils::random::generate_random<uint32_t>()),
+      seq_num_(utils::random::random<uint16_t>(1, kMaxInitRtpSeqNumber)),
+      num_protected_frames_(0),
+      contains_key_frame_(false) {
+    media_packets_.reserve(kRsFecMaxMediaPackets);
+    generated_fec_packets_.reserve(kRsFecMaxMediaPackets);
+}
+
+RsFecGenerator::~RsFecGenerator() = default;
+
+size_t RsFecGenerator::MaxPacketOverhead() const {
+    return RsFecHeader::kSize + RsFecHeader::kSymbolLengthSize;
+}
+
+void RsFecGenerator::SetProtectionParameters(const FecProtectionParams& delta_params, 
+                                             const FecProtectionParams& key_params) {
+    assert(delta_params.fec_rate <= 255);
+    assert(key_params.fec_rate <= 255);
+    pending_params_.emplace(delta_params, key_params);
+}
+
+void RsFecGenerator::PushMediaPacket(RtpPacketToSend packet) {
+    if (packet.ssrc() != protected_media_ssrc_) {
+        PLOG_WARNING << "Media packet with SSRC=" << packet.ssrc() 
+                     << " is not protected by the Reed-Solomon FEC stream.";
+        return;
+    }
+    if (pending_params_) {
+        current_params_ = *pending_params_;
+        pending_params_.reset();
+    }
+
+    // The media packets of a block are identified by the consecutive
+    // sequence numbers from the base, so a gap ends the block early.
+    if (!media_packets_.empty()) {
+        const uint16_t seq_num_base = ByteReader<uint16_t>::ReadBigEndian(&media_packets_.front().cdata()[2]);
+        if (packet.sequence_number() != static_cast<uint16_t>(seq_num_base + media_packets_.size())) {
+            EncodeBlock();
+        }
+    }
+
+    if (packet.is_key_frame()) {
+        contains_key_frame_ = true;
+    }
+    const bool complete_frame = packet.marker();
+    media_packets_.push_back(std::move(packet));
+    if (complete_frame) {
+        ++num_protected_frames_;
+    }
+
+    if (media_packets_.size() >= kRsFecMaxMediaPackets ||
+        (complete_frame && num_protected_frames_ >= CurrentParams().max_fec_frames)) {
+        EncodeBlock();
+    }
+}
+
+std::vector<RtpPacketToSend> RsFecGenerator::PopFecPackets() {
+    std::vector<RtpPacketToSend> fec_packets_to_send;
+    if (generated_fec_packets_.empty()) {
+        return fec_packets_to_send;
+    }
+    fec_packets_to_send.reserve(generated_fec_packets_.size());
+    const uint32_t timestamp = timestamp_offset_ + static_cast<uint32_t>(kMsToRtpTimestamp * clock_->now_ms());
+    for (const auto& fec_packet : generated_fec_packets_) {
+        RtpPacketToSend fec_packet_to_send(kRtpHeaderSize + fec_packet.size());
+        fec_packet_to_send.set_payload_type(payload_type_);
+        fec_packet_to_send.set_sequence_number(seq_num_++);
+        fec_packet_to_send.set_timestamp(timestamp);
+        fec_packet_to_send.set_ssrc(ssrc_);
+
+        uint8_t* payload = fec_packet_to_send.set_payload_size(fec_packet.size());
+        assert(payload != nullptr);
+        memcpy(payload, fec_packet.cdata(), fec_packet.size());
+
+        fec_packet_to_send.set_packet_type(RtpPacketType::FEC);
+        fec_packet_to_send.set_allow_retransmission(false);
+        fec_packet_to_send.set_fec_protection_need(false);
+        fec_packet_to_send.set_red_protection_need(false);
+        fec_packets_to_send.push_back(std::move(fec_packet_to_send));
+    }
+    generated_fec_packets_.clear();
+    return fec_packets_to_send;
+}
+
+// Private methods
+const FecProtectionParams& RsFecGenerator::CurrentParams() const {
+    return contains_key_frame_ ? current_params_.second : current_params_.first;
+}
+
+void RsFecGenerator::EncodeBlock() {
+    const size_t num_media_packets = media_packets_.size();
+    const size_t num_fec_packets = FecEncoder::CalcNumFecPackets(num_media_packets, 
+                                                                 static_cast<uint8_t>(CurrentParams().fec_rate));
+    if (num_media_packets == 0 || num_fec_packets == 0) {
+        ResetBlock();
+        return;
+    }
+
+    // The source symbols are the media packets prefixed with their lengths,
+    // and padded with zeros to the longest one.
+    size_t max_packet_size = 0;
+    for (const auto& media_packet : media_packets_) {
+        max_packet_size = std::max(max_packet_size, media_packet.size());
+    }
+    const size_t symbol_size = RsFecHeader::kSymbolLengthSize + max_packet_size;
+    std::vector<uint8_t> source_data(num_media_packets * symbol_size, 0);
+    std::vector<const uint8_t*> source_symbols(num_media_packets);
+    for (size_t i = 0; i < num_media_packets; ++i) {
+        uint8_t* source_symbol = &source_data[i * symbol_size];
+        const auto& media_packet = media_packets_[i];
+        ByteWriter<uint16_t>::WriteBigEndian(source_symbol, static_cast<uint16_t>(media_packet.size()));
+        memcpy(source_symbol + RsFecHeader::kSymbolLengthSize, media_packet.cdata(), media_packet.size());
+        source_symbols[i] = source_symbol;
+    }
+
+    RsFecHeader header;
+    header.protected_ssrc = protected_media_ssrc_;
+    header.seq_num_base = ByteReader<uint16_t>::ReadBigEndian(&media_packets_.front().cdata()[2]);
+    header.num_media_packets = static_cast<uint8_t>(num_media_packets);
+    header.num_fec_packets = static_cast<uint8_t>(num_fec_packets);
+    header.symbol_size = static_cast<uint16_t>(symbol_size);
+    for (size_t fec_index = 0; fec_index < num_fec_packets; ++fec_index) {
+        CopyOnWriteBuffer fec_packet(RsFecHeader::kSize + symbol_size);
+        header.fec_index = static_cast<uint8_t>(fec_index);
+        header.Write(fec_packet.data());
+        RsFecCodec::Encode(source_symbols, symbol_size, fec_index, fec_packet.data() + RsFecHeader::kSize);
+        generated_fec_packets_.push_back(std::move(fec_packet));
+    }
+    ResetBlock();
+}
+
+void RsFecGenerator::ResetBlock() {
+    media_packets_.clear();
+    num_protected_frames_ = 0;
+    contains_key_frame_ = false;
+}
+    
+} // namespace naivertc
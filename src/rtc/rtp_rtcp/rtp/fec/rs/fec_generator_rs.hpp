@@ -0,0 +1,69 @@
+#ifndef _RTC_RTP_RTCP_FEC_RS_FEC_GENERATOR_RS_H_
+#define _RTC_RTP_RTCP_FEC_RS_FEC_GENERATOR_RS_H_
+
+#include "base/defines.hpp"
+#include "rtc/base/time/clock.hpp"
+#include "rtc/base/copy_on_write_buffer.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/fec_generator.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/fec_defines.hpp"
+
+#include <optional>
+
+namespace naivertc {
+
+// The Reed-Solomon FEC packets are sent in a separate stream with its own
+// SSRC and sequence number space like FlexFEC, but any |num_fec_packets| lost
+// packets of a block are recovered, no matter how they are lost, so the
+// protection does not depend on the mask type.
+// NOTE: This class is not thread safe, the caller MUST provide that.
+class RsFecGenerator : public FecGenerator {
+public:
+    RsFecGenerator(int payload_type,
+                   uint32_t ssrc,
+                   uint32_t protected_media_ssrc,
+                   Clock* clock);
+    ~RsFecGenerator();
+
+    FecType fec_type() const override { return FecGenerator::FecType::RS_FEC; };
+
+    std::optional<uint32_t> fec_ssrc() override { return ssrc_; };
+
+    std::optional<int> red_payload_type() override { return std::nullopt; };
+
+    size_t MaxPacketOverhead() const override;
+
+    void SetProtectionParameters(const FecProtectionParams& delta_params, const FecProtectionParams& key_params) override;
+
+    void PushMediaPacket(RtpPacketToSend packet) override;
+
+    std::vector<RtpPacketToSend> PopFecPackets() override;
+
+private:
+    const FecProtectionParams& CurrentParams() const;
+    // Generates the repair symbols of the media packets protected so far.
+    void EncodeBlock();
+    void ResetBlock();
+
+private:
+    const int payload_type_;
+    const uint32_t ssrc_;
+    const uint32_t protected_media_ssrc_;
+    Clock* const clock_;
+    const uint32_t timestamp_offset_;
+
+    uint16_t seq_num_;
+
+    using ParamsTuple = std::pair<FecProtectionParams, FecProtectionParams>;
+    ParamsTuple current_params_;
+    std::optional<ParamsTuple> pending_params_;
+
+    size_t num_protected_frames_;
+    bool contains_key_frame_;
+    std::vector<CopyOnWriteBuffer> media_packets_;
+    std::vector<CopyOnWriteBuffer> generated_fec_packets_;
+};
+    
+} // namespace naivertc
+
+
+#endif
@@ -0,0 +1,48 @@
+#include "rtc/rtp_rtcp/rtp/fec/rs/fec_header_rs.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/rs/fec_codec_rs.hpp"
+#include "rtc/base/memory/byte_io_reader.hpp"
+#include "rtc/base/memory/byte_io_writer.hpp"
+
+#include <plog/Log.h>
+
+namespace naivertc {
+
+std::optional<RsFecHeader> RsFecHeader::Parse(const uint8_t* data, size_t size) {
+    if (size < kSize) {
+        PLOG_WARNING << "Truncated Reed-Solomon FEC packet, size=" << size;
+        return std::nullopt;
+    }
+    RsFecHeader header;
+    header.protected_ssrc = ByteReader<uint32_t>::ReadBigEndian(&data[0]);
+    header.seq_num_base = ByteReader<uint16_t>::ReadBigEndian(&data[4]);
+    header.num_media_packets = data[6];
+    header.num_fec_packets = data[7];
+    header.fec_index = data[8];
+    header.symbol_size = ByteReader<uint16_t>::ReadBigEndian(&data[10]);
+    if (header.num_media_packets == 0 ||
+        header.fec_index >= header.num_fec_packets ||
+        size_t(header.num_media_packets) + header.num_fec_packets > RsFecCodec::kMaxSymbols ||
+        header.symbol_size <= kSymbolLengthSize) {
+        PLOG_WARNING << "Invalid Reed-Solomon FEC header.";
+        return std::nullopt;
+    }
+    if (size - kSize != header.symbol_size) {
+        PLOG_WARNING << "The size of the repair symbol mismatches the symbol size="
+                     << header.symbol_size << ".";
+        return std::nullopt;
+    }
+    return header;
+}
+
+void RsFecHeader::Write(uint8_t* data) const {
+    ByteWriter<uint32_t>::WriteBigEndian(&data[0], protected_ssrc);
+    ByteWriter<uint16_t>::WriteBigEndian(&data[4], seq_num_base);
+    data[6] = num_media_packets;
+    data[7] = num_fec_packets;
+    data[8] = fec_index;
+    // Reserved
+    data[9] = 0;
+    ByteWriter<uint16_t>::WriteBigEndian(&data[10], symbol_size);
+}
+
+} // namespace naivertc
@@ -0,0 +1,46 @@
+#ifndef _RTC_RTP_RTCP_FEC_RS_FEC_HEADER_RS_H_
+#define _RTC_RTP_RTCP_FEC_RS_FEC_HEADER_RS_H_
+
+#include "base/defines.hpp"
+
+#include <optional>
+
+namespace naivertc {
+
+// The header of the Reed-Solomon FEC packets, followed by the repair symbol.
+// Each media packet is a source symbol of the block, which is the length of
+// the packet and the whole packet, padded with zeros to the symbol size.
+//    0                   1                   2                   3
+//    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |                         Protected SSRC                        |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |          SN base              |  Media count  |   FEC count   |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |   FEC index   |   reserved    |          Symbol size          |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// NOTE: There is no standard payload format of the Reed-Solomon FEC for RTP,
+// so both ends MUST agree on it out of band.
+struct RsFecHeader {
+    static constexpr size_t kSize = 12;
+    // The length field prepended to each media packet in the source symbols.
+    static constexpr size_t kSymbolLengthSize = 2;
+
+    uint32_t protected_ssrc = 0;
+    // The sequence number of the first media packet of the block, and the
+    // media packets of a block are consecutive.
+    uint16_t seq_num_base = 0;
+    uint8_t num_media_packets = 0;
+    uint8_t num_fec_packets = 0;
+    // The index of the repair symbol in [0, num_fec_packets).
+    uint8_t fec_index = 0;
+    uint16_t symbol_size = 0;
+
+    static std::optional<RsFecHeader> Parse(const uint8_t* data, size_t size);
+    void Write(uint8_t* data) const;
+};
+
+} // namespace naivertc
+
+
+#endif
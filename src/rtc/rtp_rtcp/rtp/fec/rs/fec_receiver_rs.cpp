@@ -0,0 +1,228 @@
+#include "rtc/rtp_rtcp/rtp/fec/rs/fec_receiver_rs.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/rs/fec_codec_rs.hpp"
+#include "rtc/rtp_rtcp/components/wrap_around_utils.hpp"
+#include "rtc/rtp_rtcp/base/rtp_rtcp_defines.hpp"
+#include "rtc/base/memory/byte_io_reader.hpp"
+#include "rtc/base/memory/byte_io_writer.hpp"
+#include "rtc/base/internals.hpp"
+
+#include <plog/Log.h>
+
+#include <algorithm>
+
+namespace naivertc {
+namespace {
+
+// The maximum number of blocks waiting for the recovery.
+constexpr size_t kMaxPendingBlocks = 16;
+// The blocks whose media packets are older than this are discarded, which
+// keeps all the media packets of the pending blocks in the ring.
+constexpr uint16_t kMaxBlockAge = 256 - kRsFecMaxMediaPackets;
+
+} // namespace
+
+RsFecReceiver::RsFecReceiver(uint32_t ssrc,
+                             uint32_t protected_media_ssrc,
+                             Clock* clock, 
+                             RecoveredPacketReceiver* recovered_packet_receiver) 
+    : ssrc_(ssrc),
+      protected_media_ssrc_(protected_media_ssrc),
+      clock_(clock),
+      recovered_packet_receiver_(recovered_packet_receiver) {}
+
+RsFecReceiver::~RsFecReceiver() = default;
+
+bool RsFecReceiver::OnRtpPacket(const RtpPacketReceived& rtp_packet) {
+    // Do not pass recovered packets to FEC, which are decoded already.
+    if (rtp_packet.is_recovered()) {
+        return false;
+    }
+    if (rtp_packet.size() > kIpPacketSize) {
+        PLOG_WARNING << "Received packet with length exceeds maxmimum typical IP packet size, dropping.";
+        return false;
+    }
+
+    const uint32_t ssrc = rtp_packet.ssrc();
+    if (ssrc == ssrc_) {
+        const CopyOnWriteBuffer payload = rtp_packet.PayloadBuffer();
+        auto header = RsFecHeader::Parse(payload.cdata(), payload.size());
+        if (!header || header->protected_ssrc != protected_media_ssrc_) {
+            PLOG_WARNING << "Received an invalid Reed-Solomon FEC packet, dropping.";
+            return false;
+        }
+        ++packet_counter_.num_received_fec_packets;
+        OnFecPacket(*header, CopyOnWriteBuffer(payload.cdata() + RsFecHeader::kSize, header->symbol_size));
+    } else if (ssrc == protected_media_ssrc_) {
+        // The media packets are protected in their entirety.
+        OnMediaPacket(rtp_packet.sequence_number(), CopyOnWriteBuffer(rtp_packet.cdata(), rtp_packet.size()));
+    } else {
+        PLOG_WARNING << "Received packet with SSRC=" << ssrc 
+                     << " is neither Reed-Solomon FEC packet nor the protected media packet, dropping.";
+        return false;
+    }
+
+    ++packet_counter_.num_received_packets;
+    packet_counter_.num_received_bytes += rtp_packet.size();
+    if (packet_counter_.first_packet_arrival_time_ms == -1) {
+        packet_counter_.first_packet_arrival_time_ms = clock_->now_ms();
+    }
+    return true;
+}
+
+// Private methods
+void RsFecReceiver::OnMediaPacket(uint16_t seq_num, CopyOnWriteBuffer packet) {
+    if (FindMediaPacket(seq_num) != nullptr) {
+        // Duplicate or recovered already.
+        return;
+    }
+    StoreMediaPacket(seq_num, std::move(packet));
+    DiscardOldBlocks();
+    for (auto& block : blocks_) {
+        if (IsInBlock(block, seq_num)) {
+            TryToRecover(block);
+        }
+    }
+}
+
+void RsFecReceiver::OnFecPacket(const RsFecHeader& header, CopyOnWriteBuffer repair_symbol) {
+    auto it = std::find_if(blocks_.begin(), blocks_.end(), [&header](const Block& block){
+        return block.header.seq_num_base == header.seq_num_base &&
+               block.header.num_media_packets == header.num_media_packets;
+    });
+    if (it == blocks_.end()) {
+        if (blocks_.size() >= kMaxPendingBlocks) {
+            blocks_.pop_front();
+        }
+        Block block;
+        block.header = header;
+        block.repair_symbols.resize(header.num_fec_packets);
+        blocks_.push_back(std::move(block));
+        it = std::prev(blocks_.end());
+    }
+    Block& block = *it;
+    if (block.complete || 
+        block.header.num_fec_packets != header.num_fec_packets ||
+        block.header.symbol_size != header.symbol_size) {
+        return;
+    }
+    auto& stored_repair_symbol = block.repair_symbols[header.fec_index];
+    if (!stored_repair_symbol.empty()) {
+        return;
+    }
+    stored_repair_symbol = std::move(repair_symbol);
+    ++block.num_repair_symbols;
+    TryToRecover(block);
+    DiscardOldBlocks();
+}
+
+const CopyOnWriteBuffer* RsFecReceiver::FindMediaPacket(uint16_t seq_num) const {
+    const auto& media_packet = media_packets_[seq_num % kMediaPacketRingSize];
+    if (media_packet && media_packet->seq_num == seq_num) {
+        return &media_packet->pkt;
+    }
+    return nullptr;
+}
+
+void RsFecReceiver::StoreMediaPacket(uint16_t seq_num, CopyOnWriteBuffer packet) {
+    media_packets_[seq_num % kMediaPacketRingSize] = MediaPacket{seq_num, std::move(packet)};
+    if (!newest_media_seq_num_ || wrap_around_utils::AheadOf<uint16_t>(seq_num, *newest_media_seq_num_)) {
+        newest_media_seq_num_ = seq_num;
+    }
+}
+
+bool RsFecReceiver::IsInBlock(const Block& block, uint16_t seq_num) const {
+    return static_cast<uint16_t>(seq_num - block.header.seq_num_base) < block.header.num_media_packets;
+}
+
+void RsFecReceiver::TryToRecover(Block& block) {
+    if (block.complete) {
+        return;
+    }
+    const size_t num_media_packets = block.header.num_media_packets;
+    const size_t symbol_size = block.header.symbol_size;
+    std::vector<bool> erased(num_media_packets, false);
+    size_t num_erased = 0;
+    for (size_t i = 0; i < num_media_packets; ++i) {
+        const CopyOnWriteBuffer* media_packet = FindMediaPacket(static_cast<uint16_t>(block.header.seq_num_base + i));
+        if (media_packet == nullptr) {
+            erased[i] = true;
+            ++num_erased;
+        }
+    }
+    if (num_erased == 0) {
+        block.complete = true;
+        return;
+    }
+    if (num_erased > block.num_repair_symbols) {
+        // Not enough packets to recover yet.
+        return;
+    }
+
+    std::vector<uint8_t> source_data(num_media_packets * symbol_size, 0);
+    std::vector<uint8_t*> source_symbols(num_media_packets);
+    for (size_t i = 0; i < num_media_packets; ++i) {
+        source_symbols[i] = &source_data[i * symbol_size];
+        if (erased[i]) {
+            continue;
+        }
+        const CopyOnWriteBuffer* media_packet = FindMediaPacket(static_cast<uint16_t>(block.header.seq_num_base + i));
+        if (RsFecHeader::kSymbolLengthSize + media_packet->size() > symbol_size) {
+            PLOG_WARNING << "The media packet is larger than the symbol size=" << symbol_size 
+                         << ", can not recover the block.";
+            block.complete = true;
+            return;
+        }
+        ByteWriter<uint16_t>::WriteBigEndian(source_symbols[i], static_cast<uint16_t>(media_packet->size()));
+        memcpy(source_symbols[i] + RsFecHeader::kSymbolLengthSize, media_packet->cdata(), media_packet->size());
+    }
+    std::vector<RsFecCodec::RepairSymbol> repair_symbols;
+    repair_symbols.reserve(block.num_repair_symbols);
+    for (size_t fec_index = 0; fec_index < block.repair_symbols.size(); ++fec_index) {
+        if (!block.repair_symbols[fec_index].empty()) {
+            repair_symbols.push_back({fec_index, block.repair_symbols[fec_index].cdata()});
+        }
+    }
+
+    block.complete = true;
+    if (!RsFecCodec::Decode(source_symbols, erased, repair_symbols, symbol_size)) {
+        PLOG_WARNING << "Failed to decode the Reed-Solomon FEC block.";
+        return;
+    }
+
+    for (size_t i = 0; i < num_media_packets; ++i) {
+        if (!erased[i]) {
+            continue;
+        }
+        const uint16_t seq_num = static_cast<uint16_t>(block.header.seq_num_base + i);
+        const uint8_t* source_symbol = source_symbols[i];
+        const size_t packet_size = ByteReader<uint16_t>::ReadBigEndian(source_symbol);
+        if (packet_size < kRtpHeaderSize || 
+            RsFecHeader::kSymbolLengthSize + packet_size > symbol_size ||
+            ByteReader<uint16_t>::ReadBigEndian(&source_symbol[RsFecHeader::kSymbolLengthSize + 2]) != seq_num) {
+            PLOG_WARNING << "Recovered an invalid media packet, seq_num=" << seq_num;
+            continue;
+        }
+        CopyOnWriteBuffer recovered_packet(source_symbol + RsFecHeader::kSymbolLengthSize, packet_size);
+        StoreMediaPacket(seq_num, recovered_packet);
+        ++packet_counter_.num_recovered_packets;
+        if (recovered_packet_receiver_) {
+            recovered_packet_receiver_->OnRecoveredPacket(std::move(recovered_packet));
+        }
+    }
+}
+
+void RsFecReceiver::DiscardOldBlocks() {
+    while (!blocks_.empty()) {
+        const Block& block = blocks_.front();
+        const uint16_t last_seq_num = static_cast<uint16_t>(block.header.seq_num_base + block.header.num_media_packets - 1);
+        const bool is_old = newest_media_seq_num_ && 
+                            wrap_around_utils::AheadOf<uint16_t>(*newest_media_seq_num_, last_seq_num) &&
+                            static_cast<uint16_t>(*newest_media_seq_num_ - last_seq_num) > kMaxBlockAge;
+        if (!block.complete && !is_old) {
+            break;
+        }
+        blocks_.pop_front();
+    }
+}
+    
+} // namespace naivertc
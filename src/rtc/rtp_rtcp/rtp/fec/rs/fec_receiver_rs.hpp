@@ -0,0 +1,79 @@
+#ifndef _RTC_RTP_RTCP_FEC_RS_FEC_RECEIVER_RS_H_
+#define _RTC_RTP_RTCP_FEC_RS_FEC_RECEIVER_RS_H_
+
+#include "base/defines.hpp"
+#include "rtc/base/time/clock.hpp"
+#include "rtc/rtp_rtcp/rtp/packets/rtp_packet_received.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/fec_defines.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/rs/fec_header_rs.hpp"
+#include "rtc/rtp_rtcp/base/rtp_rtcp_interfaces.hpp"
+
+#include <array>
+#include <deque>
+#include <optional>
+
+namespace naivertc {
+
+// Receives the Reed-Solomon FEC packets in a separate stream and the media
+// packets protected by them, and recovers the lost media packets of a block
+// as soon as any |num_media_packets| packets of the block are received.
+class RsFecReceiver {
+public:
+    // Packet counter
+    using PacketCounter = FecPacketCounter;
+
+public:
+    RsFecReceiver(uint32_t ssrc,
+                  uint32_t protected_media_ssrc,
+                  Clock* clock, 
+                  RecoveredPacketReceiver* recovered_packet_receiver);
+    ~RsFecReceiver();
+
+    // Inserts a received Reed-Solomon FEC packet or a media packet protected by it.
+    bool OnRtpPacket(const RtpPacketReceived& rtp_packet);
+
+    PacketCounter packet_counter() const { return packet_counter_; }
+
+private:
+    struct Block {
+        RsFecHeader header;
+        // The repair symbols indexed by the FEC index.
+        std::vector<CopyOnWriteBuffer> repair_symbols;
+        size_t num_repair_symbols = 0;
+        // All the media packets of the block are received or recovered.
+        bool complete = false;
+    };
+
+    void OnMediaPacket(uint16_t seq_num, CopyOnWriteBuffer packet);
+    void OnFecPacket(const RsFecHeader& header, CopyOnWriteBuffer repair_symbol);
+
+    const CopyOnWriteBuffer* FindMediaPacket(uint16_t seq_num) const;
+    void StoreMediaPacket(uint16_t seq_num, CopyOnWriteBuffer packet);
+    bool IsInBlock(const Block& block, uint16_t seq_num) const;
+    void TryToRecover(Block& block);
+    void DiscardOldBlocks();
+
+private:
+    // The media packets are indexed by the low bits of their sequence numbers.
+    static constexpr size_t kMediaPacketRingSize = 256;
+    struct MediaPacket {
+        uint16_t seq_num = 0;
+        CopyOnWriteBuffer pkt;
+    };
+
+    const uint32_t ssrc_;
+    const uint32_t protected_media_ssrc_;
+    Clock* const clock_;
+    RecoveredPacketReceiver* recovered_packet_receiver_;
+
+    std::array<std::optional<MediaPacket>, kMediaPacketRingSize> media_packets_;
+    std::optional<uint16_t> newest_media_seq_num_;
+    std::deque<Block> blocks_;
+
+    PacketCounter packet_counter_;
+};
+    
+} // namespace naivertc
+
+
+#endif
@@ -0,0 +1,402 @@
+#include "rtc/rtp_rtcp/rtp/fec/rs/fec_receiver_rs.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/rs/fec_generator_rs.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/ulp/fec_receiver_ulp.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/fec_encoder.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/fec_test_helper.hpp"
+#include "rtc/base/memory/byte_io_writer.hpp"
+#include "testing/simulated_clock.hpp"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#define ENABLE_UNIT_TESTS 0
+#include "testing/defines.hpp"
+
+namespace naivertc {
+namespace test {
+namespace {
+
+using ::testing::_;
+
+constexpr uint8_t kRsFecPayloadType = 96;
+constexpr uint8_t kUlpFecPayloadType = 97;
+constexpr uint8_t kRedPayloadType = 98;
+constexpr uint8_t kMediaPayloadType = 120;
+
+constexpr uint32_t kRsFecSsrc = 42984;
+constexpr uint32_t kMediaSsrc = 835424;
+
+constexpr size_t kPayloadSize = 100;
+
+// 50% protection in the [0, 255] domain.
+constexpr FecProtectionParams kProtectionParams = {128, 1, FecMaskType::RANDOM};
+
+RtpPacketReceived ToReceivedPacket(const RtpPacket& rtp_packet) {
+    RtpPacketReceived received_packet;
+    EXPECT_TRUE(received_packet.Parse(rtp_packet.cdata(), rtp_packet.size()));
+    return received_packet;
+}
+
+RtpPacketToSend ToPacketToSend(const RtpPacket& rtp_packet) {
+    RtpPacketToSend packet_to_send(kIpPacketSize);
+    EXPECT_TRUE(packet_to_send.Parse(rtp_packet.cdata(), rtp_packet.size()));
+    packet_to_send.set_packet_type(RtpPacketType::VIDEO);
+    return packet_to_send;
+}
+    
+} // namespace
+
+// MockRecoveredPacketReceiver
+class MockRecoveredPacketReceiver : public RecoveredPacketReceiver {
+public:
+    MOCK_METHOD(void, 
+                OnRecoveredPacket, 
+                (CopyOnWriteBuffer recovered_packet), 
+                (override));
+};
+
+// RsFecReceiverTest
+class T(RsFecReceiverTest) : public ::testing::Test {
+protected:
+    T(RsFecReceiverTest)() 
+        : clock_(0x100),
+          fec_generator_(kRsFecPayloadType, kRsFecSsrc, kMediaSsrc, &clock_),
+          fec_receiver_(kRsFecSsrc, kMediaSsrc, &clock_, &recovered_packet_receiver_),
+          packet_generator_(kMediaSsrc, kMediaPayloadType) {
+        fec_generator_.SetProtectionParameters(kProtectionParams, kProtectionParams);
+    }
+
+    // Packetizes a frame and protects it with the Reed-Solomon FEC packets.
+    std::vector<RtpPacketToSend> PacketizeAndProtectFrame(size_t num_media_packets, 
+                                                          std::vector<RtpPacket>& media_packets) {
+        packet_generator_.NewFrame(num_media_packets);
+        for (size_t i = 0; i < num_media_packets; ++i) {
+            // The media packets of different sizes.
+            RtpPacket rtp_packet = packet_generator_.NextRtpPacket(kPayloadSize + i * 13);
+            fec_generator_.PushMediaPacket(ToPacketToSend(rtp_packet));
+            media_packets.push_back(std::move(rtp_packet));
+        }
+        return fec_generator_.PopFecPackets();
+    }
+
+protected:
+    SimulatedClock clock_;
+    MockRecoveredPacketReceiver recovered_packet_receiver_;
+    RsFecGenerator fec_generator_;
+    RsFecReceiver fec_receiver_;
+    RtpPacketGenerator packet_generator_;
+};
+
+MY_TEST_F(RsFecReceiverTest, GeneratesFecPacketsInSeparateStream) {
+    std::vector<RtpPacket> media_packets;
+    auto fec_packets = PacketizeAndProtectFrame(4, media_packets);
+    ASSERT_EQ(2u, fec_packets.size());
+    EXPECT_EQ(FecGenerator::FecType::RS_FEC, fec_generator_.fec_type());
+    EXPECT_EQ(kRsFecSsrc, fec_generator_.fec_ssrc());
+
+    const uint16_t first_seq_num = fec_packets[0].sequence_number();
+    for (size_t i = 0; i < fec_packets.size(); ++i) {
+        const auto& fec_packet = fec_packets[i];
+        EXPECT_EQ(kRsFecPayloadType, fec_packet.payload_type());
+        EXPECT_EQ(kRsFecSsrc, fec_packet.ssrc());
+        EXPECT_EQ(static_cast<uint16_t>(first_seq_num + i), fec_packet.sequence_number());
+        EXPECT_EQ(RtpPacketType::FEC, fec_packet.packet_type());
+        EXPECT_FALSE(fec_packet.allow_retransmission());
+        // The FEC packets are not larger than the largest media packet plus the overhead.
+        EXPECT_EQ(fec_packet.size(), kRtpHeaderSize + fec_generator_.MaxPacketOverhead() + media_packets.back().size());
+
+        auto header = RsFecHeader::Parse(fec_packet.payload().data(), fec_packet.payload_size());
+        ASSERT_TRUE(header);
+        EXPECT_EQ(kMediaSsrc, header->protected_ssrc);
+        EXPECT_EQ(media_packets[0].sequence_number(), header->seq_num_base);
+        EXPECT_EQ(4, header->num_media_packets);
+        EXPECT_EQ(2, header->num_fec_packets);
+        EXPECT_EQ(i, header->fec_index);
+    }
+    // The sequence numbers continue in the next frame.
+    auto next_fec_packets = PacketizeAndProtectFrame(4, media_packets);
+    ASSERT_FALSE(next_fec_packets.empty());
+    EXPECT_EQ(static_cast<uint16_t>(first_seq_num + fec_packets.size()), next_fec_packets[0].sequence_number());
+}
+
+MY_TEST_F(RsFecReceiverTest, DropsPacketsOfUnprotectedStream) {
+    RtpPacketGenerator packet_generator(kMediaSsrc + 1, kMediaPayloadType);
+    packet_generator.NewFrame(1);
+    auto rtp_packet = packet_generator.NextRtpPacket(kPayloadSize);
+
+    fec_generator_.PushMediaPacket(ToPacketToSend(rtp_packet));
+    EXPECT_TRUE(fec_generator_.PopFecPackets().empty());
+    EXPECT_FALSE(fec_receiver_.OnRtpPacket(ToReceivedPacket(rtp_packet)));
+    EXPECT_EQ(0u, fec_receiver_.packet_counter().num_received_packets);
+}
+
+MY_TEST_F(RsFecReceiverTest, RecoversBurstOfLostMediaPackets) {
+    constexpr size_t kNumMediaPackets = 10;
+    std::vector<RtpPacket> media_packets;
+    auto fec_packets = PacketizeAndProtectFrame(kNumMediaPackets, media_packets);
+    ASSERT_EQ(5u, fec_packets.size());
+
+    // The last 5 media packets are lost in a burst, which is more than any
+    // XOR mask of the same overhead can recover.
+    for (size_t i = 0; i < 5; ++i) {
+        EXPECT_TRUE(fec_receiver_.OnRtpPacket(ToReceivedPacket(media_packets[i])));
+    }
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_TRUE(fec_receiver_.OnRtpPacket(ToReceivedPacket(fec_packets[i])));
+    }
+    for (size_t i = 5; i < kNumMediaPackets; ++i) {
+        EXPECT_CALL(recovered_packet_receiver_, OnRecoveredPacket(media_packets[i])).Times(1);
+    }
+    EXPECT_TRUE(fec_receiver_.OnRtpPacket(ToReceivedPacket(fec_packets[4])));
+
+    auto packet_counter = fec_receiver_.packet_counter();
+    EXPECT_EQ(10u, packet_counter.num_received_packets);
+    EXPECT_EQ(5u, packet_counter.num_received_fec_packets);
+    EXPECT_EQ(5u, packet_counter.num_recovered_packets);
+}
+
+MY_TEST_F(RsFecReceiverTest, RecoversLostMediaPacketsWhenFecPacketsArriveFirst) {
+    constexpr size_t kNumMediaPackets = 4;
+    std::vector<RtpPacket> media_packets;
+    auto fec_packets = PacketizeAndProtectFrame(kNumMediaPackets, media_packets);
+    ASSERT_EQ(2u, fec_packets.size());
+
+    // Nothing to recover while all the media packets are missing.
+    EXPECT_CALL(recovered_packet_receiver_, OnRecoveredPacket(_)).Times(0);
+    for (const auto& fec_packet : fec_packets) {
+        EXPECT_TRUE(fec_receiver_.OnRtpPacket(ToReceivedPacket(fec_packet)));
+    }
+    EXPECT_TRUE(fec_receiver_.OnRtpPacket(ToReceivedPacket(media_packets[0])));
+
+    // The other two media packets are recovered once any 4 packets are received.
+    EXPECT_CALL(recovered_packet_receiver_, OnRecoveredPacket(media_packets[2])).Times(1);
+    EXPECT_CALL(recovered_packet_receiver_, OnRecoveredPacket(media_packets[3])).Times(1);
+    EXPECT_TRUE(fec_receiver_.OnRtpPacket(ToReceivedPacket(media_packets[1])));
+
+    // The late media packets are not recovered again.
+    EXPECT_TRUE(fec_receiver_.OnRtpPacket(ToReceivedPacket(media_packets[3])));
+    EXPECT_EQ(2u, fec_receiver_.packet_counter().num_recovered_packets);
+}
+
+MY_TEST_F(RsFecReceiverTest, ProtectsMultipleFramesInOneBlock) {
+    const FecProtectionParams params = {128, 2, FecMaskType::RANDOM};
+    fec_generator_.SetProtectionParameters(params, params);
+    std::vector<RtpPacket> media_packets;
+    // No FEC packets until the second frame is complete.
+    EXPECT_TRUE(PacketizeAndProtectFrame(2, media_packets).empty());
+    auto fec_packets = PacketizeAndProtectFrame(2, media_packets);
+    ASSERT_EQ(2u, fec_packets.size());
+
+    // One media packet of each frame is lost.
+    EXPECT_CALL(recovered_packet_receiver_, OnRecoveredPacket(media_packets[0])).Times(1);
+    EXPECT_CALL(recovered_packet_receiver_, OnRecoveredPacket(media_packets[3])).Times(1);
+    EXPECT_TRUE(fec_receiver_.OnRtpPacket(ToReceivedPacket(media_packets[1])));
+    EXPECT_TRUE(fec_receiver_.OnRtpPacket(ToReceivedPacket(media_packets[2])));
+    for (const auto& fec_packet : fec_packets) {
+        EXPECT_TRUE(fec_receiver_.OnRtpPacket(ToReceivedPacket(fec_packet)));
+    }
+}
+
+MY_TEST_F(RsFecReceiverTest, DoesNotRecoverWithTooFewPackets) {
+    std::vector<RtpPacket> media_packets;
+    auto fec_packets = PacketizeAndProtectFrame(4, media_packets);
+    ASSERT_EQ(2u, fec_packets.size());
+
+    // 3 media packets are lost, but only 2 FEC packets.
+    EXPECT_CALL(recovered_packet_receiver_, OnRecoveredPacket(_)).Times(0);
+    EXPECT_TRUE(fec_receiver_.OnRtpPacket(ToReceivedPacket(media_packets[0])));
+    for (const auto& fec_packet : fec_packets) {
+        EXPECT_TRUE(fec_receiver_.OnRtpPacket(ToReceivedPacket(fec_packet)));
+    }
+}
+
+MY_TEST_F(RsFecReceiverTest, DropsInvalidFecPackets) {
+    std::vector<RtpPacket> media_packets;
+    auto fec_packets = PacketizeAndProtectFrame(2, media_packets);
+    ASSERT_EQ(1u, fec_packets.size());
+
+    // Truncated repair symbol.
+    RtpPacket truncated_packet = fec_packets[0];
+    truncated_packet.set_payload_size(fec_packets[0].payload_size() - 1);
+    EXPECT_FALSE(fec_receiver_.OnRtpPacket(ToReceivedPacket(truncated_packet)));
+    // Protecting the other stream.
+    RtpPacket other_stream_packet = fec_packets[0];
+    ByteWriter<uint32_t>::WriteBigEndian(other_stream_packet.data() + kRtpHeaderSize, kMediaSsrc + 1);
+    EXPECT_FALSE(fec_receiver_.OnRtpPacket(ToReceivedPacket(other_stream_packet)));
+    EXPECT_EQ(0u, fec_receiver_.packet_counter().num_received_fec_packets);
+}
+
+MY_TEST_F(RsFecReceiverTest, DoesNotDecodeRecoveredPackets) {
+    std::vector<RtpPacket> media_packets;
+    auto fec_packets = PacketizeAndProtectFrame(2, media_packets);
+    ASSERT_EQ(1u, fec_packets.size());
+
+    auto recovered_packet = ToReceivedPacket(media_packets[0]);
+    recovered_packet.set_is_recovered(true);
+    EXPECT_FALSE(fec_receiver_.OnRtpPacket(recovered_packet));
+
+    // Not enough packets to recover the lost one.
+    EXPECT_CALL(recovered_packet_receiver_, OnRecoveredPacket(_)).Times(0);
+    EXPECT_TRUE(fec_receiver_.OnRtpPacket(ToReceivedPacket(fec_packets[0])));
+}
+
+// Benchmark
+namespace {
+
+constexpr size_t kNumFrames = 3000;
+constexpr size_t kNumPacketsPerFrame = 10;
+
+struct LossScenario {
+    const char* name;
+    double loss_fraction;
+    double mean_burst_length;
+};
+
+struct RecoveryResult {
+    size_t num_lost_media_packets = 0;
+    size_t num_recovered_packets = 0;
+    size_t num_fec_packets = 0;
+    // The frames with any media packet neither received nor recovered,
+    // which can not be decoded.
+    size_t num_lost_frames = 0;
+
+    double residual_loss() const {
+        return static_cast<double>(num_lost_media_packets - num_recovered_packets) / (kNumFrames * kNumPacketsPerFrame);
+    }
+    double frame_loss() const {
+        return static_cast<double>(num_lost_frames) / kNumFrames;
+    }
+    double overhead() const {
+        return static_cast<double>(num_fec_packets) / (kNumFrames * kNumPacketsPerFrame);
+    }
+};
+
+class NullRecoveredPacketReceiver : public RecoveredPacketReceiver {
+public:
+    void OnRecoveredPacket(CopyOnWriteBuffer recovered_packet) override {}
+};
+
+// ULPFEC over RED, with the mask designed for the loss pattern.
+RecoveryResult SimulateUlpFec(const LossScenario& scenario, uint8_t fec_rate) {
+    SimulatedClock clock(0x100);
+    LossChannel channel(scenario.loss_fraction, scenario.mean_burst_length);
+    NullRecoveredPacketReceiver recovered_packet_receiver;
+    UlpFecReceiver fec_receiver(kMediaSsrc, &clock, &recovered_packet_receiver);
+    auto fec_encoder = FecEncoder::CreateUlpFecEncoder();
+    UlpFecPacketGenerator packet_generator(kMediaSsrc, kMediaPayloadType, kUlpFecPayloadType, kRedPayloadType);
+    const FecMaskType mask_type = scenario.mean_burst_length > 1 ? FecMaskType::BURSTY : FecMaskType::RANDOM;
+
+    RecoveryResult result;
+    for (size_t frame = 0; frame < kNumFrames; ++frame) {
+        const size_t num_lost_media_packets = result.num_lost_media_packets;
+        const size_t num_recovered_packets = fec_receiver.packet_counter().num_recovered_packets;
+        FecEncoder::PacketList media_packets;
+        packet_generator.NewFrame(kNumPacketsPerFrame);
+        for (size_t i = 0; i < kNumPacketsPerFrame; ++i) {
+            media_packets.push_back(packet_generator.NextRtpPacket(kPayloadSize));
+        }
+        FecEncoder::FecPacketList fec_packets;
+        EXPECT_TRUE(fec_encoder->Encode(media_packets, fec_rate, 0, false, mask_type, fec_packets));
+        for (const auto& media_packet : media_packets) {
+            if (channel.Lost()) {
+                ++result.num_lost_media_packets;
+                continue;
+            }
+            fec_receiver.OnRedPacket(packet_generator.BuildMediaRedPacket(media_packet), kUlpFecPayloadType);
+        }
+        for (const auto& fec_packet : fec_packets) {
+            ++result.num_fec_packets;
+            // Builds the RED packet anyway to keep the sequence numbers.
+            auto red_packet = packet_generator.BuildUlpFecRedPacket(fec_packet);
+            if (!channel.Lost()) {
+                fec_receiver.OnRedPacket(red_packet, kUlpFecPayloadType);
+            }
+        }
+        if (result.num_lost_media_packets - num_lost_media_packets >
+            fec_receiver.packet_counter().num_recovered_packets - num_recovered_packets) {
+            ++result.num_lost_frames;
+        }
+        clock.AdvanceTimeMs(33);
+    }
+    result.num_recovered_packets = fec_receiver.packet_counter().num_recovered_packets;
+    return result;
+}
+
+RecoveryResult SimulateRsFec(const LossScenario& scenario, uint8_t fec_rate) {
+    SimulatedClock clock(0x100);
+    LossChannel channel(scenario.loss_fraction, scenario.mean_burst_length);
+    NullRecoveredPacketReceiver recovered_packet_receiver;
+    RsFecGenerator fec_generator(kRsFecPayloadType, kRsFecSsrc, kMediaSsrc, &clock);
+    RsFecReceiver fec_receiver(kRsFecSsrc, kMediaSsrc, &clock, &recovered_packet_receiver);
+    RtpPacketGenerator packet_generator(kMediaSsrc, kMediaPayloadType);
+    const FecProtectionParams params = {fec_rate, 1, FecMaskType::RANDOM};
+    fec_generator.SetProtectionParameters(params, params);
+
+    RecoveryResult result;
+    for (size_t frame = 0; frame < kNumFrames; ++frame) {
+        const size_t num_lost_media_packets = result.num_lost_media_packets;
+        const size_t num_recovered_packets = fec_receiver.packet_counter().num_recovered_packets;
+        packet_generator.NewFrame(kNumPacketsPerFrame);
+        for (size_t i = 0; i < kNumPacketsPerFrame; ++i) {
+            RtpPacket rtp_packet = packet_generator.NextRtpPacket(kPayloadSize);
+            fec_generator.PushMediaPacket(ToPacketToSend(rtp_packet));
+            if (channel.Lost()) {
+                ++result.num_lost_media_packets;
+                continue;
+            }
+            fec_receiver.OnRtpPacket(ToReceivedPacket(rtp_packet));
+        }
+        for (const auto& fec_packet : fec_generator.PopFecPackets()) {
+            ++result.num_fec_packets;
+            if (!channel.Lost()) {
+                fec_receiver.OnRtpPacket(ToReceivedPacket(fec_packet));
+            }
+        }
+        if (result.num_lost_media_packets - num_lost_media_packets >
+            fec_receiver.packet_counter().num_recovered_packets - num_recovered_packets) {
+            ++result.num_lost_frames;
+        }
+        clock.AdvanceTimeMs(33);
+    }
+    result.num_recovered_packets = fec_receiver.packet_counter().num_recovered_packets;
+    return result;
+}
+
+} // namespace
+
+MY_TEST(RsFecRecoveryTest, RecoveryVersusUlpFecOnLossPatterns) {
+    const LossScenario kScenarios[] = {
+        {"5% random loss", 0.05, 1.0},
+        {"5% bursty loss, mean burst 3", 0.05, 3.0},
+        {"10% bursty loss, mean burst 4", 0.10, 4.0},
+        {"10% bursty loss, mean burst 8", 0.10, 8.0},
+    };
+    // 20%, 30% and 50% protection in the [0, 255] domain.
+    const uint8_t kFecRates[] = {51, 77, 128};
+    for (const auto& scenario : kScenarios) {
+        for (uint8_t fec_rate : kFecRates) {
+            const RecoveryResult ulp_fec = SimulateUlpFec(scenario, fec_rate);
+            const RecoveryResult rs_fec = SimulateRsFec(scenario, fec_rate);
+            GTEST_COUT << scenario.name << ", " << rs_fec.overhead() * 100 << "% overhead: "
+                       << "ULPFEC residual loss " << ulp_fec.residual_loss() * 100 << "%"
+                       << ", frame loss " << ulp_fec.frame_loss() * 100 << "%"
+                       << "; Reed-Solomon residual loss " << rs_fec.residual_loss() * 100 << "%"
+                       << ", frame loss " << rs_fec.frame_loss() * 100 << "%"
+                       << std::endl;
+            // Both codes send the same number of packets, which are lost in
+            // the same pattern.
+            ASSERT_EQ(ulp_fec.num_fec_packets, rs_fec.num_fec_packets);
+            ASSERT_EQ(ulp_fec.num_lost_media_packets, rs_fec.num_lost_media_packets);
+            // The Reed-Solomon code recovers a frame whenever ULPFEC does, but
+            // not the part of a frame beyond its capacity, which the XOR masks
+            // may do, so it may recover fewer packets under the bursty loss.
+            EXPECT_LE(rs_fec.num_lost_frames, ulp_fec.num_lost_frames) << scenario.name;
+            if (scenario.mean_burst_length <= 1) {
+                EXPECT_LT(rs_fec.residual_loss(), ulp_fec.residual_loss()) << scenario.name;
+            }
+        }
+    }
+}
+
+} // namespace test
+} // namespace naivertc
@@ -0,0 +1,211 @@
+#include "rtc/rtp_rtcp/rtp/fec/rs/galois_field.hpp"
+
+#include <atomic>
+#include <cassert>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RTC_GF_MUL_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define RTC_GF_MUL_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace naivertc {
+namespace {
+
+constexpr unsigned kPrimitivePolynomial = 0x11D;
+
+using MultiplyAccumulateFunc = void (*)(uint8_t coef, const uint8_t* src, uint8_t* dst, size_t size);
+
+struct MultiplyKernel {
+    const char* name;
+    MultiplyAccumulateFunc func;
+};
+
+struct Tables {
+    // exp[i] = 2^i, doubled to skip the modulo of the sum of two logs.
+    uint8_t exp[510];
+    uint8_t log[256];
+    // The products of each coefficient with the low and high nibbles,
+    // coef * b = low[coef][b & 0x0F] ^ high[coef][b >> 4], which are
+    // looked up 16 bytes at a time by the vector kernels.
+    alignas(16) uint8_t low[256][16];
+    alignas(16) uint8_t high[256][16];
+
+    Tables() {
+        unsigned x = 1;
+        for (int i = 0; i < 255; ++i) {
+            exp[i] = exp[i + 255] = static_cast<uint8_t>(x);
+            log[x] = static_cast<uint8_t>(i);
+            x <<= 1;
+            if (x & 0x100) {
+                x ^= kPrimitivePolynomial;
+            }
+        }
+        log[0] = 0;
+        for (int coef = 0; coef < 256; ++coef) {
+            for (int nibble = 0; nibble < 16; ++nibble) {
+                low[coef][nibble] = Mul(static_cast<uint8_t>(coef), static_cast<uint8_t>(nibble));
+                high[coef][nibble] = Mul(static_cast<uint8_t>(coef), static_cast<uint8_t>(nibble << 4));
+            }
+        }
+    }
+
+    uint8_t Mul(uint8_t a, uint8_t b) const {
+        return a == 0 || b == 0 ? 0 : exp[log[a] + log[b]];
+    }
+};
+
+const Tables& GfTables() {
+    static const Tables tables;
+    return tables;
+}
+
+void MultiplyAccumulateScalar(uint8_t coef, const uint8_t* src, uint8_t* dst, size_t size) {
+    const Tables& tables = GfTables();
+    const uint8_t* low = tables.low[coef];
+    const uint8_t* high = tables.high[coef];
+    for (size_t i = 0; i < size; ++i) {
+        dst[i] ^= low[src[i] & 0x0F] ^ high[src[i] >> 4];
+    }
+}
+
+#if defined(RTC_GF_MUL_X86)
+
+__attribute__((target("ssse3")))
+void MultiplyAccumulateSsse3(uint8_t coef, const uint8_t* src, uint8_t* dst, size_t size) {
+    const Tables& tables = GfTables();
+    const __m128i low = _mm_load_si128(reinterpret_cast<const __m128i*>(tables.low[coef]));
+    const __m128i high = _mm_load_si128(reinterpret_cast<const __m128i*>(tables.high[coef]));
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i l = _mm_shuffle_epi8(low, _mm_and_si128(s, mask));
+        __m128i h = _mm_shuffle_epi8(high, _mm_and_si128(_mm_srli_epi64(s, 4), mask));
+        d = _mm_xor_si128(d, _mm_xor_si128(l, h));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), d);
+    }
+    MultiplyAccumulateScalar(coef, src + i, dst + i, size - i);
+}
+
+__attribute__((target("avx2")))
+void MultiplyAccumulateAvx2(uint8_t coef, const uint8_t* src, uint8_t* dst, size_t size) {
+    const Tables& tables = GfTables();
+    // The shuffle looks up in each 128-bit lane separately.
+    const __m256i low = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(tables.low[coef])));
+    const __m256i high = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(tables.high[coef])));
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        __m256i l = _mm256_shuffle_epi8(low, _mm256_and_si256(s, mask));
+        __m256i h = _mm256_shuffle_epi8(high, _mm256_and_si256(_mm256_srli_epi64(s, 4), mask));
+        d = _mm256_xor_si256(d, _mm256_xor_si256(l, h));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), d);
+    }
+    MultiplyAccumulateScalar(coef, src + i, dst + i, size - i);
+}
+
+#elif defined(RTC_GF_MUL_NEON)
+
+void MultiplyAccumulateNeon(uint8_t coef, const uint8_t* src, uint8_t* dst, size_t size) {
+    const Tables& tables = GfTables();
+    const uint8x16_t low = vld1q_u8(tables.low[coef]);
+    const uint8x16_t high = vld1q_u8(tables.high[coef]);
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        uint8x16_t s = vld1q_u8(src + i);
+        uint8x16_t l = vqtbl1q_u8(low, vandq_u8(s, mask));
+        uint8x16_t h = vqtbl1q_u8(high, vshrq_n_u8(s, 4));
+        vst1q_u8(dst + i, veorq_u8(vld1q_u8(dst + i), veorq_u8(l, h)));
+    }
+    MultiplyAccumulateScalar(coef, src + i, dst + i, size - i);
+}
+
+#endif
+
+// Returns the kernels supported by the running CPU, from the fastest to the
+// slowest, the scalar one is always the last.
+const std::vector<MultiplyKernel>& SupportedKernels() {
+    static const std::vector<MultiplyKernel> kernels = [](){
+        std::vector<MultiplyKernel> kernels;
+#if defined(RTC_GF_MUL_X86)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            kernels.push_back({"avx2", &MultiplyAccumulateAvx2});
+        }
+        if (__builtin_cpu_supports("ssse3")) {
+            kernels.push_back({"ssse3", &MultiplyAccumulateSsse3});
+        }
+#elif defined(RTC_GF_MUL_NEON)
+        kernels.push_back({"neon", &MultiplyAccumulateNeon});
+#endif
+        kernels.push_back({"scalar", &MultiplyAccumulateScalar});
+        return kernels;
+    }();
+    return kernels;
+}
+
+std::atomic<const MultiplyKernel*>& CurrentKernel() {
+    static std::atomic<const MultiplyKernel*> kernel(&SupportedKernels().front());
+    return kernel;
+}
+
+} // namespace
+
+uint8_t GaloisField::Multiply(uint8_t a, uint8_t b) {
+    return GfTables().Mul(a, b);
+}
+
+uint8_t GaloisField::Divide(uint8_t a, uint8_t b) {
+    assert(b != 0);
+    if (a == 0) {
+        return 0;
+    }
+    const Tables& tables = GfTables();
+    return tables.exp[tables.log[a] + 255 - tables.log[b]];
+}
+
+uint8_t GaloisField::Inverse(uint8_t a) {
+    return Divide(1, a);
+}
+
+void GaloisField::MultiplyAccumulate(uint8_t coef,
+                                     const uint8_t* src,
+                                     uint8_t* dst,
+                                     size_t size) {
+    if (coef == 0 || size == 0) {
+        return;
+    }
+    MultiplyAccumulateFunc func = CurrentKernel().load(std::memory_order_relaxed)->func;
+    func(coef, src, dst, size);
+}
+
+const char* GaloisField::KernelName() {
+    return CurrentKernel().load()->name;
+}
+
+std::vector<std::string> GaloisField::SupportedKernelNames() {
+    std::vector<std::string> names;
+    for (const auto& kernel : SupportedKernels()) {
+        names.push_back(kernel.name);
+    }
+    return names;
+}
+
+bool GaloisField::SelectKernelForTesting(const std::string& name) {
+    for (const auto& kernel : SupportedKernels()) {
+        if (name == kernel.name) {
+            CurrentKernel().store(&kernel);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace naivertc
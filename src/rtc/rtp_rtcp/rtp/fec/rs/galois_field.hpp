@@ -0,0 +1,39 @@
+#ifndef _RTC_RTP_RTCP_FEC_RS_GALOIS_FIELD_H_
+#define _RTC_RTP_RTCP_FEC_RS_GALOIS_FIELD_H_
+
+#include "base/defines.hpp"
+
+#include <string>
+#include <vector>
+
+namespace naivertc {
+
+// The arithmetic in GF(2^8) with the primitive polynomial
+// x^8 + x^4 + x^3 + x^2 + 1 (0x11D), in which the addition is XOR.
+class GaloisField {
+public:
+    static uint8_t Multiply(uint8_t a, uint8_t b);
+    // |b| MUST NOT be zero.
+    static uint8_t Divide(uint8_t a, uint8_t b);
+    // |a| MUST NOT be zero.
+    static uint8_t Inverse(uint8_t a);
+
+    // dst[i] ^= coef * src[i] for i in [0, size), the inner loop of the
+    // Reed-Solomon encoding and decoding.
+    static void MultiplyAccumulate(uint8_t coef,
+                                   const uint8_t* src,
+                                   uint8_t* dst,
+                                   size_t size);
+
+    // Returns the name of the multiply kernel selected for the running CPU,
+    // one of "avx2", "ssse3", "neon" or "scalar".
+    static const char* KernelName();
+    static std::vector<std::string> SupportedKernelNames();
+    // Returns false if the kernel is not supported by the running CPU.
+    static bool SelectKernelForTesting(const std::string& name);
+};
+
+} // namespace naivertc
+
+
+#endif
@@ -0,0 +1,123 @@
+#include "rtc/rtp_rtcp/rtp/fec/rs/galois_field.hpp"
+
+#include <gtest/gtest.h>
+
+#define ENABLE_UNIT_TESTS 0
+#include "testing/defines.hpp"
+
+#include <chrono>
+
+namespace naivertc {
+namespace test {
+namespace {
+
+constexpr size_t kMaxSize = 100;
+constexpr size_t kMaxOffset = 40;
+constexpr size_t kSymbolSize = 1200;
+
+using SteadyClock = std::chrono::steady_clock;
+
+// The carry-less multiplication reduced by the primitive polynomial,
+// bit by bit.
+uint8_t SlowMultiply(uint8_t a, uint8_t b) {
+    unsigned product = 0;
+    unsigned x = a;
+    for (int bit = 0; bit < 8; ++bit) {
+        if (b & (1 << bit)) {
+            product ^= x;
+        }
+        x <<= 1;
+        if (x & 0x100) {
+            x ^= 0x11D;
+        }
+    }
+    return static_cast<uint8_t>(product);
+}
+
+std::vector<uint8_t> CreateBuffer(size_t size, uint8_t seed) {
+    std::vector<uint8_t> buffer(size);
+    for (size_t i = 0; i < size; ++i) {
+        buffer[i] = static_cast<uint8_t>(seed + i * 7);
+    }
+    return buffer;
+}
+
+} // namespace
+
+MY_TEST(GaloisFieldTest, MultiplyMatchesPolynomialMultiplication) {
+    for (int a = 0; a < 256; ++a) {
+        for (int b = 0; b < 256; ++b) {
+            ASSERT_EQ(SlowMultiply(a, b), GaloisField::Multiply(a, b)) << "a=" << a << " b=" << b;
+        }
+    }
+}
+
+MY_TEST(GaloisFieldTest, DivideIsInverseOfMultiply) {
+    for (int a = 0; a < 256; ++a) {
+        for (int b = 1; b < 256; ++b) {
+            ASSERT_EQ(a, GaloisField::Divide(GaloisField::Multiply(a, b), b)) << "a=" << a << " b=" << b;
+        }
+    }
+    for (int a = 1; a < 256; ++a) {
+        EXPECT_EQ(1, GaloisField::Multiply(a, GaloisField::Inverse(a)));
+    }
+}
+
+// Params: the name of the multiply kernel.
+class T(GaloisFieldKernelTest) : public ::testing::TestWithParam<std::string> {
+public:
+    void SetUp() override {
+        ASSERT_TRUE(GaloisField::SelectKernelForTesting(GetParam()));
+    }
+
+    void TearDown() override {
+        // Restore the fastest kernel for the other tests.
+        GaloisField::SelectKernelForTesting(GaloisField::SupportedKernelNames().front());
+    }
+};
+
+MY_INSTANTIATE_TEST_SUITE_P(MultiplyKernels,
+                            GaloisFieldKernelTest,
+                            ::testing::ValuesIn(GaloisField::SupportedKernelNames()));
+
+MY_TEST_P(GaloisFieldKernelTest, MultiplyAccumulateMatchesBytewise) {
+    EXPECT_EQ(GetParam(), GaloisField::KernelName());
+    const auto src = CreateBuffer(kMaxOffset + kMaxSize, 3);
+    for (int coef = 0; coef < 256; coef += 5) {
+        // Covers the unaligned buffers and the tails.
+        for (size_t offset = 0; offset < kMaxOffset; offset += 7) {
+            for (size_t size = 0; size <= kMaxSize; ++size) {
+                auto dst = CreateBuffer(offset + size, 11);
+                auto expected = dst;
+                for (size_t i = 0; i < size; ++i) {
+                    expected[offset + i] ^= SlowMultiply(coef, src[i]);
+                }
+
+                GaloisField::MultiplyAccumulate(coef, src.data(), dst.data() + offset, size);
+
+                ASSERT_EQ(expected, dst) << "coef=" << coef
+                                         << " offset=" << offset
+                                         << " size=" << size;
+            }
+        }
+    }
+}
+
+MY_TEST_P(GaloisFieldKernelTest, MultiplyAccumulateThroughput) {
+    constexpr size_t kNumIterations = 100000;
+    const auto src = CreateBuffer(kSymbolSize, 3);
+    auto dst = CreateBuffer(kSymbolSize, 11);
+
+    auto start = SteadyClock::now();
+    for (size_t i = 0; i < kNumIterations; ++i) {
+        GaloisField::MultiplyAccumulate(static_cast<uint8_t>(i | 2), src.data(), dst.data(), kSymbolSize);
+    }
+    const int64_t elapsed_ns = std::max<int64_t>(1, std::chrono::duration_cast<std::chrono::nanoseconds>(SteadyClock::now() - start).count());
+
+    GTEST_COUT << GetParam() << " GF(2^8) multiply-accumulate of " << kSymbolSize << " bytes: "
+               << static_cast<double>(kSymbolSize * kNumIterations) / elapsed_ns << " GB/s"
+               << std::endl;
+}
+
+} // namespace test
+} // namespace naivertc
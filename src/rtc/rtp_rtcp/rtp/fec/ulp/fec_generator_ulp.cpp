@@ -34,15 +34,23 @@ constexpr float kMinMediaPacketsAdaptationThreshold = 2.0f;
 
 UlpFecGenerator::UlpFecGenerator(int red_payload_type, 
                                  int fec_payload_type) 
+    : UlpFecGenerator(red_payload_type, 
+                      fec_payload_type, 
+                      FecEncoder::CreateUlpFecEncoder()) {}
+
+UlpFecGenerator::UlpFecGenerator(int red_payload_type, 
+                                 int fec_payload_type,
+                                 std::unique_ptr<FecEncoder> fec_encoder) 
     : red_payload_type_(red_payload_type),
       fec_payload_type_(fec_payload_type),
       num_protected_frames_(0),
       min_num_media_packets_(1),
       contains_key_frame_(false),
-      fec_encoder_(FecEncoder::CreateUlpFecEncoder()),
+      fec_encoder_(std::move(fec_encoder)),
       last_protected_media_packet_(std::nullopt) {
     // Set the capacity to the maximum number of FEC packet can be generated.
     generated_fec_packets_.reserve(fec_encoder_->MaxFecPackets());
+    media_packets_.reserve(kUlpFecMaxMediaPackets);
 }
     
 UlpFecGenerator::~UlpFecGenerator() {}
@@ -16,6 +16,11 @@ class UlpFecGenerator : public FecGenerator {
 public:
     UlpFecGenerator(int red_payload_type, 
                     int fec_payload_type);
+    // Batches the media packets in the same way, but encodes them with
+    // |fec_encoder|, e.g. FlexFEC.
+    UlpFecGenerator(int red_payload_type, 
+                    int fec_payload_type,
+                    std::unique_ptr<FecEncoder> fec_encoder);
     virtual ~UlpFecGenerator();
 
     FecType fec_type() const override { return FecGenerator::FecType::ULP_FEC; }
@@ -33,13 +38,18 @@ public:
 
     std::vector<RtpPacketToSend> PopFecPackets() override;
 
+    // Returns the FEC packets generated without RTP headers, which are valid
+    // until the next call of |PushMediaPacket| or |Reset|.
+    const FecEncoder::FecPacketList& generated_fec_packets() const { return generated_fec_packets_; }
+
+    // Drops the media packets batched and the FEC packets generated.
+    void Reset();
+
 protected:
     const FecProtectionParams& CurrentParams() const;
 
     bool MaxExcessOverheadNotReached(size_t target_fec_rate) const;
     bool MinimumMediaPacketsReached() const;
-
-    void Reset();
     
 private:
     int red_payload_type_;
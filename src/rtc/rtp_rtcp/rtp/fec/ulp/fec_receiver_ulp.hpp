@@ -13,17 +13,7 @@ namespace naivertc {
 class UlpFecReceiver {
 public:
     // Packet counter
-    struct PacketCounter {
-        // Number of received packets.
-        size_t num_received_packets = 0;
-        size_t num_received_bytes = 0;
-        // Number of received FEC packets.
-        size_t num_received_fec_packets = 0;
-        // Number of recovered media packets using FEC.
-        size_t num_recovered_packets = 0;
-        // Time in ms of the first packet is received.
-        int64_t first_packet_arrival_time_ms = -1;
-    };
+    using PacketCounter = FecPacketCounter;
 
 public:
     UlpFecReceiver(uint32_t ssrc, 
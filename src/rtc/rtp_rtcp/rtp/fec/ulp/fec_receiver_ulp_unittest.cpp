@@ -192,6 +192,26 @@ MY_TEST_F(UlpFecReceiverTest, TwoMediaOneFec) {
     EXPECT_EQ(first_packet_arrival_time_ms, fec_packet_counter.first_packet_arrival_time_ms);
 }
 
+// The payload sizes differ in the high nibble of the low byte, which must be
+// recovered too.
+MY_TEST_F(UlpFecReceiverTest, TwoMediaOfDifferentSizesOneFec) {
+    const size_t kNumFecPackets = 1u;
+    FecEncoder::PacketList media_packets;
+    packet_generator_.NewFrame(2);
+    media_packets.push_back(packet_generator_.NextRtpPacket(0x0A /* payload_size */));
+    media_packets.push_back(packet_generator_.NextRtpPacket(0xFA /* payload_size */));
+    EXPECT_EQ(kNumFecPackets, EncoderFec(media_packets, kNumFecPackets));
+
+    VerifyRecoveredMediaPacket(media_packets.front(), 1 /* call_times */);
+    BuildAndAddRedMediaPacket(media_packets.front());
+
+    // Drop the second media packet, and recover it.
+    VerifyRecoveredMediaPacket(media_packets.back(), 1 /* call_times */);
+    BuildAndAddRedFecPacket(generated_fec_packets_.front());
+
+    EXPECT_EQ(1u, fec_receiver_->packet_counter().num_recovered_packets);
+}
+
 MY_TEST_F(UlpFecReceiverTest, TwoMediaOneFecNotUsesRecoveredPackets) {
     const size_t kNumMediaPackets = 2u;
     const size_t kNumFecPackets = 1u;
@@ -0,0 +1,54 @@
+#include "rtc/rtp_rtcp/rtp/packetizer/rtp_deferred_packetizer.hpp"
+#include "rtc/rtp_rtcp/rtp/packetizer/rtp_packetizer_h264.hpp"
+
+#include <plog/Log.h>
+
+namespace naivertc {
+
+std::shared_ptr<RtpDeferredPacketizer> RtpDeferredPacketizer::Create(video::CodecType codec_type,
+                                                                     CopyOnWriteBuffer payload,
+                                                                     const RtpPacketizer::PayloadSizeLimits& limits) {
+    if (codec_type == video::CodecType::H264) {
+        auto packetizer = std::make_unique<RtpH264Packetizer>();
+        // The fragments refer to |payload|, whose data is shared with the
+        // copy held by the deferred packetizer.
+        packetizer->Packetize(ArrayView<const uint8_t>(payload.cdata(), payload.size()), 
+                              limits, 
+                              h264::PacketizationMode::NON_INTERLEAVED);
+        return std::make_shared<RtpDeferredPacketizer>(std::move(payload), std::move(packetizer));
+    } else {
+        PLOG_WARNING << "Unsupported codec type: " << codec_type;
+        return nullptr;
+    }
+}
+
+RtpDeferredPacketizer::RtpDeferredPacketizer(CopyOnWriteBuffer payload, 
+                                             std::unique_ptr<RtpPacketizer> packetizer) 
+    : payload_(std::move(payload)),
+      packetizer_(std::move(packetizer)),
+      payload_sizes_(packetizer_->RemainingPayloadSizes()) {}
+
+RtpDeferredPacketizer::~RtpDeferredPacketizer() = default;
+
+bool RtpDeferredPacketizer::WritePayload(size_t packet_index, RtpPacketToSend* packet) {
+    if (packet_index < next_packet_index_ || packet_index >= payload_sizes_.size()) {
+        PLOG_WARNING << "Failed to write the payload of packet " << packet_index
+                     << ", the next packet to write is " << next_packet_index_;
+        return false;
+    }
+    // Skip the packets never sent.
+    while (next_packet_index_ < packet_index) {
+        RtpPacketToSend skipped_packet(packet->size() + payload_sizes_[next_packet_index_]);
+        if (!packetizer_->NextPacket(&skipped_packet)) {
+            return false;
+        }
+        ++next_packet_index_;
+    }
+    if (!packetizer_->NextPacket(packet)) {
+        return false;
+    }
+    ++next_packet_index_;
+    return true;
+}
+    
+} // namespace naivertc
@@ -0,0 +1,47 @@
+#ifndef _RTC_RTP_RTCP_RTP_PACKETIZER_RTP_DEFERRED_PACKETIZER_H_
+#define _RTC_RTP_RTCP_RTP_PACKETIZER_RTP_DEFERRED_PACKETIZER_H_
+
+#include "base/defines.hpp"
+#include "rtc/base/copy_on_write_buffer.hpp"
+#include "rtc/rtp_rtcp/rtp/packetizer/rtp_packetizer.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace naivertc {
+
+// Holds an encoded frame and packetizes it on demand, the payload of each
+// packet is written only when the packet is about to send, which keeps the
+// frame in one buffer while its packets are waiting in the pacer.
+class RtpDeferredPacketizer final : public RtpPacketToSend::DeferredPayload {
+public:
+    // Returns nullptr if the codec type is not supported.
+    static std::shared_ptr<RtpDeferredPacketizer> Create(video::CodecType codec_type,
+                                                         CopyOnWriteBuffer payload,
+                                                         const RtpPacketizer::PayloadSizeLimits& limits);
+public:
+    RtpDeferredPacketizer(CopyOnWriteBuffer payload, 
+                          std::unique_ptr<RtpPacketizer> packetizer);
+    ~RtpDeferredPacketizer() override;
+
+    size_t NumberOfPackets() const { return payload_sizes_.size(); }
+    // The payload sizes of the packets in order.
+    const std::vector<size_t>& PayloadSizes() const { return payload_sizes_; }
+
+    // Implements RtpPacketToSend::DeferredPayload
+    // NOTE: The packets must be written in order, the packets skipped (e.g.
+    // dropped by the pacer) are packetized and discarded.
+    bool WritePayload(size_t packet_index, RtpPacketToSend* packet) override;
+
+private:
+    const CopyOnWriteBuffer payload_;
+    const std::unique_ptr<RtpPacketizer> packetizer_;
+    const std::vector<size_t> payload_sizes_;
+    size_t next_packet_index_ = 0;
+
+    DISALLOW_COPY_AND_ASSIGN(RtpDeferredPacketizer);
+};
+    
+} // namespace naivertc
+
+#endif
@@ -0,0 +1,140 @@
+#include "rtc/rtp_rtcp/rtp/packetizer/rtp_deferred_packetizer.hpp"
+#include "rtc/rtp_rtcp/rtp/packetizer/rtp_packetizer_h264.hpp"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#define ENABLE_UNIT_TESTS 0
+#include "testing/defines.hpp"
+
+namespace naivertc {
+namespace test {
+namespace {
+
+constexpr size_t kMaxPayloadSize = 100;
+
+// A frame with a NAL unit fragmented into 3 FU-A packets and
+// 2 NAL units aggregated into one STAP-A packet.
+CopyOnWriteBuffer CreateFrame() {
+    const size_t kNaluSizes[] = {250, 20, 30};
+    std::vector<uint8_t> frame;
+    for (size_t nalu_size : kNaluSizes) {
+        // Start code
+        frame.insert(frame.end(), {0, 0, 1});
+        frame.push_back(uint8_t(h264::NaluType::IDR));
+        for (size_t i = 1; i < nalu_size - 1; ++i) {
+            frame.push_back(static_cast<uint8_t>(i));
+        }
+        // Last byte shouldn't be 0, or it may be counted as part of next start code.
+        frame.push_back(0x10);
+    }
+    return CopyOnWriteBuffer(frame.data(), frame.size());
+}
+
+RtpPacketizer::PayloadSizeLimits DefaultLimits() {
+    RtpPacketizer::PayloadSizeLimits limits;
+    limits.max_payload_size = kMaxPayloadSize;
+    return limits;
+}
+
+std::vector<RtpPacketToSend> PacketizeEagerly(const CopyOnWriteBuffer& frame) {
+    RtpH264Packetizer packetizer;
+    packetizer.Packetize(ArrayView<const uint8_t>(frame.cdata(), frame.size()), 
+                         DefaultLimits(), 
+                         h264::PacketizationMode::NON_INTERLEAVED);
+    std::vector<RtpPacketToSend> packets;
+    RtpPacketToSend packet(nullptr);
+    while (packetizer.NextPacket(&packet)) {
+        packets.push_back(packet);
+    }
+    return packets;
+}
+
+} // namespace
+
+MY_TEST(RtpDeferredPacketizerTest, WritesSamePayloadsAsEagerPacketization) {
+    CopyOnWriteBuffer frame = CreateFrame();
+    std::vector<RtpPacketToSend> expected_packets = PacketizeEagerly(frame);
+    ASSERT_EQ(expected_packets.size(), 4u);
+
+    auto deferred_packetizer = RtpDeferredPacketizer::Create(video::CodecType::H264, frame, DefaultLimits());
+    ASSERT_TRUE(deferred_packetizer);
+    ASSERT_EQ(deferred_packetizer->NumberOfPackets(), expected_packets.size());
+
+    std::vector<RtpPacketToSend> packets;
+    for (size_t i = 0; i < deferred_packetizer->NumberOfPackets(); ++i) {
+        RtpPacketToSend packet(nullptr);
+        packet.SetDeferredPayload(deferred_packetizer, i, deferred_packetizer->PayloadSizes()[i]);
+        EXPECT_TRUE(packet.has_deferred_payload());
+        EXPECT_EQ(packet.payload_size(), 0u);
+        EXPECT_EQ(packet.expected_payload_size(), expected_packets[i].payload_size());
+        packets.push_back(std::move(packet));
+    }
+
+    for (size_t i = 0; i < packets.size(); ++i) {
+        ASSERT_TRUE(packets[i].WriteDeferredPayload());
+        EXPECT_FALSE(packets[i].has_deferred_payload());
+        EXPECT_EQ(packets[i].expected_payload_size(), packets[i].payload_size());
+        EXPECT_THAT(packets[i].payload(), ::testing::ElementsAreArray(expected_packets[i].payload()));
+        EXPECT_EQ(packets[i].marker(), i == packets.size() - 1);
+    }
+}
+
+MY_TEST(RtpDeferredPacketizerTest, SkipsPacketsNeverSent) {
+    CopyOnWriteBuffer frame = CreateFrame();
+    std::vector<RtpPacketToSend> expected_packets = PacketizeEagerly(frame);
+    auto deferred_packetizer = RtpDeferredPacketizer::Create(video::CodecType::H264, frame, DefaultLimits());
+    ASSERT_TRUE(deferred_packetizer);
+
+    RtpPacketToSend packet(nullptr);
+    EXPECT_TRUE(deferred_packetizer->WritePayload(2, &packet));
+    EXPECT_THAT(packet.payload(), ::testing::ElementsAreArray(expected_packets[2].payload()));
+
+    // The packets written or skipped can not be written again.
+    RtpPacketToSend old_packet(nullptr);
+    EXPECT_FALSE(deferred_packetizer->WritePayload(0, &old_packet));
+    EXPECT_FALSE(deferred_packetizer->WritePayload(2, &old_packet));
+
+    RtpPacketToSend last_packet(nullptr);
+    EXPECT_TRUE(deferred_packetizer->WritePayload(3, &last_packet));
+    EXPECT_THAT(last_packet.payload(), ::testing::ElementsAreArray(expected_packets[3].payload()));
+    EXPECT_FALSE(deferred_packetizer->WritePayload(4, &last_packet));
+}
+
+MY_TEST(RtpDeferredPacketizerTest, PlaceholdersKeepOnlyHeaders) {
+    CopyOnWriteBuffer frame = CreateFrame();
+    std::vector<RtpPacketToSend> expected_packets = PacketizeEagerly(frame);
+    auto deferred_packetizer = RtpDeferredPacketizer::Create(video::CodecType::H264, frame, DefaultLimits());
+    ASSERT_TRUE(deferred_packetizer);
+
+    // The template packet is allocated with the full capacity.
+    RtpPacketToSend template_packet(nullptr);
+    template_packet.set_ssrc(1234);
+    const size_t header_size = template_packet.size();
+    ASSERT_GT(template_packet.capacity(), header_size);
+
+    std::vector<RtpPacketToSend> packets;
+    for (size_t i = 0; i < deferred_packetizer->NumberOfPackets(); ++i) {
+        RtpPacketToSend packet = template_packet;
+        packet.SetDeferredPayload(deferred_packetizer, i, deferred_packetizer->PayloadSizes()[i]);
+        // Writing the header doesn't clone the full capacity.
+        packet.set_sequence_number(static_cast<uint16_t>(i));
+        EXPECT_EQ(packet.capacity(), header_size);
+        EXPECT_EQ(packet.expected_size(), header_size + expected_packets[i].payload_size());
+        packets.push_back(std::move(packet));
+    }
+
+    // The buffer grows as the payload is written.
+    for (size_t i = 0; i < packets.size(); ++i) {
+        ASSERT_TRUE(packets[i].WriteDeferredPayload());
+        EXPECT_EQ(packets[i].sequence_number(), i);
+        EXPECT_THAT(packets[i].payload(), ::testing::ElementsAreArray(expected_packets[i].payload()));
+    }
+}
+
+MY_TEST(RtpDeferredPacketizerTest, UnsupportedCodec) {
+    EXPECT_EQ(RtpDeferredPacketizer::Create(video::CodecType::VP8, CreateFrame(), DefaultLimits()), nullptr);
+}
+
+} // namespace test
+} // namespace naivertc
@@ -44,6 +44,10 @@ public:
 
     // Return the next packet on success, nilptr otherwise
     virtual bool NextPacket(RtpPacketToSend* rtp_packet) = 0;
+
+    // Return the payload sizes of the remaining packets in order, which
+    // allows the packets to be paced before the payloads are written.
+    virtual std::vector<size_t> RemainingPayloadSizes() const = 0;
 };
     
 } // namespace naivertc
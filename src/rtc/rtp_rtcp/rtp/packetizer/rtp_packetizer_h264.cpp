@@ -60,6 +60,31 @@ bool RtpH264Packetizer::NextPacket(RtpPacketToSend* rtp_packet) {
     return true;
 }
 
+std::vector<size_t> RtpH264Packetizer::RemainingPayloadSizes() const {
+    std::vector<size_t> payload_sizes;
+    payload_sizes.reserve(num_packets_left_);
+    auto it = packet_units_.begin();
+    while (it != packet_units_.end()) {
+        if (it->first_fragment && it->last_fragment) {
+            payload_sizes.push_back(it->fragment_data.size());
+            ++it;
+        } else if (it->aggregated) {
+            size_t payload_size = kNaluHeaderSize;
+            bool is_last_fragment = false;
+            while (it != packet_units_.end() && !is_last_fragment) {
+                payload_size += kLengthFieldSize + it->fragment_data.size();
+                is_last_fragment = it->last_fragment;
+                ++it;
+            }
+            payload_sizes.push_back(payload_size);
+        } else {
+            payload_sizes.push_back(kFuAHeaderSize + it->fragment_data.size());
+            ++it;
+        }
+    }
+    return payload_sizes;
+}
+
 void RtpH264Packetizer::Packetize(ArrayView<const uint8_t> payload, 
                                   const PayloadSizeLimits& limits, 
                                   h264::PacketizationMode packetization_mode) {
@@ -126,7 +151,7 @@ bool RtpH264Packetizer::PacketizeSingleNalu(size_t fragment_index, const Payload
                      << ", packet capacity: " << limits.max_payload_size;
         return false;
     }
-    packet_units_.push(PacketUnit(fragment, true, true, false, fragment[0]));
+    packet_units_.push_back(PacketUnit(fragment, true, true, false, fragment[0]));
     ++num_packets_left_;
     return true;
 }
@@ -162,7 +187,7 @@ bool RtpH264Packetizer::PacketizeFuA(size_t fragment_index, const PayloadSizeLim
     size_t payload_size_left = payload_size;
     for (size_t i = 0; i < payload_size_list.size(); ++i) {
         size_t packet_size = payload_size_list[i];
-        packet_units_.push(PacketUnit(fragment.subview(offset, packet_size), i == 0, i == payload_size_list.size() - 1, false, fragment[0]));
+        packet_units_.push_back(PacketUnit(fragment.subview(offset, packet_size), i == 0, i == payload_size_list.size() - 1, false, fragment[0]));
         offset += packet_size;
         payload_size_left -= packet_size;
     }
@@ -199,7 +224,7 @@ size_t RtpH264Packetizer::PacketizeStapA(size_t fragment_index, const PayloadSiz
     
     size_t payload_size_left = payload_size;
     while (payload_size_left >= payload_size_need()) {
-        packet_units_.push(PacketUnit(fragment, aggregated_fragments_count == 0, false, true, fragment[0]));
+        packet_units_.push_back(PacketUnit(fragment, aggregated_fragments_count == 0, false, true, fragment[0]));
         payload_size_left -= fragment.size();
         payload_size_left -= fragment_headers_size;
 
@@ -235,7 +260,7 @@ void RtpH264Packetizer::NextSinglePacket(RtpPacketToSend* rtp_packet) {
     uint8_t* payload_buffer = rtp_packet->AllocatePayload(bytes_to_send);
     assert(payload_buffer != nullptr);
     memcpy(payload_buffer, packet.fragment_data.data(), bytes_to_send);
-    packet_units_.pop();
+    packet_units_.pop_front();
     input_fragments_.pop_front();
 }
 
@@ -272,7 +297,7 @@ void RtpH264Packetizer::NextFuAPacket(RtpPacketToSend* rtp_packet) {
     if (packet->last_fragment) {
         input_fragments_.pop_front();
     }
-    packet_units_.pop();
+    packet_units_.pop_front();
 }
 
 // Aggregate fragments into one packet (STAP-A)
@@ -319,7 +344,7 @@ void RtpH264Packetizer::NextStapAPacket(RtpPacketToSend* rtp_packet) {
         // Add NAL unit
         memcpy(&payload_buffer[index], fragment.data(), fragment.size());
         index += fragment.size();
-        packet_units_.pop();
+        packet_units_.pop_front();
         input_fragments_.pop_front();
         if (is_last_fragment) {
             break;
@@ -332,9 +357,7 @@ void RtpH264Packetizer::NextStapAPacket(RtpPacketToSend* rtp_packet) {
 }
 
 void RtpH264Packetizer::Reset() {
-    while(!packet_units_.empty()) {
-        packet_units_.pop();
-    }
+    packet_units_.clear();
     input_fragments_.clear();
     num_packets_left_ = 0;
 }
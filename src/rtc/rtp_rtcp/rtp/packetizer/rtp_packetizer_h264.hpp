@@ -8,7 +8,6 @@
 
 #include <deque>
 #include <memory>
-#include <queue>
 
 namespace naivertc {
 
@@ -25,6 +24,8 @@ public:
 
     bool NextPacket(RtpPacketToSend* rtp_packet) override;
 
+    std::vector<size_t> RemainingPayloadSizes() const override;
+
 private:
     // A packet unit (H264 packet), to be put into an RTP packet:
     // If a NAL unit is too large for an RTP packet, this packet unit will
@@ -69,7 +70,7 @@ private:
   
     size_t num_packets_left_;
     std::deque<ArrayView<const uint8_t>> input_fragments_;
-    std::queue<PacketUnit> packet_units_;
+    std::deque<PacketUnit> packet_units_;
 
     DISALLOW_COPY_AND_ASSIGN(RtpH264Packetizer);
 };
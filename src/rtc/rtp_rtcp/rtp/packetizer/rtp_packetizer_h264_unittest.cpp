@@ -329,6 +329,38 @@ MY_TEST(RtpH264PacketizerTest, MixedStapAFUA) {
                 ::testing::ElementsAreArray(nalus[2]));
 }
 
+MY_TEST(RtpH264PacketizerTest, RemainingPayloadSizesMatchPackets) {
+    RtpPacketizer::PayloadSizeLimits limits;
+    limits.max_payload_size = 100;
+    limits.first_packet_reduction_size = 5;
+    limits.last_packet_reduction_size = 10;
+    BinaryBuffer nalus[] = {GenerateNalUnit(250),
+                            GenerateNalUnit(20),
+                            GenerateNalUnit(30),
+                            GenerateNalUnit(90),
+                            GenerateNalUnit(10)};
+    BinaryBuffer frame = CreateFrame(nalus);
+
+    RtpH264Packetizer packetizer;
+    packetizer.Packetize(frame, limits, h264::PacketizationMode::NON_INTERLEAVED);
+    std::vector<size_t> payload_sizes = packetizer.RemainingPayloadSizes();
+    ASSERT_EQ(payload_sizes.size(), packetizer.NumberOfPackets());
+
+    // Fetch the first packet, and the sizes left should exclude it.
+    RtpPacketToSend first_packet(nullptr);
+    ASSERT_TRUE(packetizer.NextPacket(&first_packet));
+    EXPECT_EQ(first_packet.payload_size(), payload_sizes[0]);
+    EXPECT_THAT(packetizer.RemainingPayloadSizes(),
+                ::testing::ElementsAreArray(payload_sizes.begin() + 1, payload_sizes.end()));
+
+    std::vector<RtpPacketToSend> packets = FetchAllPackets(&packetizer);
+    ASSERT_EQ(packets.size() + 1, payload_sizes.size());
+    for (size_t i = 0; i < packets.size(); ++i) {
+        EXPECT_EQ(packets[i].payload_size(), payload_sizes[i + 1]);
+    }
+    EXPECT_TRUE(packetizer.RemainingPayloadSizes().empty());
+}
+
 MY_TEST(RtpH264PacketizerTest, LastFragmentFitsInSingleButNotLastPacket) {
     RtpPacketizer::PayloadSizeLimits limits;
     limits.max_payload_size = 1178;
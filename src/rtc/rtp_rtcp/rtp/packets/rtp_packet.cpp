@@ -48,6 +48,7 @@ RtpPacket::RtpPacket(size_t capacity)
     : RtpPacket(nullptr, capacity) {}
 
 RtpPacket::RtpPacket(const RtpPacket&) = default;
+RtpPacket::RtpPacket(RtpPacket&&) = default;
 
 RtpPacket::RtpPacket(const HeaderExtensionMap* extension_map) 
     : RtpPacket(extension_map, kIpPacketSize) {}
@@ -61,6 +62,9 @@ RtpPacket::RtpPacket(const HeaderExtensionMap* extension_map, size_t capacity)
 
 RtpPacket::~RtpPacket() {}
 
+RtpPacket& RtpPacket::operator=(const RtpPacket&) = default;
+RtpPacket& RtpPacket::operator=(RtpPacket&&) = default;
+
 // Getter
 std::vector<uint32_t> RtpPacket::csrcs() const {
     size_t num_csrc = cdata()[0] & 0x0F;
@@ -213,6 +217,7 @@ void RtpPacket::Reset() {
     ssrc_ = 0;
     payload_offset_ = kFixedHeaderSize;
     payload_size_ = 0;
+    has_padding_ = false;
     padding_size_ = 0;
 
     // After clear, size changes to 0 and capacity stays the same.
@@ -27,10 +27,14 @@ public:
     RtpPacket();
     RtpPacket(size_t capacity);
     RtpPacket(const RtpPacket&);
+    RtpPacket(RtpPacket&&);
     explicit RtpPacket(const HeaderExtensionMap* extension_map);
     RtpPacket(const HeaderExtensionMap* extension_map, size_t capacity);
     virtual ~RtpPacket();
 
+    RtpPacket& operator=(const RtpPacket&);
+    RtpPacket& operator=(RtpPacket&&);
+
     // Header
     bool marker() const { return marker_; }
     uint8_t payload_type() const { return payload_type_; }
@@ -42,6 +46,7 @@ public:
     std::vector<uint32_t> csrcs() const;
 
     size_t header_size() const { return payload_offset_; }
+    const HeaderExtensionMap& extension_map() const { return extension_map_; }
     // Payload
     size_t payload_size() const { return payload_size_; }
     ArrayView<const uint8_t> payload() const {
@@ -16,5 +16,31 @@ RtpPacketToSend::RtpPacketToSend(const HeaderExtensionMap* extension_map, size_t
     : RtpPacket(extension_map, capacity) {}
 
 RtpPacketToSend::~RtpPacketToSend() = default;
+
+void RtpPacketToSend::SetDeferredPayload(std::shared_ptr<DeferredPayload> deferred_payload,
+                                         size_t packet_index,
+                                         size_t payload_size) {
+    deferred_payload_ = std::move(deferred_payload);
+    deferred_packet_index_ = packet_index;
+    deferred_payload_size_ = payload_size;
+    // Keep only the header until the payload is written, otherwise the
+    // header written later (e.g. the sequence number) would clone the
+    // buffer shared with other packets at its full capacity.
+    if (capacity() > size()) {
+        CopyOnWriteBuffer::operator=(CopyOnWriteBuffer(cdata(), size()));
+    }
+}
+
+bool RtpPacketToSend::WriteDeferredPayload() {
+    if (!deferred_payload_) {
+        return true;
+    }
+    // Grow the buffer to hold the payload.
+    EnsureCapacity(expected_size());
+    auto deferred_payload = std::move(deferred_payload_);
+    deferred_payload_ = nullptr;
+    deferred_payload_size_ = 0;
+    return deferred_payload->WritePayload(deferred_packet_index_, this);
+}
     
 } // namespace naivertc
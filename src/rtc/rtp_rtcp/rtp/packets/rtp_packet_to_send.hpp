@@ -5,11 +5,22 @@
 #include "rtc/rtp_rtcp/rtp/packets/rtp_packet.hpp"
 #include "rtc/rtp_rtcp/base/rtp_rtcp_defines.hpp"
 
+#include <memory>
 #include <optional>
 
 namespace naivertc {
 
 class RtpPacketToSend : public RtpPacket {
+public:
+    // DeferredPayload
+    // The payload written only when the packet is about to send, which allows
+    // the packets of a frame to be queued before being packetized.
+    class DeferredPayload {
+    public:
+        virtual ~DeferredPayload() = default;
+        // Writes the payload of the |packet_index|-th packet into |packet|.
+        virtual bool WritePayload(size_t packet_index, RtpPacketToSend* packet) = 0;
+    };
 public:
     RtpPacketToSend(size_t capacity);
     RtpPacketToSend(const RtpPacketToSend& packet);
@@ -48,6 +59,17 @@ public:
     bool is_red() const { return is_red_; }
     void set_is_red(bool is_red) { is_red_ = is_red; }
 
+    bool has_deferred_payload() const { return deferred_payload_ != nullptr; }
+    void SetDeferredPayload(std::shared_ptr<DeferredPayload> deferred_payload,
+                            size_t packet_index,
+                            size_t payload_size);
+    // Writes the deferred payload if any, returns false on failure.
+    bool WriteDeferredPayload();
+
+    // The sizes including the deferred payload not written yet.
+    size_t expected_payload_size() const { return payload_size() + deferred_payload_size_; }
+    size_t expected_size() const { return size() + deferred_payload_size_; }
+
 private:
     int64_t capture_time_ms_ = 0;   
     RtpPacketType packet_type_;
@@ -58,6 +80,10 @@ private:
     bool fec_protection_need_ = false;
     bool red_protection_need_ = false;
     bool is_red_ = false;
+
+    std::shared_ptr<DeferredPayload> deferred_payload_ = nullptr;
+    size_t deferred_packet_index_ = 0;
+    size_t deferred_payload_size_ = 0;
 };
     
 } // namespace naivertc
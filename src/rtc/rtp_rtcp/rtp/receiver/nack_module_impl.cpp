@@ -2,6 +2,9 @@
 
 #include <plog/Log.h>
 
+#include <algorithm>
+#include <cassert>
+
 namespace naivertc {
 namespace {
 
@@ -12,19 +15,114 @@ constexpr int kMaxNackRetries = 10;
 
 } // namespace
 
-// NackInfo
-NackModuleImpl::NackInfo::NackInfo() 
-    : seq_num(0), 
-      created_time(-1), 
-      sent_time(std::nullopt), 
-      retries(0) {}
+// SeqNumSet
+NackModuleImpl::SeqNumSet::SeqNumSet()
+    : begin_(0),
+      window_size_(0),
+      size_(0) {
+    bits_.fill(0);
+}
+
+bool NackModuleImpl::SeqNumSet::Contains(uint16_t seq_num) const {
+    const size_t offset = static_cast<uint16_t>(seq_num - begin_);
+    if (offset >= window_size_) {
+        return false;
+    }
+    const size_t bit = seq_num % kWindowSize;
+    return (bits_[bit / 64] >> (bit % 64)) & 1;
+}
 
-NackModuleImpl::NackInfo::NackInfo(uint16_t seq_num, 
-                                   int64_t created_time) 
-    : seq_num(seq_num), 
-      created_time(created_time), 
-      sent_time(std::nullopt), 
-      retries(0) {}
+void NackModuleImpl::SeqNumSet::Insert(uint16_t seq_num) {
+    // All the bits are cleared as empty, so the window can restart anywhere.
+    if (size_ == 0) {
+        begin_ = seq_num;
+        window_size_ = 0;
+    }
+    const size_t offset = static_cast<uint16_t>(seq_num - begin_);
+    if (offset >= window_size_) {
+        if (window_size_ == 0 || wrap_around_utils::AheadOf(seq_num, begin_)) {
+            // Slide the window forward to cover `seq_num`.
+            if (offset >= kWindowSize) {
+                EraseBefore(seq_num - kWindowSize + 1);
+                if (empty()) {
+                    begin_ = seq_num;
+                }
+            }
+            window_size_ = static_cast<uint16_t>(seq_num - begin_) + 1;
+        } else {
+            // Extend the window backward to cover `seq_num`.
+            const size_t window_size = static_cast<uint16_t>(begin_ + window_size_ - seq_num);
+            if (window_size > kWindowSize) {
+                return;
+            }
+            begin_ = seq_num;
+            window_size_ = window_size;
+        }
+    }
+    const size_t bit = seq_num % kWindowSize;
+    const uint64_t mask = uint64_t(1) << (bit % 64);
+    if ((bits_[bit / 64] & mask) == 0) {
+        bits_[bit / 64] |= mask;
+        ++size_;
+    }
+}
+
+void NackModuleImpl::SeqNumSet::Erase(uint16_t seq_num) {
+    if (Contains(seq_num)) {
+        const size_t bit = seq_num % kWindowSize;
+        bits_[bit / 64] &= ~(uint64_t(1) << (bit % 64));
+        --size_;
+    }
+}
+
+void NackModuleImpl::SeqNumSet::EraseBefore(uint16_t seq_num) {
+    size_t num_bits = static_cast<uint16_t>(seq_num - begin_);
+    if (num_bits > window_size_) {
+        // `seq_num` is either ahead of or behind the whole window.
+        num_bits = wrap_around_utils::AheadOf(seq_num, begin_) ? window_size_ : 0;
+    }
+    ClearBits(0, num_bits);
+    begin_ += num_bits;
+    window_size_ -= num_bits;
+}
+
+void NackModuleImpl::SeqNumSet::Clear() {
+    bits_.fill(0);
+    window_size_ = 0;
+    size_ = 0;
+}
+
+uint16_t NackModuleImpl::SeqNumSet::Front() const {
+    assert(!empty());
+    return *Next(begin_);
+}
+
+std::optional<uint16_t> NackModuleImpl::SeqNumSet::Next(uint16_t seq_num) const {
+    for (size_t offset = static_cast<uint16_t>(seq_num - begin_); offset < window_size_;) {
+        const size_t bit = static_cast<uint16_t>(begin_ + offset) % kWindowSize;
+        const size_t num_bits = std::min(64 - bit % 64, window_size_ - offset);
+        uint64_t word = bits_[bit / 64] >> (bit % 64);
+        if (num_bits < 64) {
+            word &= (uint64_t(1) << num_bits) - 1;
+        }
+        if (word != 0) {
+            return static_cast<uint16_t>(begin_ + offset + __builtin_ctzll(word));
+        }
+        offset += num_bits;
+    }
+    return std::nullopt;
+}
+
+void NackModuleImpl::SeqNumSet::ClearBits(size_t offset, size_t num_bits) {
+    for (size_t end = offset + num_bits; offset < end && size_ > 0;) {
+        const size_t bit = static_cast<uint16_t>(begin_ + offset) % kWindowSize;
+        const size_t num_bits_in_word = std::min(64 - bit % 64, end - offset);
+        uint64_t mask = num_bits_in_word < 64 ? ((uint64_t(1) << num_bits_in_word) - 1) << (bit % 64) : ~uint64_t(0);
+        size_ -= __builtin_popcountll(bits_[bit / 64] & mask);
+        bits_[bit / 64] &= ~mask;
+        offset += num_bits_in_word;
+    }
+}
 
 // NackModuleImpl
 NackModuleImpl::NackModuleImpl(Clock* clock, 
@@ -33,14 +131,15 @@ NackModuleImpl::NackModuleImpl(Clock* clock,
       send_nack_delay_ms_(send_nack_delay_ms),
       initialized_(false),
       rtt_ms_(kDefaultRttMs),
-      newest_seq_num_(0) {}
+      newest_seq_num_(0),
+      nack_infos_(kWindowSize) {}
 
 NackModuleImpl::~NackModuleImpl() {}
 
 void NackModuleImpl::ClearUpTo(uint16_t seq_num) {
-    nack_list_.erase(nack_list_.begin(), nack_list_.lower_bound(seq_num));
-    keyframe_list_.erase(keyframe_list_.begin(), keyframe_list_.lower_bound(seq_num));
-    recovered_list_.erase(recovered_list_.begin(), recovered_list_.lower_bound(seq_num));
+    nack_list_.EraseBefore(seq_num);
+    keyframe_list_.EraseBefore(seq_num);
+    recovered_list_.EraseBefore(seq_num);
 }
 
 void NackModuleImpl::UpdateRtt(int64_t rtt_ms) {
@@ -52,7 +151,7 @@ NackModuleImpl::InsertResult NackModuleImpl::InsertPacket(uint16_t seq_num, bool
     if (!initialized_) {
         newest_seq_num_ = seq_num;
         if (is_keyframe) {
-            keyframe_list_.insert(seq_num);
+            keyframe_list_.Insert(seq_num);
         }
         initialized_ = true;
         return ret;
@@ -65,10 +164,9 @@ NackModuleImpl::InsertResult NackModuleImpl::InsertPacket(uint16_t seq_num, bool
     // `seq_num` is newer than `newest_seq_num`
     if (wrap_around_utils::AheadOf(newest_seq_num_, seq_num)) {
         size_t nacks_sent_for_packet = 0;
-        auto it = nack_list_.find(seq_num);
-        if (it != nack_list_.end()) {
-            nacks_sent_for_packet = it->second.retries;
-            nack_list_.erase(it);
+        if (nack_list_.Contains(seq_num)) {
+            nacks_sent_for_packet = nack_infos_[seq_num % kWindowSize].retries;
+            nack_list_.Erase(seq_num);
         }
         ret.nacks_sent_for_seq_num = nacks_sent_for_packet;
         return ret;
@@ -76,22 +174,16 @@ NackModuleImpl::InsertResult NackModuleImpl::InsertPacket(uint16_t seq_num, bool
 
     // Keep track of new keyframe.
     if (is_keyframe) {
-        keyframe_list_.insert(seq_num);
+        keyframe_list_.Insert(seq_num);
     }
     // Remove old ones so we don't accumulate keyframes.
-    auto it = keyframe_list_.lower_bound(seq_num - kMaxPacketAge);
-    if (it != keyframe_list_.begin()) {
-        keyframe_list_.erase(keyframe_list_.begin(), it);
-    }
+    keyframe_list_.EraseBefore(seq_num - kMaxPacketAge);
 
     // Update recovered packet list.
     if (is_recovered) {
-        recovered_list_.insert(seq_num);
+        recovered_list_.Insert(seq_num);
         // Remove old ones so we don't accumulate recovered packets.
-        auto it = recovered_list_.lower_bound(seq_num - kMaxPacketAge);
-        if (it != recovered_list_.begin()) {
-            recovered_list_.erase(recovered_list_.begin(), it);
-        }
+        recovered_list_.EraseBefore(seq_num - kMaxPacketAge);
         // Don't send nack for packets recovered by FEC or RTX.
         return ret;
     }
@@ -119,8 +211,7 @@ std::vector<uint16_t> NackModuleImpl::NackListOnRttPassed() {
 
 // Private methods
 bool NackModuleImpl::AddPacketsToNack(uint16_t seq_num_start, uint16_t seq_num_end) {
-    auto it = nack_list_.lower_bound(seq_num_end - kMaxPacketAge);
-    nack_list_.erase(nack_list_.begin(), it);
+    nack_list_.EraseBefore(seq_num_end - kMaxPacketAge);
 
     uint16_t num_new_nacks = ForwardDiff(seq_num_start, seq_num_end);
     if (nack_list_.size() + num_new_nacks > kMaxNackPacketCount) {
@@ -129,34 +220,35 @@ bool NackModuleImpl::AddPacketsToNack(uint16_t seq_num_start, uint16_t seq_num_e
 
         if (nack_list_.size() + num_new_nacks > kMaxNackPacketCount) {
             PLOG_WARNING << "NACK list is full, clearing it and requesting a keyframe.";
-            nack_list_.clear();
+            nack_list_.Clear();
             return false;
         }
     }
 
+    const int64_t now_ms = clock_->now_ms();
     for (uint16_t seq_num = seq_num_start; seq_num != seq_num_end; ++seq_num) {
         // Don't send nack for packets recovered by FEC or RTX.
-        if (recovered_list_.find(seq_num) != recovered_list_.end()) {
+        if (recovered_list_.Contains(seq_num)) {
             continue;
         }
-        NackInfo nack_info(seq_num, clock_->now_ms());
-        nack_list_[seq_num] = std::move(nack_info);
+        nack_infos_[seq_num % kWindowSize] = NackInfo{now_ms, -1, 0};
+        nack_list_.Insert(seq_num);
     }   
     return true;
 }
 
 bool NackModuleImpl::RemovePacketsUntilKeyFrame() {
     while (!keyframe_list_.empty()) {
-        auto it = nack_list_.lower_bound(*keyframe_list_.begin());
-        if (it != nack_list_.begin()) {
+        const uint16_t keyframe_seq_num = keyframe_list_.Front();
+        if (!nack_list_.empty() && wrap_around_utils::AheadOf(keyframe_seq_num, nack_list_.Front())) {
             // We have found a keyframe that actually is newer than at least one
             // packet in the nack list.
-            nack_list_.erase(nack_list_.begin(), it);
+            nack_list_.EraseBefore(keyframe_seq_num);
             return true;
         }
         // If this keyframe is so old it does not remove any packets from the list,
         // remove it from the list of keyframes and try the next keyframe.
-        keyframe_list_.erase(keyframe_list_.begin());
+        keyframe_list_.Erase(keyframe_seq_num);
     }
     return false;
 }
@@ -164,38 +256,40 @@ bool NackModuleImpl::RemovePacketsUntilKeyFrame() {
 std::vector<uint16_t> NackModuleImpl::NackListToSend(NackFilterType type, uint16_t seq_num) {
     Timestamp now = clock_->CurrentTime();
     std::vector<uint16_t> nack_list_to_send;
-    auto it = nack_list_.begin();
-    while (it != nack_list_.end()) {
+    if (nack_list_.empty()) {
+        return nack_list_to_send;
+    }
+    std::optional<uint16_t> nack_seq_num = nack_list_.Front();
+    for (; nack_seq_num; nack_seq_num = nack_list_.Next(*nack_seq_num + 1)) {
+        NackInfo& nack_info = nack_infos_[*nack_seq_num % kWindowSize];
         TimeDelta resend_delay = TimeDelta::Millis(rtt_ms_);
         // Delay to send nack timed out.
-        bool delay_timed_out = now.ms() - it->second.created_time >= send_nack_delay_ms_;
-        if (delay_timed_out) {
-            bool nack_on_rtt_passed = false;
-            // Nack on rtt passed and sent once.
-            if (type == NackFilterType::TIME && it->second.sent_time) {
-                nack_on_rtt_passed = now.ms() - *it->second.sent_time >= resend_delay.ms();
-            }
-            bool nack_on_seq_num_passed = false;
-            // Nack on seq_num passed and not sent before.
-            if (type == NackFilterType::SEQ_NUM && !it->second.sent_time) {
-                nack_on_seq_num_passed = wrap_around_utils::AheadOrAt(seq_num, it->second.seq_num);
-            }
+        bool delay_timed_out = now.ms() - nack_info.created_time >= send_nack_delay_ms_;
+        if (!delay_timed_out) {
+            continue;
+        }
+        const bool sent = nack_info.sent_time >= 0;
+        bool nack_on_rtt_passed = false;
+        // Nack on rtt passed and sent once.
+        if (type == NackFilterType::TIME && sent) {
+            nack_on_rtt_passed = now.ms() - nack_info.sent_time >= resend_delay.ms();
+        }
+        bool nack_on_seq_num_passed = false;
+        // Nack on seq_num passed and not sent before.
+        if (type == NackFilterType::SEQ_NUM && !sent) {
+            nack_on_seq_num_passed = wrap_around_utils::AheadOrAt(seq_num, *nack_seq_num);
+        }
 
-            if (nack_on_rtt_passed || nack_on_seq_num_passed) {
-                nack_list_to_send.emplace_back(it->second.seq_num);
-                ++it->second.retries;
-                it->second.sent_time = now.ms();
-                if (it->second.retries >= kMaxNackRetries) {
-                    PLOG_WARNING << "Sequence number " << it->second.seq_num
-                                 << " remove from NACK list due to max retries.";
-                    it = nack_list_.erase(it);
-                } else {
-                    ++it;
-                }
-                continue;
+        if (nack_on_rtt_passed || nack_on_seq_num_passed) {
+            nack_list_to_send.emplace_back(*nack_seq_num);
+            ++nack_info.retries;
+            nack_info.sent_time = now.ms();
+            if (nack_info.retries >= kMaxNackRetries) {
+                PLOG_WARNING << "Sequence number " << *nack_seq_num
+                             << " remove from NACK list due to max retries.";
+                nack_list_.Erase(*nack_seq_num);
             }
         }
-        ++it;
     }
     return nack_list_to_send;
 }
@@ -5,9 +5,10 @@
 #include "rtc/base/time/clock.hpp"
 #include "rtc/rtp_rtcp/components/wrap_around_utils.hpp"
 
+#include <array>
 #include <memory>
-#include <set>
-#include <map>
+#include <optional>
+#include <vector>
 #include <functional>
 
 namespace naivertc {
@@ -37,15 +38,50 @@ public:
     std::vector<uint16_t> NackListOnRttPassed();
 
 private:
+    // The packets are tracked within a window of the newest sequence
+    // numbers, which covers the max packet age.
+    static constexpr size_t kWindowSize = 1 << 14;
+
+    // The NACK state of a sequence number, which is stored in place.
     struct NackInfo {
-        NackInfo();
-        NackInfo(uint16_t seq_num, 
-                 int64_t created_time);
-
-        uint16_t seq_num;
-        int64_t created_time;
-        std::optional<int64_t> sent_time;
-        size_t retries;
+        int64_t created_time = -1;
+        // -1 if not sent yet.
+        int64_t sent_time = -1;
+        uint32_t retries = 0;
+    };
+
+    // The set of sequence numbers within a sliding window of `kWindowSize`
+    // ordered with the wrap around, as a bitmap indexed by the sequence
+    // number, so that it never allocates and walks a word at a time.
+    class SeqNumSet {
+    public:
+        SeqNumSet();
+
+        bool empty() const { return size_ == 0; }
+        size_t size() const { return size_; }
+
+        bool Contains(uint16_t seq_num) const;
+        // The sequence numbers too old to fit in the window are ignored,
+        // and the oldest ones are evicted to fit a newer one in.
+        void Insert(uint16_t seq_num);
+        void Erase(uint16_t seq_num);
+        // Erases the sequence numbers older than `seq_num`.
+        void EraseBefore(uint16_t seq_num);
+        void Clear();
+
+        // The oldest sequence number, MUST NOT be empty.
+        uint16_t Front() const;
+        // Returns the oldest sequence number at or after `seq_num`.
+        std::optional<uint16_t> Next(uint16_t seq_num) const;
+
+    private:
+        void ClearBits(size_t offset, size_t num_bits);
+
+    private:
+        uint16_t begin_;
+        size_t window_size_;
+        size_t size_;
+        std::array<uint64_t, kWindowSize / 64> bits_;
     };
 
     // Which fields to consider when deciding 
@@ -69,9 +105,11 @@ private:
     int64_t rtt_ms_;
     uint16_t newest_seq_num_;
 
-    std::set<uint16_t, wrap_around_utils::OlderThan<uint16_t>> keyframe_list_;
-    std::set<uint16_t, wrap_around_utils::OlderThan<uint16_t>> recovered_list_;
-    std::map<uint16_t, NackInfo, wrap_around_utils::OlderThan<uint16_t>> nack_list_;
+    SeqNumSet keyframe_list_;
+    SeqNumSet recovered_list_;
+    SeqNumSet nack_list_;
+    // Indexed by the sequence number in `nack_list_`.
+    std::vector<NackInfo> nack_infos_;
 };
     
 } // namespace naivertc
@@ -1,5 +1,6 @@
 #include "rtc/rtp_rtcp/rtp/receiver/nack_module_impl.hpp"
 #include "testing/simulated_clock.hpp"
+#include "testing/allocation_counter.hpp"
 
 #include <gtest/gtest.h>
 
@@ -316,6 +317,31 @@ MY_TEST_F(NackModuleTest, SendNackWithDelay) {
     InsertPacket(109, false, false);
     EXPECT_EQ(104u, sent_nacks_.size());
 }
+
+MY_TEST_F(NackModuleTest, NoAllocationsWithoutLoss) {
+    CreateNackModule();
+    // Run across the wrap around of the sequence number and beyond the
+    // max packet age, with a keyframe every 100 packets and a recovered
+    // packet every 10 packets.
+    uint16_t seq_num = 0xff00;
+    InsertPacket(seq_num++, true, false);
+    size_t num_allocations = 0;
+    for (int i = 1; i < 30000; ++i, ++seq_num) {
+        ScopedAllocationCounter allocation_counter;
+        auto ret = nack_module_->InsertPacket(seq_num, i % 100 == 0, i % 10 == 0);
+        auto sent_nacks = nack_module_->NackListOnRttPassed();
+        num_allocations += allocation_counter.num_allocations();
+        EXPECT_TRUE(ret.nack_list_to_send.empty());
+        EXPECT_TRUE(sent_nacks.empty());
+    }
+    EXPECT_EQ(0u, num_allocations);
+
+    // Still nacks the missing packets after the window slid.
+    sent_nacks_.clear();
+    InsertPacket(seq_num + 3, false, false);
+    ASSERT_EQ(3u, sent_nacks_.size());
+    EXPECT_EQ(seq_num, sent_nacks_[0]);
+}
     
 } // namespace test
 } // namespace naivertc
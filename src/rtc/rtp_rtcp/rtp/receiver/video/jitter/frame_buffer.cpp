@@ -4,7 +4,6 @@
 #include <plog/Log.h>
 
 #include <algorithm>
-#include <queue>
 
 namespace naivertc {
 namespace rtp {
@@ -34,53 +33,108 @@ FrameBuffer::FrameBuffer(Clock* clock,
       jitter_estimator_({/* Default HyperParameters */}, clock_),
       protection_mode_(ProtectionMode::NACK),
       add_rtt_to_playout_delay_(true),
-      last_log_non_decoded_ms_(-kLogNonDecodedIntervalMs) {
+      last_log_non_decoded_ms_(-kLogNonDecodedIntervalMs),
+      frame_infos_(kFrameRingSize) {
     assert(clock_ != nullptr);
     assert(timing_ != nullptr);
+    continuous_frames_.reserve(kFrameRingSize);
 }
 
 FrameBuffer::~FrameBuffer() {}
 
 void FrameBuffer::Clear() {
-    std::lock_guard lock(lock_);
+    RTC_RUN_ON(decode_queue_);
     ClearFramesAndHistory();
 }
 
 void FrameBuffer::UpdateRtt(int64_t rtt_ms) {
-    std::lock_guard lock(lock_);
+    RTC_RUN_ON(decode_queue_);
     jitter_estimator_.UpdateRtt(rtt_ms);
 }
 
 ProtectionMode FrameBuffer::protection_mode() const {
+    RTC_RUN_ON(decode_queue_);
     return protection_mode_;
 }
 
 void FrameBuffer::set_protection_mode(ProtectionMode mode) {
-    std::lock_guard lock(lock_);
+    RTC_RUN_ON(decode_queue_);
     protection_mode_ = mode;
 }
 
 // Private methods
 void FrameBuffer::ClearFramesAndHistory() {
-    if (stats_observer_) {
-        // The undecodable frames
-        size_t dropped_frames = NumUndecodableFrames(frame_infos_.begin(), frame_infos_.end());
-        if (dropped_frames > 0) {
-            PLOG_WARNING << "Dropped " << dropped_frames << " frames";
-            stats_observer_->OnDroppedFrames(dropped_frames);
-        }
+    // The undecodable frames
+    size_t dropped_frames = num_frame_infos_ > 0 ? EraseFramesUpTo(last_frame_id_) : 0;
+    if (stats_observer_ && dropped_frames > 0) {
+        PLOG_WARNING << "Dropped " << dropped_frames << " frames";
+        stats_observer_->OnDroppedFrames(dropped_frames);
     }
-    frame_infos_.clear();
     frame_to_decode_.reset();
     last_continuous_frame_id_.reset();
     decoded_frames_history_.Clear();
 }
 
-size_t FrameBuffer::NumUndecodableFrames(FrameInfoMap::iterator begin, FrameInfoMap::iterator end) {
-    return std::count_if(begin, end, 
-                         [](const std::pair<const int64_t, FrameInfo>& frame_tuple) {
-        return frame_tuple.second.frame != std::nullopt;
-    });
+FrameBuffer::FrameInfo* FrameBuffer::FindFrameInfo(int64_t frame_id) {
+    if (frame_id < 0) {
+        return nullptr;
+    }
+    auto& frame_info = frame_infos_[frame_id % kFrameRingSize];
+    return frame_info.frame_id == frame_id ? &frame_info : nullptr;
+}
+
+FrameBuffer::FrameInfo& FrameBuffer::GetOrCreateFrameInfo(int64_t frame_id) {
+    assert(frame_id >= 0);
+    auto& frame_info = frame_infos_[frame_id % kFrameRingSize];
+    if (frame_info.frame_id == frame_id) {
+        return frame_info;
+    }
+    // The caller MUST make sure the frame fits in the buffer by `FitsInBuffer`.
+    assert(frame_info.frame_id == -1);
+    frame_info.frame_id = frame_id;
+    if (num_frame_infos_ == 0) {
+        first_frame_id_ = frame_id;
+        last_frame_id_ = frame_id;
+    } else {
+        first_frame_id_ = std::min(first_frame_id_, frame_id);
+        last_frame_id_ = std::max(last_frame_id_, frame_id);
+    }
+    ++num_frame_infos_;
+    return frame_info;
+}
+
+bool FrameBuffer::FitsInBuffer(int64_t first_frame_id, int64_t last_frame_id) const {
+    assert(first_frame_id <= last_frame_id);
+    if (num_frame_infos_ > 0) {
+        first_frame_id = std::min(first_frame_id, first_frame_id_);
+        last_frame_id = std::max(last_frame_id, last_frame_id_);
+    }
+    return last_frame_id - first_frame_id < static_cast<int64_t>(kFrameRingSize);
+}
+
+size_t FrameBuffer::EraseFramesUpTo(int64_t frame_id) {
+    size_t num_undecoded_frames = 0;
+    if (num_frame_infos_ == 0) {
+        return num_undecoded_frames;
+    }
+    const int64_t last_frame_id = std::min(frame_id, last_frame_id_);
+    for (int64_t id = first_frame_id_; id <= last_frame_id; ++id) {
+        auto& frame_info = frame_infos_[id % kFrameRingSize];
+        if (frame_info.frame_id != id) {
+            continue;
+        }
+        if (frame_info.frame) {
+            ++num_undecoded_frames;
+        }
+        frame_info.frame_id = -1;
+        frame_info.num_missing_continuous = 0;
+        frame_info.num_missing_decodable = 0;
+        frame_info.num_dependent_frames = 0;
+        frame_info.frame.reset();
+        --num_frame_infos_;
+    }
+    first_frame_id_ = last_frame_id + 1;
+    return num_undecoded_frames;
 }
 
 } // namespace jitter
@@ -15,16 +15,15 @@
 #include "rtc/base/task_utils/repeating_task.hpp"
 
 #include <optional>
-#include <map>
+#include <array>
 #include <vector>
-#include <mutex>
 
 namespace naivertc {
 namespace rtp {
 namespace video {
 namespace jitter {
 
-// The class is not thread-safe, the caller MUST privode that.
+// The class is not thread-safe, all the methods MUST be called on `decode_queue`.
 class FrameBuffer final {
 public:
     enum class ReturnReason { FOUND, TIME_OUT, STOPPED };
@@ -36,29 +35,34 @@ public:
     ~FrameBuffer();
 
     ProtectionMode protection_mode() const;
-    void set_protection_mode(ProtectionMode mode) RTC_LOCKS_EXCLUDED(lock_);
+    void set_protection_mode(ProtectionMode mode);
     
-    void UpdateRtt(int64_t rtt_ms) RTC_LOCKS_EXCLUDED(lock_);
+    void UpdateRtt(int64_t rtt_ms);
 
-    std::pair<int64_t, bool> InsertFrame(video::FrameToDecode frame) RTC_LOCKS_EXCLUDED(lock_);
+    std::pair<int64_t, bool> InsertFrame(video::FrameToDecode frame);
 
     using NextFrameFoundCallback = std::function<void(std::optional<video::FrameToDecode>)>;
     void NextFrame(int64_t max_wait_time_ms, 
                    bool keyframe_required,
-                   NextFrameFoundCallback callback) RTC_LOCKS_EXCLUDED(lock_);
+                   NextFrameFoundCallback callback);
 
-    void Clear() RTC_LOCKS_EXCLUDED(lock_);
+    void Clear();
 
 private:
+    // Max number of frames having unfulfilled dependencies on a frame.
+    static constexpr size_t kMaxDependentFrames = 16;
+
     struct FrameInfo {
         FrameInfo();
         ~FrameInfo();
 
-        int64_t frame_id() const { return frame.has_value() ? frame->id() : -1; }
-
         // Indicate if the frame is continuous or not.
         bool continuous() const { return num_missing_continuous == 0; }
 
+        // The id of the frame (or the referred frame not received yet) 
+        // occupying this slot, -1 if the slot is free.
+        int64_t frame_id = -1;
+
         // A frame is continuous if it has all its referenced/indirectly referenced frames.
         // Indicate how many unfulfilled frames this frame have until it becomes continuous.
         size_t num_missing_continuous = 0;
@@ -68,60 +72,80 @@ private:
         size_t num_missing_decodable = 0;
 
         // Which other frames that have direct unfulfilled dependencies on this frame.
-        std::vector<int64_t> dependent_frames;
+        size_t num_dependent_frames = 0;
+        std::array<int64_t, kMaxDependentFrames> dependent_frames;
 
         std::optional<video::FrameToDecode> frame = std::nullopt;
     };
-    // FIXME: Is it necessary to add a compare to sort map by frame id?
-    // DONE: No, because the frame id was unwrapped and will be sorted (ascending).
-    using FrameInfoMap = std::map<int64_t, FrameInfo>;
 
 private:
-    void ClearFramesAndHistory() RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
-    size_t NumUndecodableFrames(FrameInfoMap::iterator begin, FrameInfoMap::iterator end) RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
-    int EstimateJitterDelay(uint32_t send_timestamp, int64_t recv_time_ms, size_t frame_size) RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+    void ClearFramesAndHistory();
+    int EstimateJitterDelay(uint32_t send_timestamp, int64_t recv_time_ms, size_t frame_size);
+
+    // Frame infos
+    // Returns the info of the frame `frame_id` if it's in the buffer, otherwise nullptr.
+    FrameInfo* FindFrameInfo(int64_t frame_id);
+    // Returns the info of the frame `frame_id`, and occupies a free slot for it if necessary.
+    FrameInfo& GetOrCreateFrameInfo(int64_t frame_id);
+    // Returns true if the frame ids in [first_frame_id, last_frame_id] can
+    // be held along with the frames in the buffer.
+    bool FitsInBuffer(int64_t first_frame_id, int64_t last_frame_id) const;
+    // Removes the frames up to (including) `frame_id`, returns the
+    // number of the undecoded frames removed.
+    size_t EraseFramesUpTo(int64_t frame_id);
 
     // Continuity
     bool ValidReferences(const video::FrameToDecode& frame) const;
-    // Returns a pair consisting of an iterator to the inserted element,
-    // or the already-existing element if no insertion happened,
-    // and a bool denoting whether the insertion took place(true if insertion
-    // happened, false if it did not).
-    std::pair<FrameInfo&, bool> EmplaceFrameInfo(video::FrameToDecode frame) RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
-    void PropagateContinuity(const FrameInfo& frame_info) RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+    // Returns a pair consisting of the frame info inserted, or the already-existing
+    // one if no insertion happened, and a bool denoting whether the insertion took
+    // place(true if insertion happened, false if it did not).
+    std::pair<FrameInfo*, bool> EmplaceFrameInfo(video::FrameToDecode frame);
+    void PropagateContinuity(const FrameInfo& frame_info);
 
     // Decodability
-    void FindNextDecodableFrames(int64_t last_decodable_frame_id) RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
-    bool IsValidRenderTiming(int64_t render_time_ms, int64_t now_ms) RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
-    int64_t PropagateDecodability(const FrameInfo& frame_info) RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
-    void StartWaitForNextFrameToDecode() RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
-    int64_t FindNextFrameToDecode() RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
-    video::FrameToDecode GetNextFrameToDecode() RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+    bool IsValidRenderTiming(int64_t render_time_ms, int64_t now_ms);
+    int64_t PropagateDecodability(const FrameInfo& frame_info);
+    void StartWaitForNextFrameToDecode();
+    int64_t FindNextFrameToDecode();
+    video::FrameToDecode GetNextFrameToDecode();
 
 private:
     static constexpr int64_t kLogNonDecodedIntervalMs = 5000;
+    // Max number of frames the buffer will hold.
+    static constexpr size_t kMaxFramesBuffered = 800;
+    // The size of the frame ring indexed by frame id.
+    static constexpr size_t kFrameRingSize = 1 << 10; // 1024
+    static_assert(kFrameRingSize > kMaxFramesBuffered, "The frame ring must hold all the frames buffered.");
+    static_assert((kFrameRingSize & (kFrameRingSize - 1)) == 0, "The size of frame ring must be a power of 2.");
 private:
-    std::mutex lock_;
-    Clock* const clock_ RTC_GUARDED_BY(lock_);
-    Timing* const timing_ RTC_GUARDED_BY(lock_);
-    TaskQueue* const decode_queue_ RTC_GUARDED_BY(lock_);
+    Clock* const clock_;
+    Timing* const timing_;
+    TaskQueue* const decode_queue_;
     VideoReceiveStatisticsObserver* const stats_observer_;
 
-    InterFrameDelay inter_frame_delay_ RTC_GUARDED_BY(lock_);
-    DecodedFramesHistory decoded_frames_history_ RTC_GUARDED_BY(lock_);
-    JitterEstimator jitter_estimator_ RTC_GUARDED_BY(lock_);
-    ProtectionMode protection_mode_ RTC_GUARDED_BY(lock_);
+    InterFrameDelay inter_frame_delay_ RTC_GUARDED_BY(decode_queue_);
+    DecodedFramesHistory decoded_frames_history_ RTC_GUARDED_BY(decode_queue_);
+    JitterEstimator jitter_estimator_ RTC_GUARDED_BY(decode_queue_);
+    ProtectionMode protection_mode_ RTC_GUARDED_BY(decode_queue_);
     const bool add_rtt_to_playout_delay_;
-    int64_t last_log_non_decoded_ms_ RTC_GUARDED_BY(lock_);
+    int64_t last_log_non_decoded_ms_ RTC_GUARDED_BY(decode_queue_);
 
-    std::optional<int64_t> last_continuous_frame_id_ RTC_GUARDED_BY(lock_) = std::nullopt;
+    std::optional<int64_t> last_continuous_frame_id_ RTC_GUARDED_BY(decode_queue_) = std::nullopt;
     
-    FrameInfoMap frame_infos_ RTC_GUARDED_BY(lock_);
-    std::unique_ptr<RepeatingTask> decode_task_ RTC_GUARDED_BY(lock_) = nullptr;
-    std::optional<FrameInfoMap::iterator> frame_to_decode_;
-    bool keyframe_required_ RTC_GUARDED_BY(lock_) = false;
-    int64_t waiting_deadline_ms_ RTC_GUARDED_BY(lock_) = 0;
-    NextFrameFoundCallback next_frame_found_callback_ RTC_GUARDED_BY(lock_) = nullptr;
+    // The frame infos indexed by frame id, and all the frames
+    // in the buffer are in the range [first_frame_id_, last_frame_id_].
+    std::vector<FrameInfo> frame_infos_ RTC_GUARDED_BY(decode_queue_);
+    size_t num_frame_infos_ RTC_GUARDED_BY(decode_queue_) = 0;
+    int64_t first_frame_id_ RTC_GUARDED_BY(decode_queue_) = -1;
+    int64_t last_frame_id_ RTC_GUARDED_BY(decode_queue_) = -1;
+    // The frames becoming continuous to traverse, reused to avoid allocations.
+    std::vector<int64_t> continuous_frames_ RTC_GUARDED_BY(decode_queue_);
+
+    std::unique_ptr<RepeatingTask> decode_task_ RTC_GUARDED_BY(decode_queue_) = nullptr;
+    std::optional<int64_t> frame_to_decode_ RTC_GUARDED_BY(decode_queue_) = std::nullopt;
+    bool keyframe_required_ RTC_GUARDED_BY(decode_queue_) = false;
+    int64_t waiting_deadline_ms_ RTC_GUARDED_BY(decode_queue_) = 0;
+    NextFrameFoundCallback next_frame_found_callback_ RTC_GUARDED_BY(decode_queue_) = nullptr;
 };
     
 } // namespace jitter
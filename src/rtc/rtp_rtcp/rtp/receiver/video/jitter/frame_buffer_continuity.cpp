@@ -4,21 +4,14 @@
 #include <plog/Log.h>
 
 #include <algorithm>
-#include <queue>
 
 namespace naivertc {
 namespace rtp {
 namespace video {
 namespace jitter {
-namespace {
-
-// Max number of frames the buffer will hold.
-constexpr size_t kMaxFramesBuffered = 800;
-
-} // namespace
 
 std::pair<int64_t, bool> FrameBuffer::InsertFrame(video::FrameToDecode frame) {
-    std::lock_guard lock(lock_);
+    RTC_RUN_ON(decode_queue_);
     int64_t last_continuous_frame_id = last_continuous_frame_id_.value_or(-1);
 
     if (!ValidReferences(frame)) {
@@ -27,7 +20,7 @@ std::pair<int64_t, bool> FrameBuffer::InsertFrame(video::FrameToDecode frame) {
         return {last_continuous_frame_id, false};
     }
 
-    if (frame_infos_.size() >= kMaxFramesBuffered) {
+    if (num_frame_infos_ >= kMaxFramesBuffered) {
         if (frame.is_keyframe()) {
             PLOG_WARNING << "Inserting keyframe " << frame.id()
                          << " but the buffer is full, clearing buffer and inserting the frame.";
@@ -64,17 +57,28 @@ std::pair<int64_t, bool> FrameBuffer::InsertFrame(video::FrameToDecode frame) {
         }
     }
 
-    // Test if inserting this frame would cause the order of the frame to become
-    // ambigous (covering more than half the interval of 2^16). This can happen
-    // when the frame id make large jumps mid stream.
-    // FIXME: I don't think this can happen, since frame id has been unwrapped already.
-    if (!frame_infos_.empty() && 
-        frame.id() < frame_infos_.begin()->first &&
-        frame.id() > frame_infos_.rbegin()->first) {
-        PLOG_WARNING << "A jump in frame id was detected, clearing buffer.";
-        // Clear and continue to decode (start from this frame).
-        ClearFramesAndHistory();
-        last_continuous_frame_id = -1;
+    // Test if the frame and its referred frames can be held along with
+    // the buffered frames in the ring. This can happen when the frame id
+    // make large jumps mid stream.
+    int64_t first_frame_id = frame.id();
+    frame.ForEachReference([&first_frame_id](int64_t ref_frame_id, bool* stoped) {
+        first_frame_id = std::min(first_frame_id, ref_frame_id);
+    });
+    if (last_decoded_frame_id) {
+        // The referred frames decoded already are not held in the buffer.
+        first_frame_id = std::min(frame.id(), std::max(first_frame_id, *last_decoded_frame_id + 1));
+    }
+    if (!FitsInBuffer(first_frame_id, frame.id())) {
+        if (frame.is_keyframe()) {
+            PLOG_WARNING << "A jump in frame id was detected, clearing buffer.";
+            // Clear and continue to decode (start from this frame).
+            ClearFramesAndHistory();
+            last_continuous_frame_id = -1;
+        } else {
+            PLOG_WARNING << "Frame " << frame.id()
+                         << " is too far from the buffered frames, dropping it.";
+            return {last_continuous_frame_id, false};
+        }
     }
 
     auto [frame_info, success] = EmplaceFrameInfo(std::move(frame));
@@ -86,34 +90,28 @@ std::pair<int64_t, bool> FrameBuffer::InsertFrame(video::FrameToDecode frame) {
 
     // If all packets of this frame was not be retransmited, 
     // it can be used to calculate delay in Timing.
-    if (!frame.delayed_by_retransmission()) {
-        timing_->IncomingTimestamp(frame_info.frame->timestamp(), frame_info.frame->received_time_ms());
+    if (!frame_info->frame->delayed_by_retransmission()) {
+        timing_->IncomingTimestamp(frame_info->frame->timestamp(), frame_info->frame->received_time_ms());
     }
 
     if (stats_observer_) {
-        stats_observer_->OnCompleteFrame(frame_info.frame->is_keyframe(), frame_info.frame->size());
+        stats_observer_->OnCompleteFrame(frame_info->frame->is_keyframe(), frame_info->frame->size());
     }
 
     // The incoming frame is continuous and try to find all the decodable frames.
-    if (frame_info.continuous()) {
+    if (frame_info->continuous()) {
         // Propaget continuity
-        PropagateContinuity(frame_info);
+        PropagateContinuity(*frame_info);
         // Update the last continuous frame id with this frame id.
         last_continuous_frame_id = *last_continuous_frame_id_;
-        // It might be a better time to decode next frame.
-        if (decode_queue_) {
-            decode_queue_->Post([this](){
-                // Check if the decode task has been started and 
-                // waiting for next decodable frame.
-                if (decode_task_ && decode_task_->Running()) {
-                    // The decode task is waiting for next frame to decode,
-                    // so we restart it for new decodable frame.
-                    decode_task_->Stop();
-                    StartWaitForNextFrameToDecode();
-                }
-            });
+        // It might be a better time to decode next frame, check if the decode
+        // task has been started and waiting for next decodable frame.
+        if (decode_task_ && decode_task_->Running()) {
+            // The decode task is waiting for next frame to decode,
+            // so we restart it for new decodable frame.
+            decode_task_->Stop();
+            StartWaitForNextFrameToDecode();
         }
-        
     }
 
     return {last_continuous_frame_id, true};
@@ -137,27 +135,29 @@ bool FrameBuffer::ValidReferences(const video::FrameToDecode& frame) const {
     }
 }
 
-std::pair<FrameBuffer::FrameInfo&, bool> 
+std::pair<FrameBuffer::FrameInfo*, bool> 
 FrameBuffer::EmplaceFrameInfo(video::FrameToDecode frame) {
-    auto& frame_info = frame_infos_[frame.id()];
+    auto existing_frame_info = FindFrameInfo(frame.id());
     // Frame has been inserted already, ignoring.
-    if (frame_info.frame.has_value()) {
+    if (existing_frame_info && existing_frame_info->frame.has_value()) {
         PLOG_WARNING << "Frame with id=" << frame.id()
                      << " is existed with non-empty frame, ignoring it.";
-        return {frame_info, false};
+        return {existing_frame_info, false};
     }
 
     auto last_decoded_frame_id = decoded_frames_history_.last_decoded_frame_id();
     // The incoming frame is undecodable since the frame ahead of it was decoded.
     if (last_decoded_frame_id && *last_decoded_frame_id >= frame.id()) {
-        return {frame_info, false};;
+        return {existing_frame_info, false};
     }
 
     struct Dependency {
         int64_t frame_id;
         bool continuous;
     };
-    std::vector<Dependency> not_yet_fulfilled_referred_frames;
+    // The references of a frame are far less than the dependent frames of a frame.
+    std::array<Dependency, kMaxDependentFrames> not_yet_fulfilled_referred_frames;
+    size_t num_not_yet_fulfilled_referred_frames = 0;
     // Indicates the incoming frame is decodable.
     bool is_frame_decodable = true;
     // Find all referred frames of this frame that have not yet been fulfilled.
@@ -180,72 +180,87 @@ FrameBuffer::EmplaceFrameInfo(video::FrameToDecode frame) {
             }
         // The referred frame is not be decoded yet.
         } else {
+            auto ref_frame_info = FindFrameInfo(ref_frame_id);
+            // The dependent frames of the referred frame is full or
+            // the frame has too many references.
+            if (num_not_yet_fulfilled_referred_frames == kMaxDependentFrames ||
+                (ref_frame_info && ref_frame_info->num_dependent_frames == kMaxDependentFrames)) {
+                PLOG_WARNING << "Frame with id=" << frame.id()
+                             << " has too many unfulfilled dependencies, dropping frame.";
+                is_frame_decodable = false;
+                *stoped = true;
+                return;
+            }
             // Check if the referred frame is continuous.
-            auto ref_frame_it = frame_infos_.find(ref_frame_id);
-            bool ref_continuous = ref_frame_it != frame_infos_.end() &&
-                                  ref_frame_it->second.continuous();
-            not_yet_fulfilled_referred_frames.push_back({ref_frame_id, ref_continuous});
+            bool ref_continuous = ref_frame_info != nullptr &&
+                                  ref_frame_info->frame.has_value() &&
+                                  ref_frame_info->continuous();
+            not_yet_fulfilled_referred_frames[num_not_yet_fulfilled_referred_frames++] = {ref_frame_id, ref_continuous};
         }
     });
 
     // This frame will never become decodable since
     // its referred frame was non-decodable.
     if (!is_frame_decodable) {
-        return {frame_info, false};
+        return {existing_frame_info, false};
     }
 
+    auto& frame_info = GetOrCreateFrameInfo(frame.id());
     frame_info.frame.emplace(std::move(frame));
 
     // The `num_missing_decodable` is the same as `num_missing_continuous` so far.
-    frame_info.num_missing_continuous = not_yet_fulfilled_referred_frames.size();
-    frame_info.num_missing_decodable = not_yet_fulfilled_referred_frames.size();
+    frame_info.num_missing_continuous = num_not_yet_fulfilled_referred_frames;
+    frame_info.num_missing_decodable = num_not_yet_fulfilled_referred_frames;
 
     // Update the dependent frame list of all the referred frames of this frame.
-    for (auto& ref_frame : not_yet_fulfilled_referred_frames) {
+    for (size_t i = 0; i < num_not_yet_fulfilled_referred_frames; ++i) {
+        const auto& ref_frame = not_yet_fulfilled_referred_frames[i];
         if (ref_frame.continuous) {
             --frame_info.num_missing_continuous;
         }
         // The referred frame of this frame is not continuous for now,
         // so we keep a dependent list (as a reverse link) to propagate 
         // continuity when the referred frame becomes continuous later.
-        // NOTE: If the referred frame is not coming yet, we will insert 
-        // a frame info by the frame id with a empty frame.
-        frame_infos_[ref_frame.frame_id].dependent_frames.push_back(frame_info.frame_id());
+        // NOTE: If the referred frame is not coming yet, we will occupy 
+        // a slot by the frame id with a empty frame.
+        auto& ref_frame_info = GetOrCreateFrameInfo(ref_frame.frame_id);
+        ref_frame_info.dependent_frames[ref_frame_info.num_dependent_frames++] = frame_info.frame_id;
     }
-    return {frame_info, true};
+    return {&frame_info, true};
 }
 
 void FrameBuffer::PropagateContinuity(const FrameInfo& frame_info) {
     assert(frame_info.continuous());
-    std::queue<const FrameInfo*> continuous_frames;
-    continuous_frames.push(&frame_info);
+    // A simple BFS to traverse continuous frames, and each frame
+    // in the buffer will be traversed once at most.
+    continuous_frames_.clear();
+    continuous_frames_.push_back(frame_info.frame_id);
 
-    // A simple BFS to traverse continuous frames.
-    while (!continuous_frames.empty()) {
-        auto frame_info = continuous_frames.front();
-        continuous_frames.pop();
+    for (size_t i = 0; i < continuous_frames_.size(); ++i) {
+        auto frame_info = FindFrameInfo(continuous_frames_[i]);
+        assert(frame_info != nullptr);
        
         // Update the last continuous frame id with the newest frame id.
-        if (!last_continuous_frame_id_ || *last_continuous_frame_id_ < frame_info->frame_id()) {
-            last_continuous_frame_id_ = frame_info->frame_id();
+        if (!last_continuous_frame_id_ || *last_continuous_frame_id_ < frame_info->frame_id) {
+            last_continuous_frame_id_ = frame_info->frame_id;
         }
 
         // Loop through all dependent frames, and if that frame no longer has
         // any unfulfiied dependencies then that frame is continuous as well.
-        for (int64_t dep_frame_id : frame_info->dependent_frames) {
-            auto dep_frame_it = frame_infos_.find(dep_frame_id);
+        for (size_t j = 0; j < frame_info->num_dependent_frames; ++j) {
+            auto dep_frame_info = FindFrameInfo(frame_info->dependent_frames[j]);
             // Test if the dependent frame is still in the buffer.
-            if (dep_frame_it != frame_infos_.end()) {
-                --dep_frame_it->second.num_missing_continuous;
+            if (dep_frame_info) {
+                --dep_frame_info->num_missing_continuous;
                 // Test if the dependent frame becomes continuous so far.
-                if (dep_frame_it->second.continuous()) {
-                    // Push this dependent frame to `continuous_frames` and
+                if (dep_frame_info->continuous()) {
+                    // Push this dependent frame to `continuous_frames_` and
                     // we will traverse it's dependent frames next (BFS).
-                    continuous_frames.push(&dep_frame_it->second);
+                    continuous_frames_.push_back(dep_frame_info->frame_id);
                 }
             }
         }
-    } // end of while
+    } // end of for
 }
 
 } // namespace jitter
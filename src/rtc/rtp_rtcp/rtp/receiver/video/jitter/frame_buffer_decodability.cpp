@@ -23,7 +23,6 @@ void FrameBuffer::NextFrame(int64_t max_wait_time_ms,
                             std::function<void(std::optional<video::FrameToDecode>)> callback) {
     RTC_RUN_ON(decode_queue_);
     int64_t last_return_time_ms = clock_->now_ms() + max_wait_time_ms;
-    std::lock_guard lock(lock_);
     waiting_deadline_ms_ = last_return_time_ms;
     keyframe_required_ = keyframe_required;
     next_frame_found_callback_ = std::move(callback);
@@ -37,19 +36,15 @@ void FrameBuffer::StartWaitForNextFrameToDecode() {
     int64_t wait_ms = FindNextFrameToDecode();
     decode_task_ = RepeatingTask::DelayedStart(clock_, decode_queue_->Get(), TimeDelta::Millis(wait_ms), [this]() {
         std::optional<video::FrameToDecode> next_frame = std::nullopt;
-        NextFrameFoundCallback callback = nullptr;
-        {
-            std::lock_guard lock(lock_);
-            if (frame_to_decode_) {
-                next_frame = GetNextFrameToDecode();
-            } else if (clock_->now_ms() < waiting_deadline_ms_) {
-                // If there's no frames to decode and there is still time left, 
-                // we should continue waiting for the remaining time.
-                return TimeDelta::Millis(FindNextFrameToDecode());
-            }
-            callback = std::move(next_frame_found_callback_);
-            next_frame_found_callback_ = nullptr;
+        if (frame_to_decode_) {
+            next_frame = GetNextFrameToDecode();
+        } else if (clock_->now_ms() < waiting_deadline_ms_) {
+            // If there's no frames to decode and there is still time left, 
+            // we should continue waiting for the remaining time.
+            return TimeDelta::Millis(FindNextFrameToDecode());
         }
+        NextFrameFoundCallback callback = std::move(next_frame_found_callback_);
+        next_frame_found_callback_ = nullptr;
         callback(std::move(next_frame));
         return TimeDelta::Zero();
     });
@@ -62,16 +57,18 @@ int64_t FrameBuffer::FindNextFrameToDecode() {
     int64_t wait_time_ms = max_wait_time_ms;
     frame_to_decode_.reset();
 
-    for (auto frame_it = frame_infos_.begin(); 
-         frame_it != frame_infos_.end() && frame_it->first <= last_continuous_frame_id_; 
-         ++frame_it) {
+    // All the frames before `first_frame_id_` have been removed, and in the common
+    // case the first frame in the buffer is the next frame to decode.
+    const int64_t last_frame_id = num_frame_infos_ > 0 ? std::min(last_frame_id_, last_continuous_frame_id_.value_or(-1)) : -1;
+    for (int64_t frame_id = first_frame_id_; frame_id <= last_frame_id; ++frame_id) {
 
-        auto& frame_info = frame_it->second;
+        auto frame_info_ptr = FindFrameInfo(frame_id);
 
-        // Filter the decoded frames.
-        if (frame_info.frame == std::nullopt) {
+        // Filter the frames not received yet.
+        if (frame_info_ptr == nullptr || frame_info_ptr->frame == std::nullopt) {
             continue;
         }
+        auto& frame_info = *frame_info_ptr;
 
         // Filter the uncontinuous or undecodable frames.
         if (!frame_info.continuous() || 
@@ -96,7 +93,7 @@ int64_t FrameBuffer::FindNextFrameToDecode() {
         // TODO: Gather and combine all remaining frames for the same superframe.
 
         // Retrieve the decodable frame.
-        frame_to_decode_.emplace(frame_it);
+        frame_to_decode_.emplace(frame_id);
         
         // Set render time if necessary.
         if (frame_info.frame->render_time_ms() == -1) {
@@ -138,27 +135,26 @@ video::FrameToDecode FrameBuffer::GetNextFrameToDecode() {
     RTC_RUN_ON(decode_queue_);
     assert(frame_to_decode_);
 
-    auto& frame_info_it = frame_to_decode_.value();
-    auto& frame_info = frame_info_it->second;
-    assert(frame_info.frame);
+    auto frame_info = FindFrameInfo(*frame_to_decode_);
+    assert(frame_info && frame_info->frame);
     
     // Update related info.
     // Propagate the decodability to the dependent frames of this frame.
-    PropagateDecodability(frame_info);
+    PropagateDecodability(*frame_info);
     // Indicate the frame was decoded.
-    decoded_frames_history_.InsertFrame(frame_info.frame->id(), frame_info.frame->timestamp());
+    decoded_frames_history_.InsertFrame(frame_info->frame->id(), frame_info->frame->timestamp());
 
-    // Trigger state callback with all the dropped frames.
-    if (stats_observer_) {
-        size_t dropped_frames = NumUndecodableFrames(frame_infos_.begin(), frame_info_it);
-        if (dropped_frames > 0) {
-            stats_observer_->OnDroppedFrames(dropped_frames);
-        }
-    }
     // Retrieve the next frame to decode.
-    video::FrameToDecode frame = std::move(frame_info.frame.value());
+    video::FrameToDecode frame = std::move(frame_info->frame.value());
+    frame_info->frame.reset();
+    frame_to_decode_.reset();
     // Remove decoded frame and all undecoded frames before it.
-    frame_infos_.erase(frame_infos_.begin(), ++frame_info_it);
+    size_t dropped_frames = EraseFramesUpTo(frame.id());
+
+    // Trigger state callback with all the dropped frames.
+    if (stats_observer_ && dropped_frames > 0) {
+        stats_observer_->OnDroppedFrames(dropped_frames);
+    }
 
     // No nack has happened during the transport of this frame,
     // and it can estimate the jitter delay directly.
@@ -213,13 +209,14 @@ bool FrameBuffer::IsValidRenderTiming(int64_t render_time_ms, int64_t now_ms) {
 // make sure the dependent frames of it can be decoded later.
 int64_t FrameBuffer::PropagateDecodability(const FrameInfo& frame_info) {
     int64_t last_decodable_frame_id = -1;
-    for (int64_t frame_id : frame_info.dependent_frames) {
-        auto dep_frame_it = frame_infos_.find(frame_id);
+    for (size_t i = 0; i < frame_info.num_dependent_frames; ++i) {
+        const int64_t frame_id = frame_info.dependent_frames[i];
+        auto dep_frame_info = FindFrameInfo(frame_id);
         // Make sure the dependent frame is still in the buffer, since
         // the older frames will be removed after a jump in frame id happened.
-        if (dep_frame_it != frame_infos_.end() && dep_frame_it->second.num_missing_decodable > 0) {
-            --dep_frame_it->second.num_missing_decodable;
-            if (dep_frame_it->second.num_missing_decodable == 0) {
+        if (dep_frame_info && dep_frame_info->num_missing_decodable > 0) {
+            --dep_frame_info->num_missing_decodable;
+            if (dep_frame_info->num_missing_decodable == 0) {
                 last_decodable_frame_id = frame_id;
             }
         }
@@ -147,16 +147,30 @@ protected:
         return frame;
     }
 
+    // The frame buffer is confined to the decode queue.
+    void RunOnDecodeQueue(std::function<void()> handler) {
+        decode_queue_->Post(std::move(handler));
+        AdvanceTimeMs(0);
+    }
+
+    int64_t InsertFrame(FrameToDecode frame) {
+        int64_t last_continuous_frame_id = -1;
+        RunOnDecodeQueue([&](){
+            last_continuous_frame_id = frame_buffer_->InsertFrame(std::move(frame)).first;
+        });
+        return last_continuous_frame_id;
+    }
+
     template<typename... U>
     int64_t InsertFrame(uint16_t picture_id,
                      int64_t timestamp_ms,
                      size_t frame_size,
                      U... refs) {
-        return frame_buffer_->InsertFrame(CreateFrame(picture_id, timestamp_ms, 0, frame_size, refs...)).first;
+        return InsertFrame(CreateFrame(picture_id, timestamp_ms, 0, frame_size, refs...));
     }
 
     int64_t InsertNackedFrame(uint16_t picture_id, int64_t timestamp_ms, int times_nacked = 1) {
-        return frame_buffer_->InsertFrame(CreateFrame(picture_id, timestamp_ms, times_nacked, kFrameSize)).first;
+        return InsertFrame(CreateFrame(picture_id, timestamp_ms, times_nacked, kFrameSize));
     }
     // 
     void ExtractFrame(int64_t max_wait_time_ms = 0, bool keyframe_required = false) {
@@ -329,9 +343,9 @@ MY_TEST_F(FrameBufferTest, DroppedFramesCountedOnClear) {
 
     // All frames should be dropped when Clear is called.
     EXPECT_CALL(stats_observer_, OnDroppedFrames(5)).Times(1);
-    frame_buffer_->Clear();
-    // Make the clear task executed.
-    AdvanceTimeMs(0);
+    RunOnDecodeQueue([this](){
+        frame_buffer_->Clear();
+    });
 }
 
 MY_TEST_F(FrameBufferTest, InsertLateFrame) {
@@ -357,12 +371,16 @@ MY_TEST_F(FrameBufferTest, ProtectionModeNackFEC) {
     uint32_t ts = Rand();
 
     constexpr int64_t kRttMs = 200;
-    frame_buffer_->UpdateRtt(kRttMs);
+    RunOnDecodeQueue([this](){
+        frame_buffer_->UpdateRtt(kRttMs);
+    });
 
     EXPECT_CALL(stats_observer_, OnCompleteFrame(_, _)).Times(4);
 
     // Jitter estimate unaffected by RTT in this protection mode.
-    frame_buffer_->set_protection_mode(jitter::ProtectionMode::NACK_FEC);
+    RunOnDecodeQueue([this](){
+        frame_buffer_->set_protection_mode(jitter::ProtectionMode::NACK_FEC);
+    });
     InsertNackedFrame(pid, ts);
     InsertNackedFrame(pid + 1, ts + 100);
     InsertNackedFrame(pid + 2, ts + 200);
@@ -380,12 +398,16 @@ MY_TEST_F(FrameBufferTest, ProtectionModeNack) {
     uint32_t ts = Rand();
 
     constexpr int64_t kRttMs = 200;
-    frame_buffer_->UpdateRtt(kRttMs);
+    RunOnDecodeQueue([this](){
+        frame_buffer_->UpdateRtt(kRttMs);
+    });
 
     EXPECT_CALL(stats_observer_, OnCompleteFrame(_, _)).Times(4);
 
     // Jitter estimate includes RTT (after 3 retransmitted packets)
-    frame_buffer_->set_protection_mode(jitter::ProtectionMode::NACK);
+    RunOnDecodeQueue([this](){
+        frame_buffer_->set_protection_mode(jitter::ProtectionMode::NACK);
+    });
     InsertNackedFrame(pid, ts);
     InsertNackedFrame(pid + 1, ts + 100);
     InsertNackedFrame(pid + 2, ts + 200);
@@ -539,6 +561,51 @@ MY_TEST_F(FrameBufferTest, DontDecodeOlderTimestamp) {
     CheckFrame(1, 3);
     CheckNoFrame(2);
 }
+
+MY_TEST_F(FrameBufferTest, FrameTooFarFromBufferedFrames) {
+
+    EXPECT_CALL(stats_observer_, OnCompleteFrame(_, _)).Times(2);
+
+    EXPECT_EQ(1, InsertFrame(1, 1000, kFrameSize));
+    // The delta frame can not be held along with the undecoded frame 1.
+    EXPECT_EQ(1, InsertFrame(5000, 2000, kFrameSize, 4999));
+
+    // The keyframe clears the buffer and the frame 1 will be dropped.
+    EXPECT_CALL(stats_observer_, OnDroppedFrames(1)).Times(1);
+    EXPECT_EQ(5001, InsertFrame(5001, 3000, kFrameSize));
+    ExtractFrame();
+    ExtractFrame();
+
+    CheckFrame(0, 5001);
+    CheckNoFrame(1);
+}
+
+MY_TEST_F(FrameBufferTest, ContinuityAcrossFrameRingWrapAround) {
+    const int kNumFrames = 3000;
+    uint32_t ts = Rand();
+
+    EXPECT_CALL(stats_observer_, OnCompleteFrame(_, _)).Times(kNumFrames);
+
+    EXPECT_EQ(0, InsertFrame(0, ts, kFrameSize));
+    ExtractFrame();
+    // Insert the frames in pairs reordered, and each one refers to the previous one.
+    for (int i = 1; i + 1 < kNumFrames; i += 2) {
+        EXPECT_EQ(i - 1, InsertFrame(i + 1, ts + (i + 1) * kFps20, kFrameSize, i));
+        EXPECT_EQ(i + 1, InsertFrame(i, ts + i * kFps20, kFrameSize, i - 1));
+        ExtractFrame();
+        AdvanceTimeMs(kFps20);
+        ExtractFrame();
+        AdvanceTimeMs(kFps20);
+    }
+    EXPECT_EQ(kNumFrames - 1, InsertFrame(kNumFrames - 1, ts + (kNumFrames - 1) * kFps20, kFrameSize, kNumFrames - 2));
+    ExtractFrame();
+    AdvanceTimeMs(kFps20);
+
+    ASSERT_EQ(static_cast<size_t>(kNumFrames), frames_.size());
+    for (int i = 0; i < kNumFrames; ++i) {
+        CheckFrame(i, i);
+    }
+}
     
 } // namespace test
 } // namespace naivertc
@@ -24,6 +24,23 @@ PacketBuffer::Packet::Packet(RtpVideoHeader video_header,
       timestamp(timestamp),
       received_time_ms(received_time_ms) {}
 
+// Frame
+CopyOnWriteBuffer PacketBuffer::Frame::bitstream() const {
+    if (payloads.size() == 1) {
+        return payloads[0];
+    }
+    size_t size = 0;
+    for (const auto& payload : payloads) {
+        size += payload.size();
+    }
+    CopyOnWriteBuffer bitstream;
+    bitstream.EnsureCapacity(size);
+    for (const auto& payload : payloads) {
+        bitstream.Append(payload.data(), payload.size());
+    }
+    return bitstream;
+}
+
 // PacketBuffer
 PacketBuffer::PacketBuffer(size_t initial_buffer_size, 
                            size_t max_buffer_size) 
@@ -32,15 +49,18 @@ PacketBuffer::PacketBuffer(size_t initial_buffer_size,
       first_seq_num_(0),
       first_packet_received_(false),
       is_cleared_to_first_seq_num_(false),
-      sps_pps_idr_is_h264_keyframe_(true) {}
+      sps_pps_idr_is_h264_keyframe_(true),
+      missing_packets_begin_(0) {
+    missing_packets_.fill(0);
+}
 
 PacketBuffer::~PacketBuffer() {
     Clear();
 }
 
-PacketBuffer::InsertResult PacketBuffer::InsertPacket(std::unique_ptr<Packet> packet) {
+PacketBuffer::InsertResult PacketBuffer::InsertPacket(Packet packet) {
     InsertResult ret;
-    uint16_t seq_num = packet->seq_num;
+    uint16_t seq_num = packet.seq_num;
     size_t index = seq_num % packet_buffer_.size();
 
     if (!first_packet_received_) {
@@ -57,9 +77,9 @@ PacketBuffer::InsertResult PacketBuffer::InsertPacket(std::unique_ptr<Packet> pa
     }
 
     // Different sequence number may result a same index.
-    if (packet_buffer_[index] != nullptr) {
+    if (packet_buffer_[index].used) {
         // Duplicate packet, ignoring it.
-        if (packet_buffer_[index]->seq_num == packet->seq_num) {
+        if (packet_buffer_[index].packet.seq_num == packet.seq_num) {
             return ret;
         }
         // Try to expand the packet buffer for new packet
@@ -74,8 +94,9 @@ PacketBuffer::InsertResult PacketBuffer::InsertPacket(std::unique_ptr<Packet> pa
     }
     
     // Every new packet is uncontinuous before assembled.
-    packet->continuous = false;
-    packet_buffer_[index] = std::move(packet);
+    packet.continuous = false;
+    packet_buffer_[index].packet = std::move(packet);
+    packet_buffer_[index].used = true;
 
     UpdateMissingPackets(seq_num, kMaxMissingPacketCount);
 
@@ -93,13 +114,12 @@ PacketBuffer::InsertResult PacketBuffer::InsertPadding(uint16_t seq_num) {
 }
 
 void PacketBuffer::Clear() {
-    for (auto& packet : packet_buffer_) {
-        packet.reset();
+    for (auto& slot : packet_buffer_) {
+        ReleaseSlot(slot);
     }
     first_packet_received_ = false;
     is_cleared_to_first_seq_num_ = false;
     newest_inserted_seq_num_.reset();
-    missing_packets_.clear();
 }
 
 void PacketBuffer::ClearTo(uint16_t seq_num) {
@@ -120,8 +140,8 @@ void PacketBuffer::ClearTo(uint16_t seq_num) {
     size_t iterations = std::min(diff, packet_buffer_.size());
     for (size_t i = 0; i < iterations; ++i) {
         auto& stored = packet_buffer_[first_seq_num_ % packet_buffer_.size()];
-        if (stored != nullptr && wrap_around_utils::AheadOf<uint16_t>(seq_num, stored->seq_num)) {
-            stored = nullptr;
+        if (stored.used && wrap_around_utils::AheadOf<uint16_t>(seq_num, stored.packet.seq_num)) {
+            ReleaseSlot(stored);
         }
         ++first_seq_num_;
     }
@@ -131,10 +151,9 @@ void PacketBuffer::ClearTo(uint16_t seq_num) {
     first_seq_num_ = seq_num;
 
     is_cleared_to_first_seq_num_ = true;
-    auto clear_to_it = missing_packets_.upper_bound(seq_num);
-    if (clear_to_it != missing_packets_.begin()) {
-        --clear_to_it;
-        missing_packets_.erase(missing_packets_.begin(), clear_to_it);
+    // Keep the last missing packet up to `seq_num`.
+    if (auto last_missing_seq_num = LastMissingPacketUpTo(seq_num)) {
+        EraseMissingPacketsBefore(*last_missing_seq_num);
     }
 }
 
@@ -147,15 +166,14 @@ PacketBuffer::AssembledFrames PacketBuffer::TryToAssembleFrames(uint16_t seq_num
             break;
         }
         size_t index = seq_num % packet_buffer_.size();
-        Packet* curr_packet = packet_buffer_[index].get();
+        Packet* curr_packet = &packet_buffer_[index].packet;
         curr_packet->continuous = true;
         // If all packets of the frame is continuous, try to assmble them as a frame.
-        if (packet_buffer_[index]->video_header.is_last_packet_in_frame) {
+        if (curr_packet->video_header.is_last_packet_in_frame) {
             uint16_t seq_num_start = seq_num;
             size_t tested_packets = 0;
             int index_in_frame = index;
             int64_t frame_timestamp = curr_packet->timestamp;
-            size_t frame_size = 0;
             
             // Identify H264 keyframes by means of SPS, PPS, and IDR.
             bool is_h264 = curr_packet->video_header.codec_type == ::naivertc::video::CodecType::H264;
@@ -171,7 +189,6 @@ PacketBuffer::AssembledFrames PacketBuffer::TryToAssembleFrames(uint16_t seq_num
                 ++tested_packets;
 
                 const auto& video_header = curr_packet->video_header;
-                frame_size += curr_packet->video_payload.size();
 
                 // `is_first_packet_in_frame` flag not works for H264
                 if (!is_h264 && video_header.is_first_packet_in_frame) {
@@ -214,7 +231,8 @@ PacketBuffer::AssembledFrames PacketBuffer::TryToAssembleFrames(uint16_t seq_num
                 // Backwards to previous packet 
                 index_in_frame = index_in_frame > 0 ? index_in_frame - 1 : packet_buffer_.size() - 1;
 
-                curr_packet = packet_buffer_[index_in_frame].get();
+                Slot& prev_slot = packet_buffer_[index_in_frame];
+                curr_packet = prev_slot.used ? &prev_slot.packet : nullptr;
 
                 // In the case of H264 we don't have a frame_begin bit (yes,
                 // |frame_begin| might be set to true but that is a lie). So instead
@@ -245,23 +263,23 @@ PacketBuffer::AssembledFrames PacketBuffer::TryToAssembleFrames(uint16_t seq_num
                 // Now that we have decided whether to treat this frame as a key frame
                 // or delta frame in the frame buffer, we update the `frame_type` of the first 
                 // packet in the frame that determines if the frame is a key frame or delta frame.
-                const size_t first_packet_index = seq_num_start % packet_buffer_.size();
+                RtpVideoHeader& first_video_header = packet_buffer_[seq_num_start % packet_buffer_.size()].packet.video_header;
                 if (is_h264_keyframe) {
-                    packet_buffer_[first_packet_index]->video_header.frame_type = video::FrameType::KEY;
+                    first_video_header.frame_type = video::FrameType::KEY;
                     if (idr_width > 0 && idr_height > 0) {
                         // IDR frame was finalized and we have the correct resolution for
                         // IDR; update first packet to have same resolution as IDR.
-                        packet_buffer_[first_packet_index]->video_header.frame_width = idr_width;
-                        packet_buffer_[first_packet_index]->video_header.frame_height = idr_height;
+                        first_video_header.frame_width = idr_width;
+                        first_video_header.frame_height = idr_height;
                     }
                 } else {
-                    packet_buffer_[first_packet_index]->video_header.frame_type = video::FrameType::DELTA;
+                    first_video_header.frame_type = video::FrameType::DELTA;
                 }
 
                 // If this is not a keyframe, make sure there are no gaps in the packet
                 // sequence numbers up until this point.
                 // FIXME: https://blog.csdn.net/CrystalShaw/article/details/98081575
-                if (!is_h264_keyframe && missing_packets_.upper_bound(seq_num_start) != missing_packets_.begin()) {
+                if (!is_h264_keyframe && LastMissingPacketUpTo(seq_num_start)) {
                     return assembled_frames;
                 }
             }
@@ -269,13 +287,13 @@ PacketBuffer::AssembledFrames PacketBuffer::TryToAssembleFrames(uint16_t seq_num
             uint16_t num_packets = end_seq_num - seq_num_start;
             auto frame = std::make_unique<Frame>();
             frame->num_packets = num_packets;
-            frame->bitstream.Resize(frame_size);
-            uint8_t* write_at = frame->bitstream.data();
+            frame->payloads.reserve(num_packets);
             // NOTE: Using `!=` not `<` to make sure the wrapped around sequence number works.
             // e.g.: seq_num_start=0xffff, end_seq_num=1
             for (uint16_t i = seq_num_start; i != end_seq_num; ++i) {
-                std::unique_ptr<Packet>& packet = packet_buffer_[i % packet_buffer_.size()];
-                assert(packet != nullptr);
+                Slot& slot = packet_buffer_[i % packet_buffer_.size()];
+                assert(slot.used);
+                Packet* packet = &slot.packet;
                 assert(i == packet->seq_num);
                 // The first packet in frame
                 if (i == seq_num_start) {
@@ -298,17 +316,14 @@ PacketBuffer::AssembledFrames PacketBuffer::TryToAssembleFrames(uint16_t seq_num
                 frame->min_received_time_ms = std::min(frame->min_received_time_ms, packet->received_time_ms);
                 frame->max_received_time_ms = std::max(frame->max_received_time_ms, packet->received_time_ms);
 
-                // Append payload data
-                memcpy(write_at, packet->video_payload.data(), packet->video_payload.size());
-                write_at += packet->video_payload.size();
-                packet.reset();
+                // Link the payload to the frame.
+                frame->payloads.push_back(std::move(packet->video_payload));
+                ReleaseSlot(slot);
             }
 
-            assert(frame_size == frame->bitstream.size());
-
             assembled_frames.push_back(std::move(frame));
 
-            missing_packets_.erase(missing_packets_.begin(), missing_packets_.upper_bound(seq_num));
+            EraseMissingPacketsBefore(seq_num + 1);
         }
         ++seq_num;
     }
@@ -318,12 +333,13 @@ PacketBuffer::AssembledFrames PacketBuffer::TryToAssembleFrames(uint16_t seq_num
 // To check the current sequence number is continuous with the previous one.
 bool PacketBuffer::IsContinuous(uint16_t seq_num) {
     size_t index = seq_num % packet_buffer_.size();
-    const auto& curr_packet = packet_buffer_[index];
+    const Slot& curr_slot = packet_buffer_[index];
 
     // Current packet is not arrived yet,
-    if (curr_packet == nullptr) {
+    if (!curr_slot.used) {
         return false;
     }
+    const Packet* curr_packet = &curr_slot.packet;
 
     // The urrent packet is not belong to `seq_num`,
     // so it's not continuous.
@@ -336,12 +352,13 @@ bool PacketBuffer::IsContinuous(uint16_t seq_num) {
         return true;
     } else {
         size_t prev_index = index > 0 ? index - 1 : packet_buffer_.size() - 1;
-        const auto& prev_packet = packet_buffer_[prev_index];
+        const Slot& prev_slot = packet_buffer_[prev_index];
 
         // Previous packet is not arrived yet,
-        if (prev_packet == nullptr) {
+        if (!prev_slot.used) {
             return false;
         }
+        const Packet* prev_packet = &prev_slot.packet;
         // The previous sequence number is not continuous with the current one,
         // so it's not continuous.
         if (prev_packet->seq_num != static_cast<uint16_t>(curr_packet->seq_num - 1)) {
@@ -362,33 +379,82 @@ bool PacketBuffer::IsContinuous(uint16_t seq_num) {
 void PacketBuffer::UpdateMissingPackets(uint16_t seq_num, size_t window_size) {
     if (!newest_inserted_seq_num_) {
         newest_inserted_seq_num_ = seq_num;
+        missing_packets_begin_ = seq_num + 1;
     }
     // There is a jump between `newest_inserted_seq_num_` and `seq_num`.
     if (wrap_around_utils::AheadOf(seq_num, newest_inserted_seq_num_.value())) {
         // Erase the obsolete packets
         uint16_t old_seq_num = seq_num - window_size;
-        auto erase_to = missing_packets_.lower_bound(old_seq_num);
-        missing_packets_.erase(missing_packets_.begin(), erase_to);
+        EraseMissingPacketsBefore(old_seq_num);
 
         // Guard against inserting a large amout of missing packets
         // if there is a jump in the sequence number.
         if (wrap_around_utils::AheadOf(old_seq_num, newest_inserted_seq_num_.value())) {
             newest_inserted_seq_num_ = old_seq_num;
+            missing_packets_begin_ = old_seq_num + 1;
         }
 
         // Inserting missing packets from `newest_inserted_seq_num_` to `seq_num`,
         // and resulting `newest_inserted_seq_num_` = `seq_num`.
         while (wrap_around_utils::AheadOf(seq_num, ++*newest_inserted_seq_num_)) {
-            missing_packets_.insert(*newest_inserted_seq_num_);
+            SetMissing(*newest_inserted_seq_num_, true);
         }
+        SetMissing(seq_num, false);
+    // Only the packets within the tracked range own their bits.
+    } else if (NumTrackedPacketsUpTo(seq_num) > static_cast<uint16_t>(seq_num - missing_packets_begin_)) {
+        SetMissing(seq_num, false);
+    }
+}
+
+size_t PacketBuffer::NumTrackedPacketsUpTo(uint16_t seq_num) const {
+    if (!newest_inserted_seq_num_) {
+        return 0;
+    }
+    const uint16_t num_tracked_packets = *newest_inserted_seq_num_ + 1 - missing_packets_begin_;
+    const uint16_t offset = seq_num - missing_packets_begin_;
+    if (offset < num_tracked_packets) {
+        return offset + 1;
+    }
+    // `seq_num` is either ahead of or behind the whole range.
+    return wrap_around_utils::AheadOf(seq_num, *newest_inserted_seq_num_) ? num_tracked_packets : 0;
+}
+
+void PacketBuffer::SetMissing(uint16_t seq_num, bool missing) {
+    const size_t bit = seq_num % kMissingPacketsBitmapSize;
+    const uint64_t mask = uint64_t(1) << (bit % 64);
+    if (missing) {
+        missing_packets_[bit / 64] |= mask;
     } else {
-        missing_packets_.erase(seq_num);
+        missing_packets_[bit / 64] &= ~mask;
+    }
+}
+
+std::optional<uint16_t> PacketBuffer::LastMissingPacketUpTo(uint16_t seq_num) const {
+    const size_t num_packets = NumTrackedPacketsUpTo(seq_num);
+    std::optional<uint16_t> last_missing_seq_num;
+    // Scan a word at a time, as the missing packets are sparse.
+    for (size_t i = 0; i < num_packets;) {
+        const size_t bit = static_cast<uint16_t>(missing_packets_begin_ + i) % kMissingPacketsBitmapSize;
+        const size_t num_bits = std::min(64 - bit % 64, num_packets - i);
+        uint64_t word = missing_packets_[bit / 64] >> (bit % 64);
+        if (num_bits < 64) {
+            word &= (uint64_t(1) << num_bits) - 1;
+        }
+        if (word != 0) {
+            last_missing_seq_num = static_cast<uint16_t>(missing_packets_begin_ + i + 63 - __builtin_clzll(word));
+        }
+        i += num_bits;
     }
+    return last_missing_seq_num;
+}
+
+void PacketBuffer::EraseMissingPacketsBefore(uint16_t seq_num) {
+    missing_packets_begin_ += NumTrackedPacketsUpTo(seq_num - 1);
 }
 
 bool PacketBuffer::ExpandPacketBufferIfNecessary(uint16_t seq_num) {
     // No conflict
-    if (packet_buffer_[seq_num % packet_buffer_.size()] == nullptr) {
+    if (!packet_buffer_[seq_num % packet_buffer_.size()].used) {
         return true;
     }
     if (packet_buffer_.size() == max_packet_buffer_size_) {
@@ -401,9 +467,9 @@ bool PacketBuffer::ExpandPacketBufferIfNecessary(uint16_t seq_num) {
     while(!no_more_space_to_expand && new_size <= max_packet_buffer_size_) {
         auto it = packet_buffer_.begin();
         for (; it != packet_buffer_.end(); ++it) {
-            auto& packet = *it;
+            const auto& slot = *it;
             // Check if We need to expand buffer
-            if (packet && (packet->seq_num % new_size == seq_num)) {
+            if (slot.used && (slot.packet.seq_num % new_size == seq_num)) {
                 if (new_size < max_packet_buffer_size_) {
                     new_size = std::min(max_packet_buffer_size_, 2 * new_size);
                     no_more_space_to_expand = false;
@@ -432,15 +498,23 @@ void PacketBuffer::ExpandPacketBuffer(size_t new_size) {
         return;
     }
     new_size = std::min(max_packet_buffer_size_, new_size);
-    std::vector<std::unique_ptr<Packet>> new_packet_buffer(new_size);
-    for (auto& packet : packet_buffer_) {
-        if (packet) {
-            new_packet_buffer[packet->seq_num % new_size] = std::move(packet);
+    std::vector<Slot> new_packet_buffer(new_size);
+    for (auto& slot : packet_buffer_) {
+        if (slot.used) {
+            Slot& new_slot = new_packet_buffer[slot.packet.seq_num % new_size];
+            new_slot.packet = std::move(slot.packet);
+            new_slot.used = true;
         }
     }
     packet_buffer_ = std::move(new_packet_buffer);
     PLOG_INFO << "Packet buffer expanded to " << new_size;
 }
+
+void PacketBuffer::ReleaseSlot(Slot& slot) {
+    slot.used = false;
+    // Drop the reference to the payload, which may be linked to a frame.
+    slot.packet.video_payload = CopyOnWriteBuffer();
+}
     
 } // namespace jitter
 } // namespace video
@@ -8,9 +8,9 @@
 #include "rtc/rtp_rtcp/components/wrap_around_utils.hpp"
 #include "rtc/rtp_rtcp/rtp/depacketizer/rtp_depacketizer.hpp"
 
+#include <array>
 #include <vector>
 #include <memory>
-#include <set>
 
 namespace naivertc {
 namespace rtp {
@@ -32,9 +32,9 @@ public:
                int64_t received_time_ms);
         Packet() = default;
         Packet(const Packet&) = delete;
-        Packet(Packet&&) = delete;
+        Packet(Packet&&) = default;
         Packet& operator=(const Packet&) = delete;
-        Packet& operator=(Packet&&) = delete;
+        Packet& operator=(Packet&&) = default;
         ~Packet() = default;
 
         int width() const { return video_header.frame_width; }
@@ -73,7 +73,13 @@ public:
         int64_t max_received_time_ms = -1;
 
         size_t num_packets = 0;
-        CopyOnWriteBuffer bitstream;
+        // The payloads of the packets in order, which are moved out of the
+        // packets rather than copied during the assembly.
+        std::vector<CopyOnWriteBuffer> payloads;
+
+        // Returns the payloads as a contiguous bitstream, which shares the
+        // payload without copying if there is only one packet in the frame.
+        CopyOnWriteBuffer bitstream() const;
     };
     
     using AssembledFrames = std::vector<std::unique_ptr<Frame>>;
@@ -91,23 +97,42 @@ public:
     bool sps_pps_idr_is_h264_keyframe() const { return sps_pps_idr_is_h264_keyframe_; }
     void set_sps_pps_idr_is_h264_keyframe(bool flag) { sps_pps_idr_is_h264_keyframe_ = flag; }
 
-    InsertResult InsertPacket(std::unique_ptr<Packet> packet);
+    InsertResult InsertPacket(Packet packet);
     InsertResult InsertPadding(uint16_t seq_num);
     void Clear();
     void ClearTo(uint16_t seq_num);
 
 private:
+    // The packets are stored in place and the slots are reused, which
+    // are only reallocated as the packet buffer expands.
+    struct Slot {
+        bool used = false;
+        Packet packet;
+    };
+
     bool ExpandPacketBufferIfNecessary(uint16_t seq_num);
     void ExpandPacketBuffer(size_t new_size);
+    void ReleaseSlot(Slot& slot);
 
     void UpdateMissingPackets(uint16_t seq_num, size_t window_size);
     bool IsContinuous(uint16_t seq_num);
 
+    // The missing packets are tracked as a bitmap indexed by the sequence
+    // number, which covers the range [`missing_packets_begin_`, `newest_inserted_seq_num_`].
+    size_t NumTrackedPacketsUpTo(uint16_t seq_num) const;
+    void SetMissing(uint16_t seq_num, bool missing);
+    std::optional<uint16_t> LastMissingPacketUpTo(uint16_t seq_num) const;
+    void EraseMissingPacketsBefore(uint16_t seq_num);
+
     AssembledFrames TryToAssembleFrames(uint16_t seq_num);
 
 private:
+    // A power of two larger than the maximum number of the missing packets
+    // to track, so that the bits of the range never overlap.
+    static constexpr size_t kMissingPacketsBitmapSize = 1024;
+
     const size_t max_packet_buffer_size_;
-    std::vector<std::unique_ptr<Packet>> packet_buffer_;
+    std::vector<Slot> packet_buffer_;
 
     uint16_t first_seq_num_;
     bool first_packet_received_;
@@ -115,8 +140,8 @@ private:
     bool sps_pps_idr_is_h264_keyframe_;
 
     std::optional<uint16_t> newest_inserted_seq_num_;
-    std::set<uint16_t, wrap_around_utils::OlderThan<uint16_t>> missing_packets_;
-
+    uint16_t missing_packets_begin_;
+    std::array<uint64_t, kMissingPacketsBitmapSize / 64> missing_packets_;
 };
     
 } // namespace jitter
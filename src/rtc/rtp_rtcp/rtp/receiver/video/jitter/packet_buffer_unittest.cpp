@@ -3,6 +3,7 @@
 #include "common/utils_random.hpp"
 #include "rtc/rtp_rtcp/components/num_unwrapper.hpp"
 #include "rtc/media/video/codecs/h264/common.hpp"
+#include "testing/allocation_counter.hpp"
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
@@ -97,16 +98,16 @@ protected:
                         IsLast last,    // is last packet of frame
                         ArrayView<const uint8_t> data = {},
                         uint32_t timestamp = 123u) {  // rtp timestamp
-        auto packet = std::make_unique<Packet>();
-        packet->video_header.codec_type = video::CodecType::GENERIC;
-        packet->timestamp = timestamp;
-        packet->seq_num = seq_num;
-        packet->video_header.frame_type = keyframe == kKeyFrame
+        Packet packet;
+        packet.video_header.codec_type = video::CodecType::GENERIC;
+        packet.timestamp = timestamp;
+        packet.seq_num = seq_num;
+        packet.video_header.frame_type = keyframe == kKeyFrame
                                             ? video::FrameType::KEY
                                             : video::FrameType::DELTA;
-        packet->video_header.is_first_packet_in_frame = first == kFirst;
-        packet->video_header.is_last_packet_in_frame = last == kLast;
-        packet->video_payload.Assign(data.data(), data.size());
+        packet.video_header.is_first_packet_in_frame = first == kFirst;
+        packet.video_header.is_last_packet_in_frame = last == kLast;
+        packet.video_payload.Assign(data.data(), data.size());
 
         return packet_buffer_.InsertPacket(std::move(packet));
     }
@@ -364,6 +365,54 @@ MY_TEST_F(PacketBufferTest, FreeSlotsOnFrameCreation) {
                 StartSeqNumsAre(seq_num + 3));
 }
 
+MY_TEST_F(PacketBufferTest, NoAllocationsPerPacketInSteadyState) {
+    constexpr size_t kNumFrames = 1000;
+    constexpr size_t kNumPacketsPerFrame = 10;
+    // The frame, its payload list and the list of the assembled frames.
+    constexpr size_t kMaxAllocationsPerFrame = 3;
+    const CopyOnWriteBuffer payload = "payload";
+    // Run across the wrap around of the sequence number.
+    uint16_t seq_num = 0xFFFF - kNumFrames * kNumPacketsPerFrame / 2;
+    std::vector<Packet> packets(kNumPacketsPerFrame);
+    for (size_t frame = 0; frame < kNumFrames; ++frame) {
+        for (size_t i = 0; i < kNumPacketsPerFrame; ++i) {
+            Packet& packet = packets[i];
+            packet.video_header.codec_type = video::CodecType::GENERIC;
+            packet.video_header.frame_type = video::FrameType::DELTA;
+            packet.video_header.is_first_packet_in_frame = i == 0;
+            packet.video_header.is_last_packet_in_frame = i == kNumPacketsPerFrame - 1;
+            packet.timestamp = static_cast<uint32_t>(frame);
+            packet.seq_num = seq_num++;
+            packet.video_payload = payload;
+        }
+        for (size_t i = 0; i < kNumPacketsPerFrame - 1; ++i) {
+            size_t num_allocations = 0;
+            InsertResult result;
+            {
+                ScopedAllocationCounter allocation_counter;
+                result = packet_buffer_.InsertPacket(std::move(packets[i]));
+                num_allocations = allocation_counter.num_allocations();
+            }
+            ASSERT_EQ(num_allocations, 0u);
+            EXPECT_THAT(result.assembled_frames, IsEmpty());
+        }
+        size_t num_allocations = 0;
+        InsertResult result;
+        {
+            ScopedAllocationCounter allocation_counter;
+            result = packet_buffer_.InsertPacket(std::move(packets.back()));
+            num_allocations = allocation_counter.num_allocations();
+        }
+        ASSERT_LE(num_allocations, kMaxAllocationsPerFrame);
+        const auto& frames = result.assembled_frames;
+        ASSERT_THAT(frames, SizeIs(1));
+        EXPECT_EQ(frames[0]->num_packets, kNumPacketsPerFrame);
+        // The payloads are linked rather than copied.
+        ASSERT_THAT(frames[0]->payloads, SizeIs(kNumPacketsPerFrame));
+        EXPECT_EQ(frames[0]->payloads[0].cdata(), payload.cdata());
+    }
+}
+
 MY_TEST_F(PacketBufferTest, Clear) {
     const uint16_t seq_num = Rand();
 
@@ -401,14 +450,14 @@ MY_TEST_F(PacketBufferTest, ContinuousSeqNumDoubleMarkerBit) {
 }
 
 MY_TEST_F(PacketBufferTest, TooManyNalusInPacket) {
-    auto packet = std::make_unique<Packet>();
-    packet->video_header.codec_type = video::CodecType::H264;
-    packet->timestamp = 1;
-    packet->seq_num = 1;
-    packet->video_header.frame_type = video::FrameType::KEY;
-    packet->video_header.is_first_packet_in_frame = true;
-    packet->video_header.is_last_packet_in_frame = true;
-    auto& h264_header = packet->video_codec_header.emplace<h264::PacketizationInfo>();
+    Packet packet;
+    packet.video_header.codec_type = video::CodecType::H264;
+    packet.timestamp = 1;
+    packet.seq_num = 1;
+    packet.video_header.frame_type = video::FrameType::KEY;
+    packet.video_header.is_first_packet_in_frame = true;
+    packet.video_header.is_last_packet_in_frame = true;
+    auto& h264_header = packet.video_codec_header.emplace<h264::PacketizationInfo>();
     h264_header.nalus.resize(h264::kMaxNaluNumPerPacket);
     EXPECT_THAT(packet_buffer_.InsertPacket(std::move(packet)).assembled_frames,
                 IsEmpty());
@@ -433,12 +482,12 @@ protected:
                             ArrayView<const uint8_t> data = {},
                             uint32_t width = 0,     // width of frame (SPS/IDR)
                             uint32_t height = 0) {  // height of frame (SPS/IDR)
-        auto packet = std::make_unique<Packet>();
-        packet->video_header.codec_type = video::CodecType::H264;
-        auto& h264_header = packet->video_codec_header.emplace<h264::PacketizationInfo>();
+        Packet packet;
+        packet.video_header.codec_type = video::CodecType::H264;
+        auto& h264_header = packet.video_codec_header.emplace<h264::PacketizationInfo>();
         
-        packet->seq_num = seq_num;
-        packet->timestamp = timestamp;
+        packet.seq_num = seq_num;
+        packet.timestamp = timestamp;
         if (keyframe == kKeyFrame) {
             if (packet_buffer_.sps_pps_idr_is_h264_keyframe()) {
                 h264_header.nalus.resize(3);
@@ -456,11 +505,11 @@ protected:
                 h264_header.has_idr = true;
             }
         }
-        packet->video_header.frame_width = width;
-        packet->video_header.frame_height = height;
-        packet->video_header.is_first_packet_in_frame = first == kFirst;
-        packet->video_header.is_last_packet_in_frame = last == kLast;
-        packet->video_payload.Assign(data.data(), data.size());
+        packet.video_header.frame_width = width;
+        packet.video_header.frame_height = height;
+        packet.video_header.is_first_packet_in_frame = first == kFirst;
+        packet.video_header.is_last_packet_in_frame = last == kLast;
+        packet.video_payload.Assign(data.data(), data.size());
 
         return packet_buffer_.InsertPacket(std::move(packet));
     }
@@ -507,29 +556,29 @@ MY_TEST_P(PacketBufferH264ParameterizedTest, GetBitstreamOneFrameFullBuffer) {
     ASSERT_THAT(frames, SizeIs(1));
     ASSERT_THAT(StartSeqNums(frames), ElementsAre(0));
     EXPECT_EQ(frames[0]->num_packets, kStartSize);
-    EXPECT_EQ(frames[0]->bitstream.size(), kStartSize);
+    EXPECT_EQ(frames[0]->bitstream().size(), kStartSize);
 }
 
 MY_TEST_P(PacketBufferH264ParameterizedTest, GetBitstreamBufferPadding) {
     uint16_t seq_num = Rand();
     CopyOnWriteBuffer data = "some plain old data";
 
-    auto packet = std::make_unique<Packet>();
-    auto& h264_header = packet->video_codec_header.emplace<h264::PacketizationInfo>();
+    Packet packet;
+    auto& h264_header = packet.video_codec_header.emplace<h264::PacketizationInfo>();
     h264_header.nalus.resize(1);
     h264_header.nalus[0].type = h264::NaluType::IDR;
     h264_header.packetization_type = h264::PacketizationType::SIGNLE;
-    packet->seq_num = seq_num;
-    packet->video_header.codec_type = video::CodecType::H264;
-    packet->video_payload = data;
-    packet->video_header.is_first_packet_in_frame = true;
-    packet->video_header.is_last_packet_in_frame = true;
+    packet.seq_num = seq_num;
+    packet.video_header.codec_type = video::CodecType::H264;
+    packet.video_payload = data;
+    packet.video_header.is_first_packet_in_frame = true;
+    packet.video_header.is_last_packet_in_frame = true;
     auto frames = packet_buffer_.InsertPacket(std::move(packet)).assembled_frames;
 
     ASSERT_THAT(frames, SizeIs(1));
     EXPECT_EQ(frames[0]->seq_num_start, seq_num);
     EXPECT_EQ(frames[0]->seq_num_end, seq_num);
-    EXPECT_EQ(frames[0]->bitstream, data);
+    EXPECT_EQ(frames[0]->bitstream(), data);
 }
 
 MY_TEST_P(PacketBufferH264ParameterizedTest, FrameResolution) {
@@ -575,6 +624,15 @@ MY_TEST_P(PacketBufferH264ParameterizedTest, OneFrameMaxSeqNum) {
                 StartSeqNumsAre(65534));
 }
 
+MY_TEST_P(PacketBufferH264ParameterizedTest, MissingPacketsAcrossSeqNumWrapAround) {
+    EXPECT_THAT(InsertH264(65534, kKeyFrame, kFirst, kLast, 0), StartSeqNumsAre(65534));
+    InsertH264(1, kDeltaFrame, kFirst, kNotLast, 2);
+    // Expect no frame because of missing of packet #65535 and #0.
+    EXPECT_THAT(InsertH264(2, kDeltaFrame, kNotFirst, kLast, 2).assembled_frames, IsEmpty());
+    InsertH264(65535, kDeltaFrame, kFirst, kNotLast, 1);
+    EXPECT_THAT(InsertH264(0, kDeltaFrame, kNotFirst, kLast, 1), StartSeqNumsAre(65535, 1));
+}
+
 MY_TEST_P(PacketBufferH264ParameterizedTest, ClearMissingPacketsOnKeyframe) {
     EXPECT_THAT(InsertH264(0, kKeyFrame, kFirst, kLast, 1000), StartSeqNumsAre(0));
     EXPECT_THAT(InsertH264(2, kKeyFrame, kFirst, kLast, 3000).assembled_frames, SizeIs(1));
@@ -604,13 +662,13 @@ protected:
     explicit T(PacketBufferH264XIsKeyframeTest)(bool sps_pps_idr_is_keyframe)
         : T(PacketBufferH264Test)(sps_pps_idr_is_keyframe) {}
 
-    std::unique_ptr<Packet> CreatePacket() {
-        auto packet = std::make_unique<Packet>();
-        packet->video_header.codec_type = video::CodecType::H264;
-        packet->seq_num = kSeqNum;
+    Packet CreatePacket() {
+        Packet packet;
+        packet.video_header.codec_type = video::CodecType::H264;
+        packet.seq_num = kSeqNum;
 
-        packet->video_header.is_first_packet_in_frame = true;
-        packet->video_header.is_last_packet_in_frame = true;
+        packet.video_header.is_first_packet_in_frame = true;
+        packet.video_header.is_last_packet_in_frame = true;
         return packet;
     }
 };
@@ -624,7 +682,7 @@ protected:
 
 MY_TEST_F(PacketBufferH264IdrIsKeyframeTest, IdrIsKeyframe) {
     auto packet = CreatePacket();
-    auto& h264_header = packet->video_codec_header.emplace<h264::PacketizationInfo>();
+    auto& h264_header = packet.video_codec_header.emplace<h264::PacketizationInfo>();
     h264_header.nalus.resize(1);
     h264_header.nalus[0].type = h264::NaluType::IDR;
     h264_header.has_idr = true;
@@ -634,7 +692,7 @@ MY_TEST_F(PacketBufferH264IdrIsKeyframeTest, IdrIsKeyframe) {
 
 MY_TEST_F(PacketBufferH264IdrIsKeyframeTest, SpsPpsIdrIsKeyframe) {
     auto packet = CreatePacket();
-    auto& h264_header = packet->video_codec_header.emplace<h264::PacketizationInfo>();
+    auto& h264_header = packet.video_codec_header.emplace<h264::PacketizationInfo>();
     h264_header.nalus.resize(3);
     h264_header.nalus[0].type = h264::NaluType::SPS;
     h264_header.nalus[1].type = h264::NaluType::PPS;
@@ -656,7 +714,7 @@ class T(PacketBufferH264SpsPpsIdrIsKeyframeTest)
 
 MY_TEST_F(PacketBufferH264SpsPpsIdrIsKeyframeTest, IdrIsNotKeyframe) {
     auto packet = CreatePacket();
-    auto& h264_header = packet->video_codec_header.emplace<h264::PacketizationInfo>();
+    auto& h264_header = packet.video_codec_header.emplace<h264::PacketizationInfo>();
     h264_header.nalus.resize(1);
     h264_header.nalus[0].type = h264::NaluType::IDR;
     h264_header.has_sps = false;
@@ -669,7 +727,7 @@ MY_TEST_F(PacketBufferH264SpsPpsIdrIsKeyframeTest, IdrIsNotKeyframe) {
 
 MY_TEST_F(PacketBufferH264SpsPpsIdrIsKeyframeTest, SpsPpsIsNotKeyframe) {
     auto packet = CreatePacket();
-    auto& h264_header = packet->video_codec_header.emplace<h264::PacketizationInfo>();
+    auto& h264_header = packet.video_codec_header.emplace<h264::PacketizationInfo>();
     h264_header.nalus.resize(2);
     h264_header.nalus[0].type = h264::NaluType::SPS;
     h264_header.nalus[1].type = h264::NaluType::PPS;
@@ -683,7 +741,7 @@ MY_TEST_F(PacketBufferH264SpsPpsIdrIsKeyframeTest, SpsPpsIsNotKeyframe) {
 
 MY_TEST_F(PacketBufferH264SpsPpsIdrIsKeyframeTest, SpsPpsIdrIsKeyframe) {
     auto packet = CreatePacket();
-    auto& h264_header = packet->video_codec_header.emplace<h264::PacketizationInfo>();
+    auto& h264_header = packet.video_codec_header.emplace<h264::PacketizationInfo>();
     h264_header.nalus.resize(3);
     h264_header.nalus[0].type = h264::NaluType::SPS;
     h264_header.nalus[1].type = h264::NaluType::PPS;
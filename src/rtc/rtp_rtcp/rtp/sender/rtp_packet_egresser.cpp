@@ -1,6 +1,7 @@
 #include "rtc/rtp_rtcp/rtp/sender/rtp_packet_egresser.hpp"
 #include "rtc/rtp_rtcp/rtp/packets/rtp_header_extensions.hpp"
 #include "rtc/rtp_rtcp/rtp/sender/rtp_packet_history.hpp"
+#include "rtc/rtp_rtcp/rtp/sender/rtp_packet_generator.hpp"
 #include "rtc/rtp_rtcp/rtp/sender/rtp_packet_sequencer.hpp"
 #include "rtc/base/task_utils/repeating_task.hpp"
 
@@ -19,7 +20,8 @@ constexpr auto kUpdateInterval = TimeDelta::Millis(BitrateStatistics::kDefauleWi
 
 RtpPacketEgresser::RtpPacketEgresser(const RtpConfiguration& config,
                                      SequenceNumberAssigner* seq_num_assigner,
-                                     RtpPacketHistory* const packet_history) 
+                                     RtpPacketHistory* const packet_history,
+                                     RtpPacketGenerator* const padding_generator) 
         : is_audio_(config.audio),
           send_side_bwe_with_overhead_(config.send_side_bwe_with_overhead),
           clock_(config.clock),
@@ -28,6 +30,7 @@ RtpPacketEgresser::RtpPacketEgresser(const RtpConfiguration& config,
           flex_fec_ssrc_(config.fec_generator ? config.fec_generator->fec_ssrc() : std::nullopt),
           send_transport_(config.send_transport),
           packet_history_(packet_history),
+          padding_generator_(padding_generator),
           fec_generator_(config.fec_generator),
           seq_num_assigner_(seq_num_assigner),
           transport_sequence_number_(1),
@@ -89,8 +92,8 @@ void RtpPacketEgresser::SetFecProtectionParameters(const FecProtectionParams& de
 }
 
 void RtpPacketEgresser::PrepareForSend(RtpPacketToSend& packet) {
-    // Assign sequence numbers, but not for flexfec which is already running on
-    // an internally maintained sequence number series.
+    // Assign sequence numbers, but not for FlexFEC or Reed-Solomon FEC which are
+    // already running on an internally maintained sequence number series.
     if (!flex_fec_ssrc_ || packet.ssrc() != *flex_fec_ssrc_) {
         seq_num_assigner_->Sequence(packet);
     }
@@ -105,6 +108,11 @@ bool RtpPacketEgresser::SendPacket(RtpPacketToSend packet,
     if (!VerifySsrcs(packet)) {
         return false;
     }
+    // Packetize the deferred payload right before sending.
+    if (!packet.WriteDeferredPayload()) {
+        PLOG_WARNING << "Failed to write the deferred payload of packet: " << packet.sequence_number();
+        return false;
+    }
     if (packet.packet_type() == RtpPacketType::RETRANSMISSION && 
         !packet.retransmitted_sequence_number().has_value()) {
         PLOG_WARNING << "Retransmission RTP packet can not send without retransmitted sequence number.";
@@ -191,7 +199,15 @@ bool RtpPacketEgresser::SendPacket(RtpPacketToSend packet,
     // Send statistics
     SendStats send_stats(packet.ssrc(), packet.size(), packet_type, RtpPacketCounter(packet));
 
-    const bool send_success = SendPacketToNetwork(std::move(packet), std::move(options));
+    bool send_success = false;
+    if (packet_type == RtpPacketType::PADDING && padding_generator_) {
+        // Shares the buffer with the transport, and recycles the padding packet
+        // to be patched in place next time.
+        send_success = SendPacketToNetwork(packet, std::move(options));
+        padding_generator_->RecyclePaddingPacket(std::move(packet));
+    } else {
+        send_success = SendPacketToNetwork(std::move(packet), std::move(options));
+    }
 
     // NOTE: The `packet` was moved to other, DO NOT use it any more.
 
@@ -261,14 +277,15 @@ DataRate RtpPacketEgresser::CalcTotalSendBitrate(const int64_t now_ms) {
     return send_bitrate;
 }
 
-bool RtpPacketEgresser::SendPacketToNetwork(RtpPacketToSend packet, PacketOptions options) {
+bool RtpPacketEgresser::SendPacketToNetwork(CopyOnWriteBuffer packet, PacketOptions options) {
     if (send_transport_) {
         auto packet_id = options.packet_id;
+        const size_t packet_size = packet.size();
         int sent_size = send_transport_->SendRtpPacket(std::move(packet), std::move(options), false);
         // NOTE: The |sent_size| may be greater then size of the packet to send,
         // since it will be processed before sending to network, like encryption. 
         if (sent_size < 0) {
-            PLOG_WARNING << "Faild to send packet: " << packet.sequence_number();
+            PLOG_WARNING << "Faild to send packet of size: " << packet_size;
             return false;
         }
         if (transport_feedback_observer_) {
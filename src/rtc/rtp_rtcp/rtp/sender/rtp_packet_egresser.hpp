@@ -20,6 +20,7 @@ namespace naivertc {
 
 class RepeatingTask;
 class RtpPacketHistory;
+class RtpPacketGenerator;
 class RtpPacketSequencer;
 
 class RtpPacketEgresser {
@@ -40,7 +41,8 @@ public:
 public:
     RtpPacketEgresser(const RtpConfiguration& config,
                       SequenceNumberAssigner* seq_num_assigner,
-                      RtpPacketHistory* packet_history);
+                      RtpPacketHistory* packet_history,
+                      RtpPacketGenerator* padding_generator = nullptr);
     ~RtpPacketEgresser();
 
     uint32_t ssrc() const;
@@ -84,7 +86,7 @@ private:
     };
 
 private:
-    bool SendPacketToNetwork(RtpPacketToSend packet, PacketOptions options);
+    bool SendPacketToNetwork(CopyOnWriteBuffer packet, PacketOptions options);
 
     bool VerifySsrcs(const RtpPacketToSend& packet);
 
@@ -124,6 +126,8 @@ private:
     RtcMediaTransport* const send_transport_;
     
     RtpPacketHistory* const packet_history_;
+    // The padding packets sent are recycled to it if present.
+    RtpPacketGenerator* const padding_generator_;
     FecGenerator* const fec_generator_;
     SequenceNumberAssigner* const seq_num_assigner_;
 
@@ -713,7 +713,7 @@ MY_TEST_P(RtpPacketEgresserTest, TransportFeedbackObserverFEC) {
     fec.set_packet_type(RtpPacketType::FEC);
     fec.set_ssrc(kFlexFecSsrc);
     
-    FlexfecGenerator flex_fec_generator(98, kFlexFecSsrc, kMediaSsrc);
+    FlexfecGenerator flex_fec_generator(98, kFlexFecSsrc, kMediaSsrc, &clock_);
     auto config = DefaultConfig();
     config.fec_generator = &flex_fec_generator;
     Reset(config);
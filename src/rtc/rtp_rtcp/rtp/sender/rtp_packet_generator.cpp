@@ -11,6 +11,7 @@ namespace {
 
 // Max in the RFC 3550 is 255 bytes, we limit it to be modulus 32 for SRTP.
 constexpr size_t kMaxPaddingSize = 224;
+constexpr size_t kMaxPooledPaddingPackets = 16;
 constexpr size_t kMinAudioPaddingSize = 50;
 // Min size needed to get payload padding from packet history.
 constexpr int kMinPayloadPaddingBytes = 50;
@@ -393,14 +394,11 @@ std::vector<RtpPacketToSend> RtpPacketGenerator::GeneratePadding(size_t target_p
         // Allow smaller padding packet for audio.
         padding_bytes_in_packet = std::min(padding_bytes_in_packet, std::max(bytes_left, kMinAudioPaddingSize));
     }
+    padding_packets.reserve(padding_packets.size() + 
+                            (bytes_left + padding_bytes_in_packet - 1) / padding_bytes_in_packet);
 
     while (bytes_left) {
-        // NOTE: the padding packets without FEC protection.
-        auto padding_packet = RtpPacketToSend(&rtp_header_extension_map_);
-        padding_packet.set_packet_type(RtpPacketType::PADDING);
-        // NOTE: We can distinguish padding packet from media packet by marker flag.
-        padding_packet.set_marker(false);
-        
+        uint32_t padding_ssrc = media_ssrc_;
         if (rtx_mode_ == kRtxOff) {
             // Send padding packet on media ssrc.
 
@@ -408,7 +406,6 @@ std::vector<RtpPacketToSend> RtpPacketGenerator::GeneratePadding(size_t target_p
             if (!can_send_padding_on_media_ssrc) {
                 break;
             }
-            padding_packet.set_ssrc(media_ssrc_);
         } else {
             // Send padding packet on RTX ssrc.
 
@@ -422,36 +419,29 @@ std::vector<RtpPacketToSend> RtpPacketGenerator::GeneratePadding(size_t target_p
             }
 
             assert(rtx_ssrc_.has_value());
-            assert(!rtx_payload_type_map_.empty());
-
-            padding_packet.set_ssrc(*rtx_ssrc_);
-            // Set as RTX payload type.
-            padding_packet.set_payload_type(rtx_payload_type_map_.begin()->second);
-        }
-
-        // Reserver rtp header extensions can be used in Padding packet.
-
-        // Transport sequence number extension.
-        if (rtp_header_extension_map_.IsRegistered(kRtpExtensionTransportSequenceNumber)) {
-            padding_packet.ReserveExtension<rtp::TransportSequenceNumber>();
-        }
-        // Transmission time offset extension.
-        if (rtp_header_extension_map_.IsRegistered(kRtpExtensionTransmissionTimeOffset)) {
-            padding_packet.ReserveExtension<rtp::TransmissionTimeOffset>();
-        }
-        // Absolute send time extension.
-        if (rtp_header_extension_map_.IsRegistered(kRtpExtensionAbsoluteSendTime)) {
-            padding_packet.ReserveExtension<rtp::AbsoluteSendTime>();
+            padding_ssrc = *rtx_ssrc_;
         }
 
-        padding_packet.SetPadding(padding_bytes_in_packet);
         bytes_left -= std::min(bytes_left, padding_bytes_in_packet);
-        padding_packets.push_back(std::move(padding_packet));
+        padding_packets.push_back(CreatePaddingPacket(padding_ssrc, padding_bytes_in_packet));
     }
     
     return padding_packets;
 }
 
+void RtpPacketGenerator::RecyclePaddingPacket(RtpPacketToSend packet) {
+    RTC_RUN_ON(&sequence_checker_);
+    // The RTX packets used as padding are not reusable.
+    if (packet.payload_size() > 0) {
+        return;
+    }
+    auto it = padding_packet_pools_.find(packet.ssrc());
+    if (it == padding_packet_pools_.end() || it->second.size() >= kMaxPooledPaddingPackets) {
+        return;
+    }
+    it->second.push_back(std::move(packet));
+}
+
 void RtpPacketGenerator::OnReceivedAckOnMediaSsrc() {
     RTC_RUN_ON(&sequence_checker_);
     bool update_required = !media_ssrc_has_acked_;
@@ -472,6 +462,8 @@ void RtpPacketGenerator::OnReceivedAckOnRtxSsrc() {
 
 // Private methods
 void RtpPacketGenerator::UpdateHeaderSizes() {
+    // The header extensions of padding packet may be changed.
+    ClearPaddingPacketPools();
     const size_t rtp_header_size = kRtpHeaderSize + sizeof(uint32_t) * csrcs_.size();
     // The maximum header size per FEC/Padding packet.
     max_fec_or_padding_packet_header_size_ = rtp_header_size + 
@@ -515,6 +507,82 @@ void RtpPacketGenerator::UpdateHeaderSizes() {
     }
 }
 
+RtpPacketToSend RtpPacketGenerator::CreatePaddingPacket(uint32_t ssrc, size_t padding_size) {
+    auto [it, inserted] = padding_packet_pools_.try_emplace(ssrc);
+    auto& pool = it->second;
+    if (inserted) {
+        pool.reserve(kMaxPooledPaddingPackets);
+    }
+    while (!pool.empty()) {
+        RtpPacketToSend padding_packet = std::move(pool.back());
+        pool.pop_back();
+        if (!IsPaddingPacketReusable(padding_packet, padding_size)) {
+            continue;
+        }
+        // The sequence number, timestamp and header extensions are written in
+        // place at sending, and the RTX payload type may be changed.
+        if (ssrc != media_ssrc_) {
+            padding_packet.set_payload_type(rtx_payload_type_map_.begin()->second);
+        }
+        return padding_packet;
+    }
+
+    // NOTE: the padding packets without FEC protection.
+    RtpPacketToSend padding_packet(&rtp_header_extension_map_);
+    padding_packet.set_packet_type(RtpPacketType::PADDING);
+    // NOTE: We can distinguish padding packet from media packet by marker flag.
+    padding_packet.set_marker(false);
+    padding_packet.set_ssrc(ssrc);
+    if (ssrc != media_ssrc_) {
+        assert(!rtx_payload_type_map_.empty());
+        // Set as RTX payload type.
+        padding_packet.set_payload_type(rtx_payload_type_map_.begin()->second);
+    }
+
+    // Reserver rtp header extensions can be used in Padding packet.
+
+    // Transport sequence number extension.
+    if (rtp_header_extension_map_.IsRegistered(kRtpExtensionTransportSequenceNumber)) {
+        padding_packet.ReserveExtension<rtp::TransportSequenceNumber>();
+    }
+    // Transmission time offset extension.
+    if (rtp_header_extension_map_.IsRegistered(kRtpExtensionTransmissionTimeOffset)) {
+        padding_packet.ReserveExtension<rtp::TransmissionTimeOffset>();
+    }
+    // Absolute send time extension.
+    if (rtp_header_extension_map_.IsRegistered(kRtpExtensionAbsoluteSendTime)) {
+        padding_packet.ReserveExtension<rtp::AbsoluteSendTime>();
+    }
+
+    padding_packet.SetPadding(padding_size);
+    return padding_packet;
+}
+
+bool RtpPacketGenerator::IsPaddingPacketReusable(const RtpPacketToSend& packet, size_t padding_size) const {
+    if (packet.padding_size() != padding_size) {
+        return false;
+    }
+    const auto& extension_map = packet.extension_map();
+    if (extension_map.extmap_allow_mixed() != rtp_header_extension_map_.extmap_allow_mixed()) {
+        return false;
+    }
+    for (auto type : {kRtpExtensionTransportSequenceNumber, 
+                      kRtpExtensionTransmissionTimeOffset, 
+                      kRtpExtensionAbsoluteSendTime}) {
+        if (extension_map.GetId(type) != rtp_header_extension_map_.GetId(type)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void RtpPacketGenerator::ClearPaddingPacketPools() {
+    // Keep the capacity for reuse.
+    for (auto& [ssrc, pool] : padding_packet_pools_) {
+        pool.clear();
+    }
+}
+
 void RtpPacketGenerator::CopyHeaderAndExtensionsToRtxPacket(const RtpPacketToSend& packet, RtpPacketToSend* rtx_packet) {
     // Set the relevant fixed fields in the packet headers.
     // The following are not set:
@@ -60,6 +60,9 @@ public:
     std::vector<RtpPacketToSend> GeneratePadding(size_t target_packet_size, 
                                                  bool media_has_been_sent,
                                                  bool can_send_padding_on_medai_ssrc);
+    // Returns the padding packet generated to the pool once it has been sent
+    // or discarded, so its buffer can be patched in place for the next one.
+    void RecyclePaddingPacket(RtpPacketToSend packet);
 
     // Return the maximum header size per media packet.
     size_t MaxMediaPacketHeaderSize() const;
@@ -73,6 +76,13 @@ public:
 
 private:
     int32_t ResendPacket(uint16_t packet_id);
+    // Reuses a padding packet of |ssrc| from the pool if any, otherwise builds
+    // a new one.
+    RtpPacketToSend CreatePaddingPacket(uint32_t ssrc, size_t padding_size);
+    // Returns false if the header extensions have been changed since the
+    // pooled |packet| was built.
+    bool IsPaddingPacketReusable(const RtpPacketToSend& packet, size_t padding_size) const;
+    void ClearPaddingPacketPools();
     static void CopyHeaderAndExtensionsToRtxPacket(const RtpPacketToSend& packet, 
                                                    RtpPacketToSend* rtx_packet);
 
@@ -103,6 +113,9 @@ private:
 
     std::map<int8_t, int8_t> rtx_payload_type_map_;
     std::vector<uint32_t> csrcs_;
+
+    // The padding packets sent and ready to be reused, keyed by SSRC.
+    std::map<uint32_t, std::vector<RtpPacketToSend>> padding_packet_pools_;
 };
     
 } // namespace naivertc
@@ -6,8 +6,10 @@
 #define ENABLE_UNIT_TESTS 0
 #include "testing/defines.hpp"
 #include "testing/simulated_clock.hpp"
+#include "testing/allocation_counter.hpp"
 
 #include <vector>
+#include <algorithm>
 
 namespace naivertc {
 namespace test {
@@ -110,6 +112,57 @@ MY_TEST_F(RtpPacketGeneratorTest, BuildRtxPacket) {
     EXPECT_NE(kSeqNum, rtx_packet->sequence_number());
 }
 
+MY_TEST_F(RtpPacketGeneratorTest, GeneratePaddingReusesRecycledPackets) {
+    const uint8_t kMediaPayloadType = 98;
+    const uint8_t kRtxPayloadType = 99;
+    packet_generator_->Register(rtp::TransportSequenceNumber::kType, kTransportSequenceNumberExtensionId);
+    packet_generator_->SetRtxPayloadType(kRtxPayloadType, kMediaPayloadType);
+    packet_generator_->set_rtx_mode(kRtxRetransmitted);
+
+    auto padding_packets = packet_generator_->GeneratePadding(/*target_packet_size=*/500, 
+                                                              /*media_has_been_sent=*/true, 
+                                                              /*can_send_padding_on_media_ssrc=*/true);
+    ASSERT_GT(padding_packets.size(), 1u);
+    std::vector<const uint8_t*> buffers;
+    for (auto& packet : padding_packets) {
+        EXPECT_EQ(packet.packet_type(), RtpPacketType::PADDING);
+        EXPECT_EQ(packet.ssrc(), kRtxSsrc);
+        EXPECT_EQ(packet.payload_type(), kRtxPayloadType);
+        EXPECT_EQ(packet.padding_size(), padding_packets[0].padding_size());
+        EXPECT_TRUE(packet.HasExtension<rtp::TransportSequenceNumber>());
+        buffers.push_back(packet.cdata());
+    }
+    const size_t num_padding_packets = padding_packets.size();
+
+    // Recycles the sent padding packets.
+    for (auto& packet : padding_packets) {
+        packet.set_sequence_number(123);
+        packet_generator_->RecyclePaddingPacket(std::move(packet));
+    }
+    padding_packets.clear();
+
+    {
+        test::ScopedAllocationCounter allocation_counter;
+        padding_packets = packet_generator_->GeneratePadding(500, true, true);
+        // Only the returned vector is allocated.
+        EXPECT_LE(allocation_counter.num_allocations(), 1u);
+    }
+    ASSERT_EQ(padding_packets.size(), num_padding_packets);
+    for (auto& packet : padding_packets) {
+        EXPECT_EQ(packet.payload_type(), kRtxPayloadType);
+        EXPECT_NE(std::find(buffers.begin(), buffers.end(), packet.cdata()), buffers.end());
+    }
+
+    // The padding packet is rebuilt after the header extensions changed.
+    for (auto& packet : padding_packets) {
+        packet_generator_->RecyclePaddingPacket(std::move(packet));
+    }
+    packet_generator_->Register(rtp::AbsoluteSendTime::kType, kAbsoluteSendTimeExtensionId);
+    padding_packets = packet_generator_->GeneratePadding(500, true, true);
+    ASSERT_FALSE(padding_packets.empty());
+    EXPECT_TRUE(padding_packets[0].HasExtension<rtp::AbsoluteSendTime>());
+}
+
 MY_TEST_F(RtpPacketGeneratorTest, UpdateCsrcsUpdateOverhead) {
     // Base RTP overhead is 12 bytes
     EXPECT_EQ(packet_generator_->MaxMediaPacketHeaderSize(), 12);
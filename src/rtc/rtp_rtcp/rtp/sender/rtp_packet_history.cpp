@@ -3,7 +3,23 @@
 
 #include <plog/Log.h>
 
+#include <algorithm>
+#include <limits>
+
 namespace naivertc {
+namespace {
+
+constexpr size_t kMinHistoryCapacity = 16;
+// The interval to warn about the packets not stored due to the budget.
+constexpr int64_t kBudgetWarningLogIntervalMs = 10000;
+// The capacity can hold all the sequence numbers.
+constexpr size_t kMaxHistoryCapacity = std::numeric_limits<uint16_t>::max() + 1;
+
+size_t PaddingPriorityBucket(size_t num_retransmitted) {
+    return std::min(num_retransmitted, RtpPacketHistory::kNumPaddingPriorityBuckets - 1);
+}
+
+} // namespace
 
 // PacketState
 RtpPacketHistory::PacketState::PacketState() = default;
@@ -23,28 +39,41 @@ RtpPacketHistory::StoredPacket::StoredPacket(
       num_retransmitted(0),
       insert_order(insert_order) {}
 
-// RtpPacketHistory
-bool RtpPacketHistory::StoredPacket::Compare::operator()(StoredPacket* lhs,
-                                                         StoredPacket* rhs) const {
-    // Prefer to send packets we haven't already sent as padding.
-    if (lhs->num_retransmitted != rhs->num_retransmitted) {
-        return lhs->num_retransmitted < rhs->num_retransmitted;
-    }
-    // All else being equal, prefer newer packets.
-    return lhs->insert_order > rhs->insert_order;
-}
-
 // RtpPacketHistory
 // Public methods
-RtpPacketHistory::RtpPacketHistory(Clock* clock, bool enable_padding_prio) 
+RtpPacketHistory::RtpPacketHistory(Clock* clock, 
+                                   bool enable_padding_prio,
+                                   RtpPacketHistoryBudget* budget) 
     : clock_(clock),
       enable_padding_prio_(enable_padding_prio),
+      budget_(budget),
       number_to_store_(0),
       mode_(StorageMode::DISABLE),
       rtt_ms_(-1),
-      packets_inserted_(0) {}
+      first_seq_num_(0),
+      history_size_(0),
+      stored_bytes_(0),
+      packets_inserted_(0),
+      num_padding_candidates_(0),
+      num_packets_over_budget_(0),
+      last_budget_warning_ms_(-1) {
+    if (enable_padding_prio_) {
+        for (auto& bucket : padding_priority_) {
+            bucket.reserve(kMaxPaddingtHistory);
+        }
+    }
+    if (budget_) {
+        budget_->AddHistory(this);
+    }
+}
 
-RtpPacketHistory::~RtpPacketHistory() {}
+RtpPacketHistory::~RtpPacketHistory() {
+    // Release the bytes stored from the budget.
+    Reset();
+    if (budget_) {
+        budget_->RemoveHistory(this);
+    }
+}
 
 void RtpPacketHistory::SetStorePacketsStatus(StorageMode mode, size_t number_to_store) {
     RTC_RUN_ON(&sequence_checker_);
@@ -65,6 +94,11 @@ RtpPacketHistory::StorageMode RtpPacketHistory::GetStorageMode() const {
     return mode_;
 }
 
+size_t RtpPacketHistory::stored_bytes() const {
+    RTC_RUN_ON(&sequence_checker_);
+    return stored_bytes_;
+}
+
 void RtpPacketHistory::SetRttMs(int64_t rtt_ms) {
     RTC_RUN_ON(&sequence_checker_);
     if (rtt_ms < 0) {
@@ -95,44 +129,74 @@ void RtpPacketHistory::PutRtpPacket(RtpPacketToSend packet, std::optional<int64_
         return;
     }
     CullOldPackets(now_ms);
+    // Make room for the packet in the shared budget.
+    if (budget_ && !budget_->MakeRoomFor(packet.size(), now_ms)) {
+        ++num_packets_over_budget_;
+        if (last_budget_warning_ms_ < 0 || now_ms - last_budget_warning_ms_ >= kBudgetWarningLogIntervalMs) {
+            PLOG_WARNING << "Packet history budget exhausted, " << num_packets_over_budget_
+                         << " packets can not be retransmitted since last warning.";
+            last_budget_warning_ms_ = now_ms;
+            num_packets_over_budget_ = 0;
+        }
+        return;
+    }
 
     // Store packet.
     const uint16_t seq_num = packet.sequence_number();
     int packet_index = GetPacketIndex(seq_num);
     if (packet_index >= 0 &&
-        static_cast<size_t>(packet_index) < packet_history_.size() &&
-        packet_history_[packet_index]) {
+        static_cast<size_t>(packet_index) < history_size_ &&
+        PacketAt(packet_index)) {
         PLOG_WARNING << "Duplicate packet inserted: " << seq_num;
         // Remove previous packet to avoid inconsistent state.
         RemovePacket(packet_index);
         packet_index = GetPacketIndex(seq_num);
     }
 
-    // Packet to be inserted ahead of first packet, expand front.
-    for (; packet_index < 0; ++packet_index) {
-        packet_history_.emplace_front();
+    if (history_size_ == 0) {
+        first_seq_num_ = seq_num;
+        packet_index = 0;
     }
-    // Packet to be inserted behind last packet, expand back.
-    while (static_cast<int>(packet_history_.size()) <= packet_index) {
-        packet_history_.emplace_back();
+
+    if (packet_index < 0) {
+        // Packet to be inserted ahead of first packet, expand front.
+        EnsureCapacity(history_size_ - packet_index);
+        history_size_ -= packet_index;
+        first_seq_num_ = seq_num;
+        packet_index = 0;
+    } else if (static_cast<size_t>(packet_index) >= history_size_) {
+        // Packet to be inserted behind last packet, expand back.
+        EnsureCapacity(packet_index + 1);
+        history_size_ = packet_index + 1;
     }
 
     assert(packet_index >= 0);
-    assert(packet_index < packet_history_.size());
-    assert(packet_history_[packet_index] == std::nullopt);
+    assert(packet_index < history_size_);
+    assert(PacketAt(packet_index) == std::nullopt);
     
-    StoredPacket& stored_packet = packet_history_[packet_index].emplace(StoredPacket(std::move(packet), send_time_ms, packets_inserted_++));
+    StoredPacket& stored_packet = PacketAt(packet_index).emplace(std::move(packet), send_time_ms, packets_inserted_++);
+    stored_bytes_ += stored_packet.packet.size();
+    if (budget_) {
+        budget_->OnPacketStored(stored_packet.packet.size());
+        if (packet_index == 0) {
+            budget_->OnOldestPacketChanged(this, stored_packet.send_time_ms.value_or(now_ms));
+        }
+    }
 
     if (enable_padding_prio_) {
-        // Erase the uppest packet in the |padding_priority_| 
+        // Erase the lowest prioritized packet in the |padding_priority_| 
         // if there is no space reserved for the new packet.
-        if (padding_priority_.size() >= kMaxPaddingtHistory - 1) {
-            padding_priority_.erase(std::prev(padding_priority_.end()));
-        }
-        auto [it, inserted] = padding_priority_.insert(&stored_packet);
-        if (!inserted) {
-            PLOG_WARNING << "Failed to insert packet into prio set.";
+        if (num_padding_candidates_ >= kMaxPaddingtHistory - 1) {
+            for (auto it = padding_priority_.rbegin(); it != padding_priority_.rend(); ++it) {
+                if (!it->empty()) {
+                    // The oldest one in the bucket.
+                    it->erase(it->begin());
+                    --num_padding_candidates_;
+                    break;
+                }
+            }
         }
+        AddPaddingCandidate(stored_packet);
     }
 }
 
@@ -200,6 +264,37 @@ std::optional<RtpPacketToSend> RtpPacketHistory::GetPacketAndMarkAsPending(uint1
     return encapsulated_packet;
 }
 
+std::vector<RtpPacketToSend> RtpPacketHistory::GetPacketsAndMarkAsPending(ArrayView<const uint16_t> sequence_numbers,
+                                                                          EncapsulateCallback encapsulate) {
+    RTC_RUN_ON(&sequence_checker_);
+    std::vector<RtpPacketToSend> packets;
+    if (mode_ == StorageMode::DISABLE || encapsulate == nullptr) {
+        return packets;
+    }
+
+    packets.reserve(sequence_numbers.size());
+    for (uint16_t sequence_number : sequence_numbers) {
+        StoredPacket* stored_packet = GetStoredPacket(sequence_number);
+        if (stored_packet == nullptr) {
+            continue;
+        }
+
+        // Packet already in pacer queue or resent within too short a time
+        // window, ignore.
+        if (stored_packet->pending_transmission || !CanBeTransmitted(*stored_packet)) {
+            continue;
+        }
+
+        auto encapsulated_packet = encapsulate(stored_packet->packet);
+        if (!encapsulated_packet) {
+            break;
+        }
+        stored_packet->pending_transmission = true;
+        packets.push_back(std::move(*encapsulated_packet));
+    }
+    return packets;
+}
+
 void RtpPacketHistory::MarkPacketAsSent(uint16_t sequence_number) {
     RTC_RUN_ON(&sequence_checker_);
     if (mode_ == StorageMode::DISABLE) {
@@ -231,10 +326,10 @@ std::optional<RtpPacketHistory::PacketState> RtpPacketHistory::GetPacketState(ui
 
     int packet_index = GetPacketIndex(sequence_number);
     if (packet_index < 0 ||
-        static_cast<size_t>(packet_index) >= packet_history_.size()) {
+        static_cast<size_t>(packet_index) >= history_size_) {
         return std::nullopt;
     }
-    const auto& stored_packet = packet_history_[packet_index];
+    const auto& stored_packet = PacketAt(packet_index);
     if (!stored_packet) {
         return std::nullopt;
     }
@@ -261,10 +356,9 @@ std::optional<RtpPacketToSend> RtpPacketHistory::GetPayloadPaddingPacket(Encapsu
     }
 
     StoredPacket* best_packet = nullptr;
-    if (enable_padding_prio_ && !padding_priority_.empty()) {
-        auto best_packet_it = padding_priority_.begin();
-        best_packet = *best_packet_it;
-    } else if (!enable_padding_prio_ && !packet_history_.empty()) {
+    if (enable_padding_prio_) {
+        best_packet = GetBestPaddingPacket();
+    } else if (history_size_ > 0) {
         // Prioritization not available, pick the last packet.
         best_packet = GetLastAvailablePacket();
     }
@@ -300,7 +394,7 @@ void RtpPacketHistory::CullAckedPackets(ArrayView<const uint16_t> acked_seq_nums
     for (uint16_t acked_seq_num : acked_seq_nums) {
         int packet_index = GetPacketIndex(acked_seq_num);
         if (packet_index < 0 ||
-            static_cast<size_t>(packet_index) >= packet_history_.size()) {
+            static_cast<size_t>(packet_index) >= history_size_) {
             continue;
         }
         RemovePacket(packet_index);
@@ -327,6 +421,35 @@ void RtpPacketHistory::Clear() {
     Reset();
 }
 
+std::optional<int64_t> RtpPacketHistory::OldestEvictableSendTimeMs(int64_t now_ms) const {
+    RTC_RUN_ON(&sequence_checker_);
+    if (history_size_ == 0) {
+        return std::nullopt;
+    }
+    // The first entry is always populated, and it's the oldest one.
+    const auto& stored_packet = PacketAt(0);
+    assert(stored_packet != std::nullopt);
+
+    // Don't evict the packets in the pacer queue or unsent.
+    if (stored_packet->pending_transmission || !stored_packet->send_time_ms) {
+        return std::nullopt;
+    }
+
+    // Don't evict the packets sent within one RTT, which are likely
+    // to be requested for retransmission.
+    if (*stored_packet->send_time_ms + std::max<int64_t>(rtt_ms_, 0) > now_ms) {
+        return std::nullopt;
+    }
+    return stored_packet->send_time_ms;
+}
+
+void RtpPacketHistory::EvictOldestPacket() {
+    RTC_RUN_ON(&sequence_checker_);
+    if (history_size_ > 0) {
+        RemovePacket(0);
+    }
+}
+
 // Private methods
 bool RtpPacketHistory::CanBeTransmitted(const StoredPacket& packet) const {
     if (packet.send_time_ms.has_value()) {
@@ -342,23 +465,34 @@ bool RtpPacketHistory::CanBeTransmitted(const StoredPacket& packet) const {
 }
 
 void RtpPacketHistory::Reset() {
-    packet_history_.clear();
-    padding_priority_.clear();
+    // Keep the capacity for reuse.
+    for (size_t i = 0; i < history_size_; ++i) {
+        PacketAt(i).reset();
+    }
+    history_size_ = 0;
+    if (budget_) {
+        budget_->OnPacketRemoved(stored_bytes_);
+        budget_->OnOldestPacketChanged(this, std::nullopt);
+    }
+    stored_bytes_ = 0;
+    for (auto& bucket : padding_priority_) {
+        bucket.clear();
+    }
+    num_padding_candidates_ = 0;
 }
 
 void RtpPacketHistory::CullOldPackets(int64_t now_ms) {
     int64_t packet_duration_ms = std::max(kMinPacketDurationRttFactor * rtt_ms_, kMinPacketDurationMs);
-    while (!packet_history_.empty()) {
-        if (packet_history_.size() >= kMaxCapacity) {
+    while (history_size_ > 0) {
+        if (history_size_ >= kMaxCapacity) {
             // We have reached the absolute max capacity, remove one packet unconditionally
             RemovePacket(0);
             continue;
         }
 
-        const auto& stored_packet = packet_history_.front();
-        if (!stored_packet) {
-            continue;
-        }
+        // The first entry is always populated.
+        const auto& stored_packet = PacketAt(0);
+        assert(stored_packet != std::nullopt);
 
         if (stored_packet->pending_transmission) {
             // Don't remove packets in the pacer queue, pending tranmission.
@@ -367,7 +501,7 @@ void RtpPacketHistory::CullOldPackets(int64_t now_ms) {
 
         // Don't remove unsent packets.
         if (!stored_packet->send_time_ms) {
-            continue;
+            return;
         }
 
         if (*stored_packet->send_time_ms + packet_duration_ms > now_ms) {
@@ -376,7 +510,7 @@ void RtpPacketHistory::CullOldPackets(int64_t now_ms) {
             return;
         }
 
-        if (packet_history_.size() >= number_to_store_ ||
+        if (history_size_ >= number_to_store_ ||
             IsTimedOut(*stored_packet->send_time_ms, 
                         packet_duration_ms, 
                         now_ms)) {
@@ -396,21 +530,30 @@ std::optional<RtpPacketToSend> RtpPacketHistory::RemovePacket(int packet_index)
     // Move the packet out from the StoredPacket container.
     std::optional<RtpPacketToSend> rtp_packet = std::nullopt;
 
-    auto& packet_to_remove = packet_history_[packet_index];
+    auto& packet_to_remove = PacketAt(packet_index);
     if (packet_to_remove) {
-        rtp_packet = std::move(packet_to_remove->packet);
         // Erase from padding priority set, if eligible.
         if (enable_padding_prio_) {
-            padding_priority_.erase(&packet_to_remove.value());
+            RemovePaddingCandidate(*packet_to_remove);
         }
+        const size_t packet_size = packet_to_remove->packet.size();
+        stored_bytes_ -= packet_size;
+        if (budget_) {
+            budget_->OnPacketRemoved(packet_size);
+        }
+        rtp_packet = std::move(packet_to_remove->packet);
         packet_to_remove.reset();
     }
 
     // Make sure the first entry is always populated.
     if (packet_index == 0) {
-        while (!packet_history_.empty() &&
-                packet_history_.front() == std::nullopt) {
-            packet_history_.pop_front();
+        while (history_size_ > 0 && PacketAt(0) == std::nullopt) {
+            ++first_seq_num_;
+            --history_size_;
+        }
+        if (budget_) {
+            budget_->OnOldestPacketChanged(this, history_size_ > 0 ? std::make_optional(PacketAt(0)->send_time_ms.value_or(clock_->now_ms())) 
+                                                                   : std::nullopt);
         }
     }
 
@@ -418,13 +561,13 @@ std::optional<RtpPacketToSend> RtpPacketHistory::RemovePacket(int packet_index)
 }
 
 int RtpPacketHistory::GetPacketIndex(uint16_t sequence_number) const {
-    if (packet_history_.empty()) {
+    if (history_size_ == 0) {
         return 0;
     }
 
-    // The first entry is always populated if the |packet_history_| is not empty.
-    assert(packet_history_.front() != std::nullopt);
-    int first_seq = packet_history_.front()->packet.sequence_number();
+    // The first entry is always populated if the history is not empty.
+    assert(PacketAt(0) != std::nullopt);
+    int first_seq = first_seq_num_;
     if (first_seq == sequence_number) {
         return 0;
     }
@@ -445,25 +588,56 @@ int RtpPacketHistory::GetPacketIndex(uint16_t sequence_number) const {
     return packet_index;
 }
 
+std::optional<RtpPacketHistory::StoredPacket>& RtpPacketHistory::PacketAt(int packet_index) {
+    return packet_history_[static_cast<uint16_t>(first_seq_num_ + packet_index) & (packet_history_.size() - 1)];
+}
+
+const std::optional<RtpPacketHistory::StoredPacket>& RtpPacketHistory::PacketAt(int packet_index) const {
+    return packet_history_[static_cast<uint16_t>(first_seq_num_ + packet_index) & (packet_history_.size() - 1)];
+}
+
+void RtpPacketHistory::EnsureCapacity(size_t history_size) {
+    assert(history_size <= kMaxHistoryCapacity);
+    size_t capacity = std::max(packet_history_.size(), kMinHistoryCapacity);
+    // Reserve for the packets expected to store on the first allocation.
+    if (packet_history_.empty()) {
+        history_size = std::max(history_size, std::min(number_to_store_, kMaxCapacity));
+    }
+    while (capacity < history_size) {
+        capacity <<= 1;
+    }
+    if (capacity == packet_history_.size()) {
+        return;
+    }
+    // Rehash the stored packets as the mask changed.
+    std::vector<std::optional<StoredPacket>> packet_history(capacity);
+    for (size_t i = 0; i < history_size_; ++i) {
+        auto& stored_packet = PacketAt(i);
+        if (stored_packet) {
+            packet_history[stored_packet->packet.sequence_number() & (capacity - 1)] = std::move(stored_packet);
+        }
+    }
+    packet_history_ = std::move(packet_history);
+}
+
 RtpPacketHistory::StoredPacket* RtpPacketHistory::GetStoredPacket(uint16_t sequence_number) {
     int index = GetPacketIndex(sequence_number);
     if (index < 0 || 
-        static_cast<size_t>(index) >= packet_history_.size() ||
-        packet_history_[index] == std::nullopt) {
+        static_cast<size_t>(index) >= history_size_ ||
+        PacketAt(index) == std::nullopt) {
         return nullptr;
     }
-    return &packet_history_[index].value();
+    return &PacketAt(index).value();
 }
 
 RtpPacketHistory::StoredPacket* RtpPacketHistory::GetLastAvailablePacket() {
-    StoredPacket* result = nullptr;
-    for (auto it = packet_history_.rbegin(); it != packet_history_.rend(); ++it) {
-        if (it->has_value()) {
-            result = &(it->value());
-            break;
+    for (int i = static_cast<int>(history_size_) - 1; i >= 0; --i) {
+        auto& stored_packet = PacketAt(i);
+        if (stored_packet) {
+            return &stored_packet.value();
         }
     }
-    return result;
+    return nullptr;
 }
 
 RtpPacketHistory::PacketState RtpPacketHistory::StoredPacketToPacketState(const StoredPacket& stored_packet) {
@@ -480,21 +654,51 @@ RtpPacketHistory::PacketState RtpPacketHistory::StoredPacketToPacketState(const
 
 void RtpPacketHistory::Retransmitted(StoredPacket& stored_packet) {
     // Check if this StoredPacket is in the priority set. If so, we need to remove
-    // it before updating |num_retransmitted_| since that is used in sorting,
+    // it before updating |num_retransmitted_| since that is used in bucketing,
     // and then add it back.
-    const bool in_priority_set = enable_padding_prio_ ? padding_priority_.erase(&stored_packet) > 0 
+    const bool in_priority_set = enable_padding_prio_ ? RemovePaddingCandidate(stored_packet) 
                                                       : false;
     ++stored_packet.num_retransmitted;
     if (in_priority_set) {
-        auto [it, inserted] = padding_priority_.insert(&stored_packet);
-        if (!inserted) {
-            PLOG_WARNING << "ERROR: Priority set already contains matching packet! In set: insert order = "
-                         << (*it)->insert_order
-                         << ", times retransmitted = " << (*it)->num_retransmitted
-                         << ". Trying to add: insert order = " << stored_packet.insert_order
-                         << ", times retransmitted = " << stored_packet.num_retransmitted;
+        AddPaddingCandidate(stored_packet);
+    }
+}
+
+void RtpPacketHistory::AddPaddingCandidate(const StoredPacket& stored_packet) {
+    auto& bucket = padding_priority_[PaddingPriorityBucket(stored_packet.num_retransmitted)];
+    // Keep the bucket ordered by insert order, the new packets are appended
+    // to the back in most cases.
+    auto it = bucket.end();
+    while (it != bucket.begin() && std::prev(it)->insert_order > stored_packet.insert_order) {
+        --it;
+    }
+    bucket.insert(it, {stored_packet.insert_order, stored_packet.packet.sequence_number()});
+    ++num_padding_candidates_;
+}
+
+bool RtpPacketHistory::RemovePaddingCandidate(const StoredPacket& stored_packet) {
+    auto& bucket = padding_priority_[PaddingPriorityBucket(stored_packet.num_retransmitted)];
+    auto it = std::lower_bound(bucket.begin(), bucket.end(), stored_packet.insert_order, 
+                               [](const PaddingCandidate& candidate, uint64_t insert_order) {
+        return candidate.insert_order < insert_order;
+    });
+    if (it == bucket.end() || it->insert_order != stored_packet.insert_order) {
+        return false;
+    }
+    bucket.erase(it);
+    --num_padding_candidates_;
+    return true;
+}
+
+RtpPacketHistory::StoredPacket* RtpPacketHistory::GetBestPaddingPacket() {
+    // Prefer to send packets we haven't already sent as padding, and all 
+    // else being equal, prefer newer packets.
+    for (const auto& bucket : padding_priority_) {
+        if (!bucket.empty()) {
+            return GetStoredPacket(bucket.back().sequence_number);
         }
     }
+    return nullptr;
 }
 
 bool RtpPacketHistory::IsTimedOut(int64_t send_time_ms, 
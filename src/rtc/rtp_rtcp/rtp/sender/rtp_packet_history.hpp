@@ -5,13 +5,12 @@
 #include "rtc/base/task_utils/task_queue.hpp"
 #include "rtc/rtp_rtcp/rtp/packets/rtp_packet_to_send.hpp"
 #include "rtc/rtp_rtcp/base/rtp_rtcp_configurations.hpp"
+#include "rtc/rtp_rtcp/rtp/sender/rtp_packet_history_budget.hpp"
 #include "rtc/base/synchronization/sequence_checker.hpp"
 
 #include <optional>
-#include <deque>
-#include <map>
+#include <array>
 #include <memory>
-#include <set>
 #include <vector>
 #include <functional>
 
@@ -23,6 +22,8 @@ public:
     static constexpr size_t kMaxCapacity = 9600;
     // Maximum number of entries in prioritized queue of padding packets.
     static constexpr size_t kMaxPaddingtHistory = 63;
+    // The padding candidates retransmitted more times than it share the last bucket.
+    static constexpr size_t kNumPaddingPriorityBuckets = 8;
     // Don't remove packets within max(1000ms, 3x RTT).
     static constexpr int64_t kMinPacketDurationMs = 1000;
     static constexpr int kMinPacketDurationRttFactor = 3;
@@ -53,7 +54,11 @@ public:
     using EncapsulateCallback = std::function<std::optional<RtpPacketToSend>(const RtpPacketToSend&)>;
 
 public:
-    RtpPacketHistory(Clock* clock, bool enable_padding_prio);
+    // The packets stored are accounted in |budget| if set, which may be
+    // shared by the histories of several streams.
+    RtpPacketHistory(Clock* clock, 
+                     bool enable_padding_prio,
+                     RtpPacketHistoryBudget* budget = nullptr);
 
     RtpPacketHistory() = delete;
     RtpPacketHistory(const RtpPacketHistory&) = delete;
@@ -66,6 +71,9 @@ public:
     void SetStorePacketsStatus(StorageMode mode, size_t number_to_store);
     StorageMode GetStorageMode() const;
 
+    // Returns the bytes of the packets stored in this history.
+    size_t stored_bytes() const;
+
     // Set RTT, used to avoid premature retransmission and to prevent over-writing
     // a packet in the history before we are reasonably sure it has been received.
     void SetRttMs(int64_t rtt_ms);
@@ -92,6 +100,13 @@ public:
     std::optional<RtpPacketToSend> GetPacketAndMarkAsPending(uint16_t sequence_number, 
                                                              EncapsulateCallback encapsulate_callback);
 
+    // Batch version of GetPacketAndMarkAsPending() used to answer a whole NACK
+    // list in one pass. The packets not found, already pending (including the
+    // duplicates in the list) or resent too recently are skipped. If the
+    // encapsulator returns nullptr, the rest of the list is aborted.
+    std::vector<RtpPacketToSend> GetPacketsAndMarkAsPending(ArrayView<const uint16_t> sequence_numbers,
+                                                            EncapsulateCallback encapsulate_callback);
+
     // Updates the send time for the given packet and increments the transmission
     // counter. Marks the packet as no longer being in the pacer queue.
     void MarkPacketAsSent(uint16_t sequence_number);
@@ -124,13 +139,16 @@ public:
     // capacity.
     void Clear();
 
+    // Used by the shared budget to evict the oldest packets across the histories,
+    // which is notified once the oldest packet is changed.
+    // Returns the send time of the oldest packet if it can be evicted, that is,
+    // sent longer than one RTT ago and not pending in the pacer.
+    std::optional<int64_t> OldestEvictableSendTimeMs(int64_t now_ms) const;
+    void EvictOldestPacket();
+
 private:
     // StoredPacket
     struct StoredPacket {
-        struct Compare {
-            bool operator()(StoredPacket* lhs, StoredPacket* rhs) const;
-        };
-
         StoredPacket(RtpPacketToSend packet,
                      std::optional<int64_t> send_time_ms,
                      uint64_t insert_order);
@@ -152,7 +170,15 @@ private:
         uint64_t insert_order = 0;
     };
 
-    using PacketPrioritySet = std::set<StoredPacket*, StoredPacket::Compare>;
+    // PaddingCandidate
+    struct PaddingCandidate {
+        uint64_t insert_order = 0;
+        uint16_t sequence_number = 0;
+    };
+
+    // The padding candidates bucketed by the number of retransmissions,
+    // each bucket is ordered by insert order with the newest at the back.
+    using PaddingPriorityBuckets = std::array<std::vector<PaddingCandidate>, kNumPaddingPriorityBuckets>;
 
 private:
     // Check if packet is sendable or not.
@@ -170,6 +196,13 @@ private:
 
     int GetPacketIndex(uint16_t sequence_number) const;
 
+    // Returns the slot of the |packet_index|-th packet counting from the first one.
+    std::optional<StoredPacket>& PacketAt(int packet_index);
+    const std::optional<StoredPacket>& PacketAt(int packet_index) const;
+
+    // Grows the ring buffer to hold at least |history_size| packets.
+    void EnsureCapacity(size_t history_size);
+
     StoredPacket* GetStoredPacket(uint16_t sequence_number);
 
     StoredPacket* GetLastAvailablePacket();
@@ -178,6 +211,10 @@ private:
 
     void Retransmitted(StoredPacket& stored_packet);
 
+    void AddPaddingCandidate(const StoredPacket& stored_packet);
+    bool RemovePaddingCandidate(const StoredPacket& stored_packet);
+    StoredPacket* GetBestPaddingPacket();
+
     void Reset();
 
 private:
@@ -185,24 +222,36 @@ private:
 
     Clock* const clock_;
     const bool enable_padding_prio_;
+    RtpPacketHistoryBudget* const budget_;
     size_t number_to_store_;
     StorageMode mode_;
     int64_t rtt_ms_;
 
-    // Queue of stored packets, ordered by sequence number, with older packets in
-    // the front and new packets being added to the back.
-    // NOTE: that there may be wrap-arounds so the back may have a lower sequence number.
-    // Packets may also be removed out-of-order, in which case there will be
-    // instances of |StoredPacket| set to nullopt.
-    // The first and last entry in the queue will however always be populated.
-    std::deque<std::optional<StoredPacket>> packet_history_;
+    // Ring buffer of stored packets indexed by |sequence_number & (capacity - 1)|,
+    // the capacity is a power of two and grows on demand.
+    // The packets are ordered by sequence number starting from |first_seq_num_|,
+    // and |history_size_| is the number of slots from the first one to the last one.
+    // NOTE: Packets may be removed out-of-order, in which case there will be
+    // instances of |StoredPacket| set to nullopt, but the first entry will
+    // always be populated if |history_size_| is not zero.
+    std::vector<std::optional<StoredPacket>> packet_history_;
+    uint16_t first_seq_num_;
+    size_t history_size_;
+
+    // The bytes of the packets stored.
+    size_t stored_bytes_;
 
     // Total number of packets with inserted.
     uint64_t packets_inserted_;
 
-    // Objects from |packet_history_| ordered by "most likely to be useful", used
+    // Packets from |packet_history_| ordered by "most likely to be useful", used
     // in GetPayloadPaddingPacket().
-    PacketPrioritySet padding_priority_;
+    PaddingPriorityBuckets padding_priority_;
+    size_t num_padding_candidates_;
+
+    // The packets not stored due to the budget since last warning.
+    size_t num_packets_over_budget_;
+    int64_t last_budget_warning_ms_;
 };
     
 } // namespace naivertc
@@ -0,0 +1,128 @@
+#include "rtc/rtp_rtcp/rtp/sender/rtp_packet_history_budget.hpp"
+#include "rtc/rtp_rtcp/rtp/sender/rtp_packet_history.hpp"
+
+#include <vector>
+
+namespace naivertc {
+
+RtpPacketHistoryBudget::RtpPacketHistoryBudget(size_t max_bytes)
+    : max_bytes_(max_bytes) {}
+
+RtpPacketHistoryBudget::~RtpPacketHistoryBudget() {
+    assert(histories_.empty());
+}
+
+size_t RtpPacketHistoryBudget::stored_bytes() const {
+    std::lock_guard lock(mutex_);
+    return stored_bytes_;
+}
+
+size_t RtpPacketHistoryBudget::num_histories() const {
+    std::lock_guard lock(mutex_);
+    return histories_.size();
+}
+
+void RtpPacketHistoryBudget::AddHistory(RtpPacketHistory* history) {
+    std::lock_guard lock(mutex_);
+    bool inserted = histories_.emplace(history, std::nullopt).second;
+    assert(inserted);
+}
+
+void RtpPacketHistoryBudget::RemoveHistory(RtpPacketHistory* history) {
+    std::lock_guard lock(mutex_);
+    auto it = histories_.find(history);
+    assert(it != histories_.end());
+    if (it->second) {
+        age_index_.erase({*it->second, history});
+    }
+    histories_.erase(it);
+}
+
+bool RtpPacketHistoryBudget::MakeRoomFor(size_t bytes, int64_t now_ms) {
+    // The histories whose oldest packets can not be evicted for now, which
+    // are indexed again after.
+    std::vector<AgeIndex::value_type> skipped_histories;
+    bool fits = false;
+    while (true) {
+        {
+            std::lock_guard lock(mutex_);
+            if (stored_bytes_ + bytes <= max_bytes_) {
+                fits = true;
+                break;
+            }
+        }
+        auto oldest = PopOldest();
+        if (!oldest) {
+            break;
+        }
+        auto [indexed_send_time_ms, history] = *oldest;
+        // NOTE: Calls into the history without holding the lock, since it
+        // reports the bytes removed and the new oldest packet back.
+        auto send_time_ms = history->OldestEvictableSendTimeMs(now_ms);
+        if (!send_time_ms) {
+            skipped_histories.push_back(*oldest);
+        } else if (*send_time_ms > indexed_send_time_ms) {
+            // The oldest packet has been retransmitted since indexed.
+            ReindexIfPopped(history, *send_time_ms);
+        } else {
+            history->EvictOldestPacket();
+        }
+    }
+    for (const auto& [send_time_ms, history] : skipped_histories) {
+        ReindexIfPopped(history, send_time_ms);
+    }
+    return fits;
+}
+
+void RtpPacketHistoryBudget::OnPacketStored(size_t bytes) {
+    std::lock_guard lock(mutex_);
+    stored_bytes_ += bytes;
+}
+
+void RtpPacketHistoryBudget::OnPacketRemoved(size_t bytes) {
+    std::lock_guard lock(mutex_);
+    assert(stored_bytes_ >= bytes);
+    stored_bytes_ -= bytes;
+}
+
+void RtpPacketHistoryBudget::OnOldestPacketChanged(RtpPacketHistory* history, std::optional<int64_t> send_time_ms) {
+    std::lock_guard lock(mutex_);
+    UpdateIndex(history, send_time_ms);
+}
+
+// Private methods
+std::optional<RtpPacketHistoryBudget::AgeIndex::value_type> RtpPacketHistoryBudget::PopOldest() {
+    std::lock_guard lock(mutex_);
+    if (age_index_.empty()) {
+        return std::nullopt;
+    }
+    auto oldest = *age_index_.begin();
+    age_index_.erase(age_index_.begin());
+    histories_[oldest.second] = std::nullopt;
+    return oldest;
+}
+
+void RtpPacketHistoryBudget::ReindexIfPopped(RtpPacketHistory* history, int64_t send_time_ms) {
+    std::lock_guard lock(mutex_);
+    auto it = histories_.find(history);
+    if (it != histories_.end() && !it->second) {
+        UpdateIndex(history, send_time_ms);
+    }
+}
+
+void RtpPacketHistoryBudget::UpdateIndex(RtpPacketHistory* history, std::optional<int64_t> send_time_ms) {
+    auto it = histories_.find(history);
+    assert(it != histories_.end());
+    if (it->second == send_time_ms) {
+        return;
+    }
+    if (it->second) {
+        age_index_.erase({*it->second, history});
+    }
+    it->second = send_time_ms;
+    if (send_time_ms) {
+        age_index_.emplace(*send_time_ms, history);
+    }
+}
+
+} // namespace naivertc
@@ -0,0 +1,73 @@
+#ifndef _RTC_RTP_RTCP_RTP_PACKET_HISTORY_BUDGET_H_
+#define _RTC_RTP_RTCP_RTP_PACKET_HISTORY_BUDGET_H_
+
+#include "base/defines.hpp"
+
+#include <mutex>
+#include <optional>
+#include <set>
+#include <unordered_map>
+
+namespace naivertc {
+
+class RtpPacketHistory;
+
+// The bytes budget shared by the packet histories of several streams, so
+// that the memory used by the retransmission history stays bounded no matter
+// how many streams are active.
+// Before a packet is stored, the oldest packets across all the histories,
+// which have been sent longer than one RTT ago, are evicted to make room for
+// it. If there is no such packet, the new packet is not stored.
+// NOTE: The budget is thread-safe, but the eviction calls into the histories,
+// so the histories sharing a budget must run on the same sequence, e.g. the
+// worker queue of a call, and the budget must outlive them.
+class RtpPacketHistoryBudget {
+public:
+    explicit RtpPacketHistoryBudget(size_t max_bytes);
+    ~RtpPacketHistoryBudget();
+
+    size_t max_bytes() const { return max_bytes_; }
+    size_t stored_bytes() const;
+    size_t num_histories() const;
+
+    void AddHistory(RtpPacketHistory* history);
+    void RemoveHistory(RtpPacketHistory* history);
+
+    // Evicts the oldest evictable packets across the histories until |bytes|
+    // more fit in the budget, returns false if they still don't fit.
+    bool MakeRoomFor(size_t bytes, int64_t now_ms);
+
+    void OnPacketStored(size_t bytes);
+    void OnPacketRemoved(size_t bytes);
+
+    // Called when the oldest packet of |history| is changed, |send_time_ms| is
+    // the time it was sent, or stored if not sent yet, and nullopt if the
+    // history is empty.
+    void OnOldestPacketChanged(RtpPacketHistory* history, std::optional<int64_t> send_time_ms);
+
+private:
+    using AgeIndex = std::set<std::pair</*send_time_ms=*/int64_t, RtpPacketHistory*>>;
+
+    // Pops the history holding the oldest packet from the index.
+    std::optional<AgeIndex::value_type> PopOldest();
+    // Indexes |history| by |send_time_ms|, unless it's unregistered or has
+    // already been indexed since popped.
+    void ReindexIfPopped(RtpPacketHistory* history, int64_t send_time_ms);
+    void UpdateIndex(RtpPacketHistory* history, std::optional<int64_t> send_time_ms);
+
+private:
+    const size_t max_bytes_;
+
+    mutable std::mutex mutex_;
+    size_t stored_bytes_ = 0;
+    // The histories ordered by the send time of their oldest packets, which
+    // is a lower bound since the packet may be retransmitted later, so the
+    // entries are validated and updated lazily when evicting.
+    AgeIndex age_index_;
+    // The send time of the oldest packet each history is indexed by.
+    std::unordered_map<RtpPacketHistory*, std::optional<int64_t>> histories_;
+};
+
+} // namespace naivertc
+
+#endif
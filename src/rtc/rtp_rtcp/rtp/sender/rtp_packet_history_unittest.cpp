@@ -7,6 +7,7 @@
 #include "testing/defines.hpp"
 #include "testing/simulated_clock.hpp"
 
+#include <chrono>
 #include <vector>
 
 namespace naivertc {
@@ -588,6 +589,41 @@ MY_TEST_P(RtpPacketHistoryTest, GetPacketWithEncapsulationAbortOnNullptr) {
     EXPECT_TRUE(packet_hist_.GetPacketAndMarkAsPending(kStartSeqNum));
 }
 
+MY_TEST_P(RtpPacketHistoryTest, GetPacketsAndMarkAsPendingInBatch) {
+    const int64_t kRttMs = RtpPacketHistory::kMinPacketDurationMs * 2;
+    packet_hist_.SetRttMs(kRttMs);
+    packet_hist_.SetStorePacketsStatus(StorageMode::STORE_AND_CULL, 10);
+
+    for (uint16_t i = 0; i < 5; ++i) {
+        packet_hist_.PutRtpPacket(CreateRtpPacket(Unwrap(kStartSeqNum + i)), clock_.now_ms());
+    }
+    // The packet already pending is skipped.
+    EXPECT_TRUE(packet_hist_.GetPacketAndMarkAsPending(Unwrap(kStartSeqNum + 1)));
+
+    // The duplicates and the packets not found are skipped too.
+    std::vector<uint16_t> nack_list = {kStartSeqNum, Unwrap(kStartSeqNum + 1), kStartSeqNum,
+                                       Unwrap(kStartSeqNum + 2), Unwrap(kStartSeqNum + 10)};
+    auto packets = packet_hist_.GetPacketsAndMarkAsPending(nack_list, [](const RtpPacketToSend& packet){
+        return packet;
+    });
+    ASSERT_EQ(packets.size(), 2u);
+    EXPECT_EQ(packets[0].sequence_number(), kStartSeqNum);
+    EXPECT_EQ(packets[1].sequence_number(), Unwrap(kStartSeqNum + 2));
+    EXPECT_TRUE(packet_hist_.GetPacketState(Unwrap(kStartSeqNum + 2))->pending_transmission);
+
+    // The rest of the list is aborted once the encapsulator returns nullptr.
+    nack_list = {Unwrap(kStartSeqNum + 3), Unwrap(kStartSeqNum + 4)};
+    packets = packet_hist_.GetPacketsAndMarkAsPending(nack_list, [](const RtpPacketToSend& packet) -> std::optional<RtpPacketToSend> {
+        if (packet.sequence_number() == Unwrap(kStartSeqNum + 4)) {
+            return std::nullopt;
+        }
+        return packet;
+    });
+    ASSERT_EQ(packets.size(), 1u);
+    EXPECT_EQ(packets[0].sequence_number(), Unwrap(kStartSeqNum + 3));
+    EXPECT_FALSE(packet_hist_.GetPacketState(Unwrap(kStartSeqNum + 4))->pending_transmission);
+}
+
 MY_TEST_P(RtpPacketHistoryTest, DontRemovePendingTransmissions) {
     const int64_t kRttMs = RtpPacketHistory::kMinPacketDurationMs * 2;
     const int64_t kPacketTimeoutMs = kRttMs * RtpPacketHistory::kMinPacketDurationRttFactor;
@@ -778,6 +814,187 @@ MY_TEST_P(RtpPacketHistoryTest, LastPacketAsPaddingWithPrioOff) {
     packet_hist_.CullAckedPackets(std::vector<uint16_t>{kStartSeqNum});
     EXPECT_FALSE(packet_hist_.GetPayloadPaddingPacket());
 }
+
+MY_TEST_P(RtpPacketHistoryTest, EvictsOldestPacketsAcrossSharedBudget) {
+    const int64_t kRttMs = 100;
+    const size_t kPacketSize = CreateRtpPacket(kStartSeqNum).size();
+    RtpPacketHistoryBudget budget(/*max_bytes=*/10 * kPacketSize);
+    RtpPacketHistory history_1(&clock_, GetParam(), &budget);
+    RtpPacketHistory history_2(&clock_, GetParam(), &budget);
+    for (auto history : {&history_1, &history_2}) {
+        history->SetStorePacketsStatus(StorageMode::STORE_AND_CULL, 100);
+        history->SetRttMs(kRttMs);
+    }
+    uint16_t seq_num_1 = kStartSeqNum;
+    uint16_t seq_num_2 = kStartSeqNum;
+    auto put_packets = [&](RtpPacketHistory& history, uint16_t& seq_num, size_t num_packets) {
+        for (size_t i = 0; i < num_packets; ++i) {
+            history.PutRtpPacket(CreateRtpPacket(seq_num++), clock_.now_ms());
+            ASSERT_LE(budget.stored_bytes(), budget.max_bytes());
+        }
+    };
+
+    put_packets(history_1, seq_num_1, 8);
+    clock_.AdvanceTimeMs(50);
+    put_packets(history_2, seq_num_2, 2);
+    EXPECT_EQ(budget.stored_bytes(), 10 * kPacketSize);
+
+    // The oldest packets are evicted from the other history.
+    clock_.AdvanceTimeMs(2 * kRttMs);
+    put_packets(history_2, seq_num_2, 3);
+    EXPECT_EQ(history_1.stored_bytes(), 5 * kPacketSize);
+    EXPECT_FALSE(history_1.GetPacketState(Unwrap(kStartSeqNum + 2)));
+    EXPECT_TRUE(history_1.GetPacketState(Unwrap(kStartSeqNum + 3)));
+    EXPECT_EQ(history_2.stored_bytes(), 5 * kPacketSize);
+
+    // The packets of the other history sent earlier are evicted first.
+    put_packets(history_2, seq_num_2, 7);
+    EXPECT_EQ(history_1.stored_bytes(), 0u);
+    EXPECT_FALSE(history_2.GetPacketState(Unwrap(kStartSeqNum + 1)));
+    EXPECT_TRUE(history_2.GetPacketState(Unwrap(kStartSeqNum + 2)));
+    EXPECT_EQ(budget.stored_bytes(), 10 * kPacketSize);
+
+    // All the packets were sent within one RTT, so the new packet is not stored.
+    put_packets(history_1, seq_num_1, 1);
+    EXPECT_FALSE(history_1.GetPacketState(Unwrap(seq_num_1 - 1)));
+    EXPECT_EQ(budget.stored_bytes(), 10 * kPacketSize);
+
+    // The bytes are released once the history is cleared.
+    history_2.Clear();
+    EXPECT_EQ(budget.stored_bytes(), 0u);
+}
+
+MY_TEST_P(RtpPacketHistoryTest, EvictsByLatestSendTimeAcrossSharedBudget) {
+    const int64_t kRttMs = 100;
+    const size_t kPacketSize = CreateRtpPacket(kStartSeqNum).size();
+    RtpPacketHistoryBudget budget(/*max_bytes=*/4 * kPacketSize);
+    RtpPacketHistory history_1(&clock_, GetParam(), &budget);
+    RtpPacketHistory history_2(&clock_, GetParam(), &budget);
+    for (auto history : {&history_1, &history_2}) {
+        history->SetStorePacketsStatus(StorageMode::STORE_AND_CULL, 100);
+        history->SetRttMs(kRttMs);
+    }
+    history_1.PutRtpPacket(CreateRtpPacket(kStartSeqNum), clock_.now_ms());
+    history_1.PutRtpPacket(CreateRtpPacket(Unwrap(kStartSeqNum + 1)), clock_.now_ms());
+    clock_.AdvanceTimeMs(10);
+    history_2.PutRtpPacket(CreateRtpPacket(kStartSeqNum), clock_.now_ms());
+    history_2.PutRtpPacket(CreateRtpPacket(Unwrap(kStartSeqNum + 1)), clock_.now_ms());
+
+    // The oldest packet of the first history is retransmitted.
+    clock_.AdvanceTimeMs(2 * kRttMs);
+    ASSERT_TRUE(history_1.GetPacketAndSetSendTime(kStartSeqNum));
+
+    // The retransmitted packet is skipped since sent within one RTT.
+    clock_.AdvanceTimeMs(kRttMs / 2);
+    history_2.PutRtpPacket(CreateRtpPacket(Unwrap(kStartSeqNum + 2)), clock_.now_ms());
+    EXPECT_EQ(history_1.stored_bytes(), 2 * kPacketSize);
+    EXPECT_FALSE(history_2.GetPacketState(kStartSeqNum));
+
+    // The packet sent earlier is evicted first, although the retransmitted
+    // packet was stored earlier.
+    clock_.AdvanceTimeMs(kRttMs);
+    history_2.PutRtpPacket(CreateRtpPacket(Unwrap(kStartSeqNum + 3)), clock_.now_ms());
+    EXPECT_TRUE(history_1.GetPacketState(kStartSeqNum));
+    EXPECT_FALSE(history_2.GetPacketState(Unwrap(kStartSeqNum + 1)));
+    EXPECT_EQ(budget.stored_bytes(), 4 * kPacketSize);
+
+    // The retransmitted packet is the oldest one now.
+    history_2.PutRtpPacket(CreateRtpPacket(Unwrap(kStartSeqNum + 4)), clock_.now_ms());
+    EXPECT_FALSE(history_1.GetPacketState(kStartSeqNum));
+    EXPECT_TRUE(history_1.GetPacketState(Unwrap(kStartSeqNum + 1)));
+}
+
+MY_TEST_P(RtpPacketHistoryTest, KeepsPacketsWhenGrowing) {
+    const size_t kNumberToStore = 20;
+    packet_hist_.SetStorePacketsStatus(StorageMode::STORE_AND_CULL, kNumberToStore);
+
+    // The pending packets can't be culled, so the history grows beyond
+    // the number to store.
+    const size_t kNumPackets = 10 * kNumberToStore;
+    for (size_t i = 0; i < kNumPackets; ++i) {
+        packet_hist_.PutRtpPacket(CreateRtpPacket(Unwrap(kStartSeqNum + i)));
+    }
+    // Insert ahead of the first packet.
+    const uint16_t kFirstSeqNum = Unwrap(kStartSeqNum - 1);
+    packet_hist_.PutRtpPacket(CreateRtpPacket(kFirstSeqNum));
+
+    auto state = packet_hist_.GetPacketState(kFirstSeqNum);
+    ASSERT_TRUE(state);
+    EXPECT_TRUE(state->pending_transmission);
+    for (size_t i = 0; i < kNumPackets; ++i) {
+        uint16_t seq_num = Unwrap(kStartSeqNum + i);
+        state = packet_hist_.GetPacketState(seq_num);
+        ASSERT_TRUE(state);
+        EXPECT_EQ(state->rtp_sequence_number, seq_num);
+        EXPECT_TRUE(state->pending_transmission);
+    }
+}
+
+MY_TEST_P(RtpPacketHistoryTest, PutNackAndCullAt50Mbps) {
+    // 50 Mbps with 1200 bytes packets, about 5200 packets per second.
+    const size_t kPayloadSize = 1200;
+    const size_t kPacketsPerSecond = 50'000'000 / 8 / kPayloadSize;
+    const int64_t kRttMs = 50;
+    const size_t kPacketsPerRtt = kPacketsPerSecond * kRttMs / 1000;
+    const int64_t kFeedbackIntervalMs = 100;
+    const int64_t kDurationMs = 10'000;
+    // Request a retransmission every |kNackInterval| packets.
+    const size_t kNackInterval = 100;
+
+    packet_hist_.SetStorePacketsStatus(StorageMode::STORE_AND_CULL, RtpPacketHistory::kMaxCapacity);
+    packet_hist_.SetRttMs(kRttMs);
+
+    RtpPacketToSend packet = CreateRtpPacket(kStartSeqNum);
+    packet.set_payload_size(kPayloadSize);
+
+    size_t num_sent_packets = 0;
+    size_t num_retransmitted_packets = 0;
+    uint16_t first_unacked_seq_num = kStartSeqNum;
+    std::vector<uint16_t> acked_seq_nums;
+    acked_seq_nums.reserve(kPacketsPerSecond);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int64_t elapsed_ms = 0; elapsed_ms < kDurationMs; ++elapsed_ms) {
+        const size_t num_packets_to_send = (elapsed_ms + 1) * kPacketsPerSecond / 1000 - num_sent_packets;
+        for (size_t i = 0; i < num_packets_to_send; ++i) {
+            packet.set_sequence_number(Unwrap(kStartSeqNum + num_sent_packets++));
+            packet_hist_.PutRtpPacket(packet, clock_.now_ms());
+        }
+
+        // The packet sent one RTT ago was lost.
+        if (num_sent_packets > kPacketsPerRtt && 
+            (num_sent_packets - kPacketsPerRtt) % kNackInterval < num_packets_to_send) {
+            uint16_t lost_seq_num = Unwrap(kStartSeqNum + num_sent_packets - kPacketsPerRtt);
+            if (packet_hist_.GetPacketAndMarkAsPending(lost_seq_num)) {
+                packet_hist_.MarkPacketAsSent(lost_seq_num);
+                ++num_retransmitted_packets;
+            }
+        }
+
+        // Cull the packets acked by the feedback.
+        if (elapsed_ms % kFeedbackIntervalMs == 0) {
+            const uint16_t end_seq_num = Unwrap(kStartSeqNum + num_sent_packets - kPacketsPerRtt);
+            acked_seq_nums.clear();
+            for (uint16_t seq_num = first_unacked_seq_num; seq_num != end_seq_num; ++seq_num) {
+                acked_seq_nums.push_back(seq_num);
+            }
+            packet_hist_.CullAckedPackets(acked_seq_nums);
+            first_unacked_seq_num = end_seq_num;
+        }
+        clock_.AdvanceTimeMs(1);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const auto elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+
+    GTEST_COUT << "padding_prio=" << (GetParam() ? "on" : "off")
+               << " - sent_packets=" << num_sent_packets
+               << " - retransmitted_packets=" << num_retransmitted_packets
+               << " - " << elapsed_ns / num_sent_packets << " ns/packet."
+               << std::endl;
+
+    EXPECT_EQ(num_sent_packets, kPacketsPerSecond * kDurationMs / 1000);
+    EXPECT_NEAR(num_retransmitted_packets, (num_sent_packets - kPacketsPerRtt) / kNackInterval, 1);
+}
     
 } // namespace test
 } // namespace naivertc
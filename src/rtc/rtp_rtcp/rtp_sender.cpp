@@ -1,9 +1,12 @@
 #include "rtc/rtp_rtcp/rtp_sender.hpp"
 #include "rtc/rtp_rtcp/rtp/sender/rtp_packet_egresser.hpp"
+#include "rtc/rtp_rtcp/components/bitrate_limiter.hpp"
 #include "common/utils_random.hpp"
 
 #include <plog/Log.h>
 
+#include <limits>
+
 namespace naivertc {
 namespace {
 
@@ -14,9 +17,11 @@ constexpr uint16_t kMaxInitRtpSeqNumber = 32767;  // 2^15 - 1
 // RtpSenderContext
 RtpSender::RtpSenderContext::RtpSenderContext(const RtpConfiguration& config) 
     : packet_sequencer(config),
-      packet_history(config.clock, config.enable_rtx_padding_prioritization),
+      packet_history(config.clock, 
+                     config.enable_rtx_padding_prioritization, 
+                     config.packet_history_budget),
       packet_generator(config, &packet_history),
-      packet_egresser(config, &packet_sequencer, &packet_history),
+      packet_egresser(config, &packet_sequencer, &packet_history, &packet_generator),
       non_paced_sender(&packet_egresser) {}
 
 // RtpSender
@@ -24,7 +29,9 @@ RtpSender::RtpSender(const RtpConfiguration& config)
     : clock_(config.clock),
       ctx_(std::make_unique<RtpSenderContext>(config)),
       fec_generator_(config.fec_generator),
-      paced_sender_(config.paced_sender ? config.paced_sender : &ctx_->non_paced_sender) {
+      paced_sender_(config.paced_sender ? config.paced_sender : &ctx_->non_paced_sender),
+      retransmission_rate_limiter_(config.retransmission_rate_limiter),
+      intra_frame_observer_(config.intra_frame_observer) {
     RTC_RUN_ON(&sequence_checker_);
 
     timestamp_offset_ = utils::random::generate_random<uint32_t>();
@@ -175,6 +182,12 @@ size_t RtpSender::FecPacketOverhead() const {
     return overhead;
 }
 
+void RtpSender::SetFecProtectionParameters(const FecProtectionParams& delta_params,
+                                           const FecProtectionParams& key_params) {
+    RTC_RUN_ON(&sequence_checker_);
+    ctx_->packet_egresser.SetFecProtectionParameters(delta_params, key_params);
+}
+
 std::vector<RtpPacketToSend> RtpSender::FetchFecPackets() const {
     RTC_RUN_ON(&sequence_checker_);
     return ctx_->packet_egresser.FetchFecPackets();
@@ -188,6 +201,19 @@ std::vector<RtpPacketToSend> RtpSender::GeneratePadding(size_t target_packet_siz
                                                   ctx_->packet_sequencer.CanSendPaddingOnMeidaSsrc());
 }
 
+void RtpSender::OnFramesDropped(size_t num_frames) {
+    RTC_RUN_ON(&sequence_checker_);
+    if (num_frames == 0) {
+        return;
+    }
+    uint32_t media_ssrc = ctx_->packet_generator.media_ssrc();
+    PLOG_WARNING << "Pacer dropped " << num_frames << " frames of stream ssrc=" << media_ssrc
+                 << ", request a key frame.";
+    if (intra_frame_observer_) {
+        intra_frame_observer_->OnReceivedIntraFrameRequest(media_ssrc);
+    }
+}
+
 // Nack
 void RtpSender::OnReceivedNack(const std::vector<uint16_t>& nack_list, int64_t rrt_ms) {
     RTC_RUN_ON(&sequence_checker_);
@@ -199,14 +225,7 @@ void RtpSender::OnReceivedNack(const std::vector<uint16_t>& nack_list, int64_t r
     }
     // FIXME: Set RTT rrt_ms + 5 ms for keeping more packets in history?
     ctx_->packet_history.SetRttMs(5 + rrt_ms);
-    for (uint16_t seq_num : nack_list) {
-        const int32_t bytes_sent = ResendPacket(seq_num);
-        if (bytes_sent < 0) {
-            PLOG_WARNING << "Failed resending RTP packet " << seq_num
-                         << ", Discard rest of packets.";
-            break;
-        }
-    }
+    ResendPackets(nack_list);
 }
 
 // Report blocks
@@ -243,52 +262,68 @@ bool RtpSender::TrySendPacket(RtpPacketToSend packet,
         packet.ssrc() == ctx_->packet_generator.media_ssrc() &&
         !ctx_->packet_sequencer.CanSendPaddingOnMeidaSsrc()) {
         // New media packet preempted this generated padding packet, discard it.
+        ctx_->packet_generator.RecyclePaddingPacket(std::move(packet));
         return false;
     }
     return ctx_->packet_egresser.SendPacket(std::move(packet), pacing_info);
 }
 
 // Private methods
-int32_t RtpSender::ResendPacket(uint16_t seq_num) {
-    int32_t packet_size = 0;
+size_t RtpSender::ResendPackets(const std::vector<uint16_t>& nack_list) {
     const bool rtx_enabled = (rtx_mode() & kRtxRetransmitted);
+    // Apply the retransmission budget once for the whole batch.
+    const size_t available_bytes = retransmission_rate_limiter_ ? retransmission_rate_limiter_->AvailableBytes()
+                                                                : std::numeric_limits<size_t>::max();
+    if (available_bytes == 0) {
+        PLOG_WARNING << "Retransmission bitrate exhausted, discard all packets.";
+        return 0;
+    }
+    size_t bytes_to_resend = 0;
+    bool budget_exhausted = false;
 
-    auto packet = ctx_->packet_history.GetPacketAndMarkAsPending(seq_num, [&](const RtpPacketToSend& stored_packet){
-        // TODO: Check if we're overusing retransmission bitrate.
-        packet_size = stored_packet.size();
+    // The packets already queued for retransmission, including the duplicates
+    // in the list, and the packets resent within one RTT are skipped by the history.
+    auto packets = ctx_->packet_history.GetPacketsAndMarkAsPending(nack_list, [&](const RtpPacketToSend& stored_packet){
         std::optional<RtpPacketToSend> retransmit_packet;
+        const size_t packet_size = stored_packet.size();
+        // Check if we're overusing retransmission bitrate.
+        if (bytes_to_resend + packet_size > available_bytes) {
+            budget_exhausted = true;
+            return retransmit_packet;
+        }
         // Retransmitted on RTX ssrc.
         if (rtx_enabled) {
             retransmit_packet = ctx_->packet_generator.BuildRtxPacket(stored_packet);
-        }else {
+        } else {
             // Retransmitted on media ssrc.
             retransmit_packet = stored_packet;
         }
         if (retransmit_packet) {
             retransmit_packet->set_retransmitted_sequence_number(stored_packet.sequence_number());
+            retransmit_packet->set_packet_type(RtpPacketType::RETRANSMISSION);
+            // A packet can not be FEC and RTX at the same time.
+            retransmit_packet->set_fec_protection_need(false);
+            retransmit_packet->set_red_protection_need(false);
+            bytes_to_resend += packet_size;
         }
         return retransmit_packet;
     });
 
-    if (packet_size == 0) {
-        // Packet not found or already queued for retransmission, ignore.
-        return 0;
+    if (budget_exhausted) {
+        PLOG_WARNING << "Retransmission bitrate exhausted after " << packets.size()
+                     << " packets, discard rest of packets.";
     }
-    
-    if (!packet) {
-        return -1;
+
+    if (packets.empty()) {
+        return 0;
     }
 
-    packet->set_packet_type((RtpPacketType::RETRANSMISSION));
-    // A packet can not be FEC and RTX at the same time.
-    packet->set_fec_protection_need(false);
-    packet->set_red_protection_need(false);
-   
-    std::vector<RtpPacketToSend> packets;
-    packets.emplace_back(std::move(*packet));
+    if (retransmission_rate_limiter_) {
+        retransmission_rate_limiter_->ConsumeBitrate(bytes_to_resend);
+    }
     paced_sender_->EnqueuePackets(std::move(packets));
 
-    return packet_size;
+    return bytes_to_resend;
 }
     
 } // namespace naivertc
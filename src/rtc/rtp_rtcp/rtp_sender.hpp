@@ -61,11 +61,18 @@ public:
     bool fec_enabled() const;
     bool red_enabled() const;
     size_t FecPacketOverhead() const;
+    void SetFecProtectionParameters(const FecProtectionParams& delta_params,
+                                    const FecProtectionParams& key_params);
     std::vector<RtpPacketToSend> FetchFecPackets() const;
 
     // Padding
     std::vector<RtpPacketToSend> GeneratePadding(size_t target_packet_size);
 
+    // Called when the pacer dropped the stale frames of this stream, the
+    // following delta frames can not be decoded by the receiver, so a key
+    // frame is requested from the encoder.
+    void OnFramesDropped(size_t num_frames);
+
     // Implements RtcpNackListObserver
     void OnReceivedNack(const std::vector<uint16_t>& nack_list, int64_t rrt_ms) override;
 
@@ -76,7 +83,9 @@ public:
     RtpSendStats GetSendStats() override;
 
 private:
-    int32_t ResendPacket(uint16_t seq_num);
+    // Resends the packets of the NACK list as a batch, returns the number
+    // of bytes queued for retransmission.
+    size_t ResendPackets(const std::vector<uint16_t>& nack_list);
 
 private:
     // RtpSenderContext
@@ -97,6 +106,8 @@ private:
 
     FecGenerator* const fec_generator_;
     RtpPacketSender* const paced_sender_;
+    BitrateLimiter* const retransmission_rate_limiter_;
+    RtcpIntraFrameObserver* const intra_frame_observer_;
 
     uint32_t timestamp_offset_ = 0;
 };
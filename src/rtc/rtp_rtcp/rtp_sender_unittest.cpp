@@ -1,11 +1,12 @@
 #include "rtc/rtp_rtcp/rtp_sender.hpp"
+#include "rtc/rtp_rtcp/components/bitrate_limiter.hpp"
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
 #define ENABLE_UNIT_TESTS 0
 #include "testing/defines.hpp"
-#include "testing/simulated_clock.hpp"
+#include "testing/simulated_time_controller.hpp"
 
 using namespace ::testing;
 
@@ -26,29 +27,65 @@ const uint8_t kPayloadData[] = {47, 11, 32, 93, 89};
 const int64_t kDefaultExpectedRetransmissionTimeMs = 125;
 const size_t kMaxPaddingLength = 224;      // Value taken from rtp_sender.cc.
 const uint32_t kTimestampTicksPerMs = 90;  // 90kHz clock.
+constexpr TimeDelta kRetransmitWindowSize = TimeDelta::Millis(1000);
+constexpr DataRate kMaxRetransmissionBitrate = DataRate::KilobitsPerSec(100);
 
 class MockRtpPacketSender : public RtpPacketSender {
 public:
     MOCK_METHOD(void, EnqueuePackets, (std::vector<RtpPacketToSend>), (override)); 
 };
+
+class FakeRtcMediaTransport : public RtcMediaTransport {
+public:
+    int SendRtpPacket(CopyOnWriteBuffer packet, PacketOptions options, bool is_rtcp) override {
+        RtpPacket rtp_packet;
+        if (!is_rtcp && rtp_packet.Parse(packet)) {
+            sent_sequence_numbers_.push_back(rtp_packet.sequence_number());
+        }
+        return packet.size();
+    }
+
+    const std::vector<uint16_t>& sent_sequence_numbers() const { return sent_sequence_numbers_; }
+private:
+    std::vector<uint16_t> sent_sequence_numbers_;
+};
+
+class MockRtcpIntraFrameObserver : public RtcpIntraFrameObserver {
+public:
+    MOCK_METHOD(void, OnReceivedIntraFrameRequest, (uint32_t), (override));
+};
     
 } // namespace
 
 class T(RtpSenderTest) : public ::testing::Test {
 public:
     T(RtpSenderTest)() 
-        : clock_(123456) {}
+        : time_controller_(Timestamp::Millis(123456)),
+          worker_queue_(std::make_unique<TaskQueue>(time_controller_.CreateTaskQueue())),
+          retransmission_rate_limiter_(time_controller_.Clock(), kRetransmitWindowSize) {}
 
     void SetUp() override {
-        rtp_sender_ = std::make_unique<RtpSender>(GetDefaultConfig());
-        rtp_sender_->SetSequenceNumberOffset(kSeqNum);
+        RunOnWorkerQueue([this](){
+            rtp_sender_ = std::make_unique<RtpSender>(GetDefaultConfig());
+            rtp_sender_->SetSequenceNumberOffset(kSeqNum);
+        });
+    }
+
+    void TearDown() override {
+        RunOnWorkerQueue([this](){
+            rtp_sender_.reset();
+        });
     }
 
     RtpConfiguration GetDefaultConfig() {
         RtpConfiguration config;
+        config.clock = time_controller_.Clock();
         config.local_media_ssrc = kSsrc;
         config.rtx_send_ssrc = kRtxSsrc;
+        config.send_transport = &send_transport_;
         config.paced_sender = &packet_sender_;
+        config.retransmission_rate_limiter = &retransmission_rate_limiter_;
+        config.intra_frame_observer = &intra_frame_observer_;
         return config;
     }
 
@@ -65,25 +102,92 @@ public:
         return packet;
     }
 
+    // The RtpSender is confined to the worker queue.
+    void RunOnWorkerQueue(std::function<void()> handler) {
+        worker_queue_->Post(std::move(handler));
+        time_controller_.AdvanceTime(TimeDelta::Zero());
+    }
+
 protected:
-    SimulatedClock clock_;
+    SimulatedTimeController time_controller_;
+    std::unique_ptr<TaskQueue> worker_queue_;
+    BitrateLimiter retransmission_rate_limiter_;
+    FakeRtcMediaTransport send_transport_;
     NiceMock<MockRtpPacketSender> packet_sender_;
+    StrictMock<MockRtcpIntraFrameObserver> intra_frame_observer_;
     std::unique_ptr<RtpSender> rtp_sender_;
 };
 
 
 MY_TEST_F(RtpSenderTest, SenderForwardsPacketsToPacer) {
-    auto packet = BuildRtpPacket(kPayload, true, kTimestamp, 0);
-    int64_t now_ms = clock_.now_ms();
-
-    EXPECT_CALL(packet_sender_,
-                EnqueuePackets(ElementsAre(AllOf(
-                    Property(&RtpPacketToSend::ssrc, kSsrc),
-                    Property(&RtpPacketToSend::sequence_number, kSeqNum),
-                    Property(&RtpPacketToSend::capture_time_ms, now_ms)
-                ))));
-    rtp_sender_->EnqueuePacket(std::move(packet));
+    RunOnWorkerQueue([this](){
+        auto packet = BuildRtpPacket(kPayload, true, kTimestamp, 0);
+        int64_t now_ms = time_controller_.Clock()->now_ms();
+
+        // The sequence number is assigned when the packet is sent.
+        std::vector<RtpPacketToSend> enqueued_packets;
+        EXPECT_CALL(packet_sender_,
+                    EnqueuePackets(ElementsAre(AllOf(
+                        Property(&RtpPacketToSend::ssrc, kSsrc),
+                        Property(&RtpPacketToSend::sequence_number, 0),
+                        Property(&RtpPacketToSend::capture_time_ms, now_ms)
+                    )))).WillOnce(SaveArg<0>(&enqueued_packets));
+        rtp_sender_->EnqueuePacket(std::move(packet));
+
+        // The sequence number offset is applied once the paced packet is sent.
+        ASSERT_EQ(enqueued_packets.size(), 1u);
+        EXPECT_TRUE(rtp_sender_->TrySendPacket(std::move(enqueued_packets[0]), PacedPacketInfo()));
+        EXPECT_THAT(send_transport_.sent_sequence_numbers(), ElementsAre(kSeqNum));
+    });
+}
+
+MY_TEST_F(RtpSenderTest, RequestsKeyFrameWhenFramesDropped) {
+    RunOnWorkerQueue([this](){
+        EXPECT_CALL(intra_frame_observer_, OnReceivedIntraFrameRequest(kSsrc)).Times(1);
+        rtp_sender_->OnFramesDropped(2);
+
+        // Nothing was dropped.
+        EXPECT_CALL(intra_frame_observer_, OnReceivedIntraFrameRequest).Times(0);
+        rtp_sender_->OnFramesDropped(0);
+    });
 }
     
+MY_TEST_F(RtpSenderTest, NoRetransmissionWhenRateLimiterSaturated) {
+    retransmission_rate_limiter_.set_max_bitrate(kMaxRetransmissionBitrate);
+    RunOnWorkerQueue([this](){
+        rtp_sender_->SetStorePacketsStatus(true, 10);
+        auto packet = BuildRtpPacket(kPayload, true, kTimestamp, 0);
+        packet.SetPayload(kPayloadData, sizeof(kPayloadData));
+        packet.set_allow_retransmission(true);
+        EXPECT_TRUE(rtp_sender_->TrySendPacket(std::move(packet), PacedPacketInfo()));
+        // Saturates the retransmission bitrate, two samples at least to get a
+        // valid bitrate estimate.
+        retransmission_rate_limiter_.ConsumeBitrate(kMaxRetransmissionBitrate * kRetransmitWindowSize / 2);
+    });
+    time_controller_.AdvanceTime(TimeDelta::Millis(100));
+    RunOnWorkerQueue([this](){
+        retransmission_rate_limiter_.ConsumeBitrate(kMaxRetransmissionBitrate * kRetransmitWindowSize / 2);
+    });
+
+    // Not even a single packet is allowed.
+    RunOnWorkerQueue([this](){
+        ASSERT_EQ(retransmission_rate_limiter_.AvailableBytes(), 0u);
+        EXPECT_CALL(packet_sender_, EnqueuePackets).Times(0);
+        rtp_sender_->OnReceivedNack({kSeqNum}, 0);
+        Mock::VerifyAndClearExpectations(&packet_sender_);
+    });
+
+    // The budget is available again after the window.
+    time_controller_.AdvanceTime(kRetransmitWindowSize);
+    RunOnWorkerQueue([this](){
+        EXPECT_CALL(packet_sender_,
+                    EnqueuePackets(ElementsAre(AllOf(
+                        Property(&RtpPacketToSend::packet_type, RtpPacketType::RETRANSMISSION),
+                        Property(&RtpPacketToSend::retransmitted_sequence_number, kSeqNum)
+                    ))));
+        rtp_sender_->OnReceivedNack({kSeqNum}, 0);
+    });
+}
+
 } // namespace test
 } // namespace naivert 
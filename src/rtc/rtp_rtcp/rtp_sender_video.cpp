@@ -1,14 +1,18 @@
 #include "rtc/rtp_rtcp/rtp_sender_video.hpp"
 #include "rtc/rtp_rtcp/rtp/packets/rtp_header_extensions.hpp"
 #include "rtc/rtp_rtcp/rtp/packetizer/rtp_packetizer_h264.hpp"
+#include "rtc/rtp_rtcp/rtp/packetizer/rtp_deferred_packetizer.hpp"
 #include "rtc/rtp_rtcp/rtp_sender.hpp"
 #include <plog/Log.h>
 
 namespace naivertc {
 
-RtpSenderVideo::RtpSenderVideo(Clock* clock, RtpSender* packet_sender) 
+RtpSenderVideo::RtpSenderVideo(Clock* clock, 
+                               RtpSender* packet_sender, 
+                               bool lazy_packetization) 
     : clock_(clock),
       packet_sender_(packet_sender),
+      lazy_packetization_(lazy_packetization),
       current_playout_delay_{-1, -1},
       playout_delay_pending_(false) {}
     
@@ -18,7 +22,7 @@ bool RtpSenderVideo::Send(int payload_type,
                           uint32_t rtp_timestamp, 
                           int64_t capture_time_ms,
                           RtpVideoHeader video_header,
-                          ArrayView<const uint8_t> payload,
+                          CopyOnWriteBuffer payload,
                           std::optional<int64_t> expected_retransmission_time_ms,
                           std::optional<int64_t> estimated_capture_clock_offset_ms) {
     RTC_RUN_ON(&sequence_checker_);
@@ -90,14 +94,27 @@ bool RtpSenderVideo::Send(int payload_type,
     limits.first_packet_reduction_size = first_packet.header_size() - middle_packet.header_size();
     limits.last_packet_reduction_size = last_packet.header_size() - middle_packet.header_size();
 
-    auto packetizer = Packetize(video_header.codec_type, payload, limits);
-
-    if (packetizer == nullptr) {
-        return false; 
+    std::shared_ptr<RtpDeferredPacketizer> deferred_packetizer = nullptr;
+    RtpPacketizer* packetizer = nullptr;
+    size_t num_of_packets = 0;
+    if (lazy_packetization_) {
+        // Share the buffer of the encoded frame without copying, and the packets
+        // will be packetized from it when the pacer sends them.
+        deferred_packetizer = RtpDeferredPacketizer::Create(video_header.codec_type, payload, limits);
+        if (deferred_packetizer == nullptr) {
+            return false;
+        }
+        num_of_packets = deferred_packetizer->NumberOfPackets();
+    } else {
+        packetizer = Packetize(video_header.codec_type, 
+                               ArrayView<const uint8_t>(payload.cdata(), payload.size()), 
+                               limits);
+        if (packetizer == nullptr) {
+            return false; 
+        }
+        num_of_packets = packetizer->NumberOfPackets();
     }
 
-    const size_t num_of_packets = packetizer->NumberOfPackets();
-
     if (num_of_packets == 0) {
         PLOG_VERBOSE << "No packets packetized.";
         return false;
@@ -127,11 +144,14 @@ bool RtpSenderVideo::Send(int payload_type,
 
         packet->set_is_first_packet_of_frame(i == 0);
 
-        if (!packetizer->NextPacket(&packet.value())) {
+        if (deferred_packetizer) {
+            // The marker bit is set by the packetizer when the payload is written.
+            packet->SetDeferredPayload(deferred_packetizer, i, deferred_packetizer->PayloadSizes()[i]);
+        } else if (!packetizer->NextPacket(&packet.value())) {
             return false;
         }
 
-        assert(packet->payload_size() <= expected_payload_capacity);
+        assert(packet->expected_payload_size() <= expected_payload_capacity);
 
         // TODO: Put packetization finish timestamp into extension
 
@@ -141,7 +161,7 @@ bool RtpSenderVideo::Send(int payload_type,
         packet->set_is_red(false);
         packet->set_red_protection_need(packet_sender_->red_enabled());
         packet->set_packet_type(RtpPacketType::VIDEO);
-        packetized_payload_size += packet->payload_size();
+        packetized_payload_size += packet->expected_payload_size();
         rtp_packets.emplace_back(std::move(*packet));
 
     } // end of for
@@ -236,7 +256,7 @@ void RtpSenderVideo::CalcPacketizationOverhead(ArrayView<const RtpPacketToSend>
     size_t packetized_payload_size = 0;
     for (auto& packet : packets) {
         if (packet.packet_type() == RtpPacketType::VIDEO) {
-            packetized_payload_size += packet.payload_size();
+            packetized_payload_size += packet.expected_payload_size();
         }
     }
     // AV1 and H264 packetizers may produce less packetized bytes than unpacketized.
@@ -19,14 +19,19 @@ class RtpSender;
 
 class RtpSenderVideo {
 public:
-    RtpSenderVideo(Clock* clock, RtpSender* packet_sender);
+    // If |lazy_packetization| is true, the packets of a frame are enqueued
+    // with their payloads deferred, which are written when the pacer sends them.
+    // NOTE: It's off by default until the reduction of memory is measured.
+    RtpSenderVideo(Clock* clock, 
+                   RtpSender* packet_sender, 
+                   bool lazy_packetization = false);
     virtual ~RtpSenderVideo();
 
     bool Send(int payload_type,
               uint32_t rtp_timestamp, 
               int64_t capture_time_ms,
               RtpVideoHeader video_header,
-              ArrayView<const uint8_t> payload,
+              CopyOnWriteBuffer payload,
               std::optional<int64_t> expected_retransmission_time_ms,
               std::optional<int64_t> estimated_capture_clock_offset_ms = 0);
 
@@ -54,6 +59,7 @@ private:
     SequenceChecker sequence_checker_;
     Clock* const clock_;
     RtpSender* packet_sender_;
+    const bool lazy_packetization_;
 
     BitrateStatistics packetization_overhead_bitrate_stats_;
 
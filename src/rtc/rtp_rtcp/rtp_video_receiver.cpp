@@ -27,9 +27,49 @@ std::unique_ptr<RtcpResponser> CreateRtcpResponser(const RtpVideoReceiver::Confi
     return std::make_unique<RtcpResponser>(rtcp_config);
 }
 
+std::unique_ptr<FlexfecReceiver> MaybeCreateFlexfecReceiver(const RtpVideoReceiver::Configuration& config,
+                                                            RecoveredPacketReceiver* recovered_packet_receiver) {
+    const auto& flexfec = config.rtp.flexfec;
+    if (flexfec.payload_type < 0 || flexfec.reed_solomon) {
+        return nullptr;
+    }
+    if (flexfec.ssrc == 0) {
+        PLOG_WARNING << "Disable FlexFEC since no FlexFEC ssrc given.";
+        return nullptr;
+    }
+    if (!config.rtp.remote_media_ssrc) {
+        PLOG_WARNING << "Disable FlexFEC since no protected media ssrc given.";
+        return nullptr;
+    }
+    return std::make_unique<FlexfecReceiver>(flexfec.ssrc, 
+                                             *config.rtp.remote_media_ssrc, 
+                                             config.clock, 
+                                             recovered_packet_receiver);
+}
+
+std::unique_ptr<RsFecReceiver> MaybeCreateRsFecReceiver(const RtpVideoReceiver::Configuration& config,
+                                                        RecoveredPacketReceiver* recovered_packet_receiver) {
+    const auto& flexfec = config.rtp.flexfec;
+    if (flexfec.payload_type < 0 || !flexfec.reed_solomon) {
+        return nullptr;
+    }
+    if (flexfec.ssrc == 0) {
+        PLOG_WARNING << "Disable Reed-Solomon FEC since no FEC ssrc given.";
+        return nullptr;
+    }
+    if (!config.rtp.remote_media_ssrc) {
+        PLOG_WARNING << "Disable Reed-Solomon FEC since no protected media ssrc given.";
+        return nullptr;
+    }
+    return std::make_unique<RsFecReceiver>(flexfec.ssrc, 
+                                           *config.rtp.remote_media_ssrc, 
+                                           config.clock, 
+                                           recovered_packet_receiver);
+}
+
 rtp::video::FrameToDecode CreateFrameToDecode(const rtp::video::jitter::PacketBuffer::Frame& assembled_frame, 
                                               int64_t estimated_ntp_time_ms) {
-    return rtp::video::FrameToDecode(std::move(assembled_frame.bitstream),
+    return rtp::video::FrameToDecode(assembled_frame.bitstream(),
                                      assembled_frame.frame_type,
                                      assembled_frame.codec_type,
                                      assembled_frame.seq_num_start,
@@ -48,6 +88,7 @@ RtpVideoReceiver::RtpVideoReceiver(const Configuration& config,
                                    RtpReceiveStatistics* rtp_recv_stats,
                                    CompleteFrameReceiver* complete_frame_receiver) 
     : clock_(config.clock),
+      rtp_params_(config.rtp),
       complete_frame_receiver_(complete_frame_receiver),
       rtcp_responser_(CreateRtcpResponser(config)),
       rtcp_feedback_buffer_(rtcp_responser_.get(), rtcp_responser_.get()),
@@ -58,6 +99,8 @@ RtpVideoReceiver::RtpVideoReceiver(const Configuration& config,
       packet_buffer_(kPacketBufferStartSize, kPacketBufferMaxSize),
       remote_ntp_time_estimator_(clock_),
       ulp_fec_receiver_(*rtp_params_.remote_media_ssrc, clock_, this),
+      flexfec_receiver_(MaybeCreateFlexfecReceiver(config, this)),
+      rs_fec_receiver_(MaybeCreateRsFecReceiver(config, this)),
       last_packet_log_ms_(-1) {
     assert(rtp_params_.remote_media_ssrc.has_value());
 
@@ -150,6 +193,15 @@ void RtpVideoReceiver::RequestKeyFrame() {
 // Private methods
 void RtpVideoReceiver::OnReceivedPacket(const RtpPacketReceived& packet) {
     RTC_RUN_ON(&sequence_checker_);
+    // FlexFEC packet in a separate stream.
+    if (IsFlexfecPacket(packet)) {
+        if (flexfec_receiver_) {
+            flexfec_receiver_->OnRtpPacket(packet);
+        } else {
+            rs_fec_receiver_->OnRtpPacket(packet);
+        }
+        return;
+    }
     // Padding or keep-alive packet
     if (packet.payload_size() == 0) {
         HandleEmptyPacket(packet.sequence_number());
@@ -160,6 +212,12 @@ void RtpVideoReceiver::OnReceivedPacket(const RtpPacketReceived& packet) {
         HandleRedPacket(packet);
         return;
     }
+    // The media packets protected by FlexFEC.
+    if (flexfec_receiver_) {
+        flexfec_receiver_->OnRtpPacket(packet);
+    } else if (rs_fec_receiver_) {
+        rs_fec_receiver_->OnRtpPacket(packet);
+    }
     const auto type_it = payload_type_map_.find(packet.payload_type());
     if (type_it == payload_type_map_.end()) {
         PLOG_WARNING << "No RTP depacketizer found for payload type=" 
@@ -178,12 +236,12 @@ void RtpVideoReceiver::OnReceivedPacket(const RtpPacketReceived& packet) {
 void RtpVideoReceiver::OnDepacketizedPacket(RtpDepacketizer::Packet depacketized_packet, 
                                                    const RtpPacketReceived& rtp_packet) {
     RTC_RUN_ON(&sequence_checker_);
-    auto packet = std::make_unique<rtp::video::jitter::PacketBuffer::Packet>(depacketized_packet.video_header,
-                                                                              depacketized_packet.video_codec_header,
-                                                                              rtp_packet.sequence_number(),
-                                                                              rtp_packet.timestamp(),
-                                                                              clock_->now_ms() /* received_time_ms */);
-    RtpVideoHeader& video_header = packet->video_header;
+    rtp::video::jitter::PacketBuffer::Packet packet(depacketized_packet.video_header,
+                                                    depacketized_packet.video_codec_header,
+                                                    rtp_packet.sequence_number(),
+                                                    rtp_packet.timestamp(),
+                                                    clock_->now_ms() /* received_time_ms */);
+    RtpVideoHeader& video_header = packet.video_header;
     video_header.is_last_packet_in_frame |= rtp_packet.marker();
 
     if (auto extension = rtp_packet.GetExtension<rtp::PlayoutDelayLimits>()) {
@@ -202,10 +260,10 @@ void RtpVideoReceiver::OnDepacketizedPacket(RtpDepacketizer::Packet depacketized
         const bool is_keyframe = video_header.is_first_packet_in_frame && 
                                  video_header.frame_type == video::FrameType::KEY;
         // Return the nacks has sent for the packet.
-        packet->times_nacked = nack_module_->InsertPacket(rtp_packet.sequence_number(), is_keyframe, rtp_packet.is_recovered());
+        packet.times_nacked = nack_module_->InsertPacket(rtp_packet.sequence_number(), is_keyframe, rtp_packet.is_recovered());
     } else {
         // Indicates the NACK mechanism is disable.
-        packet->times_nacked = -1;
+        packet.times_nacked = -1;
     }
 
     if (depacketized_packet.video_payload.empty()) {
@@ -216,7 +274,7 @@ void RtpVideoReceiver::OnDepacketizedPacket(RtpDepacketizer::Packet depacketized
 
     // H264
     if (video_header.codec_type == video::CodecType::H264) {
-        auto h264_header = std::get<h264::PacketizationInfo>(packet->video_codec_header);
+        auto h264_header = std::get<h264::PacketizationInfo>(packet.video_codec_header);
         h264::SpsPpsTracker::FixedBitstream fixed = h264_sps_pps_tracker_.CopyAndFixBitstream(video_header.is_first_packet_in_frame, 
                                                                                               video_header.frame_width, 
                                                                                               video_header.frame_height, 
@@ -232,11 +290,11 @@ void RtpVideoReceiver::OnDepacketizedPacket(RtpDepacketizer::Packet depacketized
             PLOG_WARNING << "Packet truncated, droping.";
             return;
         case h264::SpsPpsTracker::PacketAction::INSERT:
-            packet->video_payload = std::move(depacketized_packet.video_payload);
+            packet.video_payload = std::move(depacketized_packet.video_payload);
             break;
         }
     } else {
-        packet->video_payload = std::move(depacketized_packet.video_payload);
+        packet.video_payload = std::move(depacketized_packet.video_payload);
     }
 
     rtcp_feedback_buffer_.SendBufferedRtcpFeedbacks();
@@ -382,6 +440,7 @@ void RtpVideoReceiver::OnRecoveredPacket(CopyOnWriteBuffer recovered_packet) {
 
     // TODO: To identify extensions.
     received_packet.set_payload_type_frequency(kVideoPayloadTypeFrequency);
+    received_packet.set_is_recovered(true);
 
     OnReceivedPacket(std::move(received_packet));
 }
@@ -391,4 +450,9 @@ bool RtpVideoReceiver::IsRedPacket(int payload_type) const {
     return payload_type == rtp_params_.ulpfec.red_payload_type;
 }
 
+bool RtpVideoReceiver::IsFlexfecPacket(const RtpPacketReceived& packet) const {
+    RTC_RUN_ON(&sequence_checker_);
+    return (flexfec_receiver_ || rs_fec_receiver_) && packet.ssrc() == rtp_params_.flexfec.ssrc;
+}
+
 } // namespace naivertc
@@ -8,6 +8,8 @@
 #include "rtc/rtp_rtcp/base/rtp_rtcp_interfaces.hpp"
 #include "rtc/rtp_rtcp/rtp/receiver/nack_module.hpp"
 #include "rtc/rtp_rtcp/rtp/fec/ulp/fec_receiver_ulp.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/flex/fec_receiver_flex.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/rs/fec_receiver_rs.hpp"
 #include "rtc/rtp_rtcp/rtp/depacketizer/rtp_depacketizer.hpp"
 #include "rtc/rtp_rtcp/rtp/receiver/video/jitter/packet_buffer.hpp"
 #include "rtc/rtp_rtcp/rtp/receiver/video/jitter/frame_ref_finder.hpp"
@@ -108,6 +110,7 @@ private:
     void OnRecoveredPacket(CopyOnWriteBuffer packet) override;
 
     bool IsRedPacket(int payload_type) const;
+    bool IsFlexfecPacket(const RtpPacketReceived& packet) const;
     
 private:
     SequenceChecker sequence_checker_;
@@ -123,6 +126,8 @@ private:
     std::unique_ptr<rtp::video::jitter::FrameRefFinder> frame_ref_finder_;
     RemoteNtpTimeEstimator remote_ntp_time_estimator_;
     UlpFecReceiver ulp_fec_receiver_;
+    std::unique_ptr<FlexfecReceiver> flexfec_receiver_;
+    std::unique_ptr<RsFecReceiver> rs_fec_receiver_;
 
     std::map<uint8_t, std::unique_ptr<RtpDepacketizer>> payload_type_map_;
 
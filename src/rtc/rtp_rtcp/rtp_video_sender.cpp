@@ -1,14 +1,21 @@
 #include "rtc/rtp_rtcp/rtp_video_sender.hpp"
 #include "rtc/rtp_rtcp/rtp/fec/flex/fec_generator_flex.hpp"
+#include "rtc/rtp_rtcp/rtp/fec/rs/fec_generator_rs.hpp"
 #include "rtc/rtp_rtcp/rtp/fec/ulp/fec_generator_ulp.hpp"
 #include "common/utils_numeric.hpp"
 
 #include <plog/Log.h>
 
 namespace naivertc {
+namespace {
+
+constexpr TimeDelta kRetransmitWindowSize = TimeDelta::Millis(500);
+
+} // namespace
 
 RtpVideoSender::RtpVideoSender(const Configuration& config) 
-    : media_payload_type_(config.rtp.media_payload_type) {
+    : media_payload_type_(config.rtp.media_payload_type),
+      local_media_ssrc_(config.rtp.local_media_ssrc) {
     CreateAndInitRtpRtcpModules(config);    
 }
 
@@ -52,12 +59,63 @@ void RtpVideoSender::OnRtcpPacket(CopyOnWriteBuffer in_packet) {
     rtcp_responser_->IncomingRtcpPacket(std::move(in_packet));
 }
 
+DataRate RtpVideoSender::OnBitrateUpdated(const TargetTransferRate& target_rate, double frame_rate) {
+    RTC_RUN_ON(&sequence_checker_);
+    TimeDelta rtt = target_rate.network_estimate.rtt;
+    if (rtt.IsInfinite()) {
+        rtt = rtcp_responser_->rtt();
+    }
+    if (rtt > TimeDelta::Zero()) {
+        fec_controller_->OnRttUpdated(rtt);
+    }
+    // The retransmissions are limited to the target bitrate.
+    retransmission_rate_limiter_->set_max_bitrate(target_rate.target_bitrate);
+    DataRate media_bitrate = fec_controller_->UpdateProtection(target_rate.target_bitrate, frame_rate);
+    if (fec_generator_) {
+        rtp_sender_->SetFecProtectionParameters(fec_controller_->delta_params(), 
+                                                fec_controller_->key_params());
+    }
+    return media_bitrate;
+}
+
+bool RtpVideoSender::TrySendPacket(RtpPacketToSend packet, 
+                                   const PacedPacketInfo& pacing_info) {
+    RTC_RUN_ON(&sequence_checker_);
+    return rtp_sender_->TrySendPacket(std::move(packet), pacing_info);
+}
+
+std::vector<RtpPacketToSend> RtpVideoSender::FetchFecPackets() const {
+    RTC_RUN_ON(&sequence_checker_);
+    return rtp_sender_->FetchFecPackets();
+}
+
+std::vector<RtpPacketToSend> RtpVideoSender::GeneratePadding(size_t target_packet_size) {
+    RTC_RUN_ON(&sequence_checker_);
+    return rtp_sender_->GeneratePadding(target_packet_size);
+}
+
+void RtpVideoSender::OnFramesDropped(size_t num_frames) {
+    RTC_RUN_ON(&sequence_checker_);
+    rtp_sender_->OnFramesDropped(num_frames);
+}
+
+void RtpVideoSender::OnReceivedRtcpReportBlocks(const std::vector<RtcpReportBlock>& report_blocks) {
+    RTC_RUN_ON(&sequence_checker_);
+    rtp_sender_->OnReceivedRtcpReportBlocks(report_blocks);
+    for (const auto& report_block : report_blocks) {
+        if (report_block.source_ssrc == local_media_ssrc_) {
+            fec_controller_->OnReceivedRtcpReportBlock(report_block);
+        }
+    }
+}
+
 // Private methods
 void RtpVideoSender::CreateAndInitRtpRtcpModules(const Configuration& config) {
     RTC_RUN_ON(&sequence_checker_);
     uint32_t local_media_ssrc = config.rtp.local_media_ssrc;
     std::optional<uint32_t> rtx_send_ssrc = config.rtp.rtx_send_ssrc;
-    fec_generator_ = MaybeCreateFecGenerator(config.rtp);
+    fec_generator_ = MaybeCreateFecGenerator(config.clock, config.rtp);
+    retransmission_rate_limiter_ = std::make_unique<BitrateLimiter>(config.clock, kRetransmitWindowSize);
 
     // RtpSender
     RtpConfiguration rtp_config;
@@ -68,12 +126,16 @@ void RtpVideoSender::CreateAndInitRtpRtcpModules(const Configuration& config) {
     rtp_config.clock = config.clock;
     rtp_config.send_transport = config.send_transport;
     rtp_config.fec_generator = fec_generator_.get();
+    rtp_config.retransmission_rate_limiter = retransmission_rate_limiter_.get();
+    rtp_config.packet_history_budget = config.packet_history_budget;
+    rtp_config.paced_sender = config.paced_sender;
     // Observers
     rtp_config.send_delay_observer = config.observers.send_delay_observer;
     rtp_config.send_packet_observer = config.observers.send_packet_observer;
     rtp_config.send_bitrates_observer = config.observers.send_bitrates_observer;
     rtp_config.transport_feedback_observer = config.observers.rtp_transport_feedback_observer;
     rtp_config.stream_data_counters_observer = config.observers.stream_data_counters_observer;
+    rtp_config.intra_frame_observer = config.observers.intra_frame_observer;
     auto rtp_sender = std::make_unique<RtpSender>(rtp_config);
 
     // RtcpResponser
@@ -95,7 +157,7 @@ void RtpVideoSender::CreateAndInitRtpRtcpModules(const Configuration& config) {
     rtcp_config.rtt_observer = config.observers.rtt_observer;
     rtcp_config.transport_feedback_observer = config.observers.rtcp_transport_feedback_observer;
     rtcp_config.nack_list_observer = rtp_sender.get();
-    rtcp_config.report_blocks_observer = rtp_sender.get();
+    rtcp_config.report_blocks_observer = this;
     rtcp_config.rtp_send_stats_provider = rtp_sender.get();
     auto rtcp_responser = std::make_unique<RtcpResponser>(rtcp_config);
     
@@ -103,6 +165,13 @@ void RtpVideoSender::CreateAndInitRtpRtcpModules(const Configuration& config) {
     rtp_sender_ = std::move(rtp_sender);
     sender_video_ = std::make_unique<RtpSenderVideo>(config.clock, rtp_sender_.get());
 
+    // FecController
+    FecController::Configuration fec_config;
+    fec_config.nack_enabled = config.rtp.nack_enabled;
+    fec_config.fec_enabled = fec_generator_ != nullptr;
+    fec_config.max_packet_size = config.rtp.max_packet_size;
+    fec_controller_ = std::make_unique<FecController>(fec_config);
+
     // Init
     InitRtpRtcpModules(config.rtp);
 }
@@ -132,7 +201,7 @@ void RtpVideoSender::InitRtpRtcpModules(const RtpParameters& rtp_params) {
     rtcp_responser_->RegisterPayloadFrequency(rtp_params.media_payload_type, kVideoPayloadTypeFrequency);
 }
 
-std::unique_ptr<FecGenerator> RtpVideoSender::MaybeCreateFecGenerator(const RtpParameters& rtp_params) {
+std::unique_ptr<FecGenerator> RtpVideoSender::MaybeCreateFecGenerator(Clock* clock, const RtpParameters& rtp_params) {
     RTC_RUN_ON(&sequence_checker_);
     // Flexfec takes priority
     if (rtp_params.flexfec.payload_type >= 0) {
@@ -154,9 +223,17 @@ std::unique_ptr<FecGenerator> RtpVideoSender::MaybeCreateFecGenerator(const RtpP
             return nullptr;
         }
 
+        if (rtp_params.flexfec.reed_solomon) {
+            return std::make_unique<RsFecGenerator>(rtp_params.flexfec.payload_type, 
+                                                    rtp_params.flexfec.ssrc, 
+                                                    rtp_params.flexfec.protected_media_ssrc,
+                                                    clock);
+        }
+
         return std::make_unique<FlexfecGenerator>(rtp_params.flexfec.payload_type, 
                                                   rtp_params.flexfec.ssrc, 
-                                                  rtp_params.flexfec.protected_media_ssrc);
+                                                  rtp_params.flexfec.protected_media_ssrc,
+                                                  clock);
 
     } else if (rtp_params.ulpfec.red_payload_type >= 0 && 
                rtp_params.ulpfec.ulpfec_payload_type >= 0) {
@@ -9,49 +9,72 @@
 #include "rtc/rtp_rtcp/rtp/packets/rtp_header_extensions.hpp"
 #include "rtc/rtp_rtcp/rtp/fec/fec_generator.hpp"
 #include "rtc/rtp_rtcp/rtp/fec/fec_controller.hpp"
+#include "rtc/rtp_rtcp/components/bitrate_limiter.hpp"
 #include "rtc/media/video/encoded_frame.hpp"
 #include "rtc/media/video/common.hpp"
 #include "rtc/transports/rtc_transport_media.hpp"
 #include "rtc/base/synchronization/sequence_checker.hpp"
+#include "rtc/congestion_control/base/bwe_types.hpp"
 
 #include <vector>
 
 namespace naivertc {
 
 // RtpVideoSender
-class RtpVideoSender {
+class RtpVideoSender : public RtcpReportBlocksObserver {
 public:
     struct Configuration {
         Clock* clock = nullptr;
         RtcMediaTransport* send_transport = nullptr;
+        // The bytes budget of the packet history shared by the streams of a call.
+        RtpPacketHistoryBudget* packet_history_budget = nullptr;
+        // The pacer of the call, which the media packets are enqueued to.
+        RtpPacketSender* paced_sender = nullptr;
 
         RtpParameters rtp;
         RtpSenderObservers observers;
     };
 public:
     RtpVideoSender(const Configuration& config);
-    ~RtpVideoSender();
+    ~RtpVideoSender() override;
 
     bool OnEncodedFrame(video::EncodedFrame encoded_frame);
 
     void OnRtcpPacket(CopyOnWriteBuffer in_packet);
 
+    // Updates the protection with the target bitrate from the network controller,
+    // returns the bitrate left for the media after the protection overhead.
+    DataRate OnBitrateUpdated(const TargetTransferRate& target_rate, double frame_rate);
+
+    // Called with the packets paced by the pacer of the call.
+    bool TrySendPacket(RtpPacketToSend packet, 
+                       const PacedPacketInfo& pacing_info);
+    std::vector<RtpPacketToSend> FetchFecPackets() const;
+    std::vector<RtpPacketToSend> GeneratePadding(size_t target_packet_size);
+
+    // Called when the pacer dropped the stale frames of this stream.
+    void OnFramesDropped(size_t num_frames);
+
+    // Implements RtcpReportBlocksObserver
+    void OnReceivedRtcpReportBlocks(const std::vector<RtcpReportBlock>& report_blocks) override;
+
 private:
     void CreateAndInitRtpRtcpModules(const Configuration& config);
 
     void InitRtpRtcpModules(const RtpParameters& rtp_params);
 
-    std::unique_ptr<FecGenerator> MaybeCreateFecGenerator(const RtpParameters& rtp_params);
+    std::unique_ptr<FecGenerator> MaybeCreateFecGenerator(Clock* clock, const RtpParameters& rtp_params);
 
 private:
     SequenceChecker sequence_checker_;
     const int media_payload_type_;
+    const uint32_t local_media_ssrc_;
 
+    std::unique_ptr<BitrateLimiter> retransmission_rate_limiter_ = nullptr;
     std::unique_ptr<RtcpResponser> rtcp_responser_ = nullptr;
     std::unique_ptr<RtpSender> rtp_sender_ = nullptr;
     std::unique_ptr<RtpSenderVideo> sender_video_ = nullptr;
     std::unique_ptr<FecGenerator> fec_generator_ = nullptr;
-    // TODO: Implement FecController.
     std::unique_ptr<FecController> fec_controller_ = nullptr;
 };
 
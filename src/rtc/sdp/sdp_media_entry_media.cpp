@@ -278,7 +278,7 @@ std::string Media::ToString(Codec codec) {
     case sdp::Media::Codec::ULP_FEC:
         return "ulpfec";
     case sdp::Media::Codec::FLEX_FEC:
-        return "flexfec";
+        return "flexfec-03";
     case sdp::Media::Codec::RTX:
         return "rtx";
     }
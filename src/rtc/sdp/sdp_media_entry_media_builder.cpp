@@ -64,7 +64,7 @@ std::string Media::GenerateSDPLines(const std::string eol) const {
         std::optional<uint32_t> associated_fec_ssrc = FecSsrcAssociatedWithMediaSsrc(ssrc);
     
         // No associated ssrc
-        if (!associated_rtx_ssrc && !associated_rtx_ssrc) {
+        if (!associated_rtx_ssrc && !associated_fec_ssrc) {
             // a=ssrc
             // Media ssrc entry
             oss << GenerateSsrcEntrySDPLines(ssrc_entries_.at(ssrc), eol);
@@ -72,20 +72,21 @@ std::string Media::GenerateSDPLines(const std::string eol) const {
             // a=ssrc-group:FID
             if (associated_rtx_ssrc) {
                 oss << "a=ssrc-group:FID" << sp << ssrc << sp << associated_rtx_ssrc.value() << eol;
-                // a=ssrc
-                // Media ssrc entry
-                oss << GenerateSsrcEntrySDPLines(ssrc_entries_.at(ssrc), eol);
-                // RTX ssrc entry
+            }
+            // a=ssrc-group:FEC-FR
+            // See https://datatracker.ietf.org/doc/html/rfc5956#section-4.3
+            if (associated_fec_ssrc) {
+                oss << "a=ssrc-group:FEC-FR" << sp << ssrc << sp << associated_fec_ssrc.value() << eol;
+            }
+            // a=ssrc
+            // Media ssrc entry
+            oss << GenerateSsrcEntrySDPLines(ssrc_entries_.at(ssrc), eol);
+            // RTX ssrc entry
+            if (associated_rtx_ssrc) {
                 oss << GenerateSsrcEntrySDPLines(ssrc_entries_.at(associated_rtx_ssrc.value()), eol);
-
             }
-            // a=ssrc-group:FEC
+            // FEC ssrc entry
             if (associated_fec_ssrc) {
-                oss << "a=ssrc-group:FEC" << sp << ssrc << sp << associated_rtx_ssrc.value() << eol;
-                // a=ssrc
-                // Media ssrc entry
-                oss << GenerateSsrcEntrySDPLines(ssrc_entries_.at(ssrc), eol);
-                // FEC ssrc entry
                 oss << GenerateSsrcEntrySDPLines(ssrc_entries_.at(associated_fec_ssrc.value()), eol);
             }
         }
@@ -20,7 +20,8 @@ std::optional<sdp::Media::Codec> CodecFromString(const std::string_view& codec_n
         return sdp::Media::Codec::RED;
     } else if (codec_name == "ULPFEC" || codec_name == "ulpfec") {
         return sdp::Media::Codec::ULP_FEC;
-    } else if (codec_name == "FLEXFEC" || codec_name == "flexfec") {
+    } else if (codec_name == "FLEXFEC" || codec_name == "flexfec" || 
+               codec_name == "FLEXFEC-03" || codec_name == "flexfec-03") {
         return sdp::Media::Codec::FLEX_FEC;
     } else if (codec_name == "RTX" || codec_name == "rtx") {
         return sdp::Media::Codec::RTX;
@@ -149,6 +150,7 @@ bool Media::ParseSDPAttributeField(std::string_view key, std::string_view value)
     // a=ssrc-group:<semantics> <ssrc-id>
     // eg: a=ssrc-group:FID 3463951252 1461041037
     // eg: a=ssrc-group:FEC 3463951252 1461041037
+    // eg: a=ssrc-group:FEC-FR 3463951252 1461041037
     else if (key == "ssrc-group") {
         size_t sp = value.find(" ");
         auto semantics = value.substr(0, sp);
@@ -157,13 +159,16 @@ bool Media::ParseSDPAttributeField(std::string_view key, std::string_view value)
         sp = ssrc_id_str.find(" ");
         // Media ssrc
         auto media_ssrc = utils::string::to_integer<uint32_t>(ssrc_id_str.substr(0, sp));
-        media_ssrcs_.emplace_back(media_ssrc);
+        // The media ssrc may be grouped with both of RTX and FEC ssrcs.
+        if (!IsMediaSsrc(media_ssrc)) {
+            media_ssrcs_.emplace_back(media_ssrc);
+        }
 
         // Associated ssrc
         auto associated_ssrc = utils::string::to_integer<uint32_t>(ssrc_id_str.substr(sp + 1));
         if (semantics == "FID") {
             rtx_ssrcs_.emplace_back(associated_ssrc);
-        } else if (semantics == "FEC") {
+        } else if (semantics == "FEC" || semantics == "FEC-FR") {
             fec_ssrcs_.emplace_back(associated_ssrc);
         } else {
             // TODO: How to handle SIM(simulcate) streams?
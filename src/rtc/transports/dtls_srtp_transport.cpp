@@ -4,38 +4,47 @@
 #include <plog/Log.h>
 
 namespace naivertc {
+namespace {
+
+// The authentication tag length of AES_CM_128_HMAC_SHA1_80.
+constexpr size_t kSrtpAuthTagSize = 10;
+// The SRTCP packet carries an additional 4 bytes E-flag and SRTCP index.
+constexpr size_t kSrtcpIndexSize = 4;
+    
+} // namespace
 
 DtlsSrtpTransport::DtlsSrtpTransport(DtlsTransport::Configuration config,
                                      bool is_client,
-                                     BaseTransport* lower) 
+                                     BaseTransport* lower,
+                                     size_t num_crypto_workers) 
     : DtlsTransport(std::move(config), is_client, lower),
       srtp_init_done_(false) {
     PLOG_DEBUG << "Initializing DTLS-SRTP transport";
     CreateSrtp();
+    for (size_t i = 0; i < num_crypto_workers; ++i) {
+        crypto_workers_.push_back(std::make_unique<CryptoWorker>("srtp.crypto.worker." + std::to_string(i)));
+    }
+    if (num_crypto_workers > 0) {
+        PLOG_DEBUG << "SRTP crypto offloaded to " << num_crypto_workers << " workers.";
+    }
 }
 
 DtlsSrtpTransport::~DtlsSrtpTransport() {
     RTC_RUN_ON(&sequence_checker_);
     DtlsTransport::Stop();
+    // Make sure no crypto task is running before destroying the sessions.
+    crypto_workers_.clear();
     DestroySrtp();
 }
 
 int DtlsSrtpTransport::SendRtpPacket(CopyOnWriteBuffer packet, PacketOptions options) {
     RTC_RUN_ON(&sequence_checker_);
-    if (!packet.empty() && EncryptPacket(packet, false)) {
-        return Outgoing(std::move(packet), std::move(options));
-    } else {
-        return -1;
-    }
+    return SendPacket(std::move(packet), std::move(options), false);
 }
 
 int DtlsSrtpTransport::SendRtcpPacket(CopyOnWriteBuffer packet, PacketOptions options) {
     RTC_RUN_ON(&sequence_checker_);
-    if (!packet.empty() && EncryptPacket(packet, true)) {
-        return Outgoing(std::move(packet), std::move(options));
-    } else {
-        return -1;
-    }
+    return SendPacket(std::move(packet), std::move(options), true);
 }
 
 void DtlsSrtpTransport::OnReceivedRtpPacket(RtpPacketRecvCallback callback) {
@@ -44,22 +53,76 @@ void DtlsSrtpTransport::OnReceivedRtpPacket(RtpPacketRecvCallback callback) {
 }
 
 // Private methods
-bool DtlsSrtpTransport::EncryptPacket(CopyOnWriteBuffer& packet, bool is_rtcp) {
+int DtlsSrtpTransport::SendPacket(CopyOnWriteBuffer packet, PacketOptions options, bool is_rtcp) {
     RTC_RUN_ON(&sequence_checker_);
+    if (packet.empty()) {
+        return -1;
+    }
     if (!srtp_init_done_) {
         PLOG_WARNING << "SRTP not init yet.";
-        return false;
+        return -1;
+    }
+    if ((is_rtcp && !IsRtcpPacket(packet)) || (!is_rtcp && !IsRtpPacket(packet))) {
+        PLOG_WARNING << "Sending packet is neither a RTP packet nor a RTCP packet, ignoring.";
+        return -1;
     }
 
+    // Protect inline.
+    if (crypto_workers_.empty()) {
+        if (EncryptPacket(srtp_out_, packet, is_rtcp)) {
+            return Outgoing(std::move(packet), std::move(options));
+        } else {
+            return -1;
+        }
+    }
+
+    // Offload to the crypto worker, and the size returned is the 
+    // expected size of the protected packet.
+    int expected_size = int(packet.size() + kSrtpAuthTagSize + (is_rtcp ? kSrtcpIndexSize : 0));
+    CryptoWorker* worker = SelectCryptoWorker(packet, is_rtcp);
+    worker->task_queue()->Post([this, worker, is_rtcp, flag=task_safety_.flag(), 
+                                packet=std::move(packet), options=std::move(options)]() mutable {
+        try {
+            if (!EncryptPacket(worker->srtp_out(), packet, is_rtcp)) {
+                return;
+            }
+        } catch (const std::exception& e) {
+            PLOG_WARNING << "Failed to protect packet in crypto worker: " << e.what();
+            return;
+        }
+        attached_queue_->Post([this, flag=std::move(flag), packet=std::move(packet), options=std::move(options)]() mutable {
+            if (!flag->alive()) {
+                return;
+            }
+            Outgoing(std::move(packet), std::move(options));
+        });
+    });
+    return expected_size;
+}
+
+void DtlsSrtpTransport::DeliverPacket(CopyOnWriteBuffer packet, bool is_rtcp) {
+    RTC_RUN_ON(&sequence_checker_);
+    if (rtp_packet_recv_callback_) {
+        rtp_packet_recv_callback_(std::move(packet), is_rtcp);
+    }
+}
+
+DtlsSrtpTransport::CryptoWorker* DtlsSrtpTransport::SelectCryptoWorker(const CopyOnWriteBuffer& packet, bool is_rtcp) const {
+    RTC_RUN_ON(&sequence_checker_);
+    uint32_t ssrc = is_rtcp ? ParseRtcpSenderSsrc(packet) : ParseRtpSsrc(packet);
+    return crypto_workers_[ssrc % crypto_workers_.size()].get();
+}
+
+bool DtlsSrtpTransport::EncryptPacket(srtp_t session, CopyOnWriteBuffer& packet, bool is_rtcp) {
     int protectd_data_size = (int)packet.size();
-    // Rtcp packet
-    if (is_rtcp && IsRtcpPacket(packet)) {
-        // srtp_protect() and srtp_protect_rtcp() assume that they can write SRTP_MAX_TRAILER_LEN (for the authentication tag)
-        // into the location in memory immediately following the RTP packet.
-        size_t reserve_packet_size = protectd_data_size + SRTP_MAX_TRAILER_LEN /* 144 bytes defined in srtp.h */;
-        packet.Resize(reserve_packet_size);
+    // srtp_protect() and srtp_protect_rtcp() assume that they can write SRTP_MAX_TRAILER_LEN (for the authentication tag)
+    // into the location in memory immediately following the RTP packet.
+    size_t reserve_packet_size = protectd_data_size + SRTP_MAX_TRAILER_LEN /* 144 bytes defined in srtp.h */;
+    packet.Resize(reserve_packet_size);
 
-        if (srtp_err_status_t err = srtp_protect_rtcp(srtp_out_, packet.data(), &protectd_data_size)) {
+    // Rtcp packet
+    if (is_rtcp) {
+        if (srtp_err_status_t err = srtp_protect_rtcp(session, packet.data(), &protectd_data_size)) {
             if (err == srtp_err_status_replay_fail) {
                 throw std::runtime_error("Outgoing SRTCP packet is a replay");
             } else {
@@ -68,16 +131,9 @@ bool DtlsSrtpTransport::EncryptPacket(CopyOnWriteBuffer& packet, bool is_rtcp) {
             }
         }
         PLOG_VERBOSE_IF(false) << "Protected SRTCP packet, size=" << protectd_data_size;
-
-        packet.Resize(protectd_data_size);
     // Rtp packet
-    } else if (!is_rtcp && IsRtpPacket(packet)) {
-        // srtp_protect() and srtp_protect_rtcp() assume that they can write SRTP_MAX_TRAILER_LEN (for the authentication tag)
-        // into the location in memory immediately following the RTP packet.
-        size_t reserve_packet_size = protectd_data_size + SRTP_MAX_TRAILER_LEN /* 144 bytes defined in srtp.h */;
-        packet.Resize(reserve_packet_size);
-
-        if (srtp_err_status_t err = srtp_protect(srtp_out_, packet.data(), &protectd_data_size)) {
+    } else {
+        if (srtp_err_status_t err = srtp_protect(session, packet.data(), &protectd_data_size)) {
             if (err == srtp_err_status_replay_fail) {
                 throw std::runtime_error("Outgoing SRTP packet is a replay");
             } else {
@@ -86,12 +142,43 @@ bool DtlsSrtpTransport::EncryptPacket(CopyOnWriteBuffer& packet, bool is_rtcp) {
             }
         }
         PLOG_VERBOSE_IF(false) << "Protected SRTP packet, size=" << protectd_data_size;
+    }
+    packet.Resize(protectd_data_size);
+    return true;
+}
 
-        packet.Resize(protectd_data_size);
+bool DtlsSrtpTransport::DecryptPacket(srtp_t session, CopyOnWriteBuffer& packet, bool is_rtcp) {
+    int unprotected_data_size = int(packet.size());
+    // RTCP packet
+    if (is_rtcp) {
+        PLOG_VERBOSE_IF(false) << "Incoming SRTCP packet, size: " << packet.size();
+        if (srtp_err_status_t err = srtp_unprotect_rtcp(session, static_cast<void *>(packet.data()), &unprotected_data_size)) {
+            if (err == srtp_err_status_replay_fail) {
+                PLOG_VERBOSE << "Incoming SRTCP packet is a replay.";
+            } else if (err == srtp_err_status_auth_fail) {
+                PLOG_VERBOSE << "Incoming SRTCP packet failed authentication check.";
+            } else {
+                PLOG_VERBOSE << "SRTCP unprotect error, status: " << err;
+            }
+            return false;
+        }
+        PLOG_VERBOSE_IF(false) << "Unprotected SRTCP packet, size: " << unprotected_data_size;
+    // RTP packet
     } else {
-        PLOG_WARNING << "Sending packet is neither a RTP packet nor a RTCP packet, ignoring.";
-        return false;
+        PLOG_VERBOSE << "Incoming SRTP packet, size: " << packet.size();
+        if (srtp_err_status_t err = srtp_unprotect(session, static_cast<void *>(packet.data()), &unprotected_data_size)) {
+            if (err == srtp_err_status_replay_fail) {
+                PLOG_VERBOSE << "Incoming SRTP packet is a replay.";
+            } else if (err == srtp_err_status_auth_fail) {
+                PLOG_VERBOSE << "Incoming SRTP packet failed authentication check.";
+            } else {
+                PLOG_VERBOSE << "SRTP unprotect error, status: " << err;
+            }
+            return false;
+        }
+        PLOG_VERBOSE << "Unprotected SRTP packet, size: " << unprotected_data_size;
     }
+    packet.Resize(unprotected_data_size);
     return true;
 }
 
@@ -130,52 +217,31 @@ void DtlsSrtpTransport::Incoming(CopyOnWriteBuffer in_packet) {
         DtlsTransport::Incoming(std::move(in_packet));
     // RTP/RTCP packet
     } else if (first_byte >= 128 && first_byte <= 191) {
-        // RTCP packet
-        if (IsRtcpPacket(in_packet)) {
-            PLOG_VERBOSE_IF(false) << "Incoming SRTCP packet, size: " << packet_size;
-            int unprotected_data_size = int(packet_size);
-            if (srtp_err_status_t err = srtp_unprotect_rtcp(srtp_in_, static_cast<void *>(in_packet.data()), &unprotected_data_size)) {
-                if (err == srtp_err_status_replay_fail) {
-                    PLOG_VERBOSE << "Incoming SRTCP packet is a replay.";
-                } else if (err == srtp_err_status_auth_fail) {
-                    PLOG_VERBOSE << "Incoming SRTCP packet failed authentication check.";
-                } else {
-                    PLOG_VERBOSE << "SRTCP unprotect error, status: " << err;
-                }
-                return;
-            }
-            PLOG_VERBOSE_IF(false) << "Unprotected SRTCP packet, size: " << unprotected_data_size;
-            
-            in_packet.Resize(unprotected_data_size);
-
-            if (rtp_packet_recv_callback_) {
-                rtp_packet_recv_callback_(std::move(in_packet), true /* RTCP */);
+        bool is_rtcp = IsRtcpPacket(in_packet);
+        if (!is_rtcp && !IsRtpPacket(in_packet)) {
+            PLOG_WARNING << "Incoming packet is neither a RTP packet nor a RTCP packet, ignoring.";
+            return;
+        }
+        // Unprotect inline.
+        if (crypto_workers_.empty()) {
+            if (DecryptPacket(srtp_in_, in_packet, is_rtcp)) {
+                DeliverPacket(std::move(in_packet), is_rtcp);
             }
-        // RTP packet
-        } else if (IsRtpPacket(in_packet)) {
-            PLOG_VERBOSE << "Incoming SRTP packet, size: " << packet_size;
-            int unprotected_data_size = int(packet_size);
-            if (srtp_err_status_t err = srtp_unprotect(srtp_in_, static_cast<void *>(in_packet.data()), &unprotected_data_size)) {
-                if (err == srtp_err_status_replay_fail) {
-                    PLOG_VERBOSE << "Incoming SRTP packet is a replay.";
-                } else if (err == srtp_err_status_auth_fail) {
-                    PLOG_VERBOSE << "Incoming SRTP packet failed authentication check.";
-                } else {
-                    PLOG_VERBOSE << "SRTCP unprotect error, status: " << err;
-                }
+            return;
+        }
+        // Offload to the crypto worker.
+        CryptoWorker* worker = SelectCryptoWorker(in_packet, is_rtcp);
+        worker->task_queue()->Post([this, worker, is_rtcp, flag=task_safety_.flag(), packet=std::move(in_packet)]() mutable {
+            if (!DecryptPacket(worker->srtp_in(), packet, is_rtcp)) {
                 return;
             }
-            PLOG_VERBOSE << "Unprotected SRTP packet, size: " << unprotected_data_size;
-            
-            in_packet.Resize(unprotected_data_size);
-
-            if (rtp_packet_recv_callback_) {
-                rtp_packet_recv_callback_(std::move(in_packet), false);
-            }
-            
-        } else {
-            PLOG_WARNING << "Incoming packet is neither a RTP packet nor a RTCP packet, ignoring.";
-        }
+            attached_queue_->Post([this, is_rtcp, flag=std::move(flag), packet=std::move(packet)]() mutable {
+                if (!flag->alive()) {
+                    return;
+                }
+                DeliverPacket(std::move(packet), is_rtcp);
+            });
+        });
     } else {
         PLOG_WARNING << "Incoming packet is neither a RTP/RTCP packet nor a DTLS packet, ignoring.";
     }
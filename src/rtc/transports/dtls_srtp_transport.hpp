@@ -3,10 +3,12 @@
 
 #include "base/defines.hpp"
 #include "rtc/transports/dtls_transport.hpp"
+#include "rtc/base/task_utils/task_queue.hpp"
 
 #include <srtp.h>
 
 #include <functional>
+#include <vector>
 
 namespace naivertc {
 
@@ -15,7 +17,13 @@ public:
     static void Init();
     static void Cleanup();
 public:
-    DtlsSrtpTransport(Configuration config, bool is_client, BaseTransport* lower);
+    // If |num_crypto_workers| is greater than zero, the SRTP protect/unprotect
+    // work will be offloaded to the crypto workers, otherwise it's done inline
+    // on the network task queue.
+    DtlsSrtpTransport(Configuration config, 
+                      bool is_client, 
+                      BaseTransport* lower, 
+                      size_t num_crypto_workers = 0);
     ~DtlsSrtpTransport() override;
 
     int SendRtpPacket(CopyOnWriteBuffer packet, PacketOptions options);
@@ -33,19 +41,51 @@ private:
     void Incoming(CopyOnWriteBuffer in_packet) override;
     int Outgoing(CopyOnWriteBuffer out_packet, PacketOptions options) override;
 
-    bool EncryptPacket(CopyOnWriteBuffer& packet, bool is_rtcp);
+    int SendPacket(CopyOnWriteBuffer packet, PacketOptions options, bool is_rtcp);
+    void DeliverPacket(CopyOnWriteBuffer packet, bool is_rtcp);
+
+    static bool EncryptPacket(srtp_t session, CopyOnWriteBuffer& packet, bool is_rtcp);
+    static bool DecryptPacket(srtp_t session, CopyOnWriteBuffer& packet, bool is_rtcp);
+
+    class CryptoWorker;
+    CryptoWorker* SelectCryptoWorker(const CopyOnWriteBuffer& packet, bool is_rtcp) const;
+
 private:
     bool srtp_init_done_;
 
     srtp_t srtp_in_;
     srtp_t srtp_out_;
 
+    // The packets from the same SSRC are always dispatched to the same worker,
+    // so the replay and rollover state of libsrtp stays consistent, and the 
+    // packets per SSRC will be delivered in order since the worker and the 
+    // network task queue are both FIFO.
+    std::vector<std::unique_ptr<CryptoWorker>> crypto_workers_;
+
     unsigned char client_write_key_[SRTP_AES_128_KEY_LEN + SRTP_SALT_LEN];
     unsigned char server_write_key_[SRTP_AES_128_KEY_LEN + SRTP_SALT_LEN];
 
     RtpPacketRecvCallback rtp_packet_recv_callback_ = nullptr;
 };
 
+// CryptoWorker
+class DtlsSrtpTransport::CryptoWorker {
+public:
+    CryptoWorker(std::string_view name);
+    ~CryptoWorker();
+
+    srtp_t srtp_in() const { return srtp_in_; }
+    srtp_t srtp_out() const { return srtp_out_; }
+    TaskQueue* task_queue() const { return task_queue_.get(); }
+
+    void AddStreams(const srtp_policy_t* inbound, const srtp_policy_t* outbound);
+
+private:
+    srtp_t srtp_in_;
+    srtp_t srtp_out_;
+    std::unique_ptr<TaskQueue> task_queue_;
+};
+
 
 } // namespace naivertc
 
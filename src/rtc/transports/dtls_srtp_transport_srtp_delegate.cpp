@@ -97,6 +97,40 @@ void DtlsSrtpTransport::InitSrtp() {
     if (srtp_err_status_t err = srtp_add_stream(srtp_out_, &outbound)) {
         throw std::runtime_error("Failed to add SRTP outbound stream, status: " + std::to_string(static_cast<int>(err)));
     }
+
+    // NOTE: It's safe to add streams here, since no crypto task will be posted
+    // to workers before the SRTP init done.
+    for (auto& worker : crypto_workers_) {
+        worker->AddStreams(&inbound, &outbound);
+    }
+}
+
+// CryptoWorker
+DtlsSrtpTransport::CryptoWorker::CryptoWorker(std::string_view name) 
+    : task_queue_(std::make_unique<TaskQueue>(name)) {
+    if (srtp_err_status_t err = srtp_create(&srtp_in_, nullptr)) {
+		throw std::runtime_error("SRTP create failed, status=" + std::to_string(static_cast<int>(err)));
+	}
+	if (srtp_err_status_t err = srtp_create(&srtp_out_, nullptr)) {
+		srtp_dealloc(srtp_in_);
+		throw std::runtime_error("SRTP create failed, status=" + std::to_string(static_cast<int>(err)));
+	}
+}
+
+DtlsSrtpTransport::CryptoWorker::~CryptoWorker() {
+    // Wait until all the pending crypto tasks are done.
+    task_queue_.reset();
+    srtp_dealloc(srtp_in_);
+    srtp_dealloc(srtp_out_);
+}
+
+void DtlsSrtpTransport::CryptoWorker::AddStreams(const srtp_policy_t* inbound, const srtp_policy_t* outbound) {
+    if (srtp_err_status_t err = srtp_add_stream(srtp_in_, inbound)) {
+        throw std::runtime_error("Failed to add SRTP inbound stream to crypto worker, status: " + std::to_string(static_cast<int>(err)));
+    }
+    if (srtp_err_status_t err = srtp_add_stream(srtp_out_, outbound)) {
+        throw std::runtime_error("Failed to add SRTP outbound stream to crypto worker, status: " + std::to_string(static_cast<int>(err)));
+    }
 }
 
 } // namespace naivertc 
@@ -0,0 +1,179 @@
+#include "rtc/transports/dtls_srtp_transport.hpp"
+#include "rtc/transports/loopback_transport.hpp"
+#include "rtc/rtp_rtcp/rtp/packets/rtp_packet.hpp"
+#include "rtc/rtp_rtcp/base/rtp_utils.hpp"
+#include "rtc/base/memory/byte_io_writer.hpp"
+#include "rtc/base/memory/byte_io_reader.hpp"
+#include "testing/simulated_time_controller.hpp"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <thread>
+
+#define ENABLE_UNIT_TESTS 0
+#include "testing/defines.hpp"
+
+namespace naivertc {
+namespace test {
+namespace {
+
+// The authentication tag length of AES_CM_128_HMAC_SHA1_80.
+constexpr size_t kSrtpAuthTagSize = 10;
+// The E-flag and SRTCP index followed by the authentication tag.
+constexpr size_t kSrtcpTrailerSize = 4 + kSrtpAuthTagSize;
+constexpr size_t kRtpHeaderSize = 12;
+constexpr size_t kPayloadSize = 100;
+constexpr uint32_t kSsrcs[] = {1111, 2222, 3333};
+
+CopyOnWriteBuffer CreateRtpPacket(uint32_t ssrc, uint16_t seq_num) {
+    RtpPacket packet;
+    packet.set_payload_type(96);
+    packet.set_sequence_number(seq_num);
+    packet.set_timestamp(seq_num * 3000);
+    packet.set_ssrc(ssrc);
+    uint8_t* payload = packet.set_payload_size(kPayloadSize);
+    memset(payload, seq_num & 0xFF, kPayloadSize);
+    return packet;
+}
+
+CopyOnWriteBuffer CreateRtcpPacket(uint32_t sender_ssrc) {
+    // A receiver report without report block.
+    uint8_t packet[8] = {0x80, 201, 0x00, 0x01};
+    ByteWriter<uint32_t>::WriteBigEndian(&packet[4], sender_ssrc);
+    return CopyOnWriteBuffer(packet, sizeof(packet));
+}
+
+} // namespace
+
+// The parameter is the number of crypto workers, and zero means
+// the packets are protected and unprotected inline.
+class T(DtlsSrtpTransportTest) : public ::testing::TestWithParam<size_t> {
+public:
+    T(DtlsSrtpTransportTest)()
+        : time_controller_(Timestamp::Millis(1000)),
+          task_queue_(time_controller_.CreateTaskQueue()) {
+        DtlsTransport::Init();
+        DtlsSrtpTransport::Init();
+    }
+
+    ~T(DtlsSrtpTransportTest)() override {
+        task_queue_->Post(ToQueuedTask([this](){
+            client_.reset();
+            server_.reset();
+            client_lower_.reset();
+            server_lower_.reset();
+        }));
+        time_controller_.AdvanceTime(TimeDelta::Zero());
+    }
+
+    void CreateTransportsAndHandshake() {
+        task_queue_->Post(ToQueuedTask([this, num_crypto_workers=GetParam()](){
+            client_lower_ = std::make_unique<LoopbackTransport>(LoopbackTransport::Configuration());
+            server_lower_ = std::make_unique<LoopbackTransport>(LoopbackTransport::Configuration());
+            LoopbackTransport::Connect(client_lower_.get(), server_lower_.get());
+
+            DtlsTransport::Configuration config;
+            config.clock = time_controller_.Clock();
+            config.certificate = Certificate::MakeCertificate().get();
+            client_ = std::make_unique<DtlsSrtpTransport>(config, /*is_client=*/true, client_lower_.get(), num_crypto_workers);
+            config.certificate = Certificate::MakeCertificate().get();
+            server_ = std::make_unique<DtlsSrtpTransport>(config, /*is_client=*/false, server_lower_.get(), num_crypto_workers);
+            client_->OnVerify([](std::string_view fingerprint){ return true; });
+            server_->OnVerify([](std::string_view fingerprint){ return true; });
+            server_->OnReceivedRtpPacket([this](CopyOnWriteBuffer packet, bool is_rtcp){
+                received_packets_.push_back(std::make_pair(std::move(packet), is_rtcp));
+            });
+
+            client_lower_->Start();
+            server_lower_->Start();
+            server_->Start();
+            client_->Start();
+        }));
+        time_controller_.AdvanceTime(TimeDelta::Zero());
+        task_queue_->Post(ToQueuedTask([this](){
+            ASSERT_EQ(client_->state(), BaseTransport::State::CONNECTED);
+            ASSERT_EQ(server_->state(), BaseTransport::State::CONNECTED);
+        }));
+        time_controller_.AdvanceTime(TimeDelta::Zero());
+    }
+
+    // The crypto workers run on their own threads in real time.
+    void WaitUntilReceived(size_t num_packets) {
+        for (int i = 0; i < 1000 && received_packets_.size() < num_packets; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            time_controller_.AdvanceTime(TimeDelta::Zero());
+        }
+    }
+
+protected:
+    SimulatedTimeController time_controller_;
+    std::unique_ptr<SimulatedTaskQueue, SimulatedTaskQueue::Deleter> task_queue_;
+    std::unique_ptr<LoopbackTransport> client_lower_;
+    std::unique_ptr<LoopbackTransport> server_lower_;
+    std::unique_ptr<DtlsSrtpTransport> client_;
+    std::unique_ptr<DtlsSrtpTransport> server_;
+    std::vector<std::pair<CopyOnWriteBuffer, bool>> received_packets_;
+};
+
+MY_TEST_P(DtlsSrtpTransportTest, DeliverPacketsOfSameSsrcInOrder) {
+    CreateTransportsAndHandshake();
+
+    const uint16_t kNumPacketsPerSsrc = 50;
+    task_queue_->Post(ToQueuedTask([this, kNumPacketsPerSsrc](){
+        // The packets of different SSRCs are interleaved.
+        for (uint16_t seq_num = 0; seq_num < kNumPacketsPerSsrc; ++seq_num) {
+            for (uint32_t ssrc : kSsrcs) {
+                EXPECT_GT(client_->SendRtpPacket(CreateRtpPacket(ssrc, seq_num), PacketOptions(PacketKind::VIDEO)), 0);
+            }
+        }
+    }));
+    time_controller_.AdvanceTime(TimeDelta::Zero());
+
+    const size_t kNumPackets = kNumPacketsPerSsrc * std::size(kSsrcs);
+    WaitUntilReceived(kNumPackets);
+    ASSERT_EQ(received_packets_.size(), kNumPackets);
+
+    std::map<uint32_t, uint16_t> next_seq_nums;
+    for (const auto& [packet, is_rtcp] : received_packets_) {
+        ASSERT_FALSE(is_rtcp);
+        ASSERT_EQ(packet.size(), kRtpHeaderSize + kPayloadSize);
+        uint32_t ssrc = ParseRtpSsrc(packet);
+        uint16_t seq_num = ByteReader<uint16_t>::ReadBigEndian(&packet.cdata()[2]);
+        EXPECT_EQ(seq_num, next_seq_nums[ssrc]++);
+    }
+    ASSERT_EQ(next_seq_nums.size(), std::size(kSsrcs));
+    for (const auto& [ssrc, next_seq_num] : next_seq_nums) {
+        EXPECT_EQ(next_seq_num, kNumPacketsPerSsrc);
+    }
+}
+
+MY_TEST_P(DtlsSrtpTransportTest, ReturnSizeOfProtectedPacket) {
+    CreateTransportsAndHandshake();
+
+    // The size returned in offloading mode is the expected size of the
+    // protected packet, which MUST be the same as the one sent inline.
+    CopyOnWriteBuffer rtp_packet = CreateRtpPacket(kSsrcs[0], 1);
+    CopyOnWriteBuffer rtcp_packet = CreateRtcpPacket(kSsrcs[0]);
+    task_queue_->Post(ToQueuedTask([&](){
+        EXPECT_EQ(client_->SendRtpPacket(rtp_packet, PacketOptions(PacketKind::VIDEO)),
+                  int(rtp_packet.size() + kSrtpAuthTagSize));
+        EXPECT_EQ(client_->SendRtcpPacket(rtcp_packet, PacketOptions(PacketKind::VIDEO)),
+                  int(rtcp_packet.size() + kSrtcpTrailerSize));
+    }));
+    time_controller_.AdvanceTime(TimeDelta::Zero());
+
+    WaitUntilReceived(2);
+    ASSERT_EQ(received_packets_.size(), 2u);
+    // Unprotected back to the origin packets, and the packets of
+    // the same SSRC are delivered in order.
+    EXPECT_FALSE(received_packets_[0].second);
+    EXPECT_EQ(received_packets_[0].first, rtp_packet);
+    EXPECT_TRUE(received_packets_[1].second);
+    EXPECT_EQ(received_packets_[1].first, rtcp_packet);
+}
+
+MY_INSTANTIATE_TEST_SUITE_P(InlineOrOffloaded, DtlsSrtpTransportTest, ::testing::Values(size_t{0}, size_t{3}));
+
+} // namespace test
+} // namespace naivertc
@@ -1,5 +1,7 @@
 #include "rtc/transports/dtls_transport.hpp"
 #include "common/weak_ptr_manager.hpp"
+#include "rtc/base/time/clock.hpp"
+#include "rtc/base/task_utils/task_queue_impl.hpp"
 
 #include <plog/Log.h>
 
@@ -18,8 +20,10 @@ constexpr DSCP kHandshakePacketDscp = DSCP::DSCP_AF21;
 DtlsTransport::DtlsTransport(Configuration config, bool is_client, BaseTransport* lower) 
     : BaseTransport(lower),
       config_(std::move(config)),
+      clock_(config_.clock),
       is_client_(is_client),
       handshake_packet_options_(PacketKind::BINARY, kHandshakePacketDscp) {
+    assert(clock_ != nullptr);
     InitOpenSSL(config_);
     WeakPtrManager::SharedInstance()->Register(this);
 }
@@ -35,6 +39,11 @@ void DtlsTransport::OnVerify(VerifyCallback callback) {
     verify_callback_ = callback;
 }
 
+void DtlsTransport::OnHandshakeTrace(HandshakeTraceCallback callback) {
+    RTC_RUN_ON(&sequence_checker_);
+    handshake_trace_callback_ = std::move(callback);
+}
+
 bool DtlsTransport::HandleVerify(std::string fingerprint) {
     RTC_RUN_ON(&sequence_checker_);
     return verify_callback_ != nullptr ? verify_callback_(std::move(fingerprint)) : false;
@@ -49,9 +58,10 @@ bool DtlsTransport::Start() {
     RTC_RUN_ON(&sequence_checker_);
     if (is_stoped_) {
         UpdateState(State::CONNECTING);
-        // Start to handshake
-        // TODO: Do we should use delay post to check handshake timeout in 30s here?
+        // Start to handshake, and the retransmission of handshake
+        // flights is driven by the timer posted on the attached queue.
         InitHandshake();
+        ScheduleHandshakeTimeout();
         RegisterIncoming();
         is_stoped_ = false;
     }
@@ -102,13 +112,14 @@ void DtlsTransport::Incoming(CopyOnWriteBuffer in_packet) {
 
         // In non-blocking mode, We may try to do handshake multiple time. 
         if (state_ == State::CONNECTING) {
+            TraceFlightReceived();
             if (TryToHandshake()) {
                 // DTLS Connected
+                FinishHandshake(true);
                 UpdateState(State::CONNECTED);
             } else {
-                if (IsHandshakeTimeout()) {
-                    UpdateState(State::FAILED);
-                }
+                // The retransmit timer might be restarted.
+                ScheduleHandshakeRetransmit();
                 return;
             }
         // Do SSL reading after connected
@@ -139,6 +150,7 @@ void DtlsTransport::Incoming(CopyOnWriteBuffer in_packet) {
 int DtlsTransport::HandleDtlsWrite(CopyOnWriteBuffer data) {
     RTC_RUN_ON(&sequence_checker_);
     if (state_ != State::CONNECTED) {
+        handshake_flight_written_ = true;
         return Outgoing(std::move(data), handshake_packet_options_);
     } else {
         PacketOptions options = user_packet_options_ ? std::move(*user_packet_options_): PacketOptions(PacketKind::BINARY, DSCP::DSCP_DF);
@@ -146,6 +158,65 @@ int DtlsTransport::HandleDtlsWrite(CopyOnWriteBuffer data) {
     }
 }
     
+void DtlsTransport::FinishHandshake(bool succeeded) {
+    RTC_RUN_ON(&sequence_checker_);
+    // Invalidate the pending retransmit timer and timeout task.
+    ++handshake_retransmit_timer_id_;
+    ++handshake_timeout_id_;
+    handshake_trace_.finish_time = clock_->CurrentTime();
+    handshake_trace_.succeeded = succeeded;
+    PLOG_INFO << "DTLS handshake " << (succeeded ? "succeeded" : "failed")
+              << " in " << handshake_trace_.duration().ms() << " ms"
+              << ", flights sent: " << handshake_trace_.flights_sent.size()
+              << ", flights received: " << handshake_trace_.flights_received.size()
+              << ", retransmits: " << handshake_trace_.num_retransmits;
+    if (handshake_trace_callback_) {
+        handshake_trace_callback_(handshake_trace_);
+    }
+}
+
+void DtlsTransport::ScheduleHandshakeTimeout() {
+    RTC_RUN_ON(&sequence_checker_);
+    // The handshake deadline is independent of the retransmit timer,
+    // which might be stalled by a peer which keeps sending garbage.
+    const int timeout_id = ++handshake_timeout_id_;
+    attached_queue_->PostDelayed(config_.handshake_timeout, ToQueuedTask(task_safety_, [this, timeout_id](){
+        if (timeout_id != handshake_timeout_id_) {
+            return;
+        }
+        OnHandshakeTimeout();
+    }));
+}
+
+void DtlsTransport::OnHandshakeTimeout() {
+    RTC_RUN_ON(&sequence_checker_);
+    if (state_ != State::CONNECTING) {
+        return;
+    }
+    PLOG_WARNING << "DTLS handshake timeout after " << config_.handshake_timeout.ms() << " ms.";
+    FinishHandshake(false);
+    UpdateState(State::FAILED);
+}
+
+void DtlsTransport::MaybeTraceFlightSent() {
+    RTC_RUN_ON(&sequence_checker_);
+    // The packets written during a handshake step belong to the same flight.
+    if (handshake_flight_written_) {
+        handshake_flight_written_ = false;
+        receiving_handshake_flight_ = false;
+        handshake_trace_.flights_sent.push_back(clock_->CurrentTime());
+    }
+}
+
+void DtlsTransport::TraceFlightReceived() {
+    RTC_RUN_ON(&sequence_checker_);
+    // The packets received before we sent the next flight belong to the same flight.
+    if (!receiving_handshake_flight_) {
+        receiving_handshake_flight_ = true;
+        handshake_trace_.flights_received.push_back(clock_->CurrentTime());
+    }
+}
+
 int DtlsTransport::Outgoing(CopyOnWriteBuffer out_packet, PacketOptions options) {
     RTC_RUN_ON(&sequence_checker_);
     return ForwardOutgoingPacket(std::move(out_packet), std::move(options));
@@ -5,13 +5,18 @@
 #include "base/certificate.hpp"
 #include "base/tls.hpp"
 #include "rtc/base/internals.hpp"
+#include "rtc/base/units/timestamp.hpp"
+#include "rtc/base/task_utils/pending_task_safety_flag.hpp"
 #include "rtc/transports/base_transport.hpp"
 
 #include <optional>
 #include <functional>
+#include <unordered_map>
 
 namespace naivertc {
 
+class Clock;
+
 using openssl_bool = int;
 static const openssl_bool openssl_true = 1;
 static const openssl_bool openssl_false = 0;
@@ -19,8 +24,29 @@ static const openssl_bool openssl_false = 0;
 class DtlsTransport : public BaseTransport {
 public:
     struct Configuration {
+        Clock* clock = nullptr;
         std::shared_ptr<Certificate> certificate = nullptr;
         std::optional<size_t> mtu = std::nullopt;
+        // The retransmission timeout of the first handshake flight, and it
+        // will be multiplied by |handshake_retransmit_backoff| on each 
+        // retransmission, up to |max_handshake_retransmit_timeout|.
+        TimeDelta initial_handshake_retransmit_timeout = TimeDelta::Seconds(1);
+        TimeDelta max_handshake_retransmit_timeout = TimeDelta::Seconds(60);
+        double handshake_retransmit_backoff = 2.0;
+        // The handshake will fail if not finished within the timeout.
+        TimeDelta handshake_timeout = TimeDelta::Seconds(30);
+    };
+
+    struct HandshakeTrace {
+        Timestamp start_time = Timestamp::PlusInfinity();
+        Timestamp finish_time = Timestamp::PlusInfinity();
+        // The time when the first packet of each flight was sent or received.
+        std::vector<Timestamp> flights_sent;
+        std::vector<Timestamp> flights_received;
+        size_t num_retransmits = 0;
+        bool succeeded = false;
+
+        TimeDelta duration() const { return finish_time - start_time; }
     };
 public:
     static void Init();
@@ -34,6 +60,10 @@ public:
     using VerifyCallback = std::function<bool(std::string_view fingerprint)>;
     void OnVerify(VerifyCallback callback);
 
+    // Called once the handshake is finished, successfully or not.
+    using HandshakeTraceCallback = std::function<void(const HandshakeTrace& trace)>;
+    void OnHandshakeTrace(HandshakeTraceCallback callback);
+
     virtual bool Start() override;
     virtual bool Stop() override;
 
@@ -49,16 +79,28 @@ protected:
                               size_t contextlen, bool use_context);
 
 private:
+    static std::shared_ptr<SSL_CTX> GetOrCreateContext(const Certificate& certificate);
+
     void InitOpenSSL(const Configuration& config);
     void DeinitOpenSSL();
 
     void InitHandshake();
     bool TryToHandshake();
     bool IsHandshakeTimeout();
+    void ScheduleHandshakeTimeout();
+    void OnHandshakeTimeout();
+    void ScheduleHandshakeRetransmit();
+    void OnHandshakeRetransmitTimer();
+    void FinishHandshake(bool succeeded);
     virtual void DtlsHandshakeDone();
 
+    void MaybeTraceFlightSent();
+    void TraceFlightReceived();
+    unsigned int NextHandshakeRetransmitTimeout(unsigned int timeout_us);
+
     static openssl_bool CertificateCallback(int preverify_ok, X509_STORE_CTX* ctx);
     static void InfoCallback(const SSL* ssl, int where, int ret);
+    static unsigned int TimerCallback(SSL* ssl, unsigned int timeout_us);
 
     static openssl_bool BioMethodNew(BIO* bio);
     static openssl_bool BioMethodFree(BIO* bio);
@@ -70,13 +112,17 @@ private:
     int OnDtlsWrite(CopyOnWriteBuffer data);
     int HandleDtlsWrite(CopyOnWriteBuffer data);
 
+protected:
+    ScopedTaskSafety task_safety_;
+
 private:
     const Configuration config_;
+    Clock* const clock_;
     const bool is_client_;
     const PacketOptions handshake_packet_options_;
     std::optional<PacketOptions> user_packet_options_;
 
-    SSL_CTX* ctx_ = NULL;
+    std::shared_ptr<SSL_CTX> ctx_ = nullptr;
     SSL* ssl_ = NULL;
     BIO* in_bio_ = NULL;
     BIO* out_bio_ = NULL;
@@ -85,11 +131,24 @@ private:
     static BIO_METHOD* bio_methods_;
     static int transport_ex_index_;
     static std::mutex global_mutex_;
+    // The DTLS contexts shared by the transports using the same certificate.
+    static std::unordered_map<std::string, std::weak_ptr<SSL_CTX>> context_cache_;
 
     static constexpr size_t DEFAULT_SSL_BUFFER_SIZE = 4096;
     uint8_t ssl_read_buffer_[DEFAULT_SSL_BUFFER_SIZE];
 
     VerifyCallback verify_callback_ = nullptr;
+
+    HandshakeTrace handshake_trace_;
+    // Indicates a flight was written during the last handshake step.
+    bool handshake_flight_written_ = false;
+    // Indicates the packets received belong to the same incoming flight.
+    bool receiving_handshake_flight_ = false;
+    // Used to ignore the stale retransmit timers.
+    int handshake_retransmit_timer_id_ = 0;
+    // Used to ignore the stale timeout tasks of the previous handshakes.
+    int handshake_timeout_id_ = 0;
+    HandshakeTraceCallback handshake_trace_callback_ = nullptr;
 };
 
 }
@@ -1,6 +1,7 @@
 #include "rtc/transports/dtls_transport.hpp"
 #include "common/weak_ptr_manager.hpp"
 #include "rtc/base/task_utils/task_queue_impl.hpp"
+#include "rtc/base/time/clock.hpp"
 
 #include <plog/Log.h>
 
@@ -13,6 +14,7 @@ namespace naivertc {
 BIO_METHOD* DtlsTransport::bio_methods_ = NULL;
 int DtlsTransport::transport_ex_index_ = -1;
 std::mutex DtlsTransport::global_mutex_;
+std::unordered_map<std::string, std::weak_ptr<SSL_CTX>> DtlsTransport::context_cache_;
 
 // Static methods
 void DtlsTransport::Init() {
@@ -41,6 +43,63 @@ void DtlsTransport::Cleanup() {
     // Nothing to do
 }
 
+std::shared_ptr<SSL_CTX> DtlsTransport::GetOrCreateContext(const Certificate& certificate) {
+    std::lock_guard lock(global_mutex_);
+    // The contexts are cached by the fingerprint of certificate, so the transports
+    // with the same certificate can share the same context.
+    const std::string fingerprint = certificate.fingerprint();
+    auto it = context_cache_.find(fingerprint);
+    if (it != context_cache_.end()) {
+        if (auto ctx = it->second.lock()) {
+            PLOG_VERBOSE << "Reuse cached DTLS context.";
+            return ctx;
+        }
+    }
+
+    std::shared_ptr<SSL_CTX> ctx(SSL_CTX_new(DTLS_method()), SSL_CTX_free);
+    if (!ctx) {
+        throw std::runtime_error("Failed to create SSL context for DTLS.");
+    }
+
+    // RFC 8261: SCTP performs segmentation and reassembly based on the path MTU.
+    // Therefore, the DTLS layer MUST NOT use any compression algorithm.
+    // See https://tools.ietf.org/html/rfc8261#section-5
+    // RFC 8827: Implementations MUST NOT implement DTLS renegotiation
+    // See https://tools.ietf.org/html/rfc8827#section-6.5
+    SSL_CTX_set_options(ctx.get(), SSL_OP_NO_SSLv3 | 
+                                   SSL_OP_NO_COMPRESSION | 
+                                   SSL_OP_NO_QUERY_MTU |
+                                   SSL_OP_NO_RENEGOTIATION);
+    // DTLS version 1
+    SSL_CTX_set_min_proto_version(ctx.get(), DTLS1_VERSION);
+    // Set whether we should read as many input bytes as possible (for non-blocking reads) or not
+    SSL_CTX_set_read_ahead(ctx.get(), openssl_true);
+    SSL_CTX_set_quiet_shutdown(ctx.get(), openssl_true);
+    SSL_CTX_set_info_callback(ctx.get(), InfoCallback);
+
+    SSL_CTX_set_verify(ctx.get(), SSL_VERIFY_PEER | SSL_VERIFY_FAIL_IF_NO_PEER_CERT, CertificateCallback);
+    SSL_CTX_set_verify_depth(ctx.get(), 1);
+
+    openssl::check(SSL_CTX_set_cipher_list(ctx.get(), "ALL:!LOW:!EXP:!RC4:!MD5:@STRENGTH"), "Failed to set SSL priorities.");
+
+    auto [x509, pkey] = certificate.credentials();
+    SSL_CTX_use_certificate(ctx.get(), x509);
+    SSL_CTX_use_PrivateKey(ctx.get(), pkey);
+
+    openssl::check(SSL_CTX_check_private_key(ctx.get()), "SSL local private key check failed.");
+
+    // Drop the expired contexts.
+    for (auto it = context_cache_.begin(); it != context_cache_.end();) {
+        if (it->second.expired()) {
+            it = context_cache_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    context_cache_[fingerprint] = ctx;
+    return ctx;
+}
+
 // Init methods
 void DtlsTransport::InitOpenSSL(const Configuration& config) {
     RTC_RUN_ON(&sequence_checker_);
@@ -50,40 +109,9 @@ void DtlsTransport::InitOpenSSL(const Configuration& config) {
             throw std::invalid_argument("DTLS certificate is null.");
         }
 
-        ctx_ = SSL_CTX_new(DTLS_method());
+        ctx_ = GetOrCreateContext(*config.certificate);
 
-        if (!ctx_) {
-            throw std::runtime_error("Failed to create SSL context for DTLS.");
-        }
-
-        // RFC 8261: SCTP performs segmentation and reassembly based on the path MTU.
-		// Therefore, the DTLS layer MUST NOT use any compression algorithm.
-		// See https://tools.ietf.org/html/rfc8261#section-5
-		// RFC 8827: Implementations MUST NOT implement DTLS renegotiation
-		// See https://tools.ietf.org/html/rfc8827#section-6.5
-		SSL_CTX_set_options(ctx_, SSL_OP_NO_SSLv3 | 
-                                  SSL_OP_NO_COMPRESSION | 
-                                  SSL_OP_NO_QUERY_MTU |
-		                          SSL_OP_NO_RENEGOTIATION);
-        // DTLS version 1
-        SSL_CTX_set_min_proto_version(ctx_, DTLS1_VERSION);
-        // Set whether we should read as many input bytes as possible (for non-blocking reads) or not
-        SSL_CTX_set_read_ahead(ctx_, openssl_true);
-        SSL_CTX_set_quiet_shutdown(ctx_, openssl_true);
-        SSL_CTX_set_info_callback(ctx_, InfoCallback);
-
-        SSL_CTX_set_verify(ctx_, SSL_VERIFY_PEER | SSL_VERIFY_FAIL_IF_NO_PEER_CERT, CertificateCallback);
-        SSL_CTX_set_verify_depth(ctx_, 1);
-
-        openssl::check(SSL_CTX_set_cipher_list(ctx_, "ALL:!LOW:!EXP:!RC4:!MD5:@STRENGTH"), "Failed to set SSL priorities.");
-
-        auto [x509, pkey] = config.certificate->credentials();
-        SSL_CTX_use_certificate(ctx_, x509);
-        SSL_CTX_use_PrivateKey(ctx_, pkey);
-
-        openssl::check(SSL_CTX_check_private_key(ctx_), "SSL local private key check failed.");
-
-        ssl_ = SSL_new(ctx_);
+        ssl_ = SSL_new(ctx_.get());
         if (!ssl_) {
             throw std::runtime_error("Failed to create SSL instance.");
         }
@@ -91,6 +119,9 @@ void DtlsTransport::InitOpenSSL(const Configuration& config) {
         // pass this pointer to the callback
         SSL_set_ex_data(ssl_, transport_ex_index_, this);
 
+        // Customize the retransmission timeout of handshake flights.
+        DTLS_set_timer_cb(ssl_, TimerCallback);
+
         if (IsClient()) {
             SSL_set_connect_state(ssl_);
         } else {
@@ -131,9 +162,8 @@ void DtlsTransport::DeinitOpenSSL() {
     if (ssl_) {
         SSL_free(ssl_);
     }
-    if (ctx_) {
-        SSL_CTX_free(ctx_);
-    }
+    // The context might be shared with other transports.
+    ctx_.reset();
 }
 
 void DtlsTransport::InitHandshake() {
@@ -147,8 +177,14 @@ void DtlsTransport::InitHandshake() {
 
     PLOG_VERBOSE << "SSL MTU set to " << mtu;
 
+    handshake_trace_ = HandshakeTrace();
+    handshake_trace_.start_time = clock_->CurrentTime();
+
     int ret = SSL_do_handshake(ssl_);
     openssl::check(ssl_, ret, "Initiate handshake failed.");
+
+    MaybeTraceFlightSent();
+    ScheduleHandshakeRetransmit();
 }
 
 bool DtlsTransport::TryToHandshake() {
@@ -157,6 +193,7 @@ bool DtlsTransport::TryToHandshake() {
         throw std::runtime_error("SSL instance is not created yet.");
     }
     int ret = SSL_do_handshake(ssl_);
+    MaybeTraceFlightSent();
     if (!openssl::check(ssl_, ret, "Continue to handshake failed.")) {
         return false;
     }
@@ -187,25 +224,56 @@ bool DtlsTransport::IsHandshakeTimeout() {
     if (ret < 0) {
         return true;
     } else if (ret > 0) {
+        ++handshake_trace_.num_retransmits;
         LOG_VERBOSE << "Openssl did DTLS retransmit";
     }
+    MaybeTraceFlightSent();
+    return false;
+}
 
+void DtlsTransport::ScheduleHandshakeRetransmit() {
+    RTC_RUN_ON(&sequence_checker_);
     struct timeval timeout = {};
     // DTLSv1_get_timeout queries the next DTLS handshake timeout.
     // If there is a timeout in progress, it sets *out to the time remaining and returns one. 
     // Otherwise, it returns zero.
-    if (DTLSv1_get_timeout(ssl_, &timeout)) {
-        auto duration_ms = std::chrono::milliseconds(timeout.tv_sec * 1000 + timeout.tv_usec / 1000);
-        // Also handle hand shake manually because OpenSSL actually doesn't...
-        // OpenSSL backs off exponentially in base 2 starting from the recommended 1s,
-        // so this allow for 5 retansmissions and faild after roughly 30s.
-        if (duration_ms > std::chrono::milliseconds(30000)) {
-            return true;
-        } else {
-            LOG_VERBOSE << "OpenSSL DTLS retransmit timeout is " << duration_ms.count() << "ms";
+    if (!ssl_ || !DTLSv1_get_timeout(ssl_, &timeout)) {
+        return;
+    }
+    TimeDelta delay = TimeDelta::Micros(int64_t(timeout.tv_sec) * 1'000'000 + timeout.tv_usec);
+    // Invalidate the previous timer since the timer of OpenSSL might be restarted.
+    const int timer_id = ++handshake_retransmit_timer_id_;
+    attached_queue_->PostDelayed(delay, ToQueuedTask(task_safety_, [this, timer_id](){
+        if (timer_id != handshake_retransmit_timer_id_) {
+            return;
         }
+        OnHandshakeRetransmitTimer();
+    }));
+}
+
+void DtlsTransport::OnHandshakeRetransmitTimer() {
+    RTC_RUN_ON(&sequence_checker_);
+    if (!ssl_ || state_ != State::CONNECTING) {
+        return;
     }
-    return false;
+    if (IsHandshakeTimeout()) {
+        FinishHandshake(false);
+        UpdateState(State::FAILED);
+        return;
+    }
+    ScheduleHandshakeRetransmit();
+}
+
+unsigned int DtlsTransport::NextHandshakeRetransmitTimeout(unsigned int timeout_us) {
+    RTC_RUN_ON(&sequence_checker_);
+    // Start the timer of a new flight.
+    if (timeout_us == 0) {
+        return static_cast<unsigned int>(config_.initial_handshake_retransmit_timeout.us());
+    }
+    // Back off the timer after a retransmission.
+    int64_t next_timeout_us = static_cast<int64_t>(timeout_us * config_.handshake_retransmit_backoff);
+    next_timeout_us = std::min(next_timeout_us, config_.max_handshake_retransmit_timeout.us());
+    return static_cast<unsigned int>(std::max<int64_t>(next_timeout_us, timeout_us));
 }
 
 void DtlsTransport::DtlsHandshakeDone() {
@@ -258,6 +326,16 @@ openssl_bool DtlsTransport::CertificateCallback(int preverify_ok, X509_STORE_CTX
     }
 }
 
+unsigned int DtlsTransport::TimerCallback(SSL* ssl, unsigned int timeout_us) {
+    // NOTE: The callback is called synchronously by OpenSSL on the attached queue.
+    DtlsTransport* transport = static_cast<DtlsTransport*>(SSL_get_ex_data(ssl, DtlsTransport::transport_ex_index_));
+    if (transport) {
+        return transport->NextHandshakeRetransmitTimeout(timeout_us);
+    }
+    // The default behavior of OpenSSL: starting from 1s and doubled up to 60s.
+    return timeout_us == 0 ? 1'000'000 : std::min(timeout_us * 2, 60'000'000u);
+}
+
 void DtlsTransport::InfoCallback(const SSL* ssl, int where, int ret) {
     // SSL_CB_LOOP                     0x01
     // SSL_CB_EXIT                     0x02
@@ -0,0 +1,157 @@
+#include "rtc/transports/dtls_transport.hpp"
+#include "rtc/transports/loopback_transport.hpp"
+#include "testing/simulated_time_controller.hpp"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#define ENABLE_UNIT_TESTS 0
+#include "testing/defines.hpp"
+
+namespace naivertc {
+namespace test {
+
+class T(DtlsTransportTest) : public ::testing::Test {
+public:
+    T(DtlsTransportTest)()
+        : time_controller_(Timestamp::Millis(1000)),
+          task_queue_(time_controller_.CreateTaskQueue()) {
+        DtlsTransport::Init();
+    }
+
+    ~T(DtlsTransportTest)() override {
+        task_queue_->Post(ToQueuedTask([this](){
+            client_.reset();
+            server_.reset();
+            client_lower_.reset();
+            server_lower_.reset();
+        }));
+        time_controller_.AdvanceTime(TimeDelta::Zero());
+    }
+
+    // The server is not created if |with_server| is false,
+    // and the flights sent by client will be lost.
+    void CreateTransportsAndStart(DtlsTransport::Configuration config, bool with_server) {
+        task_queue_->Post(ToQueuedTask([this, config, with_server]() mutable {
+            LoopbackTransport::Configuration lower_config;
+            lower_config.loss_rate = with_server ? 0.0 : 1.0;
+            client_lower_ = std::make_unique<LoopbackTransport>(lower_config);
+            server_lower_ = std::make_unique<LoopbackTransport>(lower_config);
+            LoopbackTransport::Connect(client_lower_.get(), server_lower_.get());
+            client_lower_->Start();
+            server_lower_->Start();
+
+            config.clock = time_controller_.Clock();
+            if (with_server) {
+                config.certificate = Certificate::MakeCertificate().get();
+                server_ = std::make_unique<DtlsTransport>(config, /*is_client=*/false, server_lower_.get());
+                server_->OnVerify([](std::string_view fingerprint){ return true; });
+                server_->Start();
+            }
+            config.certificate = Certificate::MakeCertificate().get();
+            client_ = std::make_unique<DtlsTransport>(config, /*is_client=*/true, client_lower_.get());
+            client_->OnVerify([](std::string_view fingerprint){ return true; });
+            client_->OnHandshakeTrace([this](const DtlsTransport::HandshakeTrace& trace){
+                client_traces_.push_back(trace);
+            });
+            client_->Start();
+        }));
+        time_controller_.AdvanceTime(TimeDelta::Zero());
+    }
+
+    BaseTransport::State client_state() {
+        BaseTransport::State state = BaseTransport::State::DISCONNECTED;
+        task_queue_->Post(ToQueuedTask([this, &state](){
+            state = client_->state();
+        }));
+        time_controller_.AdvanceTime(TimeDelta::Zero());
+        return state;
+    }
+
+    size_t client_num_packets_sent() {
+        size_t num_packets_sent = 0;
+        task_queue_->Post(ToQueuedTask([this, &num_packets_sent](){
+            num_packets_sent = client_lower_->num_packets_sent();
+        }));
+        time_controller_.AdvanceTime(TimeDelta::Zero());
+        return num_packets_sent;
+    }
+
+protected:
+    SimulatedTimeController time_controller_;
+    std::unique_ptr<SimulatedTaskQueue, SimulatedTaskQueue::Deleter> task_queue_;
+    std::unique_ptr<LoopbackTransport> client_lower_;
+    std::unique_ptr<LoopbackTransport> server_lower_;
+    std::unique_ptr<DtlsTransport> client_;
+    std::unique_ptr<DtlsTransport> server_;
+    std::vector<DtlsTransport::HandshakeTrace> client_traces_;
+};
+
+MY_TEST_F(DtlsTransportTest, TraceSucceededHandshake) {
+    CreateTransportsAndStart(DtlsTransport::Configuration(), /*with_server=*/true);
+
+    EXPECT_EQ(client_state(), BaseTransport::State::CONNECTED);
+    ASSERT_EQ(client_traces_.size(), 1u);
+    const auto& trace = client_traces_[0];
+    EXPECT_TRUE(trace.succeeded);
+    // ClientHello and the flight of client certificate at least.
+    EXPECT_GE(trace.flights_sent.size(), 2u);
+    EXPECT_GE(trace.flights_received.size(), 1u);
+    EXPECT_EQ(trace.num_retransmits, 0u);
+    // No time elapsed in simulated time.
+    EXPECT_EQ(trace.duration(), TimeDelta::Zero());
+}
+
+MY_TEST_F(DtlsTransportTest, FailHandshakeAfterTimeout) {
+    DtlsTransport::Configuration config;
+    config.handshake_timeout = TimeDelta::Seconds(5);
+    CreateTransportsAndStart(config, /*with_server=*/false);
+
+    time_controller_.AdvanceTime(config.handshake_timeout - TimeDelta::Millis(1));
+    EXPECT_EQ(client_state(), BaseTransport::State::CONNECTING);
+    EXPECT_TRUE(client_traces_.empty());
+
+    time_controller_.AdvanceTime(TimeDelta::Millis(1));
+    EXPECT_EQ(client_state(), BaseTransport::State::FAILED);
+    ASSERT_EQ(client_traces_.size(), 1u);
+    const auto& trace = client_traces_[0];
+    EXPECT_FALSE(trace.succeeded);
+    EXPECT_EQ(trace.duration(), config.handshake_timeout);
+    EXPECT_EQ(trace.flights_sent.size(), 1u);
+    EXPECT_TRUE(trace.flights_received.empty());
+
+    // No more handshake flight after failed.
+    const size_t num_packets_sent = client_num_packets_sent();
+    time_controller_.AdvanceTime(TimeDelta::Seconds(10));
+    EXPECT_EQ(client_num_packets_sent(), num_packets_sent);
+}
+
+MY_TEST_F(DtlsTransportTest, BackOffHandshakeRetransmitTimer) {
+    DtlsTransport::Configuration config;
+    config.initial_handshake_retransmit_timeout = TimeDelta::Millis(10);
+    config.handshake_retransmit_backoff = 2.0;
+    config.handshake_timeout = TimeDelta::Seconds(1);
+    CreateTransportsAndStart(config, /*with_server=*/false);
+
+    // OpenSSL checks the expiration of the retransmit timer in real time,
+    // so we let the real time run no slower than the simulated time.
+    const TimeDelta kStep = TimeDelta::Millis(10);
+    for (TimeDelta elapsed = TimeDelta::Zero(); elapsed < config.handshake_timeout; elapsed += kStep) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(kStep.ms()));
+        time_controller_.AdvanceTime(kStep);
+    }
+
+    EXPECT_EQ(client_state(), BaseTransport::State::FAILED);
+    ASSERT_EQ(client_traces_.size(), 1u);
+    const auto& trace = client_traces_[0];
+    // Retransmitted at 10, 30, 70, 150, 310 and 630 ms, and it would
+    // be retransmitted 99 times without backoff.
+    EXPECT_GE(trace.num_retransmits, 4u);
+    EXPECT_LE(trace.num_retransmits, 7u);
+    EXPECT_EQ(trace.flights_sent.size(), 1u + trace.num_retransmits);
+    EXPECT_GT(client_num_packets_sent(), trace.num_retransmits);
+}
+
+} // namespace test
+} // namespace naivertc
@@ -71,15 +71,14 @@ bool IceTransport::Stop() {
     RTC_RUN_ON(&sequence_checker_);
     if (!is_stoped_) {
 #if USE_NICE
-        if (timeout_id_ > 0) {
-            g_source_remove(timeout_id_);
-            timeout_id_ = 0;
-        }
-        PLOG_DEBUG << "Stopping NICE ICE thread";
-        nice_agent_attach_recv(nice_agent_.get(), stream_id_, component_id_, g_main_loop_get_context(main_loop_.get()), NULL, NULL);
+        RemoveNiceTimeout();
+        PLOG_DEBUG << "Stopping NICE ICE agent";
+        nice_agent_attach_recv(nice_agent_.get(), stream_id_, component_id_, main_loop_->context(), NULL, NULL);
+        g_signal_handlers_disconnect_by_data(G_OBJECT(nice_agent_.get()), this);
         nice_agent_remove_stream(nice_agent_.get(), stream_id_);
-        g_main_loop_quit(main_loop_.get());
-        main_loop_thread_.join();
+        // The main loop might be shared with other agents, so we wait for
+        // the callbacks in flight to be finished instead of quitting it.
+        main_loop_->Flush();
 #endif
         is_stoped_ = true;
     }
@@ -9,8 +9,9 @@
 #include "rtc/sdp/sdp_description.hpp"
 
 #if USE_NICE
+#include "rtc/transports/nice_main_loop_pool.hpp"
+
 #include <nice/agent.h>
-#include <thread>
 #include <chrono>
 #else
 #include <juice/juice.h>
@@ -34,6 +35,9 @@ public:
         
     #if USE_NICE
         std::optional<ProxyServer> proxy_server;
+        // The maximum number of main loops shared by the agents of the process,
+        // zero means running the agent on a dedicated main loop.
+        size_t num_shared_main_loops = 0;
     #else
         std::optional<std::string> bind_addresses;
     #endif
@@ -117,6 +121,7 @@ private:
     static std::string ToString(const NiceAddress& nice_addr);
 
     void InitNice(const Configuration& config);
+    void RemoveNiceTimeout();
     void OnNiceTimeout();
     void OnNiceState(guint state);
     void OnNiceGatheringState(GatheringState state);
@@ -151,10 +156,10 @@ private:
     const guint component_id_ = 1;
     guint timeout_id_ = 0;
     DSCP last_dscp_ = DSCP::DSCP_DF;
-    std::thread main_loop_thread_;
     std::chrono::milliseconds trickle_timeout_;
+    // NOTE: The agent MUST be destroyed before the main loop is released.
+    NiceMainLoopPool::Lease main_loop_ = nullptr;
     std::unique_ptr<NiceAgent, void(*)(gpointer)> nice_agent_{nullptr, nullptr};
-    std::unique_ptr<GMainLoop, void(*)(GMainLoop *)> main_loop_{nullptr, nullptr};
 #else
     std::unique_ptr<juice_agent_t, void (*)(juice_agent_t *)> juice_agent_{nullptr, nullptr};
 #endif
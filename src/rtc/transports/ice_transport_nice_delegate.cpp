@@ -26,20 +26,24 @@ void IceTransport::InitNice(const Configuration& config) {
         nice_debug_enable(false);
     }
 
-    main_loop_ = decltype(main_loop_)(g_main_loop_new(nullptr /* context */, false /* is_running */), g_main_loop_unref);
-    if (!main_loop_) {
-        throw std::runtime_error("Failed to create the nice main loop");
+    if (config.num_shared_main_loops > 0) {
+        // Run the agent on a main loop shared with other agents to avoid
+        // spawning a thread per agent.
+        auto pool = NiceMainLoopPool::SharedInstance();
+        main_loop_ = pool->Acquire(config.num_shared_main_loops);
+        PLOG_DEBUG << "Attached to a shared nice main loop, num_loops=" << pool->num_loops()
+                   << ", num_agents=" << pool->num_agents();
+    } else {
+        main_loop_ = NiceMainLoopPool::Lease(new NiceMainLoopPool::MainLoop(), [](NiceMainLoopPool::MainLoop* loop){ delete loop; });
     }
 
     // RFC 5245 was obsoleted by RFC 8445 but this should be OK.
     // See https://datatracker.ietf.org/doc/html/rfc5245
-    nice_agent_ = decltype(nice_agent_)(nice_agent_new(g_main_loop_get_context(main_loop_.get()), NICE_COMPATIBILITY_RFC5245), g_object_unref);
+    nice_agent_ = decltype(nice_agent_)(nice_agent_new(main_loop_->context(), NICE_COMPATIBILITY_RFC5245), g_object_unref);
     if (!nice_agent_) {
         throw std::runtime_error("Failed to create the nice agent");
     }
 
-    main_loop_thread_ = std::thread(g_main_loop_run, main_loop_.get());
-
     stream_id_ = nice_agent_add_stream(nice_agent_.get(), component_id_);
     if (!stream_id_) {
         throw std::runtime_error("Failed to add a nice stream");
@@ -138,8 +142,20 @@ void IceTransport::InitNice(const Configuration& config) {
     nice_agent_set_stream_name(nice_agent_.get(), stream_id_, "application");
     nice_agent_set_port_range(nice_agent_.get(), stream_id_, component_id_, config.port_range_begin, config.port_range_end);
 
-    nice_agent_attach_recv(nice_agent_.get(), stream_id_, component_id_, g_main_loop_get_context(main_loop_.get()), OnNiceDataReceived, this);
+    nice_agent_attach_recv(nice_agent_.get(), stream_id_, component_id_, main_loop_->context(), OnNiceDataReceived, this);
+
+}
 
+void IceTransport::RemoveNiceTimeout() {
+    RTC_RUN_ON(&sequence_checker_);
+    if (timeout_id_ > 0) {
+        // NOTE: `g_source_remove` only works with the default context.
+        GSource* source = g_main_context_find_source_by_id(main_loop_->context(), timeout_id_);
+        if (source) {
+            g_source_destroy(source);
+        }
+        timeout_id_ = 0;
+    }
 }
 
 void IceTransport::OnNiceTimeout() {
@@ -153,15 +169,18 @@ void IceTransport::OnNiceTimeout() {
 void IceTransport::OnNiceState(guint state) {
     attached_queue_->Post([this, state](){
         if (state == NICE_COMPONENT_STATE_FAILED && trickle_timeout_.count() > 0) {
-            if (timeout_id_)
-                g_source_remove(timeout_id_);
-            timeout_id_ = g_timeout_add(trickle_timeout_.count() /* ms */, OnNiceTimeout, this);
+            RemoveNiceTimeout();
+            // The timeout source MUST be attached to the context of the agent,
+            // since the default context is not running.
+            GSource* source = g_timeout_source_new(static_cast<guint>(trickle_timeout_.count()) /* ms */);
+            g_source_set_callback(source, OnNiceTimeout, this, nullptr);
+            timeout_id_ = g_source_attach(source, main_loop_->context());
+            g_source_unref(source);
             return;
         }
 
-        if (state == NICE_COMPONENT_STATE_CONNECTED && timeout_id_) {
-            g_source_remove(timeout_id_);
-            timeout_id_ = 0;
+        if (state == NICE_COMPONENT_STATE_CONNECTED) {
+            RemoveNiceTimeout();
         }
 
         switch (state) {
@@ -0,0 +1,138 @@
+#include "rtc/transports/loopback_transport.hpp"
+#include "rtc/base/task_utils/task_queue_impl.hpp"
+
+#include <plog/Log.h>
+
+namespace naivertc {
+
+void LoopbackTransport::Connect(LoopbackTransport* lhs, LoopbackTransport* rhs) {
+    assert(lhs != nullptr && rhs != nullptr && lhs != rhs);
+    assert(lhs->is_stoped_ && rhs->is_stoped_);
+    lhs->remote_ = rhs;
+    lhs->remote_queue_ = rhs->attached_queue_;
+    lhs->remote_safety_flag_ = rhs->task_safety_.flag();
+    rhs->remote_ = lhs;
+    rhs->remote_queue_ = lhs->attached_queue_;
+    rhs->remote_safety_flag_ = lhs->task_safety_.flag();
+}
+
+LoopbackTransport::LoopbackTransport(Configuration config)
+    : BaseTransport(nullptr),
+      config_(std::move(config)),
+      random_generator_(config_.random_seed),
+      loss_distribution_(std::clamp(config_.loss_rate, 0.0, 1.0)) {}
+
+LoopbackTransport::~LoopbackTransport() {
+    RTC_RUN_ON(&sequence_checker_);
+    Stop();
+    // Disconnect the remote from this endpoint, and the remote will
+    // fail to send after that instead of posting to a dead endpoint.
+    if (remote_) {
+        remote_queue_->Post(ToQueuedTask(remote_safety_flag_, [remote=remote_](){
+            remote->remote_ = nullptr;
+            remote->remote_queue_ = nullptr;
+            remote->remote_safety_flag_ = nullptr;
+        }));
+    }
+}
+
+bool LoopbackTransport::Start() {
+    RTC_RUN_ON(&sequence_checker_);
+    if (is_stoped_) {
+        is_stoped_ = false;
+        UpdateState(State::CONNECTED);
+    }
+    return true;
+}
+
+bool LoopbackTransport::Stop() {
+    RTC_RUN_ON(&sequence_checker_);
+    if (!is_stoped_) {
+        is_stoped_ = true;
+        UpdateState(State::DISCONNECTED);
+    }
+    return true;
+}
+
+int LoopbackTransport::Send(CopyOnWriteBuffer packet, PacketOptions options) {
+    RTC_RUN_ON(&sequence_checker_);
+    if (packet.empty() || state_ != State::CONNECTED) {
+        return -1;
+    }
+    return Outgoing(std::move(packet), std::move(options));
+}
+
+int LoopbackTransport::SendRtpPacket(CopyOnWriteBuffer packet,
+                                     PacketOptions options,
+                                     bool is_rtcp) {
+    RTC_RUN_ON(&sequence_checker_);
+    // The RTCP packets are delivered along with the RTP packets, since the
+    // receiver demultiplexes them by the payload type as RFC 5761 does.
+    int sent_size = Send(std::move(packet), std::move(options));
+    if (is_rtcp && sent_size >= 0) {
+        ++num_rtcp_packets_sent_;
+    }
+    return sent_size;
+}
+
+void LoopbackTransport::OnReceivedPacket(PacketReceivedCallback callback) {
+    RTC_RUN_ON(&sequence_checker_);
+    packet_recv_callback_ = std::move(callback);
+}
+
+size_t LoopbackTransport::num_packets_sent() const {
+    RTC_RUN_ON(&sequence_checker_);
+    return num_packets_sent_;
+}
+
+size_t LoopbackTransport::num_rtcp_packets_sent() const {
+    RTC_RUN_ON(&sequence_checker_);
+    return num_rtcp_packets_sent_;
+}
+
+size_t LoopbackTransport::num_packets_lost() const {
+    RTC_RUN_ON(&sequence_checker_);
+    return num_packets_lost_;
+}
+
+size_t LoopbackTransport::num_packets_received() const {
+    RTC_RUN_ON(&sequence_checker_);
+    return num_packets_received_;
+}
+
+// Private methods
+int LoopbackTransport::Outgoing(CopyOnWriteBuffer out_packet, PacketOptions options) {
+    RTC_RUN_ON(&sequence_checker_);
+    if (!remote_) {
+        PLOG_WARNING << "Loopback transport is not connected to a remote.";
+        return -1;
+    }
+    const int sent_size = static_cast<int>(out_packet.size());
+    ++num_packets_sent_;
+    // The lost packets are dropped silently like a real network does.
+    if (config_.loss_rate > 0 && loss_distribution_(random_generator_)) {
+        ++num_packets_lost_;
+        return sent_size;
+    }
+    // The remote is only dereferenced on its own queue once it's still alive.
+    auto task = ToQueuedTask(remote_safety_flag_, [remote=remote_, packet=std::move(out_packet)]() mutable {
+        remote->Incoming(std::move(packet));
+    });
+    if (config_.latency > TimeDelta::Zero()) {
+        remote_queue_->PostDelayed(config_.latency, std::move(task));
+    } else {
+        remote_queue_->Post(std::move(task));
+    }
+    return sent_size;
+}
+
+void LoopbackTransport::Incoming(CopyOnWriteBuffer in_packet) {
+    RTC_RUN_ON(&sequence_checker_);
+    if (is_stoped_) {
+        return;
+    }
+    ++num_packets_received_;
+    ForwardIncomingPacket(std::move(in_packet));
+}
+
+} // namespace naivertc
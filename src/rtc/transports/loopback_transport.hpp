@@ -0,0 +1,84 @@
+#ifndef _RTC_TRANSPORTS_LOOPBACK_TRANSPORT_H_
+#define _RTC_TRANSPORTS_LOOPBACK_TRANSPORT_H_
+
+#include "base/defines.hpp"
+#include "rtc/transports/base_transport.hpp"
+#include "rtc/transports/rtc_transport_media.hpp"
+#include "rtc/base/units/time_delta.hpp"
+#include "rtc/base/task_utils/pending_task_safety_flag.hpp"
+
+#include <random>
+
+namespace naivertc {
+
+// LoopbackTransport connects two endpoints in memory without sockets, which
+// can be plugged in below `DtlsSrtpTransport`, or below `Call` as a
+// `RtcMediaTransport` for unencrypted runs.
+// The packets are delivered on the attached queue of the remote endpoint, so
+// the latency is driven by `SimulatedTimeController` if the endpoints are
+// attached to simulated task queues.
+class LoopbackTransport final : public BaseTransport,
+                                public RtcMediaTransport {
+public:
+    struct Configuration {
+        // The one-way latency of the link.
+        TimeDelta latency = TimeDelta::Zero();
+        // The probability of a packet being lost, in [0, 1].
+        double loss_rate = 0.0;
+        // Used to generate the deterministic loss pattern.
+        uint32_t random_seed = 1;
+    };
+
+    // Connects the two endpoints with each other, MUST be called before
+    // the both endpoints are started.
+    static void Connect(LoopbackTransport* lhs, LoopbackTransport* rhs);
+
+public:
+    explicit LoopbackTransport(Configuration config);
+    ~LoopbackTransport() override;
+
+    bool Start() override;
+    bool Stop() override;
+
+    int Send(CopyOnWriteBuffer packet, PacketOptions options) override;
+
+    // RtcMediaTransport interface
+    int SendRtpPacket(CopyOnWriteBuffer packet,
+                      PacketOptions options,
+                      bool is_rtcp) override;
+
+    // Used to receive packets if no upper transport is registered.
+    using PacketReceivedCallback = BaseTransport::PacketReceivedCallback;
+    void OnReceivedPacket(PacketReceivedCallback callback);
+
+    size_t num_packets_sent() const;
+    size_t num_rtcp_packets_sent() const;
+    size_t num_packets_lost() const;
+    size_t num_packets_received() const;
+
+private:
+    void Incoming(CopyOnWriteBuffer in_packet) override;
+    int Outgoing(CopyOnWriteBuffer out_packet, PacketOptions options) override;
+
+private:
+    const Configuration config_;
+    std::mt19937 random_generator_;
+    std::bernoulli_distribution loss_distribution_;
+
+    // The remote endpoint MUST only be accessed on the remote queue
+    // and guarded by the remote safety flag.
+    LoopbackTransport* remote_ = nullptr;
+    TaskQueueImpl* remote_queue_ = nullptr;
+    std::shared_ptr<PendingTaskSafetyFlag> remote_safety_flag_ = nullptr;
+
+    size_t num_packets_sent_ = 0;
+    size_t num_rtcp_packets_sent_ = 0;
+    size_t num_packets_lost_ = 0;
+    size_t num_packets_received_ = 0;
+
+    ScopedTaskSafety task_safety_;
+};
+
+} // namespace naivertc
+
+#endif
@@ -0,0 +1,145 @@
+#include "rtc/transports/loopback_transport.hpp"
+#include "testing/simulated_time_controller.hpp"
+
+#include <gtest/gtest.h>
+
+#define ENABLE_UNIT_TESTS 0
+#include "testing/defines.hpp"
+
+namespace naivertc {
+namespace test {
+
+class T(LoopbackTransportTest) : public ::testing::Test {
+public:
+    T(LoopbackTransportTest)()
+        : time_controller_(Timestamp::Millis(1000)),
+          task_queue_(time_controller_.CreateTaskQueue()) {}
+
+    ~T(LoopbackTransportTest)() override {
+        task_queue_->Post(ToQueuedTask([this](){
+            local_.reset();
+            remote_.reset();
+        }));
+        time_controller_.AdvanceTime(TimeDelta::Zero());
+    }
+
+    void CreateTransports(LoopbackTransport::Configuration config) {
+        task_queue_->Post(ToQueuedTask([this, config](){
+            local_ = std::make_unique<LoopbackTransport>(config);
+            remote_ = std::make_unique<LoopbackTransport>(config);
+            LoopbackTransport::Connect(local_.get(), remote_.get());
+            remote_->OnReceivedPacket([this](CopyOnWriteBuffer packet){
+                received_packets_.push_back(std::move(packet));
+            });
+            local_->Start();
+            remote_->Start();
+        }));
+        time_controller_.AdvanceTime(TimeDelta::Zero());
+    }
+
+    void SendPackets(size_t num_packets) {
+        task_queue_->Post(ToQueuedTask([this, num_packets](){
+            for (size_t i = 0; i < num_packets; ++i) {
+                const uint8_t data[4] = {0, 1, 2, static_cast<uint8_t>(i)};
+                EXPECT_EQ(local_->Send(CopyOnWriteBuffer(data, 4), PacketOptions(PacketKind::BINARY)), 4);
+            }
+        }));
+    }
+
+protected:
+    SimulatedTimeController time_controller_;
+    std::unique_ptr<SimulatedTaskQueue, SimulatedTaskQueue::Deleter> task_queue_;
+    std::unique_ptr<LoopbackTransport> local_;
+    std::unique_ptr<LoopbackTransport> remote_;
+    std::vector<CopyOnWriteBuffer> received_packets_;
+};
+
+MY_TEST_F(LoopbackTransportTest, DeliverWithLatency) {
+    LoopbackTransport::Configuration config;
+    config.latency = TimeDelta::Millis(50);
+    CreateTransports(config);
+
+    SendPackets(10);
+    time_controller_.AdvanceTime(TimeDelta::Millis(49));
+    EXPECT_TRUE(received_packets_.empty());
+
+    time_controller_.AdvanceTime(TimeDelta::Millis(1));
+    ASSERT_EQ(received_packets_.size(), 10u);
+    for (size_t i = 0; i < received_packets_.size(); ++i) {
+        EXPECT_EQ(received_packets_[i].size(), 4u);
+        EXPECT_EQ(received_packets_[i].cdata()[3], i);
+    }
+}
+
+MY_TEST_F(LoopbackTransportTest, DropWithLossRate) {
+    LoopbackTransport::Configuration config;
+    config.loss_rate = 0.5;
+    CreateTransports(config);
+
+    const size_t kNumPackets = 1000;
+    SendPackets(kNumPackets);
+    time_controller_.AdvanceTime(TimeDelta::Zero());
+
+    task_queue_->Post(ToQueuedTask([&](){
+        EXPECT_EQ(local_->num_packets_sent(), kNumPackets);
+        EXPECT_EQ(local_->num_packets_lost() + remote_->num_packets_received(), kNumPackets);
+        EXPECT_EQ(remote_->num_packets_received(), received_packets_.size());
+    }));
+    time_controller_.AdvanceTime(TimeDelta::Zero());
+    EXPECT_NEAR(received_packets_.size(), kNumPackets / 2, kNumPackets / 10);
+}
+
+MY_TEST_F(LoopbackTransportTest, DropAfterRemoteStopped) {
+    LoopbackTransport::Configuration config;
+    config.latency = TimeDelta::Millis(10);
+    CreateTransports(config);
+
+    SendPackets(1);
+    task_queue_->Post(ToQueuedTask([this](){
+        remote_->Stop();
+    }));
+    time_controller_.AdvanceTime(TimeDelta::Millis(10));
+    EXPECT_TRUE(received_packets_.empty());
+}
+
+MY_TEST_F(LoopbackTransportTest, FailToSendAfterRemoteDestroyed) {
+    LoopbackTransport::Configuration config;
+    config.latency = TimeDelta::Millis(10);
+    CreateTransports(config);
+
+    // The packet in flight is dropped with the remote.
+    SendPackets(1);
+    task_queue_->Post(ToQueuedTask([this](){
+        remote_.reset();
+    }));
+    time_controller_.AdvanceTime(TimeDelta::Millis(10));
+    EXPECT_TRUE(received_packets_.empty());
+
+    task_queue_->Post(ToQueuedTask([this](){
+        const uint8_t data[4] = {0, 1, 2, 3};
+        EXPECT_EQ(local_->Send(CopyOnWriteBuffer(data, 4), PacketOptions(PacketKind::BINARY)), -1);
+        EXPECT_EQ(local_->num_packets_sent(), 1u);
+    }));
+    time_controller_.AdvanceTime(TimeDelta::Zero());
+}
+
+MY_TEST_F(LoopbackTransportTest, CountRtcpPacketsSent) {
+    CreateTransports(LoopbackTransport::Configuration());
+
+    task_queue_->Post(ToQueuedTask([this](){
+        const uint8_t data[4] = {0x80, 200, 0, 0};
+        EXPECT_EQ(local_->SendRtpPacket(CopyOnWriteBuffer(data, 4), PacketOptions(PacketKind::VIDEO), /*is_rtcp=*/false), 4);
+        EXPECT_EQ(local_->SendRtpPacket(CopyOnWriteBuffer(data, 4), PacketOptions(PacketKind::VIDEO), /*is_rtcp=*/true), 4);
+    }));
+    time_controller_.AdvanceTime(TimeDelta::Zero());
+
+    task_queue_->Post(ToQueuedTask([this](){
+        EXPECT_EQ(local_->num_packets_sent(), 2u);
+        EXPECT_EQ(local_->num_rtcp_packets_sent(), 1u);
+    }));
+    time_controller_.AdvanceTime(TimeDelta::Zero());
+    EXPECT_EQ(received_packets_.size(), 2u);
+}
+
+} // namespace test
+} // namespace naivertc
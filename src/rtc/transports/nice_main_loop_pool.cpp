@@ -0,0 +1,112 @@
+#if USE_NICE
+#include "rtc/transports/nice_main_loop_pool.hpp"
+
+#include <plog/Log.h>
+
+#include <future>
+
+namespace naivertc {
+
+// MainLoop
+NiceMainLoopPool::MainLoop::MainLoop() 
+    : context_(g_main_context_new(), g_main_context_unref),
+      loop_(g_main_loop_new(context_.get(), false /* is_running */), g_main_loop_unref) {
+    if (!loop_) {
+        throw std::runtime_error("Failed to create the nice main loop");
+    }
+    thread_ = std::thread(g_main_loop_run, loop_.get());
+    // Make sure the loop is running before it can be quit.
+    Flush();
+}
+
+NiceMainLoopPool::MainLoop::~MainLoop() {
+    g_main_loop_quit(loop_.get());
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+GMainContext* NiceMainLoopPool::MainLoop::context() const {
+    return context_.get();
+}
+
+void NiceMainLoopPool::MainLoop::Flush() {
+    std::promise<void> done;
+    auto future = done.get_future();
+    // NOTE: Using an idle source instead of `g_main_context_invoke`, which
+    // might run the callback on the calling thread if the context is free.
+    GSource* source = g_idle_source_new();
+    g_source_set_callback(source, [](gpointer user_data) -> gboolean {
+        static_cast<std::promise<void>*>(user_data)->set_value();
+        return G_SOURCE_REMOVE;
+    }, &done, nullptr);
+    g_source_attach(source, context_.get());
+    g_source_unref(source);
+    future.wait();
+}
+
+// NiceMainLoopPool
+NiceMainLoopPool* NiceMainLoopPool::SharedInstance() {
+    static NiceMainLoopPool* const instance = new NiceMainLoopPool();
+    return instance;
+}
+
+NiceMainLoopPool::NiceMainLoopPool() {}
+
+NiceMainLoopPool::~NiceMainLoopPool() {}
+
+NiceMainLoopPool::Lease NiceMainLoopPool::Acquire(size_t max_num_loops) {
+    std::lock_guard lock(mutex_);
+    MainLoop* selected = nullptr;
+    for (auto& loop : loops_) {
+        if (!selected || loop->num_agents_ < selected->num_agents_) {
+            selected = loop.get();
+        }
+    }
+    if (!selected || (selected->num_agents_ > 0 && loops_.size() < max_num_loops)) {
+        loops_.push_back(std::make_unique<MainLoop>());
+        selected = loops_.back().get();
+        PLOG_DEBUG << "Created a shared nice main loop, num_loops=" << loops_.size();
+    }
+    ++selected->num_agents_;
+    return Lease(selected, [this](MainLoop* loop){ Release(loop); });
+}
+
+size_t NiceMainLoopPool::num_loops() const {
+    std::lock_guard lock(mutex_);
+    return loops_.size();
+}
+
+size_t NiceMainLoopPool::num_agents() const {
+    std::lock_guard lock(mutex_);
+    size_t num_agents = 0;
+    for (const auto& loop : loops_) {
+        num_agents += loop->num_agents_;
+    }
+    return num_agents;
+}
+
+// Private methods
+void NiceMainLoopPool::Release(MainLoop* loop) {
+    std::unique_ptr<MainLoop> idle_loop = nullptr;
+    {
+        std::lock_guard lock(mutex_);
+        if (--loop->num_agents_ > 0) {
+            return;
+        }
+        for (auto it = loops_.begin(); it != loops_.end(); ++it) {
+            if (it->get() == loop) {
+                idle_loop = std::move(*it);
+                loops_.erase(it);
+                break;
+            }
+        }
+        PLOG_DEBUG << "Stopping an idle shared nice main loop, num_loops=" << loops_.size();
+    }
+    // Join the loop thread outside the lock.
+    idle_loop.reset();
+}
+
+} // namespace naivertc
+
+#endif // USE_NICE
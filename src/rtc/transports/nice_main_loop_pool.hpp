@@ -0,0 +1,74 @@
+#ifndef _RTC_TRANSPORTS_NICE_MAIN_LOOP_POOL_H_
+#define _RTC_TRANSPORTS_NICE_MAIN_LOOP_POOL_H_
+
+#include "base/defines.hpp"
+
+#if USE_NICE
+
+#include <glib.h>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace naivertc {
+
+// NiceMainLoopPool runs the NiceAgents of a process on a small set of
+// shared GMainLoop threads (shards), instead of spawning a dedicated
+// thread per agent.
+// NOTE: NiceMainLoopPoolTest reports the loop threads and the idle CPU
+// usage measured with 64 agents on 4 shared loops.
+class NiceMainLoopPool {
+public:
+    class MainLoop {
+    public:
+        MainLoop();
+        ~MainLoop();
+
+        GMainContext* context() const;
+
+        // Blocks until the callbacks dispatched before on the loop thread
+        // are finished, MUST NOT be called on the loop thread.
+        void Flush();
+
+    private:
+        friend class NiceMainLoopPool;
+        std::unique_ptr<GMainContext, void(*)(GMainContext*)> context_;
+        std::unique_ptr<GMainLoop, void(*)(GMainLoop*)> loop_;
+        std::thread thread_;
+        size_t num_agents_ = 0;
+    };
+
+    // The lease keeps an agent attached to a shared main loop, and
+    // the loop thread will be stopped once no agents are attached.
+    using Lease = std::unique_ptr<MainLoop, std::function<void(MainLoop*)>>;
+
+public:
+    static NiceMainLoopPool* SharedInstance();
+
+    // Returns the main loop with the fewest agents, a new one will be
+    // created if all the running loops are occupied and |max_num_loops|
+    // is not reached.
+    Lease Acquire(size_t max_num_loops);
+
+    size_t num_loops() const;
+    size_t num_agents() const;
+
+private:
+    NiceMainLoopPool();
+    ~NiceMainLoopPool();
+
+    void Release(MainLoop* loop);
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<MainLoop>> loops_;
+};
+
+} // namespace naivertc
+
+#endif // USE_NICE
+
+#endif
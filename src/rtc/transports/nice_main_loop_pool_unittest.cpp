@@ -0,0 +1,88 @@
+#if USE_NICE
+#include "rtc/transports/nice_main_loop_pool.hpp"
+
+#include <gtest/gtest.h>
+#include <nice/agent.h>
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+#define ENABLE_UNIT_TESTS 0
+#include "testing/defines.hpp"
+
+namespace naivertc {
+namespace test {
+namespace {
+
+constexpr size_t kNumAgents = 64;
+constexpr size_t kMaxNumLoops = 4;
+constexpr auto kIdleDuration = std::chrono::seconds(1);
+
+size_t NumThreads() {
+    // One entry per thread of the process on Linux.
+    return std::distance(std::filesystem::directory_iterator("/proc/self/task"), 
+                         std::filesystem::directory_iterator());
+}
+
+int64_t CpuTimeUs() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000'000 +
+           usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+struct Agent {
+    NiceMainLoopPool::Lease main_loop;
+    std::unique_ptr<NiceAgent, void(*)(gpointer)> nice_agent;
+};
+
+Agent CreateAgent(NiceMainLoopPool* pool) {
+    auto main_loop = pool->Acquire(kMaxNumLoops);
+    std::unique_ptr<NiceAgent, void(*)(gpointer)> nice_agent(nice_agent_new(main_loop->context(), NICE_COMPATIBILITY_RFC5245), g_object_unref);
+    nice_agent_add_stream(nice_agent.get(), 1);
+    return {std::move(main_loop), std::move(nice_agent)};
+}
+
+} // namespace
+
+MY_TEST(NiceMainLoopPoolTest, BoundsThreadsAndReleasesThemOnTeardown) {
+    NiceMainLoopPool* pool = NiceMainLoopPool::SharedInstance();
+    // Warm up, so the threads started lazily by glib are not counted.
+    CreateAgent(pool);
+    ASSERT_EQ(pool->num_loops(), 0u);
+    const size_t num_threads_before = NumThreads();
+
+    std::vector<Agent> agents;
+    for (size_t i = 0; i < kNumAgents; ++i) {
+        agents.push_back(CreateAgent(pool));
+        EXPECT_LE(pool->num_loops(), kMaxNumLoops);
+    }
+    EXPECT_EQ(pool->num_loops(), kMaxNumLoops);
+    EXPECT_EQ(pool->num_agents(), kNumAgents);
+    const size_t num_threads = NumThreads();
+    EXPECT_LE(num_threads - num_threads_before, kMaxNumLoops);
+
+    // The idle CPU time of the shared loops.
+    const int64_t cpu_time_before_us = CpuTimeUs();
+    std::this_thread::sleep_for(kIdleDuration);
+    const int64_t idle_cpu_time_us = CpuTimeUs() - cpu_time_before_us;
+
+    GTEST_COUT << "agents=" << kNumAgents
+               << ", loop threads=" << num_threads - num_threads_before
+               << ", idle cpu=" << 100.0 * idle_cpu_time_us / std::chrono::microseconds(kIdleDuration).count() << "%"
+               << std::endl;
+
+    // The loop threads are joined once the last agent is released.
+    agents.clear();
+    EXPECT_EQ(pool->num_loops(), 0u);
+    EXPECT_EQ(pool->num_agents(), 0u);
+    EXPECT_EQ(NumThreads(), num_threads_before);
+}
+
+} // namespace test
+} // namespace naivertc
+
+#endif // USE_NICE
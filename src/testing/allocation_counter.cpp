@@ -0,0 +1,49 @@
+#include "testing/allocation_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<int> g_num_active_counters{0};
+std::atomic<size_t> g_num_allocations{0};
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    if (g_num_active_counters.load(std::memory_order_relaxed) > 0) {
+        g_num_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace naivertc {
+namespace test {
+
+ScopedAllocationCounter::ScopedAllocationCounter()
+    : start_allocations_(g_num_allocations.load()) {
+    g_num_active_counters.fetch_add(1);
+}
+
+ScopedAllocationCounter::~ScopedAllocationCounter() {
+    g_num_active_counters.fetch_sub(1);
+}
+
+size_t ScopedAllocationCounter::num_allocations() const {
+    return g_num_allocations.load() - start_allocations_;
+}
+
+} // namespace test
+} // namespace naivertc
@@ -0,0 +1,27 @@
+#ifndef _TESTING_ALLOCATION_COUNTER_H_
+#define _TESTING_ALLOCATION_COUNTER_H_
+
+#include "base/defines.hpp"
+
+namespace naivertc {
+namespace test {
+
+// Counts the heap allocations made by the global operator new within its
+// scope, which are the allocations made by the code under test as long as
+// the test is single threaded. The counters can be nested.
+class ScopedAllocationCounter {
+public:
+    ScopedAllocationCounter();
+    ~ScopedAllocationCounter();
+
+    // The number of allocations made since constructed.
+    size_t num_allocations() const;
+
+private:
+    const size_t start_allocations_;
+};
+
+} // namespace test
+} // namespace naivertc
+
+#endif